@@ -0,0 +1,151 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+  Measures the time per lookup of an integer setting, before and after
+  Config cached the resolved values. "Before" repeats what
+  Config::getValue() did without the cache: search wxFileConfig for the
+  key and its fallbacks, then parse the string. "After" calls
+  Config::getValue() of the current sources.
+
+  This is a standalone program, it isn't part of the FlameRobin build.
+  Build it on Linux from this directory with
+
+    g++ -O2 -I../../src -DFR_INSTALL_PREFIX='"/usr/local"' \
+        -o config_lookup_benchmark config_lookup_benchmark.cpp \
+        ../../src/config/Config.cpp ../../src/core/FRError.cpp \
+        ../../src/core/Observer.cpp ../../src/core/StringUtils.cpp \
+        ../../src/core/Subject.cpp `wx-config --cxxflags --libs`
+
+  and run it with the number of lookups per key (default 1000000):
+
+    ./config_lookup_benchmark 1000000
+
+  The settings are written to a temporary file, the user's configuration
+  isn't touched.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "wx/fileconf.h"
+#include "wx/filename.h"
+#include "wx/init.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "config/Config.h"
+
+// the lookup of Config::getValue() before the cache
+static bool readUncached(wxFileConfig& fc, const wxString& key,
+    wxString& value)
+{
+    if (fc.Read(key, &value))
+        return true;
+    wxString::size_type separatorPos = key.rfind(Config::pathSeparator);
+    if (separatorPos == wxString::npos)
+        return false;
+    wxString keyPart = key.substr(separatorPos + 1, key.length());
+    wxString pathPart = key.substr(0, separatorPos);
+    wxString::size_type separatorPosInPath =
+        pathPart.rfind(Config::pathSeparator);
+    if (separatorPosInPath == wxString::npos)
+        return readUncached(fc, keyPart, value);
+    return readUncached(fc, pathPart.substr(0, separatorPosInPath) +
+        Config::pathSeparator + keyPart, value);
+}
+
+static bool getUncached(wxFileConfig& fc, const wxString& key, int& value)
+{
+    wxString s;
+    long l;
+    if (!readUncached(fc, key, s) || !s.ToLong(&l))
+        return false;
+    value = l;
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    wxInitializer initializer;
+    if (!initializer)
+    {
+        std::cerr << "Failed to initialize wxWidgets" << std::endl;
+        return 1;
+    }
+    long lookups = argc > 1 ? std::atol(argv[1]) : 1000000;
+    if (lookups < 1)
+        lookups = 1;
+
+    // a setting found directly, one and two levels of fallback, and a
+    // setting that doesn't exist at all
+    const wxString keys[] = {
+        "NumberPrecision",
+        "DATABASE_1/NumberPrecision",
+        "DATABASE_1/DataGrid/NumberPrecision",
+        "DATABASE_1/NoSuchSetting"
+    };
+    const int keyCount = sizeof(keys) / sizeof(keys[0]);
+
+    wxFileName fileName(wxFileName::CreateTempFileName("frconfig"));
+    Config cfg;
+    cfg.setConfigFileName(fileName);
+    cfg.setValue("NumberPrecision", 2);
+    cfg.setValue("DATABASE_2/NumberPrecision", 4);
+    wxFileConfig fc("", "", fileName.GetFullPath(), "",
+        wxCONFIG_USE_LOCAL_FILE);
+
+    long found = 0;
+    for (int k = 0; k < keyCount; ++k)
+    {
+        int value;
+        std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+        for (long i = 0; i < lookups; ++i)
+            found += getUncached(fc, keys[k], value) ? value : 0;
+        std::chrono::duration<double, std::nano> before =
+            std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (long i = 0; i < lookups; ++i)
+            found += cfg.getValue(keys[k], value) ? value : 0;
+        std::chrono::duration<double, std::nano> after =
+            std::chrono::steady_clock::now() - start;
+
+        std::cout << keys[k].ToStdString() << ": "
+            << before.count() / lookups << " ns before, "
+            << after.count() / lookups << " ns after" << std::endl;
+    }
+
+    wxRemoveFile(fileName.GetFullPath());
+    // keeps the lookups from being optimized away
+    return found == 1 ? 2 : 0;
+}
@@ -360,6 +360,30 @@ SOURCE=.\src\gui\EventWatcherFrame.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\gui\MonitoringFrame.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\gui\IndexStatisticsFrame.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\gui\MaintenanceFrame.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\gui\ResultDiffFrame.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\gui\DatabaseStatisticsFrame.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\gui\TraceFrame.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\gui\ExecuteSql.cpp
 # End Source File
 # Begin Source File
@@ -416,6 +440,14 @@ SOURCE=.\src\gui\controls\LogTextControl.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\gui\controls\TableProfileControl.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\gui\controls\PlanTreeControl.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\gui\MainFrame.cpp
 # End Source File
 # Begin Source File
@@ -448,6 +480,50 @@ SOURCE=.\src\engine\MetadataLoader.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\engine\TraceParser.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\PlanTree.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\IndexAnalyzer.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\DbStatsParser.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\BackupLog.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\BackupStream.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\BlobTransfer.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\ConnectionPool.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\SelectionAggregate.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\MaintenanceScheduler.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\ResultDiff.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\metadata\MetadataTemplateCmdHandler.cpp
 # End Source File
 # Begin Source File
@@ -798,6 +874,30 @@ SOURCE=.\src\gui\EventWatcherFrame.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\gui\MonitoringFrame.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\gui\IndexStatisticsFrame.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\gui\MaintenanceFrame.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\gui\ResultDiffFrame.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\gui\DatabaseStatisticsFrame.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\gui\TraceFrame.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\gui\ExecuteSql.h
 # End Source File
 # Begin Source File
@@ -858,6 +958,14 @@ SOURCE=.\src\gui\controls\LogTextControl.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\gui\controls\TableProfileControl.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\gui\controls\PlanTreeControl.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\gui\MainFrame.h
 # End Source File
 # Begin Source File
@@ -894,6 +1002,50 @@ SOURCE=.\src\engine\MetadataLoader.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\engine\TraceParser.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\PlanTree.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\IndexAnalyzer.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\DbStatsParser.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\BackupLog.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\BackupStream.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\BlobTransfer.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\ConnectionPool.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\SelectionAggregate.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\MaintenanceScheduler.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\engine\ResultDiff.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\metadata\MetadataTemplateManager.h
 # End Source File
 # Begin Source File
@@ -281,6 +281,10 @@ SOURCE=.\src\ibpp\dbkey.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\ibpp\decfloat.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\ibpp\events.cpp
 # End Source File
 # Begin Source File
@@ -289,6 +293,10 @@ SOURCE=.\src\ibpp\exception.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\ibpp\int128.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\ibpp\row.cpp
 # End Source File
 # Begin Source File
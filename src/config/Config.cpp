@@ -92,8 +92,38 @@ bool Config::keyExists(const wxString& key) const
     return getConfig()->HasEntry(key);
 }
 
+wxCriticalSection& Config::getCacheCritsect()
+{
+    return cacheCritsectM;
+}
+
+Config::CachedValue& Config::findValue(const wxString& key)
+{
+    CachedValues::iterator it = cachedValuesM.find(key);
+    if (it == cachedValuesM.end())
+    {
+        CachedValue cv;
+        cv.found = readValue(key, cv.value);
+        cv.longParsed = cv.longValid = false;
+        cv.longValue = 0;
+        cv.doubleParsed = cv.doubleValid = false;
+        cv.doubleValue = 0;
+        it = cachedValuesM.insert(std::make_pair(key, cv)).first;
+    }
+    return it->second;
+}
+
 //! return true if value exists, false if not
 bool Config::getValue(const wxString& key, wxString& value)
+{
+    wxCriticalSectionLocker locker(getCacheCritsect());
+    CachedValue& cv = findValue(key);
+    if (cv.found)
+        value = cv.value;
+    return cv.found;
+}
+
+bool Config::readValue(const wxString& key, wxString& value) const
 {
     // if complete key is found, then return (recursion exit condition).
     wxString configValue;
@@ -115,10 +145,10 @@ bool Config::getValue(const wxString& key, wxString& value)
         wxString pathPart = key.substr(0, separatorPos);
         wxString::size_type separatorPosInPath = pathPart.rfind(pathSeparator);
         if (separatorPosInPath == wxString::npos)
-            return getValue(keyPart, value);
+            return readValue(keyPart, value);
         else
         {
-            return getValue(pathPart.substr(0, separatorPosInPath) +
+            return readValue(pathPart.substr(0, separatorPosInPath) +
                 pathSeparator + keyPart, value);
         }
     }
@@ -126,40 +156,50 @@ bool Config::getValue(const wxString& key, wxString& value)
 
 bool Config::getValue(const wxString& key, int& value)
 {
-    wxString s;
-    if (!getValue(key, s))
+    wxCriticalSectionLocker locker(getCacheCritsect());
+    CachedValue& cv = findValue(key);
+    if (!cv.found)
         return false;
 
-    // This variable is only needed because the compiler considers
-    // int* and long* incompatible. It may be ditched if a better solution
-    // is found.
-    long longValue;
-    if (!s.ToLong(&longValue))
+    if (!cv.longParsed)
+    {
+        cv.longValid = cv.value.ToLong(&cv.longValue);
+        cv.longParsed = true;
+    }
+    if (!cv.longValid)
         return false;
 
-    value = longValue;
+    value = cv.longValue;
     return true;
 }
 
 bool Config::getValue(const wxString& key, double& value)
 {
-    wxString s;
-    if (!getValue(key, s))
+    wxCriticalSectionLocker locker(getCacheCritsect());
+    CachedValue& cv = findValue(key);
+    if (!cv.found)
         return false;
 
-    if (!s.ToDouble(&value))
+    if (!cv.doubleParsed)
+    {
+        cv.doubleValid = cv.value.ToDouble(&cv.doubleValue);
+        cv.doubleParsed = true;
+    }
+    if (!cv.doubleValid)
         return false;
 
+    value = cv.doubleValue;
     return true;
 }
 
 bool Config::getValue(const wxString& key, bool& value)
 {
-    wxString s;
-    if (!getValue(key, s))
+    wxCriticalSectionLocker locker(getCacheCritsect());
+    CachedValue& cv = findValue(key);
+    if (!cv.found)
         return false;
 
-    value = (s == "1");
+    value = (cv.value == "1");
     return true;
 }
 
@@ -196,11 +236,17 @@ bool Config::getValue(const wxString& key, wxArrayString& value)
 //! return true if value existed, false if not
 bool Config::setValue(const wxString& key, const wxString& value)
 {
-    bool result = getConfig()->Write(key, value);
-    if (!isLocked())
-        getConfig()->Flush();
-    else
-        needsFlushM = true;
+    bool result;
+    {
+        wxCriticalSectionLocker locker(cacheCritsectM);
+        result = getConfig()->Write(key, value);
+        // any key can be the fallback of others
+        cachedValuesM.clear();
+        if (!isLocked())
+            getConfig()->Flush();
+        else
+            needsFlushM = true;
+    }
     notifyObservers();
     return result;
 }
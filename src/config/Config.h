@@ -25,8 +25,12 @@
 #define FR_CONFIG_H
 
 #include "wx/arrstr.h"
+#include <wx/hashmap.h>
 #include <wx/stdpaths.h>
 #include <wx/filename.h>
+#include <wx/thread.h>
+
+#include <unordered_map>
 
 #include "core/Observer.h"
 #include "core/Subject.h"
@@ -40,6 +44,7 @@ enum StorageGranularity
 
 // forward declarations
 class wxFileConfig;
+class DatabaseConfig;
 
 //! Do not instantiate objects of this class. Use config() function (see below).
 
@@ -60,8 +65,36 @@ private:
     wxString homePathM;
     wxString userHomePathM;
     wxFileName configFileNameM;
+
+    // the result of looking up a key, with its fallbacks, and the value
+    // converted to numbers when that was first asked for
+    struct CachedValue
+    {
+        bool found;
+        wxString value;
+        bool longParsed;
+        bool longValid;
+        long longValue;
+        bool doubleParsed;
+        bool doubleValid;
+        double doubleValue;
+    };
+    // all keys that have been read since the last change, so the
+    // fallbacks are searched in wxFileConfig only once per key
+    typedef std::unordered_map<wxString, CachedValue, wxStringHash,
+        wxStringEqual> CachedValues;
+    CachedValues cachedValuesM;
+    // reads change the cache, settings are read from worker threads too
+    wxCriticalSection cacheCritsectM;
+    bool readValue(const wxString& key, wxString& value) const;
+
+    friend class DatabaseConfig;
 protected:
     virtual void lockedChanged(bool locked);
+    // the cache entry of key, the caller has to hold getCacheCritsect()
+    // while it uses the entry
+    virtual CachedValue& findValue(const wxString& key);
+    virtual wxCriticalSection& getCacheCritsect();
 public:
     Config();
     virtual ~Config();
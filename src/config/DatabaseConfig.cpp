@@ -56,9 +56,14 @@ bool DatabaseConfig::keyExists(const wxString& key) const
     return referenceConfigM.keyExists(addPathToKey(key));
 }
 
-bool DatabaseConfig::getValue(const wxString& key, wxString& value)
+Config::CachedValue& DatabaseConfig::findValue(const wxString& key)
 {
-    return referenceConfigM.getValue(addPathToKey(key), value);
+    return referenceConfigM.findValue(addPathToKey(key));
+}
+
+wxCriticalSection& DatabaseConfig::getCacheCritsect()
+{
+    return referenceConfigM.getCacheCritsect();
 }
 
 bool DatabaseConfig::setValue(const wxString& key, const wxString& value)
@@ -37,6 +37,10 @@ private:
     const Database* databaseM;
     Config& referenceConfigM;
     wxString addPathToKey(const wxString& key) const;
+protected:
+    // uses the cache of the reference config
+    virtual CachedValue& findValue(const wxString& key);
+    virtual wxCriticalSection& getCacheCritsect();
 
 public:
     DatabaseConfig(const Database *d, Config& referenceConfig);
@@ -48,7 +52,6 @@ public:
 
     // transform the key based on Database, and call regular config
     virtual bool keyExists(const wxString& key) const;
-    virtual bool getValue(const wxString& key, wxString& value);
     virtual bool setValue(const wxString& key, const wxString& value);
 };
 
@@ -0,0 +1,130 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <cstdlib>
+
+#include "engine/BackupLog.h"
+
+BackupProgressParser::BackupProgressParser()
+{
+    clear();
+}
+
+void BackupProgressParser::clear()
+{
+    tablesM.clear();
+    currentM = -1;
+    totalRowsM = 0;
+    changedM = true;
+}
+
+bool BackupProgressParser::checkChanged()
+{
+    bool changed = changedM;
+    changedM = false;
+    return changed;
+}
+
+void BackupProgressParser::finishCurrent(int64_t millis)
+{
+    if (currentM < 0)
+        return;
+    BackupTableProgress& t = tablesM[currentM];
+    t.elapsedMillis = millis - t.startMillis;
+    t.finished = true;
+    currentM = -1;
+    changedM = true;
+}
+
+void BackupProgressParser::processLine(const std::string& line,
+    int64_t millis)
+{
+    static const std::string tableStarts[] = {
+        "writing data for table ", "restoring data for table "
+    };
+    for (size_t i = 0; i < sizeof(tableStarts) / sizeof(std::string); ++i)
+    {
+        std::string::size_type pos = line.find(tableStarts[i]);
+        if (pos == std::string::npos)
+            continue;
+
+        std::string table(line.substr(pos + tableStarts[i].size()));
+        std::string::size_type end = table.find_last_not_of(" \t\r\n");
+        table.erase(end == std::string::npos ? 0 : end + 1);
+        // newer servers quote the table name
+        if (table.size() >= 2 && table[0] == '"'
+            && table[table.size() - 1] == '"')
+        {
+            table = table.substr(1, table.size() - 2);
+        }
+
+        finishCurrent(millis);
+        BackupTableProgress t;
+        t.table = table;
+        t.rows = 0;
+        t.startMillis = millis;
+        t.elapsedMillis = 0;
+        t.finished = false;
+        tablesM.push_back(t);
+        currentM = int(tablesM.size()) - 1;
+        changedM = true;
+        return;
+    }
+
+    if (line.find(" records written") != std::string::npos
+        || line.find(" records restored") != std::string::npos)
+    {
+        std::string::size_type digits = line.find_first_of("0123456789");
+        if (digits == std::string::npos)
+            return;
+        int64_t rows = strtoll(line.c_str() + digits, 0, 10);
+        totalRowsM += rows;
+        if (currentM >= 0)
+        {
+            tablesM[currentM].rows = rows;
+            finishCurrent(millis);
+        }
+        changedM = true;
+    }
+}
+
+void BackupProgressParser::updateElapsed(int64_t millis)
+{
+    if (currentM < 0)
+        return;
+    BackupTableProgress& t = tablesM[currentM];
+    if (millis - t.startMillis != t.elapsedMillis)
+    {
+        t.elapsedMillis = millis - t.startMillis;
+        changedM = true;
+    }
+}
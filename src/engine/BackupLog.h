@@ -0,0 +1,122 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_BACKUPLOG_H
+#define FR_BACKUPLOG_H
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ibpp.h>
+
+// Fixed size queue between exactly one producer and one consumer thread,
+// neither of them ever blocks. The capacity is rounded up to a power of 2.
+template <typename T>
+class SpscRingBuffer
+{
+private:
+    std::vector<T> slotsM;
+    size_t maskM;
+    // only written by the consumer
+    std::atomic<size_t> headM;
+    // only written by the producer
+    std::atomic<size_t> tailM;
+
+    SpscRingBuffer(const SpscRingBuffer&);
+    SpscRingBuffer& operator=(const SpscRingBuffer&);
+public:
+    explicit SpscRingBuffer(size_t capacity)
+        : headM(0), tailM(0)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        slotsM.resize(size);
+        maskM = size - 1;
+    }
+
+    // called by the producer, returns false when the buffer is full
+    bool push(T& item)
+    {
+        size_t tail = tailM.load(std::memory_order_relaxed);
+        if (tail - headM.load(std::memory_order_acquire) > maskM)
+            return false;
+        std::swap(slotsM[tail & maskM], item);
+        tailM.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // called by the consumer, returns false when the buffer is empty
+    bool pop(T& item)
+    {
+        size_t head = headM.load(std::memory_order_relaxed);
+        if (head == tailM.load(std::memory_order_acquire))
+            return false;
+        std::swap(item, slotsM[head & maskM]);
+        headM.store(head + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// rows and time of a table in the verbose output of gbak
+struct BackupTableProgress
+{
+    std::string table;
+    int64_t rows;
+    int64_t startMillis;
+    int64_t elapsedMillis;
+    bool finished;
+};
+
+// Collects the per-table progress of a verbose backup or restore, from
+// line pairs like "writing data for table X" and "N records written"
+// (or "restoring data for table" and "records restored").
+class BackupProgressParser
+{
+private:
+    std::vector<BackupTableProgress> tablesM;
+    // index of the table whose data is transferred, or -1
+    int currentM;
+    int64_t totalRowsM;
+    bool changedM;
+
+    void finishCurrent(int64_t millis);
+public:
+    BackupProgressParser();
+
+    void clear();
+    void processLine(const std::string& line, int64_t millis);
+    // the running table gets its elapsed time up to millis
+    void updateElapsed(int64_t millis);
+
+    const std::vector<BackupTableProgress>& getTables() const
+        { return tablesM; }
+    int64_t getTotalRows() const { return totalRowsM; }
+
+    // returns whether tables changed since the last call
+    bool checkChanged();
+};
+
+#endif // FR_BACKUPLOG_H
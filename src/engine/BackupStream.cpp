@@ -0,0 +1,99 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <wx/wfstream.h>
+#include <wx/zstream.h>
+
+#include <memory>
+#include <string>
+
+#include "engine/BackupStream.h"
+
+BackupStreamResult receiveBackupStream(IBPP::Service& svc,
+    const wxString& fileName, bool compress, BackupStreamProgress& progress,
+    wxULongLong& written)
+{
+    written = 0;
+    wxFileOutputStream file(fileName);
+    if (!file.IsOk())
+        return bsCreateFailed;
+    std::auto_ptr<wxZlibOutputStream> zlib;
+    wxOutputStream* out = &file;
+    if (compress)
+    {
+        zlib.reset(new wxZlibOutputStream(file, -1, wxZLIB_GZIP));
+        out = zlib.get();
+    }
+
+    BackupStreamResult result = bsCanceled;
+    try
+    {
+        wxULongLong bytes = 0;
+        bool finished = false;
+        std::string data;
+        while (!finished)
+        {
+            if (progress.isBackupCanceled())
+                break;
+            finished = !svc->ReadOutput(data, 1);
+            if (!data.empty())
+            {
+                out->Write(data.data(), data.size());
+                if (out->GetLastError() != wxSTREAM_NO_ERROR)
+                {
+                    result = bsWriteFailed;
+                    break;
+                }
+                bytes += data.size();
+            }
+            progress.backupReceived(bytes, finished);
+        }
+        if (finished)
+            result = bsFinished;
+    }
+    catch (...)
+    {
+        if (zlib.get())
+            zlib->Close();
+        file.Close();
+        ::wxRemoveFile(fileName);
+        throw;
+    }
+
+    if (zlib.get())
+        zlib->Close();
+    written = wxULongLong(file.GetLength());
+    file.Close();
+    if (result != bsFinished)
+        ::wxRemoveFile(fileName);
+    return result;
+}
@@ -0,0 +1,58 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_BACKUPSTREAM_H
+#define FR_BACKUPSTREAM_H
+
+#include <wx/longlong.h>
+#include <wx/string.h>
+
+#include <ibpp.h>
+
+// implemented by the callers of receiveBackupStream(), which runs in their
+// worker thread
+class BackupStreamProgress
+{
+public:
+    virtual ~BackupStreamProgress() {}
+    // polled between the chunks, the backup stops when it returns true
+    virtual bool isBackupCanceled() = 0;
+    // called for each chunk written, bytes is the total so far
+    virtual void backupReceived(const wxULongLong& bytes, bool finished) = 0;
+};
+
+enum BackupStreamResult
+{
+    bsFinished, bsCanceled, bsCreateFailed, bsWriteFailed
+};
+
+// Reads the backup of a service started with StartBackupStream() and writes
+// it to the local file, gzip compressed if requested. The file is removed
+// unless the backup finished, also when an exception leaves the function,
+// so that a truncated file is never mistaken for a valid backup.
+// written is set to the size of the finished file.
+BackupStreamResult receiveBackupStream(IBPP::Service& svc,
+    const wxString& fileName, bool compress, BackupStreamProgress& progress,
+    wxULongLong& written);
+
+#endif // FR_BACKUPSTREAM_H
@@ -0,0 +1,363 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <wx/ffile.h>
+#include <wx/thread.h>
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "core/FRError.h"
+#include "core/ProgressIndicator.h"
+#include "engine/BlobTransfer.h"
+
+// BlobFileThread class
+// Reads or writes the file for the thread transferring the BLOB. The
+// chunks are passed back and forth in two queues, the filled ones (read
+// from the file, or to be written to it) and the free ones, so at most
+// chunkCount chunks of memory are ever used.
+class BlobFileThread: public wxThread
+{
+public:
+    enum { chunkSize = 1024 * 1024, chunkCount = 4 };
+private:
+    wxFFile& fileM;
+    const bool readingM;
+    std::vector<std::vector<char> > chunksM;
+
+    wxMutex mutexM;
+    wxCondition conditionM;
+    // index and length of the chunks holding data
+    std::deque<std::pair<size_t, size_t> > filledM;
+    std::deque<size_t> freeM;
+    // reading: the end of the file has been reached,
+    // writing: no more chunks will be filled
+    bool finishedM;
+    bool canceledM;
+    wxString errorM;
+
+    void fail(const wxString& error);
+    ExitCode readFile();
+    ExitCode writeFile();
+public:
+    BlobFileThread(wxFFile& file, bool reading);
+
+    virtual ExitCode Entry();
+
+    char* getChunk(size_t index) { return &chunksM[index][0]; }
+    // wait for a free chunk, return false if the file can't take any more
+    bool getFree(size_t& index);
+    void putFilled(size_t index, size_t length);
+    // wait for a filled chunk, return false at the end of the file
+    bool getFilled(size_t& index, size_t& length);
+    void putFree(size_t index);
+
+    void finish();
+    void cancel();
+    // waits for the thread and throws if the file I/O failed
+    void join();
+};
+
+BlobFileThread::BlobFileThread(wxFFile& file, bool reading)
+    : wxThread(wxTHREAD_JOINABLE), fileM(file), readingM(reading),
+        chunksM(chunkCount, std::vector<char>(chunkSize)),
+        conditionM(mutexM), finishedM(false), canceledM(false)
+{
+    for (size_t i = 0; i < chunkCount; ++i)
+        freeM.push_back(i);
+}
+
+void BlobFileThread::fail(const wxString& error)
+{
+    wxMutexLocker lock(mutexM);
+    errorM = error;
+    canceledM = true;
+    conditionM.Broadcast();
+}
+
+wxThread::ExitCode BlobFileThread::readFile()
+{
+    while (true)
+    {
+        size_t index;
+        {
+            wxMutexLocker lock(mutexM);
+            while (freeM.empty() && !canceledM)
+                conditionM.Wait();
+            if (canceledM)
+                return 0;
+            index = freeM.front();
+            freeM.pop_front();
+        }
+
+        size_t length = fileM.Read(getChunk(index), chunkSize);
+        if (fileM.Error())
+        {
+            fail(_("Cannot read BLOB file."));
+            return 0;
+        }
+
+        wxMutexLocker lock(mutexM);
+        if (length)
+            filledM.push_back(std::make_pair(index, length));
+        else
+            freeM.push_back(index);
+        finishedM = (length < chunkSize);
+        conditionM.Broadcast();
+        if (finishedM)
+            return 0;
+    }
+}
+
+wxThread::ExitCode BlobFileThread::writeFile()
+{
+    while (true)
+    {
+        std::pair<size_t, size_t> chunk;
+        {
+            wxMutexLocker lock(mutexM);
+            while (filledM.empty() && !finishedM && !canceledM)
+                conditionM.Wait();
+            if (canceledM || filledM.empty())
+                return 0;
+            chunk = filledM.front();
+            filledM.pop_front();
+        }
+
+        if (fileM.Write(getChunk(chunk.first), chunk.second) != chunk.second)
+        {
+            fail(_("Cannot write to destination file."));
+            return 0;
+        }
+
+        wxMutexLocker lock(mutexM);
+        freeM.push_back(chunk.first);
+        conditionM.Broadcast();
+    }
+}
+
+wxThread::ExitCode BlobFileThread::Entry()
+{
+    return readingM ? readFile() : writeFile();
+}
+
+bool BlobFileThread::getFree(size_t& index)
+{
+    wxMutexLocker lock(mutexM);
+    while (freeM.empty() && !canceledM)
+        conditionM.Wait();
+    if (canceledM)
+        return false;
+    index = freeM.front();
+    freeM.pop_front();
+    return true;
+}
+
+void BlobFileThread::putFilled(size_t index, size_t length)
+{
+    wxMutexLocker lock(mutexM);
+    if (length)
+        filledM.push_back(std::make_pair(index, length));
+    else
+        freeM.push_back(index);
+    conditionM.Broadcast();
+}
+
+bool BlobFileThread::getFilled(size_t& index, size_t& length)
+{
+    wxMutexLocker lock(mutexM);
+    while (filledM.empty() && !finishedM && !canceledM)
+        conditionM.Wait();
+    if (canceledM || filledM.empty())
+        return false;
+    index = filledM.front().first;
+    length = filledM.front().second;
+    filledM.pop_front();
+    return true;
+}
+
+void BlobFileThread::putFree(size_t index)
+{
+    wxMutexLocker lock(mutexM);
+    freeM.push_back(index);
+    conditionM.Broadcast();
+}
+
+void BlobFileThread::finish()
+{
+    wxMutexLocker lock(mutexM);
+    finishedM = true;
+    conditionM.Broadcast();
+}
+
+void BlobFileThread::cancel()
+{
+    wxMutexLocker lock(mutexM);
+    canceledM = true;
+    conditionM.Broadcast();
+}
+
+void BlobFileThread::join()
+{
+    Wait();
+    wxMutexLocker lock(mutexM);
+    if (!errorM.empty())
+        throw FRError(errorM);
+}
+
+static void startBlobFileThread(BlobFileThread& thread)
+{
+    if (thread.Create() != wxTHREAD_NO_ERROR
+        || thread.Run() != wxTHREAD_NO_ERROR)
+    {
+        throw FRError(_("Cannot start the file transfer thread."));
+    }
+}
+
+bool exportBlobToFile(IBPP::Blob& blob, const wxString& fileName,
+    ProgressIndicator* pi, size_t progressLevel)
+{
+    wxFFile fl(fileName, "wb");
+    if (!fl.IsOpened())
+        throw FRError(_("Cannot open destination file."));
+
+    blob->Open();
+    int size;
+    blob->Info(&size, 0, 0);
+    if (pi)
+        pi->initProgress(_("Saving..."), size, 0, progressLevel);
+
+    BlobFileThread writer(fl, false);
+    startBlobFileThread(writer);
+    bool canceled = false;
+    try
+    {
+        bool eof = false;
+        size_t index;
+        while (!eof && writer.getFree(index))
+        {
+            // fill the whole chunk, segment by segment
+            char* chunk = writer.getChunk(index);
+            size_t length = 0;
+            while (length < BlobFileThread::chunkSize)
+            {
+                int segment = std::min(int(BlobFileThread::chunkSize
+                    - length), maxBlobSegmentSize);
+                int read = blob->Read(chunk + length, segment);
+                if (read < 1)
+                {
+                    eof = true;
+                    break;
+                }
+                length += read;
+            }
+            writer.putFilled(index, length);
+            if (pi)
+            {
+                pi->stepProgress(int(length), progressLevel);
+                canceled = pi->isCanceled();
+                if (canceled)
+                    break;
+            }
+        }
+        if (canceled)
+            writer.cancel();
+        else
+            writer.finish();
+    }
+    catch (...)
+    {
+        writer.cancel();
+        writer.Wait();
+        throw;
+    }
+    // the BLOB is shared with the grid, so it's closed even if writing the
+    // file failed
+    blob->Close();
+    writer.join();
+    return !canceled;
+}
+
+bool importBlobFromFile(IBPP::Blob& blob, const wxString& fileName,
+    ProgressIndicator* pi, size_t progressLevel)
+{
+    wxFFile fl(fileName, "rb");
+    if (!fl.IsOpened())
+        throw FRError(_("Cannot open BLOB file."));
+    if (pi)
+        pi->initProgress(_("Loading..."), fl.Length(), 0, progressLevel);
+
+    BlobFileThread reader(fl, true);
+    startBlobFileThread(reader);
+    bool canceled = false;
+    try
+    {
+        size_t index, length;
+        while (reader.getFilled(index, length))
+        {
+            const char* chunk = reader.getChunk(index);
+            for (size_t written = 0; written < length; )
+            {
+                int segment = std::min(int(length - written),
+                    maxBlobSegmentSize);
+                blob->Write(chunk + written, segment);
+                written += segment;
+            }
+            reader.putFree(index);
+            if (pi)
+            {
+                pi->stepProgress(int(length), progressLevel);
+                canceled = pi->isCanceled();
+                if (canceled)
+                    break;
+            }
+        }
+        // makes the thread stop if the import has been canceled, and has no
+        // effect when the whole file has been read
+        reader.cancel();
+    }
+    catch (...)
+    {
+        reader.cancel();
+        reader.Wait();
+        throw;
+    }
+    reader.join();
+
+    if (canceled)
+        blob->Cancel();
+    else
+        blob->Close();
+    return !canceled;
+}
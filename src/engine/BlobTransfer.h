@@ -0,0 +1,49 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_BLOBTRANSFER_H
+#define FR_BLOBTRANSFER_H
+
+#include <wx/string.h>
+
+#include <ibpp.h>
+
+class ProgressIndicator;
+
+// the largest segment isc_get_segment() and isc_put_segment() accept
+const int maxBlobSegmentSize = 64 * 1024 - 1;
+
+// Copy BLOB data between the database and local files. The BLOB is read or
+// written by the calling thread in segments of the maximum size, while a
+// worker thread does the file I/O through a few large buffers, so that the
+// client calls and the disk keep each other busy.
+// Both return false when canceled through the progress indicator, whose
+// progressLevel is initialized with the number of bytes.
+bool exportBlobToFile(IBPP::Blob& blob, const wxString& fileName,
+    ProgressIndicator* pi, size_t progressLevel = 1);
+// the BLOB has to be created but not written to yet, it is closed when the
+// file has been read and canceled when the import is canceled
+bool importBlobFromFile(IBPP::Blob& blob, const wxString& fileName,
+    ProgressIndicator* pi, size_t progressLevel = 1);
+
+#endif // FR_BLOBTRANSFER_H
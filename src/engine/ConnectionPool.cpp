@@ -0,0 +1,372 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+
+#include "engine/ConnectionPool.h"
+
+// idle attachments beyond the pre-warmed ones are disconnected after
+// being unused for this many seconds
+static const time_t extraIdleTimeout = 10 * 60;
+
+// ConnectionPoolTimer class
+class ConnectionPoolTimer: public wxTimer
+{
+private:
+    ConnectionPool& poolM;
+public:
+    ConnectionPoolTimer(ConnectionPool& pool);
+    virtual void Notify();
+};
+
+ConnectionPoolTimer::ConnectionPoolTimer(ConnectionPool& pool)
+    : wxTimer(), poolM(pool)
+{
+}
+
+void ConnectionPoolTimer::Notify()
+{
+    poolM.keepAlive();
+}
+
+// ConnectionPoolWarmer class
+// Connects the attachments it has been given, nothing else touches them
+// until the thread has finished
+class ConnectionPoolWarmer: public wxThread
+{
+private:
+    std::vector<IBPP::Database> attachmentsM;
+    wxCriticalSection finishedCritsectM;
+    bool finishedM;
+public:
+    ConnectionPoolWarmer(const std::vector<IBPP::Database>& attachments);
+    virtual ExitCode Entry();
+
+    size_t getCount() const;
+    bool isFinished();
+    // only valid after the thread has been waited for
+    std::vector<IBPP::Database>& getAttachments();
+};
+
+ConnectionPoolWarmer::ConnectionPoolWarmer(
+        const std::vector<IBPP::Database>& attachments)
+    : wxThread(wxTHREAD_JOINABLE), attachmentsM(attachments),
+        finishedM(false)
+{
+}
+
+wxThread::ExitCode ConnectionPoolWarmer::Entry()
+{
+    for (size_t i = 0; i < attachmentsM.size(); ++i)
+    {
+        try
+        {
+            attachmentsM[i]->Connect();
+        }
+        catch (IBPP::Exception&)
+        {
+            // unconnected attachments are dropped by the pool
+        }
+    }
+    wxCriticalSectionLocker locker(finishedCritsectM);
+    finishedM = true;
+    return 0;
+}
+
+size_t ConnectionPoolWarmer::getCount() const
+{
+    return attachmentsM.size();
+}
+
+bool ConnectionPoolWarmer::isFinished()
+{
+    wxCriticalSectionLocker locker(finishedCritsectM);
+    return finishedM;
+}
+
+std::vector<IBPP::Database>& ConnectionPoolWarmer::getAttachments()
+{
+    return attachmentsM;
+}
+
+// ConnectionPool class
+ConnectionPool::ConnectionPool()
+    : maxSizeM(0), prewarmCountM(0), openM(false), timerM(0), warmerM(0)
+{
+}
+
+ConnectionPool::~ConnectionPool()
+{
+    close();
+}
+
+void ConnectionPool::open(IBPP::Database& mainDatabase, size_t maxSize,
+    size_t prewarmCount, int keepAliveSeconds)
+{
+    close();
+
+    mainDatabaseM = mainDatabase;
+    maxSizeM = maxSize;
+    prewarmCountM = std::min(prewarmCount, maxSize);
+    openM = true;
+
+    startWarming();
+    if (keepAliveSeconds > 0)
+    {
+        timerM = new ConnectionPoolTimer(*this);
+        timerM->Start(1000 * keepAliveSeconds);
+    }
+}
+
+void ConnectionPool::close()
+{
+    if (timerM)
+    {
+        timerM->Stop();
+        delete timerM;
+        timerM = 0;
+    }
+    collectWarmedAttachments(true);
+    for (size_t i = 0; i < idleM.size(); ++i)
+        disconnectAttachment(idleM[i].database);
+    idleM.clear();
+    // the lessees still use their attachments, they are disconnected
+    // when released to the closed pool
+    leasedM.clear();
+    mainDatabaseM.clear();
+    openM = false;
+}
+
+bool ConnectionPool::isOpen() const
+{
+    return openM;
+}
+
+IBPP::Database ConnectionPool::createAttachment()
+{
+    return IBPP::DatabaseFactory(mainDatabaseM->ServerName(),
+        mainDatabaseM->DatabaseName(), mainDatabaseM->Username(),
+        mainDatabaseM->UserPassword(), mainDatabaseM->RoleName(),
+        mainDatabaseM->CharSet(), "");
+}
+
+size_t ConnectionPool::getWarmingCount() const
+{
+    return warmerM ? warmerM->getCount() : 0;
+}
+
+void ConnectionPool::collectWarmedAttachments(bool wait)
+{
+    if (!warmerM || (!wait && !warmerM->isFinished()))
+        return;
+
+    warmerM->Wait();
+    std::vector<IBPP::Database>& attachments(warmerM->getAttachments());
+    for (size_t i = 0; i < attachments.size(); ++i)
+    {
+        if (openM && attachments[i]->Connected())
+        {
+            IdleAttachment idle;
+            idle.database = attachments[i];
+            idle.idleSince = time(0);
+            idleM.push_back(idle);
+        }
+        else
+            disconnectAttachment(attachments[i]);
+    }
+    delete warmerM;
+    warmerM = 0;
+}
+
+void ConnectionPool::startWarming()
+{
+    if (!openM || warmerM)
+        return;
+
+    size_t total = idleM.size() + leasedM.size();
+    size_t count = 0;
+    if (idleM.size() < prewarmCountM && total < maxSizeM)
+        count = std::min(prewarmCountM - idleM.size(), maxSizeM - total);
+    if (count == 0)
+        return;
+
+    std::vector<IBPP::Database> attachments;
+    for (size_t i = 0; i < count; ++i)
+        attachments.push_back(createAttachment());
+    ConnectionPoolWarmer* warmer = new ConnectionPoolWarmer(attachments);
+    attachments.clear();
+    if (warmer->Create() != wxTHREAD_NO_ERROR
+        || warmer->Run() != wxTHREAD_NO_ERROR)
+    {
+        // the attachments will be connected by their lessees instead
+        delete warmer;
+        return;
+    }
+    warmerM = warmer;
+}
+
+void ConnectionPool::keepAlive()
+{
+    collectWarmedAttachments(false);
+
+    // the main attachment is pinged too, it is often idle far longer than
+    // the pooled ones while the user reads results or edits statements
+    if (mainDatabaseM != 0 && mainDatabaseM->Connected())
+    {
+        try
+        {
+            int fetches, marks, reads, writes, memory;
+            mainDatabaseM->Statistics(&fetches, &marks, &reads, &writes,
+                &memory);
+        }
+        catch (IBPP::Exception&)
+        {
+            // the next statement executed will report the problem
+        }
+    }
+
+    time_t now = time(0);
+    std::vector<IdleAttachment> alive;
+    for (size_t i = 0; i < idleM.size(); ++i)
+    {
+        IBPP::Database& db = idleM[i].database;
+        if (alive.size() >= prewarmCountM
+            && now - idleM[i].idleSince > extraIdleTimeout)
+        {
+            disconnectAttachment(db);
+            continue;
+        }
+        try
+        {
+            int fetches, marks, reads, writes, memory;
+            db->Statistics(&fetches, &marks, &reads, &writes, &memory);
+            alive.push_back(idleM[i]);
+        }
+        catch (IBPP::Exception&)
+        {
+            disconnectAttachment(db);
+        }
+    }
+    idleM.swap(alive);
+
+    startWarming();
+}
+
+IBPP::Database ConnectionPool::acquire()
+{
+    IBPP::Database db;
+    if (!openM)
+        return db;
+
+    collectWarmedAttachments(false);
+    // the most recently used attachment is the least likely to be broken
+    while (!idleM.empty())
+    {
+        db = idleM.back().database;
+        idleM.pop_back();
+        if (db->Connected())
+            break;
+        db.clear();
+    }
+    if (db == 0
+        && idleM.size() + leasedM.size() + getWarmingCount() < maxSizeM)
+    {
+        db = createAttachment();
+    }
+    if (db != 0)
+        leasedM.push_back(db);
+    return db;
+}
+
+IBPP::Database ConnectionPool::acquireOrCreate(IBPP::Database& mainDatabase)
+{
+    IBPP::Database db = acquire();
+    if (db == 0)
+    {
+        db = IBPP::DatabaseFactory(mainDatabase->ServerName(),
+            mainDatabase->DatabaseName(), mainDatabase->Username(),
+            mainDatabase->UserPassword(), mainDatabase->RoleName(),
+            mainDatabase->CharSet(), "");
+    }
+    return db;
+}
+
+void ConnectionPool::release(IBPP::Database& database)
+{
+    if (database == 0)
+        return;
+
+    std::vector<IBPP::Database>::iterator it = std::find(leasedM.begin(),
+        leasedM.end(), database);
+    bool keep = it != leasedM.end() && database->Connected();
+    if (it != leasedM.end())
+        leasedM.erase(it);
+    if (keep
+        && idleM.size() + leasedM.size() + getWarmingCount() < maxSizeM)
+    {
+        IdleAttachment idle;
+        idle.database = database;
+        idle.idleSince = time(0);
+        idleM.push_back(idle);
+    }
+    else
+        disconnectAttachment(database);
+    database.clear();
+}
+
+size_t ConnectionPool::getIdleCount() const
+{
+    return idleM.size();
+}
+
+size_t ConnectionPool::getLeasedCount() const
+{
+    return leasedM.size();
+}
+
+void ConnectionPool::discard(IBPP::Database& database)
+{
+    disconnectAttachment(database);
+    database.clear();
+}
+
+void ConnectionPool::disconnectAttachment(IBPP::Database& database)
+{
+    try
+    {
+        if (database != 0 && database->Connected())
+            database->Disconnect();
+    }
+    catch (IBPP::Exception&)
+    {
+    }
+}
@@ -0,0 +1,113 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_CONNECTIONPOOL_H
+#define FR_CONNECTIONPOOL_H
+
+#include <ctime>
+#include <vector>
+
+#include <ibpp.h>
+
+class ConnectionPoolTimer;
+class ConnectionPoolWarmer;
+
+// Keeps spare attachments to a connected database, so that background
+// tasks and additional windows don't pay the full attach cost every time.
+// Attachments are leased with acquire() and given back with release(), the
+// lessee may use a leased attachment in its own thread, but all calls of
+// the pool itself have to be made from the main thread, as IBPP objects are
+// not thread-safe.
+// A timer pings the idle attachments and the main one in regular intervals,
+// which replaces dead attachments and keeps firewalls and NAT routers from
+// dropping connections that are idle for a long time.
+class ConnectionPool
+{
+private:
+    friend class ConnectionPoolTimer;
+
+    struct IdleAttachment
+    {
+        IBPP::Database database;
+        time_t idleSince;
+    };
+
+    IBPP::Database mainDatabaseM;
+    std::vector<IdleAttachment> idleM;
+    std::vector<IBPP::Database> leasedM;
+    size_t maxSizeM;
+    size_t prewarmCountM;
+    bool openM;
+
+    ConnectionPoolTimer* timerM;
+    ConnectionPoolWarmer* warmerM;
+
+    // creates an attachment with the parameters of the main attachment,
+    // the attachment is not connected yet
+    IBPP::Database createAttachment();
+    size_t getWarmingCount() const;
+    // moves the attachments of a finished warmer thread into the pool
+    void collectWarmedAttachments(bool wait);
+    // starts the warmer thread to have prewarmCountM idle attachments
+    void startWarming();
+    void keepAlive();
+
+    static void disconnectAttachment(IBPP::Database& database);
+public:
+    ConnectionPool();
+    ~ConnectionPool();
+
+    // opens the pool for the connected main attachment, keeps at most
+    // maxSize attachments (leased and idle), connects prewarmCount of them
+    // in the background right away (0 connects them only when they are
+    // first leased), and pings them every keepAliveSeconds
+    // (0 disables the keep-alive pings)
+    void open(IBPP::Database& mainDatabase, size_t maxSize,
+        size_t prewarmCount, int keepAliveSeconds);
+    // disconnects all idle attachments, leased ones stay connected until
+    // they are released
+    void close();
+    bool isOpen() const;
+
+    // returns an idle connected attachment if there is one, a new and
+    // still unconnected attachment if the pool isn't full yet, and a null
+    // attachment otherwise
+    IBPP::Database acquire();
+    // like acquire(), but returns an unconnected attachment that isn't
+    // part of the pool when the pool is full, closed or has size 0, so
+    // the caller gets an attachment in any case
+    // release() disconnects these attachments
+    IBPP::Database acquireOrCreate(IBPP::Database& mainDatabase);
+    // returns a leased attachment to the pool, which disconnects it if it
+    // is broken, the pool is full or has been closed in the meantime
+    // the lessee must not use the attachment in any thread afterwards
+    void release(IBPP::Database& database);
+
+    size_t getIdleCount() const;
+    size_t getLeasedCount() const;
+
+    // disconnects a leased attachment whose pool no longer exists
+    static void discard(IBPP::Database& database);
+};
+
+#endif // FR_CONNECTIONPOOL_H
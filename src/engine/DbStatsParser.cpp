@@ -0,0 +1,300 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#include "engine/DbStatsParser.h"
+
+// a line without line break this long is processed anyway
+static const std::string::size_type maxLineLength = 65536;
+
+static std::string trim(const std::string& s)
+{
+    std::string::size_type start = s.find_first_not_of(" \t\r");
+    if (start == std::string::npos)
+        return std::string();
+    std::string::size_type end = s.find_last_not_of(" \t\r");
+    return s.substr(start, end - start + 1);
+}
+
+static std::string toLower(const std::string& s)
+{
+    std::string result(s);
+    for (std::string::iterator it = result.begin(); it != result.end(); ++it)
+        *it = char(tolower((unsigned char)*it));
+    return result;
+}
+
+// splits "NAME (123)" into name and id
+static bool splitNameAndId(const std::string& s, std::string& name, int& id)
+{
+    if (s.size() < 4 || s[s.size() - 1] != ')')
+        return false;
+    std::string::size_type open = s.rfind(" (");
+    if (open == std::string::npos || open == 0)
+        return false;
+    std::string digits(s.substr(open + 2, s.size() - open - 3));
+    if (digits.empty()
+        || digits.find_first_not_of("0123456789") != std::string::npos)
+    {
+        return false;
+    }
+    name = s.substr(0, open);
+    id = atoi(digits.c_str());
+    return true;
+}
+
+static int64_t toInt64(const std::string& s)
+{
+    return int64_t(strtod(s.c_str(), 0));
+}
+
+DbStatsTable::DbStatsTable()
+    : relationId(0), avgRecordLength(0), records(0), avgVersionLength(0),
+        versions(0), maxVersions(0), dataPages(0), dataPageSlots(0),
+        averageFill(0)
+{
+    for (int i = 0; i < dbStatsFillBuckets; ++i)
+        fill[i] = 0;
+}
+
+DbStatsIndex::DbStatsIndex()
+    : indexId(0), depth(0), leafBuckets(0), nodes(0), avgDataLength(0),
+        avgNodeLength(0), avgKeyLength(0), totalDup(0), maxDup(0)
+{
+    for (int i = 0; i < dbStatsFillBuckets; ++i)
+        fill[i] = 0;
+}
+
+DbStatsParser::DbStatsParser()
+{
+    clear();
+}
+
+void DbStatsParser::clear()
+{
+    partialLineM.clear();
+    analyzingM = false;
+    contextM = ctxNone;
+    fillBucketM = -1;
+    tablesM.clear();
+    indicesM.clear();
+    headerM.clear();
+    changedM = true;
+}
+
+bool DbStatsParser::checkChanged()
+{
+    bool changed = changedM;
+    changedM = false;
+    return changed;
+}
+
+void DbStatsParser::feed(const std::string& chunk)
+{
+    std::string::size_type start = 0;
+    while (start < chunk.size())
+    {
+        std::string::size_type end = chunk.find('\n', start);
+        if (end == std::string::npos)
+        {
+            partialLineM += chunk.substr(start);
+            if (partialLineM.size() > maxLineLength)
+            {
+                processLine(partialLineM);
+                partialLineM.clear();
+            }
+            return;
+        }
+        partialLineM += chunk.substr(start, end - start);
+        processLine(partialLineM);
+        partialLineM.clear();
+        start = end + 1;
+    }
+}
+
+void DbStatsParser::flush()
+{
+    if (!partialLineM.empty())
+    {
+        processLine(partialLineM);
+        partialLineM.clear();
+    }
+}
+
+void DbStatsParser::processLine(const std::string& line)
+{
+    std::string text(trim(line));
+    if (text.empty())
+    {
+        fillBucketM = -1;
+        return;
+    }
+    if (!analyzingM)
+    {
+        if (text.compare(0, 24, "Analyzing database pages") == 0)
+            analyzingM = true;
+        else
+            headerM.push_back(text);
+        return;
+    }
+
+    std::string name;
+    int id;
+    // tables start in the first column, indices are indented
+    bool indented = line[0] == ' ' || line[0] == '\t';
+    if (!indented && splitNameAndId(text, name, id))
+    {
+        DbStatsTable table;
+        table.name = name;
+        table.relationId = id;
+        tablesM.push_back(table);
+        contextM = ctxTable;
+        fillBucketM = -1;
+        changedM = true;
+        return;
+    }
+    if (indented && text.compare(0, 6, "Index ") == 0
+        && splitNameAndId(text.substr(6), name, id) && !tablesM.empty())
+    {
+        DbStatsIndex index;
+        index.table = tablesM.back().name;
+        index.name = name;
+        index.indexId = id;
+        indicesM.push_back(index);
+        contextM = ctxIndex;
+        fillBucketM = -1;
+        changedM = true;
+        return;
+    }
+    if (contextM == ctxNone)
+        return;
+
+    if (text == "Fill distribution:")
+    {
+        fillBucketM = 0;
+        return;
+    }
+    // "20 - 39% = 3"
+    std::string::size_type eq = text.find(" = ");
+    if (fillBucketM >= 0 && eq != std::string::npos
+        && text.find('%') != std::string::npos)
+    {
+        if (fillBucketM < dbStatsFillBuckets)
+        {
+            int64_t count = toInt64(text.substr(eq + 3));
+            if (contextM == ctxTable)
+                tablesM.back().fill[fillBucketM] = count;
+            else
+                indicesM.back().fill[fillBucketM] = count;
+            changedM = true;
+        }
+        ++fillBucketM;
+        return;
+    }
+
+    // "Key: value, other key: value"
+    std::string::size_type pos = 0;
+    while (pos < text.size())
+    {
+        std::string::size_type comma = text.find(", ", pos);
+        if (comma == std::string::npos)
+            comma = text.size();
+        std::string item(text.substr(pos, comma - pos));
+        std::string::size_type colon = item.find(':');
+        if (colon != std::string::npos)
+        {
+            processValue(toLower(trim(item.substr(0, colon))),
+                trim(item.substr(colon + 1)));
+        }
+        pos = comma + 2;
+    }
+}
+
+void DbStatsParser::processValue(const std::string& key,
+    const std::string& value)
+{
+    if (contextM == ctxTable)
+    {
+        DbStatsTable& t = tablesM.back();
+        if (key == "average record length")
+            t.avgRecordLength = strtod(value.c_str(), 0);
+        else if (key == "total records")
+            t.records = toInt64(value);
+        else if (key == "average version length")
+            t.avgVersionLength = strtod(value.c_str(), 0);
+        else if (key == "total versions")
+            t.versions = toInt64(value);
+        else if (key == "max versions")
+            t.maxVersions = toInt64(value);
+        else if (key == "data pages")
+            t.dataPages = toInt64(value);
+        else if (key == "data page slots")
+            t.dataPageSlots = toInt64(value);
+        else if (key == "average fill")
+            t.averageFill = atoi(value.c_str());
+        else
+            return;
+    }
+    else if (contextM == ctxIndex)
+    {
+        DbStatsIndex& i = indicesM.back();
+        if (key == "depth")
+            i.depth = atoi(value.c_str());
+        else if (key == "leaf buckets")
+            i.leafBuckets = toInt64(value);
+        else if (key == "nodes")
+            i.nodes = toInt64(value);
+        else if (key == "average data length")
+            i.avgDataLength = strtod(value.c_str(), 0);
+        else if (key == "average node length")
+            i.avgNodeLength = strtod(value.c_str(), 0);
+        else if (key == "average key length")
+        {
+            i.avgKeyLength = strtod(value.c_str(), 0);
+            // used when the report has no data length, a data length that
+            // follows replaces it
+            if (i.avgDataLength == 0)
+                i.avgDataLength = i.avgKeyLength;
+        }
+        else if (key == "total dup")
+            i.totalDup = toInt64(value);
+        else if (key == "max dup")
+            i.maxDup = toInt64(value);
+        else
+            return;
+    }
+    changedM = true;
+}
@@ -0,0 +1,108 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_DBSTATSPARSER_H
+#define FR_DBSTATSPARSER_H
+
+#include <string>
+#include <vector>
+
+#include <ibpp.h>
+
+// the five "Fill distribution" buckets: 0 - 19%, 20 - 39%, ... 80 - 99%
+const int dbStatsFillBuckets = 5;
+
+struct DbStatsTable
+{
+    std::string name;
+    int relationId;
+    double avgRecordLength;
+    int64_t records;
+    double avgVersionLength;
+    int64_t versions;
+    int64_t maxVersions;
+    int64_t dataPages;
+    int64_t dataPageSlots;
+    int averageFill;
+    int64_t fill[dbStatsFillBuckets];
+
+    DbStatsTable();
+};
+
+struct DbStatsIndex
+{
+    std::string table;
+    std::string name;
+    int indexId;
+    int depth;
+    int64_t leafBuckets;
+    int64_t nodes;
+    // Firebird 2.x reports the data length only, Firebird 3+ also the
+    // node and the key length
+    double avgDataLength;
+    double avgNodeLength;
+    double avgKeyLength;
+    int64_t totalDup;
+    int64_t maxDup;
+    int64_t fill[dbStatsFillBuckets];
+
+    DbStatsIndex();
+};
+
+// Parses the gstat report as the service delivers it, the chunks can end
+// anywhere in a line. Both the Firebird 2.x and the Firebird 3+ layouts
+// are understood, values the server doesn't report stay 0.
+class DbStatsParser
+{
+private:
+    enum Context { ctxNone, ctxTable, ctxIndex };
+
+    std::string partialLineM;
+    bool analyzingM;
+    Context contextM;
+    int fillBucketM;
+    std::vector<DbStatsTable> tablesM;
+    std::vector<DbStatsIndex> indicesM;
+    std::vector<std::string> headerM;
+    bool changedM;
+
+    void processLine(const std::string& line);
+    void processValue(const std::string& key, const std::string& value);
+public:
+    DbStatsParser();
+
+    void feed(const std::string& chunk);
+    // processes the pending partial line, when the output ends
+    void flush();
+    void clear();
+
+    const std::vector<DbStatsTable>& getTables() const { return tablesM; }
+    const std::vector<DbStatsIndex>& getIndices() const { return indicesM; }
+    // the lines before the page analysis (header page, file information)
+    const std::vector<std::string>& getHeader() const { return headerM; }
+
+    // returns whether tables or indices were changed since the last call
+    bool checkChanged();
+};
+
+#endif // FR_DBSTATSPARSER_H
@@ -0,0 +1,237 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+#include <map>
+
+#include "engine/IndexAnalyzer.h"
+
+static std::string trimRight(const std::string& s)
+{
+    std::string::size_type end = s.find_last_not_of(' ');
+    if (end == std::string::npos)
+        return std::string();
+    return s.substr(0, end + 1);
+}
+
+IndexAnalyzer::IndexAnalyzer(double lowSelectivityRatio, double minRows,
+        double staleRatio)
+    : lowSelectivityRatioM(lowSelectivityRatio), minRowsM(minRows),
+        staleRatioM(staleRatio)
+{
+}
+
+void IndexAnalyzer::load(IBPP::Database& database,
+    IBPP::Transaction& transaction, IndexHealthList& indices)
+{
+    indices.clear();
+    IBPP::Statement st = IBPP::StatementFactory(database, transaction);
+    st->Execute(
+        "select i.rdb$index_name, i.rdb$relation_name, i.rdb$unique_flag,"
+        " i.rdb$index_inactive, i.rdb$index_type, i.rdb$statistics,"
+        " i.rdb$system_flag,"
+        " case when i.rdb$expression_blr is null then 0 else 1 end,"
+        " rc.rdb$constraint_type"
+        " from rdb$indices i"
+        " left join rdb$relation_constraints rc"
+        " on rc.rdb$index_name = i.rdb$index_name"
+        " order by i.rdb$relation_name, i.rdb$index_name");
+
+    std::map<std::string, size_t> positions;
+    while (st->Fetch())
+    {
+        IndexHealth index;
+        int16_t flag = 0;
+        std::string s;
+        st->Get(1, s);
+        index.name = trimRight(s);
+        st->Get(2, s);
+        index.relation = trimRight(s);
+        index.unique = !st->Get(3, flag) && flag == 1;
+        flag = 0;
+        index.active = st->Get(4, flag) || flag == 0;
+        flag = 0;
+        index.descending = !st->Get(5, flag) && flag == 1;
+        index.statistics = 0;
+        st->Get(6, index.statistics);
+        flag = 0;
+        index.system = !st->Get(7, flag) && flag != 0;
+        int expression = 0;
+        st->Get(8, expression);
+        index.expression = expression != 0;
+        if (!st->Get(9, s))
+            index.constraintType = trimRight(s);
+        index.distinctKeys = 0;
+        index.estimatedRows = 0;
+        index.problems = ipNone;
+
+        positions[index.name] = indices.size();
+        indices.push_back(index);
+    }
+
+    // segment statistics only exist since ODS 11
+    int odsMajor = 0, odsMinor = 0, pageSize, pages, buffers, sweep;
+    bool sync, reserve, readOnly;
+    database->Info(&odsMajor, &odsMinor, &pageSize, &pages, &buffers,
+        &sweep, &sync, &reserve, &readOnly);
+    st->Execute(std::string(
+        "select s.rdb$index_name, s.rdb$field_name, ")
+        + (odsMajor >= 11 ? "s.rdb$statistics"
+            : "cast(null as double precision)") +
+        " from rdb$index_segments s"
+        " order by s.rdb$index_name, s.rdb$field_position");
+    while (st->Fetch())
+    {
+        std::string name, field;
+        double statistics = 0;
+        st->Get(1, name);
+        st->Get(2, field);
+        st->Get(3, statistics);
+        std::map<std::string, size_t>::const_iterator it =
+            positions.find(trimRight(name));
+        if (it == positions.end())
+            continue;
+        IndexHealth& index = indices[(*it).second];
+        index.segments.push_back(trimRight(field));
+        index.segmentStatistics.push_back(statistics);
+    }
+}
+
+// whether the segments of a are a leading part of (or equal to) those of b
+static bool isPrefixOf(const IndexHealth& a, const IndexHealth& b)
+{
+    if (a.expression || b.expression || a.descending != b.descending)
+        return false;
+    if (a.segments.empty() || a.segments.size() > b.segments.size())
+        return false;
+    for (size_t i = 0; i < a.segments.size(); ++i)
+    {
+        if (a.segments[i] != b.segments[i])
+            return false;
+    }
+    return true;
+}
+
+// of two indices with the same segments, the one that is not needed by a
+// constraint (or not unique) is reported
+static bool isPreferred(const IndexHealth& a, const IndexHealth& b)
+{
+    if (a.constraintType.empty() != b.constraintType.empty())
+        return !a.constraintType.empty();
+    if (a.unique != b.unique)
+        return a.unique;
+    return a.name < b.name;
+}
+
+void IndexAnalyzer::analyze(IndexHealthList& indices) const
+{
+    // the table size is at least the key count of its most selective index
+    std::map<std::string, double> rows;
+    for (IndexHealthList::iterator it = indices.begin(); it != indices.end();
+        ++it)
+    {
+        IndexHealth& index = *it;
+        index.problems = ipNone;
+        index.coveredBy.clear();
+        index.distinctKeys = index.statistics > 0 ? 1 / index.statistics : 0;
+        double& r = rows[index.relation];
+        if (index.active && index.distinctKeys > r)
+            r = index.distinctKeys;
+    }
+
+    // indices are ordered by relation, so all indices of a relation are
+    // compared in one range
+    IndexHealthList::iterator first = indices.begin();
+    while (first != indices.end())
+    {
+        IndexHealthList::iterator last = first;
+        while (last != indices.end() && (*last).relation == (*first).relation)
+            ++last;
+
+        double tableRows = rows[(*first).relation];
+        for (IndexHealthList::iterator it = first; it != last; ++it)
+        {
+            IndexHealth& index = *it;
+            index.estimatedRows = tableRows;
+            if (!index.active)
+            {
+                index.problems |= ipInactive;
+                continue;
+            }
+            if (index.statistics <= 0)
+            {
+                if (tableRows > 0)
+                    index.problems |= ipNoStatistics;
+            }
+            else if (index.unique
+                && index.distinctKeys < staleRatioM * tableRows)
+            {
+                index.problems |= ipStale;
+            }
+            if (!index.unique && tableRows >= minRowsM
+                && index.distinctKeys > 0
+                && index.distinctKeys < lowSelectivityRatioM * tableRows)
+            {
+                index.problems |= ipLowSelectivity;
+            }
+
+            for (IndexHealthList::iterator other = first; other != last;
+                ++other)
+            {
+                if (other == it || !(*other).active
+                    || !isPrefixOf(index, *other))
+                {
+                    continue;
+                }
+                if (index.segments.size() == (*other).segments.size())
+                {
+                    if (index.unique == (*other).unique
+                        || !index.unique)
+                    {
+                        if (isPreferred(index, *other))
+                            continue;
+                        index.problems |= ipDuplicate;
+                        index.coveredBy = (*other).name;
+                        break;
+                    }
+                }
+                else if (!index.unique)
+                {
+                    index.problems |= ipRedundantPrefix;
+                    index.coveredBy = (*other).name;
+                    break;
+                }
+            }
+        }
+        first = last;
+    }
+}
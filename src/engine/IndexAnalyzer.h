@@ -0,0 +1,95 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_INDEXANALYZER_H
+#define FR_INDEXANALYZER_H
+
+#include <string>
+#include <vector>
+
+#include <ibpp.h>
+
+// what the analyzer found wrong with an index, combined as bit flags
+enum IndexProblem
+{
+    ipNone = 0,
+    // the table has rows but the index statistics were never computed
+    ipNoStatistics = 1,
+    // another index of the table has seen many more rows since
+    ipStale = 2,
+    // a few distinct keys for many rows
+    ipLowSelectivity = 4,
+    // another index has the same segments in the same order
+    ipDuplicate = 8,
+    // the segments are a leading part of another index
+    ipRedundantPrefix = 16,
+    ipInactive = 32
+};
+
+struct IndexHealth
+{
+    std::string name;
+    std::string relation;
+    // "PRIMARY KEY", "UNIQUE" or "FOREIGN KEY" when the index is used by
+    // a constraint, empty otherwise
+    std::string constraintType;
+    std::vector<std::string> segments;
+    std::vector<double> segmentStatistics;
+    bool unique;
+    bool active;
+    bool descending;
+    bool expression;
+    bool system;
+    double statistics;
+
+    // filled by IndexAnalyzer::analyze()
+    double distinctKeys;
+    double estimatedRows;
+    unsigned problems;
+    // the other index of ipDuplicate and ipRedundantPrefix
+    std::string coveredBy;
+};
+typedef std::vector<IndexHealth> IndexHealthList;
+
+class IndexAnalyzer
+{
+private:
+    double lowSelectivityRatioM;
+    double minRowsM;
+    double staleRatioM;
+public:
+    // an index is of low selectivity when the table has at least minRows
+    // rows and less than lowSelectivityRatio * rows distinct keys, it is
+    // stale when its key count is below staleRatio * the table estimate
+    IndexAnalyzer(double lowSelectivityRatio = 0.001, double minRows = 1000,
+        double staleRatio = 0.5);
+
+    // loads all indices and their segments with two queries, names are
+    // in the connection character set
+    static void load(IBPP::Database& database, IBPP::Transaction& transaction,
+        IndexHealthList& indices);
+
+    void analyze(IndexHealthList& indices) const;
+};
+
+#endif // FR_INDEXANALYZER_H
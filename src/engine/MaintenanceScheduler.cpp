@@ -0,0 +1,279 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <sstream>
+
+#include "engine/MaintenanceScheduler.h"
+
+// the names are translated where they are shown
+static const char* const jobKindNames[] = {
+    wxTRANSLATE("sweep"), wxTRANSLATE("validate"),
+    wxTRANSLATE("index statistics"), wxTRANSLATE("backup")
+};
+
+static const char* const jobStateNames[] = {
+    wxTRANSLATE("queued"), wxTRANSLATE("running"), wxTRANSLATE("finished"),
+    wxTRANSLATE("failed"), wxTRANSLATE("canceled")
+};
+
+MaintenanceJob::MaintenanceJob()
+    : id(0), kind(mjSweep), state(mjsQueued), startMillis(0),
+        durationMillis(0), amount(0)
+{
+}
+
+/*static*/
+const char* MaintenanceJob::getKindName(MaintenanceJobKind kind)
+{
+    return jobKindNames[kind];
+}
+
+/*static*/
+const char* MaintenanceJob::getStateName(MaintenanceJobState state)
+{
+    return jobStateNames[state];
+}
+
+/*static*/
+const char* MaintenanceJob::getAmountUnit(MaintenanceJobKind kind)
+{
+    switch (kind)
+    {
+        case mjSweep:
+        case mjValidate:
+            return wxTRANSLATE("pages");
+        case mjIndexStatistics:
+            return wxTRANSLATE("indices");
+        case mjBackup:
+            return wxTRANSLATE("bytes");
+    }
+    return "";
+}
+
+double MaintenanceJob::getThroughput() const
+{
+    if (durationMillis <= 0 || amount <= 0)
+        return 0;
+    return amount * 1000.0 / durationMillis;
+}
+
+MaintenanceQueue::MaintenanceQueue(int maxPerServer)
+    : maxPerServerM(maxPerServer > 0 ? maxPerServer : 1), nextIdM(1)
+{
+}
+
+int MaintenanceQueue::add(MaintenanceJob job)
+{
+    job.id = nextIdM++;
+    job.state = mjsQueued;
+    jobsM.push_back(job);
+    return job.id;
+}
+
+void MaintenanceQueue::cancelQueued()
+{
+    for (std::vector<MaintenanceJob>::iterator it = jobsM.begin();
+        it != jobsM.end(); ++it)
+    {
+        if (it->state == mjsQueued)
+            it->state = mjsCanceled;
+    }
+}
+
+void MaintenanceQueue::clearCompleted()
+{
+    std::vector<MaintenanceJob> jobs;
+    for (std::vector<MaintenanceJob>::iterator it = jobsM.begin();
+        it != jobsM.end(); ++it)
+    {
+        if (it->state == mjsQueued || it->state == mjsRunning)
+            jobs.push_back(*it);
+    }
+    jobsM.swap(jobs);
+}
+
+const MaintenanceJob* MaintenanceQueue::findJob(int id) const
+{
+    for (std::vector<MaintenanceJob>::const_iterator it = jobsM.begin();
+        it != jobsM.end(); ++it)
+    {
+        if (it->id == id)
+            return &(*it);
+    }
+    return 0;
+}
+
+void MaintenanceQueue::finishJob(int id, MaintenanceJobState state,
+    int64_t amount,
+    const std::string& message, int64_t nowMillis)
+{
+    for (std::vector<MaintenanceJob>::iterator it = jobsM.begin();
+        it != jobsM.end(); ++it)
+    {
+        if (it->id != id || it->state != mjsRunning)
+            continue;
+        it->state = state;
+        it->durationMillis = nowMillis - it->startMillis;
+        it->amount = amount;
+        it->message = message;
+        --runningM[it->server];
+        return;
+    }
+}
+
+void MaintenanceQueue::setProgress(int id, int64_t amount,
+    int64_t nowMillis)
+{
+    for (std::vector<MaintenanceJob>::iterator it = jobsM.begin();
+        it != jobsM.end(); ++it)
+    {
+        if (it->id != id || it->state != mjsRunning)
+            continue;
+        it->durationMillis = nowMillis - it->startMillis;
+        it->amount = amount;
+        return;
+    }
+}
+
+size_t MaintenanceQueue::getCount(MaintenanceJobState state) const
+{
+    size_t count = 0;
+    for (std::vector<MaintenanceJob>::const_iterator it = jobsM.begin();
+        it != jobsM.end(); ++it)
+    {
+        if (it->state == state)
+            ++count;
+    }
+    return count;
+}
+
+void MaintenanceQueue::setMaxPerServer(int maxPerServer)
+{
+    maxPerServerM = maxPerServer > 0 ? maxPerServer : 1;
+}
+
+std::vector<int> MaintenanceQueue::startJobs(int64_t nowMillis,
+    const std::string& started)
+{
+    std::vector<int> ids;
+    for (std::vector<MaintenanceJob>::iterator it = jobsM.begin();
+        it != jobsM.end(); ++it)
+    {
+        if (it->state != mjsQueued)
+            continue;
+        int& running = runningM[it->server];
+        if (running >= maxPerServerM)
+            continue;
+        ++running;
+        it->state = mjsRunning;
+        it->startMillis = nowMillis;
+        it->started = started;
+        ids.push_back(it->id);
+    }
+    return ids;
+}
+
+static std::string historyField(const std::string& s)
+{
+    std::string field(s);
+    for (std::string::iterator it = field.begin(); it != field.end(); ++it)
+    {
+        if (*it == '\t' || *it == '\r' || *it == '\n')
+            *it = ' ';
+    }
+    return field;
+}
+
+/*static*/
+bool MaintenanceHistory::append(const std::string& fileName,
+    const MaintenanceJob& job)
+{
+    std::ofstream file(fileName.c_str(), std::ios::out | std::ios::app);
+    if (!file)
+        return false;
+    file << historyField(job.started) << '\t'
+        << historyField(job.database) << '\t'
+        << historyField(job.server) << '\t'
+        << int(job.kind) << '\t' << int(job.state) << '\t'
+        << job.durationMillis << '\t' << job.amount << '\t'
+        << historyField(job.message) << '\n';
+    return file.good();
+}
+
+/*static*/
+bool MaintenanceHistory::load(const std::string& fileName,
+    std::vector<MaintenanceJob>& jobs, size_t maxJobs)
+{
+    jobs.clear();
+    std::ifstream file(fileName.c_str());
+    if (!file)
+        return false;
+
+    std::deque<MaintenanceJob> last;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::vector<std::string> fields;
+        std::istringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, '\t'))
+            fields.push_back(field);
+        if (fields.size() < 7)
+            continue;
+        int kind = atoi(fields[3].c_str());
+        int state = atoi(fields[4].c_str());
+        if (kind < mjSweep || kind > mjBackup
+            || state < mjsQueued || state > mjsCanceled)
+        {
+            continue;
+        }
+
+        MaintenanceJob job;
+        job.started = fields[0];
+        job.database = fields[1];
+        job.server = fields[2];
+        job.kind = MaintenanceJobKind(kind);
+        job.state = MaintenanceJobState(state);
+        job.durationMillis = strtoll(fields[5].c_str(), 0, 10);
+        job.amount = strtoll(fields[6].c_str(), 0, 10);
+        if (fields.size() > 7)
+            job.message = fields[7];
+        last.push_front(job);
+        if (last.size() > maxJobs)
+            last.pop_back();
+    }
+    jobs.assign(last.begin(), last.end());
+    return true;
+}
@@ -0,0 +1,111 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_MAINTENANCESCHEDULER_H
+#define FR_MAINTENANCESCHEDULER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <ibpp.h>
+
+enum MaintenanceJobKind
+{
+    mjSweep, mjValidate, mjIndexStatistics, mjBackup
+};
+
+enum MaintenanceJobState
+{
+    mjsQueued, mjsRunning, mjsFinished, mjsFailed, mjsCanceled
+};
+
+struct MaintenanceJob
+{
+    int id;
+    MaintenanceJobKind kind;
+    // jobs with the same server count against the same concurrency limit
+    std::string server;
+    std::string database;
+    MaintenanceJobState state;
+    // local time of the start, as "YYYY-MM-DD hh:mm:ss"
+    std::string started;
+    int64_t startMillis;
+    int64_t durationMillis;
+    // the work done, in units of getAmountUnit(kind)
+    int64_t amount;
+    std::string message;
+
+    MaintenanceJob();
+
+    static const char* getKindName(MaintenanceJobKind kind);
+    static const char* getStateName(MaintenanceJobState state);
+    static const char* getAmountUnit(MaintenanceJobKind kind);
+    // amount per second, or 0 if unknown
+    double getThroughput() const;
+};
+
+// Jobs are started in the order they were queued, but never more than
+// maxPerServer at the same time on one server.
+class MaintenanceQueue
+{
+private:
+    std::vector<MaintenanceJob> jobsM;
+    std::map<std::string, int> runningM;
+    int maxPerServerM;
+    int nextIdM;
+public:
+    MaintenanceQueue(int maxPerServer = 2);
+
+    int add(MaintenanceJob job);
+    void clearCompleted();
+    void setMaxPerServer(int maxPerServer);
+    int getMaxPerServer() const { return maxPerServerM; }
+
+    // marks the jobs that may be started now as running and returns them
+    std::vector<int> startJobs(int64_t nowMillis, const std::string& started);
+    // state is mjsFinished, mjsFailed or mjsCanceled
+    void finishJob(int id, MaintenanceJobState state, int64_t amount,
+        const std::string& message, int64_t nowMillis);
+    // updates the amount of work a running job has done so far
+    void setProgress(int id, int64_t amount, int64_t nowMillis);
+    // cancels the jobs that didn't start yet
+    void cancelQueued();
+
+    const std::vector<MaintenanceJob>& getJobs() const { return jobsM; }
+    const MaintenanceJob* findJob(int id) const;
+    size_t getCount(MaintenanceJobState state) const;
+};
+
+// The job history is a text file with one tab separated line per job,
+// new jobs are appended to it.
+class MaintenanceHistory
+{
+public:
+    static bool append(const std::string& fileName, const MaintenanceJob& job);
+    // loads the last maxJobs jobs, most recent first
+    static bool load(const std::string& fileName,
+        std::vector<MaintenanceJob>& jobs, size_t maxJobs);
+};
+
+#endif // FR_MAINTENANCESCHEDULER_H
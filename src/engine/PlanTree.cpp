@@ -0,0 +1,413 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include "engine/PlanTree.h"
+
+static std::string trim(const std::string& s)
+{
+    std::string::size_type start = s.find_first_not_of(" \t\r");
+    if (start == std::string::npos)
+        return std::string();
+    std::string::size_type end = s.find_last_not_of(" \t\r");
+    return s.substr(start, end - start + 1);
+}
+
+static bool startsWith(const std::string& s, const char* prefix)
+{
+    return s.compare(0, strlen(prefix), prefix) == 0;
+}
+
+// reads a double-quoted identifier starting at pos, doubled quotes are
+// unescaped, pos is moved behind the closing quote
+static bool readQuoted(const std::string& s, std::string::size_type& pos,
+    std::string& name)
+{
+    while (pos < s.size() && s[pos] == ' ')
+        ++pos;
+    if (pos >= s.size() || s[pos] != '"')
+        return false;
+    name.erase();
+    for (++pos; pos < s.size(); ++pos)
+    {
+        if (s[pos] == '"')
+        {
+            if (pos + 1 < s.size() && s[pos + 1] == '"')
+                ++pos;
+            else
+            {
+                ++pos;
+                return true;
+            }
+        }
+        name += s[pos];
+    }
+    return false;
+}
+
+static void parseExplainedLine(const std::string& line, bool isAccess,
+    PlanNode& node)
+{
+    node.text = line;
+    std::string::size_type pos;
+    if (!isAccess)
+        node.kind = PlanNode::nkExpression;
+    else if (startsWith(line, "Table "))
+    {
+        // Table "NAME" [as "ALIAS" ["ALIAS"...]] Full Scan | Access By ID
+        pos = 5;
+        readQuoted(line, pos, node.relation);
+        std::string rest(trim(line.substr(std::min(pos, line.size()))));
+        if (startsWith(rest, "as "))
+        {
+            std::string::size_type apos = 2;
+            std::string alias;
+            while (readQuoted(rest, apos, alias))
+            {
+                if (!node.alias.empty())
+                    node.alias += " ";
+                node.alias += alias;
+            }
+            rest = trim(rest.substr(std::min(apos, rest.size())));
+        }
+        node.detail = rest;
+        if (rest.find("Full Scan") != std::string::npos)
+            node.kind = PlanNode::nkNaturalScan;
+        else
+            node.kind = PlanNode::nkTableAccess;
+    }
+    else if (startsWith(line, "Index "))
+    {
+        pos = 5;
+        readQuoted(line, pos, node.index);
+        node.detail = trim(line.substr(std::min(pos, line.size())));
+        node.kind = PlanNode::nkIndexScan;
+    }
+    else if (startsWith(line, "Procedure "))
+    {
+        pos = 9;
+        readQuoted(line, pos, node.relation);
+        node.detail = trim(line.substr(std::min(pos, line.size())));
+        node.kind = PlanNode::nkProcedure;
+    }
+    else if (line.find(" Join") != std::string::npos)
+    {
+        node.kind = PlanNode::nkJoin;
+        std::string::size_type open = line.find('(');
+        std::string::size_type close = line.find(')', open);
+        if (open != std::string::npos && close != std::string::npos)
+            node.detail = line.substr(open + 1, close - open - 1);
+    }
+    else if (startsWith(line, "Sort"))
+        node.kind = PlanNode::nkSort;
+    else
+        node.kind = PlanNode::nkOther;
+}
+
+bool PlanParser::parseExplained(const std::string& plan, PlanNodes& nodes)
+{
+    nodes.clear();
+    // indentation of the current node and all of its ancestors
+    std::vector<std::string::size_type> indents;
+    std::string::size_type start = 0;
+    while (start < plan.size())
+    {
+        std::string::size_type end = plan.find('\n', start);
+        if (end == std::string::npos)
+            end = plan.size();
+        std::string line(plan.substr(start, end - start));
+        start = end + 1;
+
+        std::string::size_type indent = line.find_first_not_of(' ');
+        if (indent == std::string::npos)
+            continue;
+        std::string text(trim(line));
+        if (text.empty())
+            continue;
+        bool isAccess = startsWith(text, "->");
+        if (isAccess)
+            text = trim(text.substr(2));
+
+        while (!indents.empty() && indents.back() >= indent)
+            indents.pop_back();
+        PlanNode node;
+        node.level = int(indents.size());
+        indents.push_back(indent);
+        parseExplainedLine(text, isAccess, node);
+        nodes.push_back(node);
+    }
+    return !nodes.empty();
+}
+
+namespace
+{
+
+class LegacyPlanParser
+{
+private:
+    std::vector<std::string> tokensM;
+    std::vector<bool> quotedM;
+    size_t posM;
+    PlanNodes& nodesM;
+
+    void tokenize(const std::string& plan);
+    bool isToken(const char* token) const;
+    bool parseList(int level);
+    bool parseItem(int level);
+    PlanNode& addNode(int level, PlanNode::Kind kind,
+        const std::string& text);
+public:
+    LegacyPlanParser(const std::string& plan, PlanNodes& nodes);
+    bool parse();
+};
+
+LegacyPlanParser::LegacyPlanParser(const std::string& plan,
+        PlanNodes& nodes)
+    : posM(0), nodesM(nodes)
+{
+    tokenize(plan);
+}
+
+void LegacyPlanParser::tokenize(const std::string& plan)
+{
+    std::string::size_type pos = 0;
+    while (pos < plan.size())
+    {
+        char c = plan[pos];
+        if (isspace((unsigned char)c))
+        {
+            ++pos;
+            continue;
+        }
+        if (c == '(' || c == ')' || c == ',')
+        {
+            tokensM.push_back(std::string(1, c));
+            quotedM.push_back(false);
+            ++pos;
+            continue;
+        }
+        std::string token;
+        if (c == '"')
+        {
+            if (!readQuoted(plan, pos, token))
+                pos = plan.size();
+            tokensM.push_back(token);
+            quotedM.push_back(true);
+            continue;
+        }
+        while (pos < plan.size() && !isspace((unsigned char)plan[pos])
+            && strchr("(),\"", plan[pos]) == 0)
+        {
+            token += plan[pos++];
+        }
+        tokensM.push_back(token);
+        quotedM.push_back(false);
+    }
+}
+
+bool LegacyPlanParser::isToken(const char* token) const
+{
+    // quoted identifiers are never keywords or punctuation
+    return posM < tokensM.size() && !quotedM[posM]
+        && tokensM[posM] == token;
+}
+
+PlanNode& LegacyPlanParser::addNode(int level, PlanNode::Kind kind,
+    const std::string& text)
+{
+    PlanNode node;
+    node.level = level;
+    node.kind = kind;
+    node.text = text;
+    nodesM.push_back(node);
+    return nodesM.back();
+}
+
+bool LegacyPlanParser::parseList(int level)
+{
+    if (!isToken("("))
+        return false;
+    ++posM;
+    while (posM < tokensM.size())
+    {
+        if (!parseItem(level))
+            return false;
+        if (isToken(","))
+            ++posM;
+        else if (isToken(")"))
+        {
+            ++posM;
+            return true;
+        }
+        else
+            return false;
+    }
+    return false;
+}
+
+bool LegacyPlanParser::parseItem(int level)
+{
+    if (posM >= tokensM.size())
+        return false;
+    if (isToken("("))
+        return parseList(level);
+
+    bool nextIsList = posM + 1 < tokensM.size() && !quotedM[posM + 1]
+        && tokensM[posM + 1] == "(";
+    if (nextIsList && (isToken("JOIN") || isToken("MERGE")
+        || isToken("HASH") || isToken("SORT")))
+    {
+        const std::string& keyword = tokensM[posM];
+        PlanNode& node = addNode(level,
+            keyword == "SORT" ? PlanNode::nkSort : PlanNode::nkJoin,
+            keyword);
+        if (keyword != "SORT")
+            node.detail = keyword == "JOIN" ? "nested loop" : keyword;
+        ++posM;
+        return parseList(level + 1);
+    }
+
+    // the stream: one or more names (view aliases first) and its access
+    std::vector<std::string> names;
+    while (posM < tokensM.size() && !isToken("NATURAL")
+        && !isToken("INDEX") && !isToken("ORDER"))
+    {
+        if (isToken("(") || isToken(")") || isToken(","))
+            return false;
+        names.push_back(tokensM[posM++]);
+    }
+    if (names.empty() || posM >= tokensM.size())
+        return false;
+
+    std::string alias;
+    for (size_t i = 0; i < names.size(); ++i)
+        alias += (i ? " " : "") + names[i];
+    PlanNode& node = addNode(level, PlanNode::nkTableAccess, alias);
+    node.relation = names.back();
+    node.alias = alias;
+    size_t streamIndex = nodesM.size() - 1;
+
+    if (isToken("NATURAL"))
+    {
+        ++posM;
+        nodesM[streamIndex].kind = PlanNode::nkNaturalScan;
+        nodesM[streamIndex].detail = "NATURAL";
+        nodesM[streamIndex].text += " NATURAL";
+        return true;
+    }
+    if (isToken("ORDER"))
+    {
+        ++posM;
+        if (posM >= tokensM.size())
+            return false;
+        PlanNode& index = addNode(level + 1, PlanNode::nkIndexScan,
+            "ORDER " + tokensM[posM]);
+        index.index = tokensM[posM];
+        index.detail = "ORDER";
+        ++posM;
+        nodesM[streamIndex].detail = "ORDER";
+    }
+    if (isToken("INDEX"))
+    {
+        ++posM;
+        if (!isToken("("))
+            return false;
+        ++posM;
+        while (posM < tokensM.size() && !isToken(")"))
+        {
+            if (!isToken(","))
+            {
+                PlanNode& index = addNode(level + 1, PlanNode::nkIndexScan,
+                    "INDEX " + tokensM[posM]);
+                index.index = tokensM[posM];
+                index.detail = "INDEX";
+            }
+            ++posM;
+        }
+        if (!isToken(")"))
+            return false;
+        ++posM;
+        if (nodesM[streamIndex].detail.empty())
+            nodesM[streamIndex].detail = "INDEX";
+    }
+    return true;
+}
+
+bool LegacyPlanParser::parse()
+{
+    while (posM < tokensM.size())
+    {
+        if (!isToken("PLAN"))
+            return false;
+        ++posM;
+        addNode(0, PlanNode::nkExpression, "PLAN");
+        if (!parseItem(1))
+            return false;
+    }
+    return !nodesM.empty();
+}
+
+} // namespace
+
+bool PlanParser::parseLegacy(const std::string& plan, PlanNodes& nodes)
+{
+    nodes.clear();
+    LegacyPlanParser parser(plan, nodes);
+    return parser.parse();
+}
+
+bool PlanParser::parse(const std::string& explained,
+    const std::string& legacy, PlanNodes& nodes)
+{
+    if (!explained.empty() && parseExplained(explained, nodes))
+        return true;
+    return !legacy.empty() && parseLegacy(legacy, nodes);
+}
+
+std::vector<std::string> PlanParser::getNaturalScans(const PlanNodes& nodes)
+{
+    std::vector<std::string> relations;
+    for (PlanNodes::const_iterator it = nodes.begin(); it != nodes.end();
+        ++it)
+    {
+        if ((*it).kind == PlanNode::nkNaturalScan && !(*it).relation.empty()
+            && std::find(relations.begin(), relations.end(),
+                (*it).relation) == relations.end())
+        {
+            relations.push_back((*it).relation);
+        }
+    }
+    return relations;
+}
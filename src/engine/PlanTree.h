@@ -0,0 +1,66 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_PLANTREE_H
+#define FR_PLANTREE_H
+
+#include <string>
+#include <vector>
+
+// One line of a statement plan. The nodes of a plan are stored in pre-order,
+// the children of a node follow it with a level one higher.
+struct PlanNode
+{
+    enum Kind { nkExpression, nkJoin, nkNaturalScan, nkTableAccess,
+        nkIndexScan, nkProcedure, nkSort, nkOther };
+
+    int level;
+    Kind kind;
+    // the line of the explained plan, or a description of the legacy item
+    std::string text;
+    std::string relation;
+    std::string alias;
+    std::string index;
+    // "inner", "outer", ... for joins, the access method for scans
+    std::string detail;
+};
+typedef std::vector<PlanNode> PlanNodes;
+
+// Builds plan trees from the two plan formats the server provides.
+class PlanParser
+{
+public:
+    // The explained plan of Firebird 3 and later: headings like
+    // "Select Expression" and "-> " lines indented four spaces per level.
+    static bool parseExplained(const std::string& plan, PlanNodes& nodes);
+    // The legacy "PLAN JOIN (A NATURAL, B INDEX (X))" format, one plan per
+    // line. Relation names are aliases where the statement uses them.
+    static bool parseLegacy(const std::string& plan, PlanNodes& nodes);
+    static bool parse(const std::string& explained, const std::string& legacy,
+        PlanNodes& nodes);
+
+    // the distinct relations that are read in natural order
+    static std::vector<std::string> getNaturalScans(const PlanNodes& nodes);
+};
+
+#endif // FR_PLANTREE_H
@@ -0,0 +1,438 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+#include "core/FRError.h"
+#include "engine/ResultDiff.h"
+
+namespace
+{
+
+// number of temporary files each side is spread over in hash mode
+const size_t hashPartitions = 64;
+
+// splits a decimal number into sign, integer digits without leading
+// zeros and fraction digits without trailing zeros, returns false for
+// anything else (exponents, NaN, Infinity)
+bool splitDecimal(const std::string& s, bool& negative, std::string& intPart,
+    std::string& fracPart)
+{
+    std::string::size_type i = 0;
+    negative = false;
+    if (i < s.size() && (s[i] == '-' || s[i] == '+'))
+        negative = (s[i++] == '-');
+    std::string::size_type intStart = i;
+    while (i < s.size() && s[i] >= '0' && s[i] <= '9')
+        ++i;
+    intPart = s.substr(intStart, i - intStart);
+    fracPart.clear();
+    if (i < s.size() && s[i] == '.')
+    {
+        std::string::size_type fracStart = ++i;
+        while (i < s.size() && s[i] >= '0' && s[i] <= '9')
+            ++i;
+        fracPart = s.substr(fracStart, i - fracStart);
+    }
+    if (i != s.size() || (intPart.empty() && fracPart.empty()))
+        return false;
+
+    std::string::size_type nz = intPart.find_first_not_of('0');
+    intPart.erase(0, nz == std::string::npos ? intPart.size() : nz);
+    nz = fracPart.find_last_not_of('0');
+    fracPart.erase(nz == std::string::npos ? 0 : nz + 1);
+    if (intPart.empty() && fracPart.empty())
+        negative = false;
+    return true;
+}
+
+// the same number always gives the same string, "1.50" and "01.5" too
+std::string normalizeNumber(const std::string& s)
+{
+    bool negative;
+    std::string intPart, fracPart;
+    if (!splitDecimal(s, negative, intPart, fracPart))
+    {
+        char* end;
+        long double d = strtold(s.c_str(), &end);
+        if (end == s.c_str() || *end != 0)
+            return s;
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.21Lg", d);
+        return buf;
+    }
+    std::string result(negative ? "-" : "");
+    result += intPart.empty() ? std::string("0") : intPart;
+    if (!fracPart.empty())
+        result += "." + fracPart;
+    return result;
+}
+
+// 64 bit FNV-1a
+uint64_t hashBytes(const std::string& s)
+{
+    uint64_t h = 14695981039346656037ULL;
+    for (std::string::size_type i = 0; i < s.size(); ++i)
+    {
+        h ^= static_cast<unsigned char>(s[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+void appendValue(std::string& record, const std::string& value, bool isNull)
+{
+    record += isNull ? 'N' : 'V';
+    uint32_t len = static_cast<uint32_t>(value.size());
+    record.append(reinterpret_cast<const char*>(&len), sizeof(len));
+    record += value;
+}
+
+class TempFile
+{
+private:
+    FILE* fileM;
+public:
+    TempFile() : fileM(0) {}
+    ~TempFile() { if (fileM) fclose(fileM); }
+
+    void write(const std::string& record)
+    {
+        if (!fileM && (fileM = tmpfile()) == 0)
+            throw FRError(_("Could not create a temporary file."));
+        uint32_t len = static_cast<uint32_t>(record.size());
+        if (fwrite(&len, sizeof(len), 1, fileM) != 1
+            || fwrite(record.data(), 1, len, fileM) != len)
+        {
+            throw FRError(_("Could not write to a temporary file."));
+        }
+    }
+    void rewind()
+    {
+        if (fileM)
+            ::rewind(fileM);
+    }
+    bool read(std::string& record)
+    {
+        uint32_t len;
+        if (!fileM || fread(&len, sizeof(len), 1, fileM) != 1)
+            return false;
+        record.resize(len);
+        if (len && fread(&record[0], 1, len, fileM) != len)
+            throw FRError(_("Could not read from a temporary file."));
+        return true;
+    }
+    void close()
+    {
+        if (fileM)
+            fclose(fileM);
+        fileM = 0;
+    }
+};
+
+void decodeRow(const std::string& record, size_t columns, ResultDiffRow& row)
+{
+    row.values.resize(columns);
+    row.nulls.resize(columns);
+    std::string::size_type pos = 0;
+    for (size_t i = 0; i < columns; ++i)
+    {
+        row.nulls[i] = (record[pos] == 'N');
+        uint32_t len;
+        memcpy(&len, record.data() + pos + 1, sizeof(len));
+        pos += 1 + sizeof(len);
+        row.values[i].assign(record, pos, len);
+        pos += len;
+    }
+}
+
+} // namespace
+
+ResultDiff::ResultDiff(const std::vector<ResultDiffColumn>& columns,
+        size_t keyColumns, size_t maxRowsKept)
+    : columnsM(columns), keyColumnsM(std::min(keyColumns, columns.size())),
+        maxRowsKeptM(maxRowsKept), canceledM(0), leftRowsM(0),
+        rightRowsM(0), equalCountM(0), removedCountM(0), addedCountM(0),
+        changedCountM(0)
+{
+}
+
+void ResultDiff::setCancelFlag(const std::atomic<bool>* canceled)
+{
+    canceledM = canceled;
+}
+
+bool ResultDiff::isCanceled() const
+{
+    return canceledM && canceledM->load();
+}
+
+/*static*/
+int ResultDiff::compareNumbers(const std::string& left,
+    const std::string& right)
+{
+    bool lneg, rneg;
+    std::string lint, lfrac, rint, rfrac;
+    if (!splitDecimal(left, lneg, lint, lfrac)
+        || !splitDecimal(right, rneg, rint, rfrac))
+    {
+        char* lend;
+        char* rend;
+        long double l = strtold(left.c_str(), &lend);
+        long double r = strtold(right.c_str(), &rend);
+        if (*lend || *rend || l != l || r != r)
+            return left.compare(right) < 0 ? -1 : (left == right ? 0 : 1);
+        return l < r ? -1 : (l > r ? 1 : 0);
+    }
+    if (lneg != rneg)
+        return lneg ? -1 : 1;
+    int result;
+    if (lint.size() != rint.size())
+        result = lint.size() < rint.size() ? -1 : 1;
+    else if (int c = lint.compare(rint))
+        result = c < 0 ? -1 : 1;
+    else if (int c = lfrac.compare(rfrac))
+        result = c < 0 ? -1 : 1;
+    else
+        result = 0;
+    return lneg ? -result : result;
+}
+
+int ResultDiff::compareValue(size_t col, const ResultDiffRow& left,
+    const ResultDiffRow& right) const
+{
+    // NULLs sort first, like with NULLS FIRST
+    if (left.nulls[col] || right.nulls[col])
+    {
+        if (left.nulls[col] && right.nulls[col])
+            return 0;
+        return left.nulls[col] ? -1 : 1;
+    }
+    if (columnsM[col].numeric)
+        return compareNumbers(left.values[col], right.values[col]);
+    int c = left.values[col].compare(right.values[col]);
+    return c < 0 ? -1 : (c > 0 ? 1 : 0);
+}
+
+int ResultDiff::compareKeys(const ResultDiffRow& left,
+    const ResultDiffRow& right) const
+{
+    for (size_t i = 0; i < keyColumnsM; ++i)
+    {
+        if (int c = compareValue(i, left, right))
+            return c;
+    }
+    return 0;
+}
+
+bool ResultDiff::valuesEqual(const ResultDiffRow& left,
+    const ResultDiffRow& right) const
+{
+    for (size_t i = keyColumnsM; i < columnsM.size(); ++i)
+    {
+        if (compareValue(i, left, right) != 0)
+            return false;
+    }
+    return true;
+}
+
+void ResultDiff::addRemoved(const ResultDiffRow& row)
+{
+    ++removedCountM;
+    if (removedM.size() < maxRowsKeptM)
+        removedM.push_back(row);
+}
+
+void ResultDiff::addAdded(const ResultDiffRow& row)
+{
+    ++addedCountM;
+    if (addedM.size() < maxRowsKeptM)
+        addedM.push_back(row);
+}
+
+void ResultDiff::addChanged(const ResultDiffRow& left,
+    const ResultDiffRow& right)
+{
+    ++changedCountM;
+    if (changedM.size() < maxRowsKeptM)
+        changedM.push_back(ChangedRow(left, right));
+}
+
+bool ResultDiff::fetchOrdered(ResultDiffSource& source, ResultDiffRow& row,
+    ResultDiffRow& previous, bool& hasPrevious, int64_t& count)
+{
+    if (!source.fetch(row))
+        return false;
+    if (row.values.size() != columnsM.size()
+        || row.nulls.size() != columnsM.size())
+    {
+        throw FRError(_("The result sets have a different number of columns."));
+    }
+    ++count;
+    if (hasPrevious && compareKeys(previous, row) > 0)
+    {
+        throw FRError(_("The result set is not ordered by the key columns.\n\nUse ORDER BY on the key columns, with a binary collation for strings, or compare without key columns."));
+    }
+    previous = row;
+    hasPrevious = true;
+    return true;
+}
+
+void ResultDiff::compareByKey(ResultDiffSource& left,
+    ResultDiffSource& right)
+{
+    ResultDiffRow lrow, rrow, lprev, rprev;
+    bool lhasPrev = false, rhasPrev = false;
+    bool lok = fetchOrdered(left, lrow, lprev, lhasPrev, leftRowsM);
+    bool rok = fetchOrdered(right, rrow, rprev, rhasPrev, rightRowsM);
+    while ((lok || rok) && !isCanceled())
+    {
+        int c = !lok ? 1 : (!rok ? -1 : compareKeys(lrow, rrow));
+        if (c < 0)
+        {
+            addRemoved(lrow);
+            lok = fetchOrdered(left, lrow, lprev, lhasPrev, leftRowsM);
+        }
+        else if (c > 0)
+        {
+            addAdded(rrow);
+            rok = fetchOrdered(right, rrow, rprev, rhasPrev, rightRowsM);
+        }
+        else
+        {
+            if (valuesEqual(lrow, rrow))
+                ++equalCountM;
+            else
+                addChanged(lrow, rrow);
+            lok = fetchOrdered(left, lrow, lprev, lhasPrev, leftRowsM);
+            rok = fetchOrdered(right, rrow, rprev, rhasPrev, rightRowsM);
+        }
+    }
+}
+
+void ResultDiff::compareByHash(ResultDiffSource& left,
+    ResultDiffSource& right)
+{
+    std::vector<TempFile> lparts(hashPartitions), rparts(hashPartitions);
+    std::string record, normalized;
+    ResultDiffRow row;
+    // both sides are read alternately, so that neither of the statements
+    // has to wait for the other one to finish
+    bool sourceOk[2] = { true, true };
+    while ((sourceOk[0] || sourceOk[1]) && !isCanceled())
+    {
+        for (int side = 0; side < 2; ++side)
+        {
+            if (!sourceOk[side])
+                continue;
+            ResultDiffSource& source = side == 0 ? left : right;
+            if (!source.fetch(row))
+            {
+                sourceOk[side] = false;
+                continue;
+            }
+            if (row.values.size() != columnsM.size()
+                || row.nulls.size() != columnsM.size())
+            {
+                throw FRError(_("The result sets have a different number of columns."));
+            }
+            ++(side == 0 ? leftRowsM : rightRowsM);
+            normalized.clear();
+            for (size_t i = 0; i < columnsM.size(); ++i)
+            {
+                appendValue(normalized, columnsM[i].numeric && !row.nulls[i]
+                    ? normalizeNumber(row.values[i]) : row.values[i],
+                    row.nulls[i]);
+            }
+            std::vector<TempFile>& parts = side == 0 ? lparts : rparts;
+            parts[hashBytes(normalized) % hashPartitions].write(normalized);
+        }
+    }
+
+    // rows that are equal end up in the same partition, so only one
+    // partition of the left side has to be held in memory at a time
+    typedef std::unordered_map<std::string, int64_t> RowCounts;
+    for (size_t p = 0; p < hashPartitions && !isCanceled(); ++p)
+    {
+        RowCounts counts;
+        lparts[p].rewind();
+        while (lparts[p].read(record))
+            ++counts[record];
+        lparts[p].close();
+
+        rparts[p].rewind();
+        while (rparts[p].read(record))
+        {
+            RowCounts::iterator it = counts.find(record);
+            if (it != counts.end() && it->second > 0)
+            {
+                --it->second;
+                ++equalCountM;
+            }
+            else
+            {
+                decodeRow(record, columnsM.size(), row);
+                addAdded(row);
+            }
+        }
+        rparts[p].close();
+
+        for (RowCounts::const_iterator it = counts.begin();
+            it != counts.end(); ++it)
+        {
+            if (it->second > 0)
+                decodeRow(it->first, columnsM.size(), row);
+            for (int64_t i = 0; i < it->second; ++i)
+                addRemoved(row);
+        }
+    }
+}
+
+void ResultDiff::run(ResultDiffSource& left, ResultDiffSource& right)
+{
+    leftRowsM = rightRowsM = 0;
+    equalCountM = removedCountM = addedCountM = changedCountM = 0;
+    removedM.clear();
+    addedM.clear();
+    changedM.clear();
+
+    if (keyColumnsM)
+        compareByKey(left, right);
+    else
+        compareByHash(left, right);
+}
@@ -0,0 +1,129 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_RESULTDIFF_H
+#define FR_RESULTDIFF_H
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ibpp.h>
+
+// One row of a result set, the values in the Firebird literal format of
+// the column type
+struct ResultDiffRow
+{
+    std::vector<std::string> values;
+    std::vector<bool> nulls;
+};
+
+struct ResultDiffColumn
+{
+    std::string name;
+    bool numeric;
+};
+
+// Delivers the rows of one side of the comparison, in key order when
+// key columns are used
+class ResultDiffSource
+{
+public:
+    virtual ~ResultDiffSource() {}
+    // returns false after the last row
+    virtual bool fetch(ResultDiffRow& row) = 0;
+};
+
+// Compares two result sets with the same columns without holding either
+// of them in memory.
+// With key columns (the first keyColumns columns) both sides have to be
+// ordered by them, they are merged in a single pass and rows with equal
+// keys but other values are reported as changed. Without key columns the
+// rows are spread over temporary files by their hash and compared one
+// partition at a time, so that only added and removed rows are found.
+// Only the first maxRowsKept rows of each kind are kept, all are counted.
+class ResultDiff
+{
+public:
+    typedef std::pair<ResultDiffRow, ResultDiffRow> ChangedRow;
+private:
+    std::vector<ResultDiffColumn> columnsM;
+    size_t keyColumnsM;
+    size_t maxRowsKeptM;
+    const std::atomic<bool>* canceledM;
+
+    int64_t leftRowsM;
+    int64_t rightRowsM;
+    int64_t equalCountM;
+    int64_t removedCountM;
+    int64_t addedCountM;
+    int64_t changedCountM;
+    std::vector<ResultDiffRow> removedM;
+    std::vector<ResultDiffRow> addedM;
+    std::vector<ChangedRow> changedM;
+
+    bool isCanceled() const;
+    int compareValue(size_t col, const ResultDiffRow& left,
+        const ResultDiffRow& right) const;
+    int compareKeys(const ResultDiffRow& left,
+        const ResultDiffRow& right) const;
+    bool valuesEqual(const ResultDiffRow& left,
+        const ResultDiffRow& right) const;
+    void addRemoved(const ResultDiffRow& row);
+    void addAdded(const ResultDiffRow& row);
+    void addChanged(const ResultDiffRow& left, const ResultDiffRow& right);
+
+    bool fetchOrdered(ResultDiffSource& source, ResultDiffRow& row,
+        ResultDiffRow& previous, bool& hasPrevious, int64_t& count);
+    void compareByKey(ResultDiffSource& left, ResultDiffSource& right);
+    void compareByHash(ResultDiffSource& left, ResultDiffSource& right);
+public:
+    ResultDiff(const std::vector<ResultDiffColumn>& columns,
+        size_t keyColumns, size_t maxRowsKept = 1000);
+
+    // the comparison stops early when *canceled becomes true
+    void setCancelFlag(const std::atomic<bool>* canceled);
+    // throws FRError when a source is not ordered by the key columns
+    void run(ResultDiffSource& left, ResultDiffSource& right);
+
+    // compares numbers given as decimal strings, exactly for integers and
+    // fixed point values of any length
+    static int compareNumbers(const std::string& left,
+        const std::string& right);
+
+    int64_t getLeftRowCount() const { return leftRowsM; }
+    int64_t getRightRowCount() const { return rightRowsM; }
+    int64_t getEqualCount() const { return equalCountM; }
+    int64_t getRemovedCount() const { return removedCountM; }
+    int64_t getAddedCount() const { return addedCountM; }
+    int64_t getChangedCount() const { return changedCountM; }
+    const std::vector<ResultDiffRow>& getRemovedRows() const
+        { return removedM; }
+    const std::vector<ResultDiffRow>& getAddedRows() const
+        { return addedM; }
+    const std::vector<ChangedRow>& getChangedRows() const
+        { return changedM; }
+};
+
+#endif // FR_RESULTDIFF_H
@@ -0,0 +1,266 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "engine/SelectionAggregate.h"
+
+static void multiplyByPowerOf10(IBPP::Int128& value, int exponent)
+{
+    for (int i = 0; i < exponent; ++i)
+    {
+        IBPP::Int128 twice(value);
+        twice += value;
+        value = twice;
+        value += value;
+        value += value;
+        value += twice;
+    }
+}
+
+static std::string formatInt128(const IBPP::Int128& value, int scale)
+{
+    char buffer[48];
+    int len = value.Format(buffer, scale);
+    return std::string(buffer, len);
+}
+
+static std::string formatDouble(double value)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.15g", value);
+    return buffer;
+}
+
+// makes values sorted and unique, the first sorted of them already are
+template <typename T>
+static void sortUnique(std::vector<T>& values, size_t& sorted)
+{
+    if (sorted == values.size())
+        return;
+    std::sort(values.begin() + sorted, values.end());
+    std::inplace_merge(values.begin(), values.begin() + sorted, values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    sorted = values.size();
+}
+
+SelectionAggregate::SelectionAggregate()
+{
+    clear();
+}
+
+void SelectionAggregate::clear()
+{
+    countM = 0;
+    exactM = true;
+    scaleM = 0;
+    sumM.Clear();
+    minM.Clear();
+    maxM.Clear();
+    doubleSumM = doubleMinM = doubleMaxM = 0;
+    valuesM.clear();
+    doubleValuesM.clear();
+    sortedM = 0;
+}
+
+void SelectionAggregate::rescale(int scale)
+{
+    int exponent = scale - scaleM;
+    multiplyByPowerOf10(sumM, exponent);
+    multiplyByPowerOf10(minM, exponent);
+    multiplyByPowerOf10(maxM, exponent);
+    // doesn't change the order, so the sorted values stay sorted
+    for (std::vector<IBPP::Int128>::iterator it = valuesM.begin();
+        it != valuesM.end(); ++it)
+    {
+        multiplyByPowerOf10(*it, exponent);
+    }
+    scaleM = scale;
+}
+
+void SelectionAggregate::makeInexact()
+{
+    doubleSumM = sumM.AsDouble(scaleM);
+    doubleMinM = minM.AsDouble(scaleM);
+    doubleMaxM = maxM.AsDouble(scaleM);
+    doubleValuesM.reserve(valuesM.size());
+    for (std::vector<IBPP::Int128>::iterator it = valuesM.begin();
+        it != valuesM.end(); ++it)
+    {
+        doubleValuesM.push_back(it->AsDouble(scaleM));
+    }
+    // different values can become equal
+    sortedM = 0;
+    std::vector<IBPP::Int128>().swap(valuesM);
+    exactM = false;
+}
+
+void SelectionAggregate::sortValues()
+{
+    if (exactM)
+        sortUnique(valuesM, sortedM);
+    else
+        sortUnique(doubleValuesM, sortedM);
+}
+
+void SelectionAggregate::add(int64_t value)
+{
+    add(IBPP::Int128(value), 0);
+}
+
+void SelectionAggregate::add(const IBPP::Int128& value, int scale)
+{
+    if (!exactM)
+    {
+        add(value.AsDouble(scale));
+        return;
+    }
+
+    IBPP::Int128 scaled(value);
+    if (scale > scaleM)
+        rescale(scale);
+    else if (scale < scaleM)
+        multiplyByPowerOf10(scaled, scaleM - scale);
+
+    if (countM == 0 || scaled < minM)
+        minM = scaled;
+    if (countM == 0 || maxM < scaled)
+        maxM = scaled;
+    sumM += scaled;
+    valuesM.push_back(scaled);
+    ++countM;
+}
+
+void SelectionAggregate::addScaled(double value, int scale)
+{
+    // NUMERIC and DECIMAL with a precision up to 18 fit into 64 bits
+    double scaled = value * pow(10.0, scale);
+    if (scale > 18 || fabs(scaled) >= 9.2e18)
+        add(value);
+    else
+        add(IBPP::Int128(int64_t(llround(scaled))), scale);
+}
+
+void SelectionAggregate::add(double value)
+{
+    if (exactM)
+        makeInexact();
+
+    if (countM == 0 || value < doubleMinM)
+        doubleMinM = value;
+    if (countM == 0 || value > doubleMaxM)
+        doubleMaxM = value;
+    doubleSumM += value;
+    doubleValuesM.push_back(value);
+    ++countM;
+}
+
+size_t SelectionAggregate::getDistinctCount()
+{
+    sortValues();
+    return exactM ? valuesM.size() : doubleValuesM.size();
+}
+
+std::string SelectionAggregate::getSum() const
+{
+    if (countM == 0)
+        return std::string();
+    return exactM ? formatInt128(sumM, scaleM) : formatDouble(doubleSumM);
+}
+
+std::string SelectionAggregate::getMin() const
+{
+    if (countM == 0)
+        return std::string();
+    return exactM ? formatInt128(minM, scaleM) : formatDouble(doubleMinM);
+}
+
+std::string SelectionAggregate::getMax() const
+{
+    if (countM == 0)
+        return std::string();
+    return exactM ? formatInt128(maxM, scaleM) : formatDouble(doubleMaxM);
+}
+
+std::string SelectionAggregate::getAverage() const
+{
+    if (countM == 0)
+        return std::string();
+    double sum = exactM ? sumM.AsDouble(scaleM) : doubleSumM;
+    return formatDouble(sum / double(countM));
+}
+
+void normalizeRowRanges(RowRanges& ranges)
+{
+    if (ranges.empty())
+        return;
+    std::sort(ranges.begin(), ranges.end());
+    size_t last = 0;
+    for (size_t i = 1; i < ranges.size(); ++i)
+    {
+        if (ranges[i].first <= ranges[last].second + 1)
+        {
+            ranges[last].second = std::max(ranges[last].second,
+                ranges[i].second);
+        }
+        else
+            ranges[++last] = ranges[i];
+    }
+    ranges.resize(last + 1);
+}
+
+bool subtractRowRanges(const RowRanges& ranges, const RowRanges& subset,
+    RowRanges& difference)
+{
+    difference.clear();
+    size_t j = 0;
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        int first = ranges[i].first;
+        for (; j < subset.size() && subset[j].first <= ranges[i].second; ++j)
+        {
+            if (subset[j].first < first || subset[j].second > ranges[i].second)
+                return false;
+            if (subset[j].first > first)
+            {
+                difference.push_back(std::make_pair(first,
+                    subset[j].first - 1));
+            }
+            first = subset[j].second + 1;
+        }
+        if (first <= ranges[i].second)
+            difference.push_back(std::make_pair(first, ranges[i].second));
+    }
+    return j == subset.size();
+}
@@ -0,0 +1,85 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_SELECTIONAGGREGATE_H
+#define FR_SELECTIONAGGREGATE_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ibpp.h>
+
+// Count, sum, minimum, maximum, average and number of distinct values of
+// the numbers added. Exact numerics (integers and scaled NUMERIC and
+// DECIMAL values) are kept as 128 bit integers with the largest scale added
+// so far, so their sum is exact. Adding a floating point value turns the
+// whole aggregate into floating point.
+class SelectionAggregate
+{
+private:
+    int64_t countM;
+    bool exactM;
+    int scaleM;
+    IBPP::Int128 sumM, minM, maxM;
+    double doubleSumM, doubleMinM, doubleMaxM;
+    // the values for the distinct count, only the first sortedM of them
+    // are sorted and unique
+    std::vector<IBPP::Int128> valuesM;
+    std::vector<double> doubleValuesM;
+    size_t sortedM;
+
+    void rescale(int scale);
+    void makeInexact();
+    void sortValues();
+public:
+    SelectionAggregate();
+
+    void clear();
+    void add(int64_t value);
+    void add(const IBPP::Int128& value, int scale);
+    // a value of a scaled column that is stored as double
+    void addScaled(double value, int scale);
+    void add(double value);
+
+    int64_t getCount() const { return countM; }
+    bool isExact() const { return exactM; }
+    size_t getDistinctCount();
+    // the results as text, empty when nothing has been added
+    std::string getSum() const;
+    std::string getMin() const;
+    std::string getMax() const;
+    std::string getAverage() const;
+};
+
+// Sorted, non-overlapping ranges [first, last] of grid rows.
+typedef std::vector<std::pair<int, int> > RowRanges;
+
+// sorts the ranges and merges those that overlap or touch
+void normalizeRowRanges(RowRanges& ranges);
+// returns false if subset has rows that aren't in ranges, otherwise puts the
+// rows of ranges that aren't in subset into difference
+bool subtractRowRanges(const RowRanges& ranges, const RowRanges& subset,
+    RowRanges& difference);
+
+#endif // FR_SELECTIONAGGREGATE_H
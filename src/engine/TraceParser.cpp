@@ -0,0 +1,466 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#include "engine/TraceParser.h"
+
+// a line without line break this long is processed anyway
+static const std::string::size_type maxLineLength = 65536;
+
+static std::string trim(const std::string& s)
+{
+    std::string::size_type start = s.find_first_not_of(" \t\r");
+    if (start == std::string::npos)
+        return std::string();
+    std::string::size_type end = s.find_last_not_of(" \t\r");
+    return s.substr(start, end - start + 1);
+}
+
+static bool startsWith(const std::string& s, const char* prefix)
+{
+    return s.compare(0, strlen(prefix), prefix) == 0;
+}
+
+static bool consistsOf(const std::string& s, char c)
+{
+    return !s.empty() && s.find_first_not_of(c) == std::string::npos;
+}
+
+static int64_t toInt64(const std::string& s)
+{
+    int64_t value = 0;
+    for (std::string::size_type i = 0; i < s.size(); i++)
+    {
+        if (s[i] < '0' || s[i] > '9')
+            break;
+        value = value * 10 + (s[i] - '0');
+    }
+    return value;
+}
+
+// event headers start with a timestamp like "2016-05-12T10:20:30.1230"
+static bool isEventHeader(const std::string& line)
+{
+    return line.size() >= 19 && isdigit((unsigned char)line[0])
+        && line[4] == '-' && line[7] == '-' && line[10] == 'T'
+        && line[13] == ':' && line[16] == ':';
+}
+
+// "0 ms, 5 read(s), 2 write(s), 12 fetch(es), 1 mark(s)"
+static bool parsePerformance(const std::string& line,
+    TraceStatementEvent& event)
+{
+    std::string text(trim(line));
+    if (text.empty() || !isdigit((unsigned char)text[0])
+        || text.find(" ms") == std::string::npos)
+    {
+        return false;
+    }
+    std::string::size_type pos = 0;
+    while (pos < text.size())
+    {
+        std::string::size_type end = text.find(',', pos);
+        if (end == std::string::npos)
+            end = text.size();
+        std::string item(trim(text.substr(pos, end - pos)));
+        std::string::size_type space = item.find(' ');
+        if (space != std::string::npos)
+        {
+            int64_t value = toInt64(item);
+            std::string unit(item.substr(space + 1));
+            if (unit == "ms")
+                event.elapsedMillis = value;
+            else if (startsWith(unit, "read"))
+                event.reads = value;
+            else if (startsWith(unit, "write"))
+                event.writes = value;
+            else if (startsWith(unit, "fetch"))
+                event.fetches = value;
+            else if (startsWith(unit, "mark"))
+                event.marks = value;
+        }
+        pos = end + 1;
+    }
+    return true;
+}
+
+// collapses all whitespace, so that the same statement with a different
+// layout is aggregated together
+static std::string normalizeSql(const std::string& sql, size_t maxLength)
+{
+    std::string result;
+    bool space = false;
+    for (std::string::size_type i = 0; i < sql.size(); i++)
+    {
+        char c = sql[i];
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+        {
+            space = !result.empty();
+            continue;
+        }
+        if (space)
+            result += ' ';
+        space = false;
+        result += c;
+        if (result.size() >= maxLength)
+            break;
+    }
+    return result;
+}
+
+// TraceStatementEvent
+void TraceStatementEvent::clear()
+{
+    timestamp.clear();
+    eventType.clear();
+    statementId = 0;
+    sql.clear();
+    plan.clear();
+    records = 0;
+    elapsedMillis = 0;
+    reads = 0;
+    writes = 0;
+    fetches = 0;
+    marks = 0;
+    tables.clear();
+}
+
+// TraceStatistics
+TraceStatistics::TraceStatistics(size_t maxStatements, size_t maxSqlLength)
+    : maxStatementsM(maxStatements > 0 ? maxStatements : 1),
+        maxSqlLengthM(maxSqlLength), eventCountM(0), droppedCountM(0),
+        changedM(false)
+{
+}
+
+void TraceStatistics::add(const TraceStatementEvent& event)
+{
+    ++eventCountM;
+    changedM = true;
+
+    std::string sql(normalizeSql(event.sql, maxSqlLengthM));
+    StatsMap::iterator it = statsM.find(sql);
+    if (it == statsM.end())
+    {
+        if (statsM.size() >= maxStatementsM)
+            dropLeastExpensive();
+        TraceStatementStats stats = { sql, std::string(), 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0 };
+        it = statsM.insert(StatsMap::value_type(sql, stats)).first;
+    }
+
+    TraceStatementStats& stats = (*it).second;
+    if (!event.plan.empty())
+        stats.plan = event.plan;
+    stats.count++;
+    stats.totalMillis += event.elapsedMillis;
+    stats.maxMillis = std::max(stats.maxMillis, event.elapsedMillis);
+    stats.records += event.records;
+    stats.reads += event.reads;
+    stats.writes += event.writes;
+    stats.fetches += event.fetches;
+    stats.marks += event.marks;
+    for (size_t i = 0; i < event.tables.size(); i++)
+    {
+        stats.naturalReads += event.tables[i].naturalReads;
+        stats.indexReads += event.tables[i].indexReads;
+    }
+}
+
+void TraceStatistics::dropLeastExpensive()
+{
+    StatsMap::iterator least = statsM.begin();
+    for (StatsMap::iterator it = statsM.begin(); it != statsM.end(); ++it)
+    {
+        if ((*it).second.totalMillis < (*least).second.totalMillis)
+            least = it;
+    }
+    if (least != statsM.end())
+    {
+        statsM.erase(least);
+        ++droppedCountM;
+    }
+}
+
+void TraceStatistics::clear()
+{
+    statsM.clear();
+    eventCountM = 0;
+    droppedCountM = 0;
+    changedM = true;
+}
+
+static bool isMoreExpensive(const TraceStatementStats* left,
+    const TraceStatementStats* right)
+{
+    return left->totalMillis > right->totalMillis;
+}
+
+void TraceStatistics::getTopStatements(
+    std::vector<TraceStatementStats>& stats, size_t count) const
+{
+    std::vector<const TraceStatementStats*> all;
+    all.reserve(statsM.size());
+    for (StatsMap::const_iterator it = statsM.begin(); it != statsM.end();
+        ++it)
+    {
+        all.push_back(&(*it).second);
+    }
+    count = std::min(count, all.size());
+    std::partial_sort(all.begin(), all.begin() + count, all.end(),
+        isMoreExpensive);
+
+    stats.clear();
+    for (size_t i = 0; i < count; i++)
+        stats.push_back(*all[i]);
+}
+
+bool TraceStatistics::checkChanged()
+{
+    bool changed = changedM;
+    changedM = false;
+    return changed;
+}
+
+// TraceParser
+TraceParser::TraceParser(TraceStatistics& statistics)
+    : statisticsM(statistics), sectionM(secNone)
+{
+    eventM.clear();
+}
+
+void TraceParser::feed(const std::string& chunk)
+{
+    std::string::size_type pos = 0;
+    while (pos < chunk.size())
+    {
+        std::string::size_type eol = chunk.find('\n', pos);
+        if (eol == std::string::npos)
+        {
+            partialLineM.append(chunk, pos, std::string::npos);
+            if (partialLineM.size() > maxLineLength)
+            {
+                processLine(partialLineM);
+                partialLineM.clear();
+            }
+            break;
+        }
+        if (partialLineM.empty())
+            processLine(chunk.substr(pos, eol - pos));
+        else
+        {
+            partialLineM.append(chunk, pos, eol - pos);
+            processLine(partialLineM);
+            partialLineM.clear();
+        }
+        pos = eol + 1;
+    }
+}
+
+void TraceParser::flush()
+{
+    if (!partialLineM.empty())
+    {
+        processLine(partialLineM);
+        partialLineM.clear();
+    }
+    finishEvent();
+}
+
+void TraceParser::finishEvent()
+{
+    if (sectionM != secNone && eventM.eventType == "EXECUTE_STATEMENT_FINISH"
+        && !eventM.sql.empty())
+    {
+        statisticsM.add(eventM);
+    }
+    eventM.clear();
+    sectionM = secNone;
+}
+
+void TraceParser::processLine(const std::string& rawLine)
+{
+    std::string line(rawLine);
+    if (!line.empty() && line[line.size() - 1] == '\r')
+        line.erase(line.size() - 1);
+
+    // "2016-05-12T10:20:30.1230 (1234:0x7f12) EXECUTE_STATEMENT_FINISH"
+    if (isEventHeader(line))
+    {
+        finishEvent();
+        sectionM = secHeader;
+        std::string::size_type space = line.find(' ');
+        eventM.timestamp = line.substr(0, space);
+        std::string::size_type paren = line.rfind(')');
+        eventM.eventType = trim(line.substr(paren == std::string::npos
+            ? space : paren + 1));
+        return;
+    }
+
+    switch (sectionM)
+    {
+        case secNone:
+            break;
+        case secHeader:
+            // "Statement 123:"
+            if (startsWith(line, "Statement ")
+                && line[line.size() - 1] == ':')
+            {
+                eventM.statementId = toInt64(line.substr(10));
+                sectionM = secSqlStart;
+            }
+            break;
+        case secSqlStart:
+            if (consistsOf(line, '-'))
+                sectionM = secSql;
+            break;
+        case secSql:
+            // parameter values follow a line of carets
+            if (consistsOf(line, '^'))
+                sectionM = secParams;
+            else if (!processBodyLine(line))
+            {
+                if (!eventM.sql.empty())
+                    eventM.sql += '\n';
+                eventM.sql += line;
+            }
+            break;
+        case secParams:
+            processBodyLine(line);
+            break;
+        case secBody:
+            processBodyLine(line);
+            break;
+        case secTableHeader:
+            if (consistsOf(line, '*'))
+                sectionM = secTables;
+            break;
+        case secTables:
+            if (trim(line).empty())
+                sectionM = secBody;
+            else
+                parseTableRow(line);
+            break;
+    }
+}
+
+// handles the lines following the statement text, returns false when
+// the line is none of them
+bool TraceParser::processBodyLine(const std::string& line)
+{
+    if (startsWith(line, "PLAN"))
+    {
+        if (!eventM.plan.empty())
+            eventM.plan += '\n';
+        eventM.plan += line;
+        sectionM = secBody;
+        return true;
+    }
+    // "12 records fetched"
+    std::string::size_type pos = line.find(" records fetched");
+    if (pos != std::string::npos && pos > 0 && isdigit((unsigned char)line[0]))
+    {
+        eventM.records = toInt64(line);
+        sectionM = secBody;
+        return true;
+    }
+    if (parsePerformance(line, eventM))
+    {
+        sectionM = secBody;
+        return true;
+    }
+    // "Table          Natural     Index    Update ..."
+    if (sectionM != secSql && startsWith(line, "Table ")
+        && line.find("Natural") != std::string::npos)
+    {
+        // the counters are right aligned to the column titles
+        tableColumnEndsM.clear();
+        pos = line.find(' ');
+        while (pos != std::string::npos)
+        {
+            std::string::size_type start = line.find_first_not_of(' ', pos);
+            if (start == std::string::npos)
+                break;
+            pos = line.find(' ', start);
+            tableColumnEndsM.push_back(pos == std::string::npos
+                ? line.size() : pos);
+        }
+        sectionM = secTableHeader;
+        return true;
+    }
+    return false;
+}
+
+void TraceParser::parseTableRow(const std::string& line)
+{
+    if (tableColumnEndsM.empty())
+        return;
+
+    // counters of zero are left empty, so every value has to be assigned
+    // to the column whose title it is aligned to
+    std::vector<int64_t> values(tableColumnEndsM.size(), 0);
+    std::string::size_type nameEnd = line.size();
+    std::string::size_type pos = line.size();
+    while (pos > 0)
+    {
+        std::string::size_type end = line.find_last_not_of(' ', pos - 1);
+        if (end == std::string::npos)
+            break;
+        std::string::size_type start = line.find_last_of(' ', end);
+        start = (start == std::string::npos) ? 0 : start + 1;
+        std::string token(line.substr(start, end - start + 1));
+        if (token.find_first_not_of("0123456789") != std::string::npos)
+            break;
+
+        std::vector<std::string::size_type>::const_iterator col =
+            std::find(tableColumnEndsM.begin(), tableColumnEndsM.end(),
+                end + 1);
+        if (col == tableColumnEndsM.end())
+            break;
+        values[col - tableColumnEndsM.begin()] = toInt64(token);
+        nameEnd = start;
+        pos = start;
+    }
+
+    TraceTableCounts counts;
+    counts.table = trim(line.substr(0, nameEnd));
+    int64_t* fields[] = { &counts.naturalReads, &counts.indexReads,
+        &counts.updates, &counts.inserts, &counts.deletes, &counts.backouts,
+        &counts.purges, &counts.expunges };
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+        *fields[i] = (i < values.size()) ? values[i] : 0;
+    eventM.tables.push_back(counts);
+}
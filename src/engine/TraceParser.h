@@ -0,0 +1,143 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_TRACEPARSER_H
+#define FR_TRACEPARSER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <ibpp.h>
+
+struct TraceTableCounts
+{
+    std::string table;
+    int64_t naturalReads;
+    int64_t indexReads;
+    int64_t updates;
+    int64_t inserts;
+    int64_t deletes;
+    int64_t backouts;
+    int64_t purges;
+    int64_t expunges;
+};
+
+// one statement related event of the trace output
+struct TraceStatementEvent
+{
+    std::string timestamp;
+    std::string eventType;
+    int64_t statementId;
+    std::string sql;
+    std::string plan;
+    int64_t records;
+    int64_t elapsedMillis;
+    int64_t reads;
+    int64_t writes;
+    int64_t fetches;
+    int64_t marks;
+    std::vector<TraceTableCounts> tables;
+
+    void clear();
+};
+
+// statistics of all executions of one statement text
+struct TraceStatementStats
+{
+    std::string sql;
+    std::string plan;
+    int64_t count;
+    int64_t totalMillis;
+    int64_t maxMillis;
+    int64_t records;
+    int64_t reads;
+    int64_t writes;
+    int64_t fetches;
+    int64_t marks;
+    int64_t naturalReads;
+    int64_t indexReads;
+};
+
+// Aggregates finished statements by their text. The number of distinct
+// statements is limited, when it is reached the statement with the least
+// total time is dropped, so that a long running session can't use up
+// all the memory.
+class TraceStatistics
+{
+private:
+    typedef std::map<std::string, TraceStatementStats> StatsMap;
+    StatsMap statsM;
+    size_t maxStatementsM;
+    size_t maxSqlLengthM;
+    int64_t eventCountM;
+    int64_t droppedCountM;
+    bool changedM;
+
+    void dropLeastExpensive();
+public:
+    TraceStatistics(size_t maxStatements = 1000, size_t maxSqlLength = 8192);
+
+    void add(const TraceStatementEvent& event);
+    void clear();
+
+    // the statements with the highest total time, most expensive first
+    void getTopStatements(std::vector<TraceStatementStats>& stats,
+        size_t count) const;
+    size_t getStatementCount() const { return statsM.size(); }
+    int64_t getEventCount() const { return eventCountM; }
+    int64_t getDroppedCount() const { return droppedCountM; }
+
+    // returns whether statements were added since the last call
+    bool checkChanged();
+};
+
+// Parses trace output as it arrives, the chunks can end anywhere in
+// a line. Only the EXECUTE_STATEMENT_FINISH events are passed on to the
+// statistics, other events are skipped.
+class TraceParser
+{
+private:
+    enum Section { secNone, secHeader, secSqlStart, secSql, secParams,
+        secBody, secTableHeader, secTables };
+
+    TraceStatistics& statisticsM;
+    std::string partialLineM;
+    Section sectionM;
+    TraceStatementEvent eventM;
+    // end positions of the columns of the per-table counters
+    std::vector<std::string::size_type> tableColumnEndsM;
+
+    void processLine(const std::string& line);
+    bool processBodyLine(const std::string& line);
+    void parseTableRow(const std::string& line);
+    void finishEvent();
+public:
+    TraceParser(TraceStatistics& statistics);
+
+    void feed(const std::string& chunk);
+    // processes the pending partial line and event, when the output ends
+    void flush();
+};
+
+#endif // FR_TRACEPARSER_H
@@ -32,6 +32,7 @@
 
 #include <wx/datetime.h>
 #include <wx/filename.h>
+#include <wx/spinctrl.h>
 
 #include <algorithm>
 
@@ -39,6 +40,7 @@
 
 #include "core/StringUtils.h"
 #include "config/Config.h"
+#include "engine/BackupStream.h"
 #include "gui/BackupFrame.h"
 #include "gui/controls/DndTextControls.h"
 #include "gui/controls/LogTextControl.h"
@@ -48,11 +50,11 @@
 #include "metadata/server.h"
 
 // worker thread class to perform database backup
-class BackupThread: public wxThread {
+class BackupThread: public wxThread, public BackupStreamProgress {
 public:
     BackupThread(BackupFrame* frame, wxString server, wxString username,
         wxString password, wxString dbfilename, wxString bkfilename,
-        IBPP::BRF flags);
+        IBPP::BRF flags, bool stream, bool compress, int parallelWorkers);
 
     virtual void* Entry();
     virtual void OnExit();
@@ -64,6 +66,14 @@ private:
     wxString dbfileM;
     wxString bkfileM;
     IBPP::BRF brfM;
+    bool streamM;
+    bool compressM;
+    int parallelWorkersM;
+    wxLongLong streamStartMillisM;
+    wxLongLong streamReportMillisM;
+    bool streamBackup(IBPP::Service& svc);
+    virtual bool isBackupCanceled();
+    virtual void backupReceived(const wxULongLong& bytes, bool finished);
     void logError(wxString& msg);
     void logImportant(wxString& msg);
     void logProgress(wxString& msg);
@@ -71,7 +81,8 @@ private:
 
 BackupThread::BackupThread(BackupFrame* frame, wxString server,
         wxString username, wxString password, wxString dbfilename,
-        wxString bkfilename, IBPP::BRF flags)
+        wxString bkfilename, IBPP::BRF flags, bool stream, bool compress,
+        int parallelWorkers)
     : wxThread()
 {
     frameM = frame;
@@ -82,6 +93,9 @@ BackupThread::BackupThread(BackupFrame* frame, wxString server,
     bkfileM = bkfilename;
     // always use verbose flag
     brfM = (IBPP::BRF)((int)flags | (int)IBPP::brVerbose);
+    streamM = stream;
+    compressM = compress;
+    parallelWorkersM = parallelWorkers;
 }
 
 void* BackupThread::Entry()
@@ -97,6 +111,13 @@ void* BackupThread::Entry()
             wx2std(usernameM), wx2std(passwordM));
         svc->Connect();
 
+        if (streamM)
+        {
+            streamBackup(svc);
+            svc->Disconnect();
+            return 0;
+        }
+
         now = wxDateTime::Now();
         msg.Printf(_("Database backup started %s"), now.FormatTime().c_str());
         logImportant(msg);
@@ -143,6 +164,85 @@ void* BackupThread::Entry()
     return 0;
 }
 
+// reads the backup from the service output and writes it to the local
+// file, gzip compressed if requested
+bool BackupThread::streamBackup(IBPP::Service& svc)
+{
+    wxDateTime now;
+    wxString msg;
+
+    int workers = parallelWorkersM;
+    if (workers > 0)
+    {
+        std::string version;
+        svc->GetVersion(version);
+        if (BackupRestoreBaseFrame::getServerMajorVersion(version) < 5)
+        {
+            msg = _("Parallel workers need Firebird 5, the backup runs in a single thread");
+            logImportant(msg);
+            workers = 0;
+        }
+    }
+
+    now = wxDateTime::Now();
+    msg.Printf(_("Database backup to local file started %s"),
+        now.FormatTime().c_str());
+    logImportant(msg);
+    svc->StartBackupStream(wx2std(dbfileM), brfM, workers);
+
+    streamStartMillisM = ::wxGetLocalTimeMillis();
+    streamReportMillisM = streamStartMillisM;
+    wxULongLong written;
+    switch (receiveBackupStream(svc, bkfileM, compressM, *this, written))
+    {
+        case bsCreateFailed:
+            msg.Printf(_("Could not create the backup file \"%s\""),
+                bkfileM.c_str());
+            logError(msg);
+            return false;
+        case bsWriteFailed:
+            msg.Printf(_("Database backup canceled, writing to \"%s\" failed"),
+                bkfileM.c_str());
+            logError(msg);
+            return false;
+        case bsCanceled:
+            now = wxDateTime::Now();
+            msg.Printf(_("Database backup canceled %s"),
+                now.FormatTime().c_str());
+            logImportant(msg);
+            return false;
+        case bsFinished:
+            break;
+    }
+
+    now = wxDateTime::Now();
+    msg.Printf(_("Database backup finished %s, %s written to \"%s\""),
+        now.FormatTime().c_str(),
+        wxFileName::GetHumanReadableSize(written).c_str(),
+        bkfileM.c_str());
+    logImportant(msg);
+    return true;
+}
+
+bool BackupThread::isBackupCanceled()
+{
+    return TestDestroy();
+}
+
+void BackupThread::backupReceived(const wxULongLong& bytes, bool finished)
+{
+    wxLongLong nowMillis = ::wxGetLocalTimeMillis();
+    if (finished || nowMillis - streamReportMillisM >= 1000)
+    {
+        streamReportMillisM = nowMillis;
+        wxString msg;
+        msg.Printf(_("%s received"),
+            BackupRestoreBaseFrame::formatTransferProgress(bytes,
+                nowMillis - streamStartMillisM).c_str());
+        logProgress(msg);
+    }
+}
+
 void BackupThread::OnExit()
 {
     if (frameM != 0)
@@ -213,12 +313,23 @@ void BackupFrame::createControls()
     checkbox_extern = new wxCheckBox(panel_controls, wxID_ANY,
         _("Convert external tables"));
 
+    checkbox_stream = new wxCheckBox(panel_controls, ID_checkbox_stream,
+        _("Transfer to local file"));
+    checkbox_compress = new wxCheckBox(panel_controls, wxID_ANY,
+        _("Compress (gzip)"));
+    label_workers = new wxStaticText(panel_controls, wxID_ANY,
+        _("Parallel workers:"));
+    spinctrl_workers = new wxSpinCtrl(panel_controls, wxID_ANY, "0",
+        wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 0, 64, 0);
+    spinctrl_workers->SetToolTip(
+        _("Number of parallel workers (Firebird 5), 0 for the server default"));
+
     checkbox_showlog = new wxCheckBox(panel_controls, ID_checkbox_showlog,
         _("Show complete log"));
     button_start = new wxButton(panel_controls, ID_button_start,
         _("&Start Backup"));
 
-    text_ctrl_log = new LogTextControl(this, ID_text_ctrl_log);
+    createLogControls();
 }
 
 void BackupFrame::layoutControls()
@@ -243,6 +354,15 @@ void BackupFrame::layoutControls()
     sizerChecks->Add(checkbox_transport, 0, wxEXPAND);
     sizerChecks->Add(checkbox_extern, 0, wxEXPAND);
 
+    wxBoxSizer* sizerStream = new wxBoxSizer(wxHORIZONTAL);
+    sizerStream->Add(checkbox_stream, 0, wxALIGN_CENTER_VERTICAL);
+    sizerStream->Add(styleguide().getUnrelatedControlMargin(wxHORIZONTAL), 0);
+    sizerStream->Add(checkbox_compress, 0, wxALIGN_CENTER_VERTICAL);
+    sizerStream->Add(styleguide().getUnrelatedControlMargin(wxHORIZONTAL), 0);
+    sizerStream->Add(label_workers, 0, wxALIGN_CENTER_VERTICAL);
+    sizerStream->Add(styleguide().getControlLabelMargin(), 0);
+    sizerStream->Add(spinctrl_workers, 0, wxALIGN_CENTER_VERTICAL);
+
     wxBoxSizer* sizerButtons = new wxBoxSizer(wxHORIZONTAL);
     sizerButtons->Add(checkbox_showlog, 0, wxALIGN_CENTER_VERTICAL);
     sizerButtons->Add(0, 0, 1, wxEXPAND);
@@ -253,6 +373,8 @@ void BackupFrame::layoutControls()
     sizerPanelV->Add(sizerFilename, 0, wxEXPAND);
     sizerPanelV->Add(0, styleguide().getRelatedControlMargin(wxVERTICAL));
     sizerPanelV->Add(sizerChecks);
+    sizerPanelV->Add(0, styleguide().getRelatedControlMargin(wxVERTICAL));
+    sizerPanelV->Add(sizerStream);
     sizerPanelV->Add(0, styleguide().getUnrelatedControlMargin(wxVERTICAL));
     sizerPanelV->Add(sizerButtons, 0, wxEXPAND);
     sizerPanelV->Add(0, styleguide().getRelatedControlMargin(wxVERTICAL));
@@ -264,7 +386,7 @@ void BackupFrame::layoutControls()
 
     wxBoxSizer* sizerMain = new wxBoxSizer(wxVERTICAL);
     sizerMain->Add(panel_controls, 0, wxEXPAND);
-    sizerMain->Add(text_ctrl_log, 1, wxEXPAND);
+    sizerMain->Add(layoutLogControls(), 1, wxEXPAND);
 
     // show at least 3 lines of text since it is default size too
     sizerMain->SetItemMinSize(text_ctrl_log,
@@ -283,6 +405,11 @@ void BackupFrame::updateControls()
     checkbox_garbage->Enable(!running);
     checkbox_transport->Enable(!running);
     checkbox_extern->Enable(!running);
+    checkbox_stream->Enable(!running);
+    bool stream = checkbox_stream->IsChecked();
+    checkbox_compress->Enable(!running && stream);
+    label_workers->Enable(!running && stream);
+    spinctrl_workers->Enable(!running && stream);
     button_start->Enable(!running && !text_ctrl_filename->GetValue().empty());
 }
 
@@ -305,6 +432,16 @@ void BackupFrame::doReadConfigSettings(const wxString& prefix)
             flags.end() != std::find(flags.begin(), flags.end(), "no_transportable"));
         checkbox_extern->SetValue(
             flags.end() != std::find(flags.begin(), flags.end(), "external_tables"));
+        checkbox_stream->SetValue(
+            flags.end() != std::find(flags.begin(), flags.end(), "stream_local"));
+        checkbox_compress->SetValue(
+            flags.end() != std::find(flags.begin(), flags.end(), "compress"));
+    }
+    int workers = 0;
+    if (config().getValue(prefix + Config::pathSeparator + "parallel_workers",
+        workers))
+    {
+        spinctrl_workers->SetValue(workers);
     }
     updateControls();
 }
@@ -325,7 +462,13 @@ void BackupFrame::doWriteConfigSettings(const wxString& prefix) const
         flags.push_back("no_transportable");
     if (checkbox_extern->IsChecked())
         flags.push_back("external_tables");
+    if (checkbox_stream->IsChecked())
+        flags.push_back("stream_local");
+    if (checkbox_compress->IsChecked())
+        flags.push_back("compress");
     config().setValue(prefix + Config::pathSeparator + "options", flags);
+    config().setValue(prefix + Config::pathSeparator + "parallel_workers",
+        spinctrl_workers->GetValue());
 }
 
 const wxString BackupFrame::getName() const
@@ -354,14 +497,20 @@ BackupFrame* BackupFrame::findFrameFor(DatabasePtr db)
 BEGIN_EVENT_TABLE(BackupFrame, BackupRestoreBaseFrame)
     EVT_BUTTON(BackupRestoreBaseFrame::ID_button_browse, BackupFrame::OnBrowseButtonClick)
     EVT_BUTTON(BackupRestoreBaseFrame::ID_button_start, BackupFrame::OnStartButtonClick)
+    EVT_CHECKBOX(BackupFrame::ID_checkbox_stream, BackupFrame::OnStreamCheckboxClick)
 END_EVENT_TABLE()
 
 void BackupFrame::OnBrowseButtonClick(wxCommandEvent& WXUNUSED(event))
 {
     wxFileName origName(text_ctrl_filename->GetValue());
+    bool compressed = checkbox_stream->IsChecked()
+        && checkbox_compress->IsChecked();
     wxString filename = ::wxFileSelector(_("Select Backup File"),
-        origName.GetPath(), origName.GetFullName(), "*.fbk",
-        _("Backup file (*.fbk)|*.fbk|All files (*.*)|*.*"),
+        origName.GetPath(), origName.GetFullName(),
+        compressed ? "*.fbk.gz" : "*.fbk",
+        compressed
+            ? _("Compressed backup file (*.fbk.gz)|*.fbk.gz|All files (*.*)|*.*")
+            : _("Backup file (*.fbk)|*.fbk|All files (*.*)|*.*"),
         wxFD_SAVE | wxFD_OVERWRITE_PROMPT, this);
     if (!filename.empty())
         text_ctrl_filename->SetValue(filename);
@@ -401,8 +550,14 @@ void BackupFrame::OnStartButtonClick(wxCommandEvent& WXUNUSED(event))
     std::auto_ptr<wxThread> thread(new BackupThread(this,
         server->getConnectionString(), username, password,
         database->getPath(), text_ctrl_filename->GetValue(),
-        (IBPP::BRF)flags));
+        (IBPP::BRF)flags, checkbox_stream->IsChecked(),
+        checkbox_compress->IsChecked(), spinctrl_workers->GetValue()));
     startThread(thread);
     updateControls();
 }
 
+void BackupFrame::OnStreamCheckboxClick(wxCommandEvent& WXUNUSED(event))
+{
+    updateControls();
+}
+
@@ -26,6 +26,7 @@
 #define BACKUPFRAME_H
 
 #include <wx/wx.h>
+#include <wx/spinctrl.h>
 
 #include "BackupRestoreBaseFrame.h"
 
@@ -40,6 +41,10 @@ private:
     wxCheckBox* checkbox_garbage;
     wxCheckBox* checkbox_transport;
     wxCheckBox* checkbox_extern;
+    wxCheckBox* checkbox_stream;
+    wxCheckBox* checkbox_compress;
+    wxStaticText* label_workers;
+    wxSpinCtrl* spinctrl_workers;
     void createControls();
     void layoutControls();
     virtual void updateControls();
@@ -55,8 +60,13 @@ public:
     static BackupFrame* findFrameFor(DatabasePtr db);
 private:
     // event handling
+    enum {
+        ID_checkbox_stream = 201
+    };
+
     void OnBrowseButtonClick(wxCommandEvent& event);
     void OnStartButtonClick(wxCommandEvent& event);
+    void OnStreamCheckboxClick(wxCommandEvent& event);
 
     DECLARE_EVENT_TABLE()
 };
@@ -30,9 +30,12 @@
     #include "wx/wx.h"
 #endif
 
+#include <wx/filename.h>
 #include <wx/timer.h>
 #include <wx/wupdlock.h>
 
+#include <algorithm>
+
 #include "config/Config.h"
 #include "core/ArtProvider.h"
 #include "gui/BackupRestoreBaseFrame.h"
@@ -41,14 +44,19 @@
 #include "metadata/database.h"
 #include "metadata/server.h"
 
+// the log shows at most this many of the most recent messages
+static const size_t maxShownMsgs = 5000;
+// rate at which new messages and the table progress are shown
+static const int outputFramesPerSecond = 10;
+
 BackupRestoreBaseFrame::BackupRestoreBaseFrame(wxWindow* parent,
         DatabasePtr db)
-    : BaseFrame(parent, wxID_ANY, wxEmptyString), databaseM(db), threadM(0)
+    : BaseFrame(parent, wxID_ANY, wxEmptyString), databaseM(db), threadM(0),
+        threadMsgsM(16384), droppedMsgsM(0), timerM(this, ID_timer_output)
 {
     wxASSERT(db);
     db->attachObserver(this, false);
 
-    threadMsgTimeMillisM = 0;
     verboseMsgsM = true;
 
     // create controls in constructor of descendant class (correct tab order)
@@ -59,28 +67,12 @@ BackupRestoreBaseFrame::BackupRestoreBaseFrame(wxWindow* parent,
     checkbox_showlog = 0;
     button_start = 0;
     text_ctrl_log = 0;
+    listctrl_tables = 0;
 
     SetIcon(wxArtProvider::GetIcon(ART_Backup, wxART_FRAME_ICON));
 }
 
 //! implementation details
-void BackupRestoreBaseFrame::addThreadMsg(const wxString msg,
-    bool& notificationNeeded)
-{
-    notificationNeeded = false;
-    wxLongLong millisNow = ::wxGetLocalTimeMillis();
-
-    wxCriticalSectionLocker locker(critsectM);
-    threadMsgsM.Add(msg);
-    // we post no more than 10 events per second to prevent flooding of
-    // the message queue, and to keep the frame responsive for user interaction
-    if ((millisNow - threadMsgTimeMillisM).GetLo() > 100)
-    {
-        threadMsgTimeMillisM = millisNow;
-        notificationNeeded = true;
-    }
-}
-
 void BackupRestoreBaseFrame::cancelBackupRestore()
 {
     if (threadM != 0)
@@ -92,14 +84,46 @@ void BackupRestoreBaseFrame::cancelBackupRestore()
 
 void BackupRestoreBaseFrame::clearLog()
 {
-    msgKindsM.Clear();
-    msgsM.Clear();
+    msgsM.clear();
     text_ctrl_log->ClearAll();
+    progressM.clear();
+    listctrl_tables->DeleteAllItems();
+
+    // the complete log of every run goes to a new file
+    closeSpool();
+    spoolFileNameM = wxFileName::CreateTempFileName("frlog");
+    if (!spoolFileNameM.empty())
+        spoolM.Open(spoolFileNameM, "w");
+}
+
+void BackupRestoreBaseFrame::closeSpool()
+{
+    if (spoolM.IsOpened())
+        spoolM.Close();
+    if (!spoolFileNameM.empty())
+    {
+        ::wxRemoveFile(spoolFileNameM);
+        spoolFileNameM.clear();
+    }
+}
+
+void BackupRestoreBaseFrame::createLogControls()
+{
+    text_ctrl_log = new LogTextControl(this, ID_text_ctrl_log);
+
+    listctrl_tables = new wxListCtrl(this, wxID_ANY, wxDefaultPosition,
+        wxDefaultSize, wxLC_REPORT | wxLC_SINGLE_SEL);
+    listctrl_tables->InsertColumn(0, _("Table"));
+    listctrl_tables->InsertColumn(1, _("Rows"), wxLIST_FORMAT_RIGHT);
+    listctrl_tables->InsertColumn(2, _("Elapsed"), wxLIST_FORMAT_RIGHT);
+    listctrl_tables->InsertColumn(3, _("Rows/s"), wxLIST_FORMAT_RIGHT);
 }
 
 bool BackupRestoreBaseFrame::Destroy()
 {
     cancelBackupRestore();
+    timerM.Stop();
+    closeSpool();
     return BaseFrame::Destroy();
 }
 
@@ -128,11 +152,46 @@ void BackupRestoreBaseFrame::doWriteConfigSettings(const wxString& prefix) const
         text_ctrl_filename->GetValue());
 }
 
+/*static*/
+wxString BackupRestoreBaseFrame::formatTransferProgress(wxULongLong bytes,
+    wxLongLong millis)
+{
+    wxString total(wxFileName::GetHumanReadableSize(bytes));
+    if (millis <= 0)
+        return total;
+    double perSecond = bytes.ToDouble() * 1000.0 / millis.ToDouble();
+    return wxString::Format(_("%s (%s/s)"), total.c_str(),
+        wxFileName::GetHumanReadableSize(
+            wxULongLong(wxULongLong_t(perSecond))).c_str());
+}
+
 DatabasePtr BackupRestoreBaseFrame::getDatabase() const
 {
     return databaseM.lock();
 }
 
+/*static*/
+int BackupRestoreBaseFrame::getServerMajorVersion(const std::string& version)
+{
+    // version strings look like "WI-V5.0.0.1306 Firebird 5.0", the
+    // character before the number is V for releases and T for betas
+    std::string::size_type pos = version.find('-');
+    if (pos == std::string::npos || pos + 2 >= version.size())
+        return 0;
+    int major = 0;
+    for (pos += 2; pos < version.size() && isdigit(version[pos]); ++pos)
+        major = major * 10 + (version[pos] - '0');
+    return major;
+}
+
+wxSizer* BackupRestoreBaseFrame::layoutLogControls()
+{
+    wxBoxSizer* sizerLog = new wxBoxSizer(wxHORIZONTAL);
+    sizerLog->Add(text_ctrl_log, 2, wxEXPAND);
+    sizerLog->Add(listctrl_tables, 1, wxEXPAND);
+    return sizerLog;
+}
+
 const wxString BackupRestoreBaseFrame::getStorageName() const
 {
     if (DatabasePtr db = getDatabase())
@@ -152,6 +211,53 @@ void BackupRestoreBaseFrame::subjectRemoved(Subject* subject)
         Close();
 }
 
+void BackupRestoreBaseFrame::processThreadMsgs()
+{
+    size_t count = 0;
+    ThreadMsg msg;
+    while (threadMsgsM.pop(msg))
+    {
+        if (spoolM.IsOpened())
+        {
+            spoolM.Write(msg.text.data(), msg.text.size());
+            if (msg.text.empty() || msg.text[msg.text.size() - 1] != '\n')
+                spoolM.Write("\n", 1);
+        }
+        progressM.processLine(msg.text, msg.millis);
+
+        wxString s(wxString::FromUTF8(msg.text.c_str()));
+        // this depends on server type, so just in case...
+        if (s.empty() || s.Last() != '\n')
+            s.Append('\n');
+        msgsM.push_back(std::make_pair(msg.kind, s));
+        if (msgsM.size() > maxShownMsgs)
+            msgsM.pop_front();
+        ++count;
+    }
+    if (unsigned dropped = droppedMsgsM.exchange(0))
+    {
+        msgsM.push_back(std::make_pair(error_message, wxString::Format(
+            _("%u messages could not be shown in time and were skipped\n"),
+            dropped)));
+        ++count;
+    }
+
+    if (threadM != 0)
+        progressM.updateElapsed(::wxGetLocalTimeMillis().GetValue());
+    if (progressM.checkChanged())
+        updateTablesList();
+
+    if (count > 0)
+    {
+        // all new messages are added in one repaint, what doesn't fit
+        // into the control anyway is only written to the spool file
+        wxWindowUpdateLocker freeze(text_ctrl_log);
+        count = std::min(count, msgsM.size());
+        updateMessages(msgsM.size() - count, msgsM.size());
+        text_ctrl_log->discardOldLines(int(maxShownMsgs));
+    }
+}
+
 bool BackupRestoreBaseFrame::startThread(std::auto_ptr<wxThread> thread)
 {
     wxASSERT(threadM == 0);
@@ -168,33 +274,26 @@ bool BackupRestoreBaseFrame::startThread(std::auto_ptr<wxThread> thread)
         return false;
     }
     threadM = thread.release();
+    timerM.Start(1000 / outputFramesPerSecond);
     return true;
 }
 
 void BackupRestoreBaseFrame::threadOutputMsg(const wxString msg, MsgKind kind)
 {
-    wxString s(msg);
-    switch (kind)
+    ThreadMsg item;
+    item.kind = kind;
+    item.millis = ::wxGetLocalTimeMillis().GetValue();
+    item.text = msg.utf8_str();
+    // the worker waits a bit for the frame to catch up instead of growing
+    // the queue, but it doesn't stall the backup or restore for long
+    for (int i = 0; !threadMsgsM.push(item); ++i)
     {
-    case error_message:
-        s.Prepend("e");
-        break;
-    case important_message:
-        s.Prepend("i");
-        break;
-    case progress_message:
-        s.Prepend("p");
-        break;
-    default:
-        wxASSERT(false);
-        return;
-    }
-    bool doPostMsg = false;
-    addThreadMsg(s, doPostMsg);
-    if (doPostMsg)
-    {
-        wxCommandEvent event(wxEVT_COMMAND_MENU_SELECTED, ID_thread_output);
-        wxPostEvent(this, event);
+        if (i >= 100)
+        {
+            ++droppedMsgsM;
+            return;
+        }
+        ::wxMilliSleep(10);
     }
 }
 
@@ -216,31 +315,58 @@ void BackupRestoreBaseFrame::updateControls()
 
 void BackupRestoreBaseFrame::updateMessages(size_t firstmsg, size_t lastmsg)
 {
-    if (lastmsg > msgsM.GetCount())
-        lastmsg = msgsM.GetCount();
+    if (lastmsg > msgsM.size())
+        lastmsg = msgsM.size();
     for (size_t i = firstmsg; i < lastmsg; i++)
     {
-        switch ((MsgKind)msgKindsM[i])
+        switch (msgsM[i].first)
         {
             case progress_message:
                 if (verboseMsgsM)
-                    text_ctrl_log->logMsg(msgsM[i]);
+                    text_ctrl_log->logMsg(msgsM[i].second);
                 break;
             case important_message:
-                text_ctrl_log->logImportantMsg(msgsM[i]);
+                text_ctrl_log->logImportantMsg(msgsM[i].second);
                 break;
             case error_message:
-                text_ctrl_log->logErrorMsg(msgsM[i]);
+                text_ctrl_log->logErrorMsg(msgsM[i].second);
                 break;
         }
     }
 }
 
+void BackupRestoreBaseFrame::updateTablesList()
+{
+    const std::vector<BackupTableProgress>& tables = progressM.getTables();
+    wxWindowUpdateLocker freeze(listctrl_tables);
+    // rows are only ever added, the existing ones are updated in place
+    for (size_t i = 0; i < tables.size(); ++i)
+    {
+        const BackupTableProgress& t = tables[i];
+        long item = long(i);
+        if (item >= listctrl_tables->GetItemCount())
+        {
+            listctrl_tables->InsertItem(item,
+                wxString::FromUTF8(t.table.c_str()));
+        }
+        listctrl_tables->SetItem(item, 1,
+            wxString::Format("%" wxLongLongFmtSpec "d", wxLongLong_t(t.rows)));
+        listctrl_tables->SetItem(item, 2,
+            wxString::Format("%.1f s", t.elapsedMillis / 1000.0));
+        wxString rate;
+        if (t.finished && t.elapsedMillis > 0)
+            rate.Printf("%.0f", t.rows * 1000.0 / t.elapsedMillis);
+        listctrl_tables->SetItem(item, 3, rate);
+    }
+    if (!tables.empty())
+        listctrl_tables->EnsureVisible(long(tables.size()) - 1);
+}
+
 //! event handlers
 BEGIN_EVENT_TABLE(BackupRestoreBaseFrame, BaseFrame)
     EVT_CHECKBOX(BackupRestoreBaseFrame::ID_checkbox_showlog, BackupRestoreBaseFrame::OnVerboseLogChange)
     EVT_MENU(BackupRestoreBaseFrame::ID_thread_finished, BackupRestoreBaseFrame::OnThreadFinished)
-    EVT_MENU(BackupRestoreBaseFrame::ID_thread_output, BackupRestoreBaseFrame::OnThreadOutput)
+    EVT_TIMER(BackupRestoreBaseFrame::ID_timer_output, BackupRestoreBaseFrame::OnTimer)
     EVT_TEXT(BackupRestoreBaseFrame::ID_text_ctrl_filename, BackupRestoreBaseFrame::OnSettingsChange)
 END_EVENT_TABLE()
 
@@ -250,44 +376,24 @@ void BackupRestoreBaseFrame::OnSettingsChange(wxCommandEvent& WXUNUSED(event))
         updateControls();
 }
 
-void BackupRestoreBaseFrame::OnThreadFinished(wxCommandEvent& event)
+void BackupRestoreBaseFrame::OnThreadFinished(wxCommandEvent& WXUNUSED(event))
 {
     threadM = 0;
-    OnThreadOutput(event);
+    timerM.Stop();
+    processThreadMsgs();
+    if (spoolM.IsOpened())
+    {
+        spoolM.Flush();
+        text_ctrl_log->logMsg(wxString::Format(
+            _("Until this window is closed the complete log is available in \"%s\"\n"),
+            spoolFileNameM.c_str()));
+    }
     updateControls();
 }
 
-void BackupRestoreBaseFrame::OnThreadOutput(wxCommandEvent& WXUNUSED(event))
+void BackupRestoreBaseFrame::OnTimer(wxTimerEvent& WXUNUSED(event))
 {
-    wxCriticalSectionLocker locker(critsectM);
-    threadMsgTimeMillisM = ::wxGetLocalTimeMillis();
-
-    size_t first = msgsM.GetCount();
-    for (size_t i = 0; i < threadMsgsM.GetCount(); i++)
-    {
-        wxString s(threadMsgsM[i]);
-        if (s.Length() == 0)
-            continue;
-        switch ((wxChar)s[0])
-        {
-            case 'e':
-                msgKindsM.Add((int)error_message);
-                break;
-            case 'i':
-                msgKindsM.Add((int)important_message);
-                break;
-            case 'p':
-                msgKindsM.Add((int)progress_message);
-                break;
-        }
-        // this depends on server type, so just in case...
-        if (s.Last() != '\n')
-            s.Append('\n');
-        msgsM.Add(s.Mid(1));
-    }
-    threadMsgsM.Clear();
-
-    updateMessages(first, msgsM.GetCount());
+    processThreadMsgs();
 }
 
 void BackupRestoreBaseFrame::OnVerboseLogChange(wxCommandEvent& WXUNUSED(event))
@@ -298,6 +404,6 @@ void BackupRestoreBaseFrame::OnVerboseLogChange(wxCommandEvent& WXUNUSED(event))
     wxWindowUpdateLocker freeze(text_ctrl_log);
 
     text_ctrl_log->ClearAll();
-    updateMessages(0, msgsM.GetCount());
+    updateMessages(0, msgsM.size());
 }
 
@@ -26,11 +26,19 @@
 #define BACKUPRESTOREBASEFRAME_H
 
 #include <wx/wx.h>
+#include <wx/ffile.h>
+#include <wx/listctrl.h>
 #include <wx/thread.h>
+#include <wx/timer.h>
 
+#include <atomic>
+#include <deque>
 #include <memory>
+#include <string>
+#include <utility>
 
 #include "core/Observer.h"
+#include "engine/BackupLog.h"
 #include "gui/BaseFrame.h"
 #include "metadata/database.h"
 #include "metadata/MetadataClasses.h"
@@ -48,15 +56,20 @@ public:
     };
 
     enum {
-        ID_thread_output = 500,
+        ID_timer_output = 500,
         ID_thread_finished
     };
 
     // make sure that thread gets deleted
     virtual bool Destroy();
+
+    // helpers for the threads streaming backups through the service manager
+    static int getServerMajorVersion(const std::string& version);
+    static wxString formatTransferProgress(wxULongLong bytes,
+        wxLongLong millis);
 protected:
-    wxArrayString msgsM;
-    wxArrayInt msgKindsM;
+    // the most recent messages, the complete log is spooled to a file
+    std::deque<std::pair<MsgKind, wxString> > msgsM;
     bool verboseMsgsM;
 
     DatabasePtr getDatabase() const;
@@ -71,6 +84,7 @@ protected:
     bool startThread(std::auto_ptr<wxThread> thread);
     bool getThreadRunning() const;
 
+    // called by the worker thread only
     void threadOutputMsg(const wxString msg, MsgKind kind);
     virtual void updateControls();
     BackupRestoreBaseFrame(wxWindow* parent, DatabasePtr db);
@@ -78,11 +92,26 @@ private:
     DatabaseWeakPtr databaseM;
     wxThread* threadM;
 
-    wxCriticalSection critsectM;
-    wxArrayString threadMsgsM;
-    wxLongLong threadMsgTimeMillisM;
-    void addThreadMsg(const wxString msg, bool& notificationNeeded);
+    // the worker thread queues its messages without locking, timerM
+    // drains them at a fixed rate
+    struct ThreadMsg
+    {
+        MsgKind kind;
+        int64_t millis;
+        std::string text;
+    };
+    SpscRingBuffer<ThreadMsg> threadMsgsM;
+    std::atomic<unsigned> droppedMsgsM;
+    wxTimer timerM;
+
+    wxFFile spoolM;
+    wxString spoolFileNameM;
+    BackupProgressParser progressM;
+
+    void closeSpool();
+    void processThreadMsgs();
     void updateMessages(size_t firstmsg, size_t lastmsg);
+    void updateTablesList();
 
     // observer stuff
     virtual void subjectRemoved(Subject* subject);
@@ -105,12 +134,16 @@ protected:
     wxCheckBox* checkbox_showlog;
     wxButton* button_start;
     LogTextControl* text_ctrl_log;
+    wxListCtrl* listctrl_tables;
+    // creates text_ctrl_log and listctrl_tables, and their sizer
+    void createLogControls();
+    wxSizer* layoutLogControls();
     void setupControls();
 private:
     // event handling
     void OnSettingsChange(wxCommandEvent& event);
     void OnThreadFinished(wxCommandEvent& event);
-    void OnThreadOutput(wxCommandEvent& event);
+    void OnTimer(wxTimerEvent& event);
     void OnVerboseLogChange(wxCommandEvent& event);
 
     DECLARE_EVENT_TABLE()
@@ -63,15 +63,21 @@ namespace Cmds
 
         DataGrid_EditBlob,
         DataGrid_ExportBlob,
+        DataGrid_ExportBlobs,
         DataGrid_ImportBlob,
         DataGrid_Copy_as_insert,
         DataGrid_Copy_as_inList,
         DataGrid_Copy_as_update,
         DataGrid_Save_as_html,
         DataGrid_Save_as_csv,
+        DataGrid_Paste_rows,
+        DataGrid_Import_csv,
         DataGrid_Set_header_font,
         DataGrid_Set_cell_font,
         DataGrid_Log_changes,
+        DataGrid_Defer_edits,
+        DataGrid_Apply_edits,
+        DataGrid_Discard_edits,
 
         Menu_RegisterServer = 600, Menu_Manual, Menu_RelNotes, Menu_License,
         Menu_URLHomePage, Menu_URLProjectPage, Menu_URLFeatureRequest,
@@ -88,7 +94,9 @@ namespace Cmds
         Menu_AddColumn, Menu_RestoreIntoNew,
         Menu_MonitorEvents, Menu_GetServerVersion, Menu_AlterObject,
         Menu_DropDatabase, Menu_RecreateDatabase, Menu_DatabaseProperties,
-        Menu_GenerateData, Menu_CloneDatabase,
+        Menu_GenerateData, Menu_CloneDatabase, Menu_MonitorDatabase,
+        Menu_TraceDatabase, Menu_IndexStatistics, Menu_DatabaseStatistics,
+        Menu_MaintenanceScheduler, Menu_CompareResults,
 
         // view menu
         Menu_ToggleStatusBar, Menu_ToggleSearchBar, Menu_ToggleDisconnected,
@@ -104,6 +112,10 @@ namespace Cmds
         BlobEditor_Menu_BLOBSaveToFile,
         BlobEditor_Menu_BLOBLoadFromFile,
         BlobEditor_ProgressCancel,
+        BlobEditor_PagePrev,
+        BlobEditor_PageNext,
+        BlobEditor_Find,
+        BlobEditor_SearchDone,
 
         // 100 templates
         Menu_TemplateFirst = 700, Menu_TemplateLast = 799,
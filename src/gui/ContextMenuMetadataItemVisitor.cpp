@@ -93,6 +93,11 @@ void MainObjectMenuMetadataItemVisitor::visitDatabase(Database& database)
     toolsMenu->Append(Cmds::Menu_RecreateDatabase, _("Recreate empty database"));
     addSeparator();
     toolsMenu->Append(Cmds::Menu_MonitorEvents, _("&Monitor events"));
+    toolsMenu->Append(Cmds::Menu_MonitorDatabase, _("Monitor &activity"));
+    toolsMenu->Append(Cmds::Menu_TraceDatabase, _("T&race statements"));
+    toolsMenu->Append(Cmds::Menu_IndexStatistics, _("&Index statistics"));
+    toolsMenu->Append(Cmds::Menu_DatabaseStatistics,
+        _("Database &statistics (gstat)"));
     toolsMenu->Append(Cmds::Menu_GenerateData, _("&Test data generator"));
 
     menuM->Append(Cmds::Menu_DropDatabase, _("Dr&op database"));
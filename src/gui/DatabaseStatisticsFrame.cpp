@@ -0,0 +1,679 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+
+#include "config/Config.h"
+#include "core/StringUtils.h"
+#include "gui/DatabaseStatisticsFrame.h"
+#include "gui/StyleGuide.h"
+#include "gui/UsernamePasswordDialog.h"
+#include "metadata/database.h"
+#include "metadata/server.h"
+
+// DbStatsReaderThread class
+// Runs the statistics service and feeds its output to the parser
+class DbStatsReaderThread: public wxThread
+{
+private:
+    DatabaseStatisticsFrame* frameM;
+    wxString serverM;
+    wxString usernameM;
+    wxString passwordM;
+    wxString databaseFileM;
+    IBPP::STF flagsM;
+    wxCriticalSection stopCritsectM;
+    bool stopM;
+
+    bool isStopRequested();
+public:
+    DbStatsReaderThread(DatabaseStatisticsFrame* frame,
+        const wxString& server, const wxString& username,
+        const wxString& password, const wxString& databaseFile,
+        IBPP::STF flags);
+    virtual ExitCode Entry();
+
+    void requestStop();
+};
+
+DbStatsReaderThread::DbStatsReaderThread(DatabaseStatisticsFrame* frame,
+        const wxString& server, const wxString& username,
+        const wxString& password, const wxString& databaseFile,
+        IBPP::STF flags)
+    : wxThread(wxTHREAD_JOINABLE), frameM(frame), serverM(server),
+        usernameM(username), passwordM(password), databaseFileM(databaseFile),
+        flagsM(flags), stopM(false)
+{
+}
+
+void DbStatsReaderThread::requestStop()
+{
+    wxCriticalSectionLocker locker(stopCritsectM);
+    stopM = true;
+}
+
+bool DbStatsReaderThread::isStopRequested()
+{
+    wxCriticalSectionLocker locker(stopCritsectM);
+    return stopM;
+}
+
+wxThread::ExitCode DbStatsReaderThread::Entry()
+{
+    wxString error;
+    try
+    {
+        IBPP::Service svc = IBPP::ServiceFactory(wx2std(serverM),
+            wx2std(usernameM), wx2std(passwordM));
+        svc->Connect();
+        svc->StartDbStats(wx2std(databaseFileM), flagsM);
+
+        // the service can't be cancelled, detaching from it ends the
+        // report early
+        std::string chunk;
+        while (!isStopRequested() && svc->ReadOutput(chunk, 1))
+        {
+            if (!chunk.empty())
+            {
+                wxCriticalSectionLocker locker(frameM->parserCritsectM);
+                frameM->parserM.feed(chunk);
+            }
+        }
+        {
+            wxCriticalSectionLocker locker(frameM->parserCritsectM);
+            frameM->parserM.flush();
+        }
+        svc->Disconnect();
+    }
+    catch (IBPP::Exception& e)
+    {
+        error = e.what();
+    }
+    catch (...)
+    {
+        error = _("Unexpected error while reading the database statistics");
+    }
+
+    wxCriticalSectionLocker locker(frameM->parserCritsectM);
+    frameM->readerErrorM = error;
+    frameM->readerFinishedM = true;
+    return 0;
+}
+
+// DatabaseStatisticsFrame class
+DatabaseStatisticsFrame::DatabaseStatisticsFrame(wxWindow* parent,
+        DatabasePtr db)
+    : BaseFrame(parent, -1, wxEmptyString), databaseM(db), readerM(0),
+        readerFinishedM(false), tableSortColumnM(3),
+        tableSortAscendingM(false), indexSortColumnM(2),
+        indexSortAscendingM(false)
+{
+    wxASSERT(db);
+    timerM.SetOwner(this, ID_timer);
+
+    setIdString(this, getFrameId(db));
+    // observe database object to close on disconnect / destruction
+    db->attachObserver(this, false);
+    SetTitle(wxString::Format(_("Database Statistics: %s"),
+        db->getName_().c_str()));
+
+    createControls();
+    layoutControls();
+    updateControls();
+
+    button_start->SetFocus();
+
+    #include "new.xpm"
+    wxBitmap bmp(new_xpm);
+    wxIcon icon;
+    icon.CopyFromBitmap(bmp);
+    SetIcon(icon);
+}
+
+bool DatabaseStatisticsFrame::Destroy()
+{
+    stopStatistics();
+    joinReader();
+    return BaseFrame::Destroy();
+}
+
+enum TableColumn { tcTable, tcRecords, tcRecordLength, tcVersions,
+    tcMaxVersions, tcVersionLength, tcDataPages, tcPageSlots, tcAverageFill,
+    tcFill0, tcCount = tcFill0 + dbStatsFillBuckets };
+
+enum IndexColumn { icTable, icIndex, icDepth, icLeafBuckets, icNodes,
+    icDataLength, icTotalDup, icMaxDup, icFill0,
+    icCount = icFill0 + dbStatsFillBuckets };
+
+static void insertFillColumns(wxListCtrl* list, int first)
+{
+    static const char* buckets[dbStatsFillBuckets] = {
+        "0-19%", "20-39%", "40-59%", "60-79%", "80-99%" };
+    for (int i = 0; i < dbStatsFillBuckets; ++i)
+        list->InsertColumn(first + i, buckets[i], wxLIST_FORMAT_RIGHT);
+}
+
+void DatabaseStatisticsFrame::createControls()
+{
+    panel_controls = new wxPanel(this, -1, wxDefaultPosition, wxDefaultSize,
+        wxTAB_TRAVERSAL | wxCLIP_CHILDREN);
+    notebook_views = new wxNotebook(panel_controls, wxID_ANY);
+
+    listctrl_tables = new wxListCtrl(notebook_views, ID_listctrl_tables,
+        wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_SINGLE_SEL);
+    listctrl_tables->InsertColumn(tcTable, _("Table"));
+    listctrl_tables->InsertColumn(tcRecords, _("Records"),
+        wxLIST_FORMAT_RIGHT);
+    listctrl_tables->InsertColumn(tcRecordLength, _("Avg. length"),
+        wxLIST_FORMAT_RIGHT);
+    listctrl_tables->InsertColumn(tcVersions, _("Versions"),
+        wxLIST_FORMAT_RIGHT);
+    listctrl_tables->InsertColumn(tcMaxVersions, _("Max. versions"),
+        wxLIST_FORMAT_RIGHT);
+    listctrl_tables->InsertColumn(tcVersionLength, _("Avg. version length"),
+        wxLIST_FORMAT_RIGHT);
+    listctrl_tables->InsertColumn(tcDataPages, _("Data pages"),
+        wxLIST_FORMAT_RIGHT);
+    listctrl_tables->InsertColumn(tcPageSlots, _("Page slots"),
+        wxLIST_FORMAT_RIGHT);
+    listctrl_tables->InsertColumn(tcAverageFill, _("Avg. fill %"),
+        wxLIST_FORMAT_RIGHT);
+    insertFillColumns(listctrl_tables, tcFill0);
+    listctrl_tables->SetColumnWidth(tcTable, 200);
+    notebook_views->AddPage(listctrl_tables, _("Tables"));
+
+    listctrl_indices = new wxListCtrl(notebook_views, ID_listctrl_indices,
+        wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_SINGLE_SEL);
+    listctrl_indices->InsertColumn(icTable, _("Table"));
+    listctrl_indices->InsertColumn(icIndex, _("Index"));
+    listctrl_indices->InsertColumn(icDepth, _("Depth"), wxLIST_FORMAT_RIGHT);
+    listctrl_indices->InsertColumn(icLeafBuckets, _("Leaf buckets"),
+        wxLIST_FORMAT_RIGHT);
+    listctrl_indices->InsertColumn(icNodes, _("Nodes"), wxLIST_FORMAT_RIGHT);
+    listctrl_indices->InsertColumn(icDataLength, _("Avg. data length"),
+        wxLIST_FORMAT_RIGHT);
+    listctrl_indices->InsertColumn(icTotalDup, _("Total dup."),
+        wxLIST_FORMAT_RIGHT);
+    listctrl_indices->InsertColumn(icMaxDup, _("Max. dup."),
+        wxLIST_FORMAT_RIGHT);
+    insertFillColumns(listctrl_indices, icFill0);
+    listctrl_indices->SetColumnWidth(icTable, 200);
+    listctrl_indices->SetColumnWidth(icIndex, 200);
+    notebook_views->AddPage(listctrl_indices, _("Indices"));
+
+    text_ctrl_header = new wxTextCtrl(notebook_views, wxID_ANY,
+        wxEmptyString, wxDefaultPosition, wxDefaultSize,
+        wxTE_MULTILINE | wxTE_READONLY | wxTE_DONTWRAP);
+    notebook_views->AddPage(text_ctrl_header, _("Header"));
+
+    checkbox_system = new wxCheckBox(panel_controls, wxID_ANY,
+        _("Include s&ystem tables"));
+    static_text_status = new wxStaticText(panel_controls, wxID_ANY,
+        wxEmptyString);
+    button_start = new wxButton(panel_controls, ID_button_start,
+        _("&Start"));
+}
+
+void DatabaseStatisticsFrame::layoutControls()
+{
+    wxBoxSizer* sizerButtons = new wxBoxSizer(wxHORIZONTAL);
+    sizerButtons->Add(checkbox_system, 0, wxALIGN_CENTER_VERTICAL);
+    sizerButtons->AddSpacer(
+        styleguide().getUnrelatedControlMargin(wxHORIZONTAL));
+    sizerButtons->Add(static_text_status, 0, wxALIGN_CENTER_VERTICAL);
+    sizerButtons->Add(styleguide().getUnrelatedControlMargin(wxHORIZONTAL), 0,
+        1, wxEXPAND);
+    sizerButtons->Add(button_start);
+
+    wxBoxSizer* sizerPanelV = new wxBoxSizer(wxVERTICAL);
+    sizerPanelV->AddSpacer(styleguide().getFrameMargin(wxTOP));
+    sizerPanelV->Add(notebook_views, 1, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getUnrelatedControlMargin(wxVERTICAL));
+    sizerPanelV->Add(sizerButtons, 0, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getFrameMargin(wxBOTTOM));
+
+    wxBoxSizer* sizerPanelH = new wxBoxSizer(wxHORIZONTAL);
+    sizerPanelH->AddSpacer(styleguide().getFrameMargin(wxLEFT));
+    sizerPanelH->Add(sizerPanelV, 1, wxEXPAND);
+    sizerPanelH->AddSpacer(styleguide().getFrameMargin(wxRIGHT));
+
+    wxBoxSizer* sizerAll = new wxBoxSizer(wxHORIZONTAL);
+    sizerAll->Add(sizerPanelH, 1, wxEXPAND);
+
+    panel_controls->SetSizer(sizerAll);
+    sizerAll->Fit(this);
+    sizerAll->SetSizeHints(this);
+}
+
+void DatabaseStatisticsFrame::updateControls()
+{
+    checkbox_system->Enable(!isRunning());
+    if (isRunning())
+        button_start->SetLabel(_("&Stop"));
+    else
+        button_start->SetLabel(_("&Start"));
+}
+
+DatabasePtr DatabaseStatisticsFrame::getDatabase() const
+{
+    return databaseM.lock();
+}
+
+wxString DatabaseStatisticsFrame::toWx(const std::string& s) const
+{
+    DatabasePtr db = getDatabase();
+    if (db && db->getCharsetConverter())
+        return wxString(s.c_str(), *db->getCharsetConverter());
+    return wxString(s.c_str(), *wxConvCurrent);
+}
+
+bool DatabaseStatisticsFrame::isRunning() const
+{
+    return readerM != 0;
+}
+
+void DatabaseStatisticsFrame::startStatistics()
+{
+    DatabasePtr database = getDatabase();
+    if (!database)
+    {
+        Close();
+        return;
+    }
+    ServerPtr server = database->getServer();
+    wxCHECK_RET(server, "Cannot analyze database without assigned server");
+
+    wxString username;
+    wxString password;
+    if (!getConnectionCredentials(this, database, username, password))
+        return;
+
+    int flags = IBPP::stDataPages | IBPP::stIndexPages
+        | IBPP::stRecordVersions | IBPP::stHeaderPages;
+    if (checkbox_system->IsChecked())
+        flags |= IBPP::stSystemRelations;
+
+    {
+        wxCriticalSectionLocker locker(parserCritsectM);
+        parserM.clear();
+        readerErrorM.clear();
+        readerFinishedM = false;
+    }
+    tablesM.clear();
+    indicesM.clear();
+    listctrl_tables->DeleteAllItems();
+    listctrl_indices->DeleteAllItems();
+    text_ctrl_header->Clear();
+
+    DbStatsReaderThread* reader = new DbStatsReaderThread(this,
+        server->getConnectionString(), username, password,
+        database->getPath(), IBPP::STF(flags));
+    if (reader->Create() != wxTHREAD_NO_ERROR
+        || reader->Run() != wxTHREAD_NO_ERROR)
+    {
+        delete reader;
+        wxMessageBox(_("Can not start database statistics thread"),
+            _("Error"), wxOK | wxICON_ERROR);
+        return;
+    }
+    readerM = reader;
+    timerM.Start(1000);
+    static_text_status->SetLabel(_("Analyzing database pages..."));
+    panel_controls->Layout();
+}
+
+void DatabaseStatisticsFrame::stopStatistics()
+{
+    if (readerM)
+        readerM->requestStop();
+}
+
+void DatabaseStatisticsFrame::joinReader()
+{
+    if (readerM)
+    {
+        readerM->Wait();
+        delete readerM;
+        readerM = 0;
+    }
+    timerM.Stop();
+}
+
+static wxString formatInt64(int64_t value)
+{
+    return wxString::Format("%" wxLongLongFmtSpec "d", (wxLongLong_t)value);
+}
+
+struct DbStatsTableComparer
+{
+    int column;
+    bool ascending;
+
+    static double getValue(const DbStatsTable& t, int column)
+    {
+        switch (column)
+        {
+            case tcRecords:       return double(t.records);
+            case tcRecordLength:  return t.avgRecordLength;
+            case tcVersions:      return double(t.versions);
+            case tcMaxVersions:   return double(t.maxVersions);
+            case tcVersionLength: return t.avgVersionLength;
+            case tcDataPages:     return double(t.dataPages);
+            case tcPageSlots:     return double(t.dataPageSlots);
+            case tcAverageFill:   return t.averageFill;
+        }
+        if (column >= tcFill0 && column < tcCount)
+            return double(t.fill[column - tcFill0]);
+        return 0;
+    }
+
+    bool operator()(const DbStatsTable& left, const DbStatsTable& right) const
+    {
+        if (column == tcTable)
+            return ascending ? left.name < right.name : right.name < left.name;
+        double l = getValue(left, column);
+        double r = getValue(right, column);
+        return ascending ? l < r : r < l;
+    }
+};
+
+struct DbStatsIndexComparer
+{
+    int column;
+    bool ascending;
+
+    static double getValue(const DbStatsIndex& i, int column)
+    {
+        switch (column)
+        {
+            case icDepth:       return i.depth;
+            case icLeafBuckets: return double(i.leafBuckets);
+            case icNodes:       return double(i.nodes);
+            case icDataLength:  return i.avgDataLength;
+            case icTotalDup:    return double(i.totalDup);
+            case icMaxDup:      return double(i.maxDup);
+        }
+        if (column >= icFill0 && column < icCount)
+            return double(i.fill[column - icFill0]);
+        return 0;
+    }
+
+    bool operator()(const DbStatsIndex& left, const DbStatsIndex& right) const
+    {
+        if (column == icTable || column == icIndex)
+        {
+            const std::string& l = column == icTable ? left.table : left.name;
+            const std::string& r = column == icTable ? right.table : right.name;
+            return ascending ? l < r : r < l;
+        }
+        double l = getValue(left, column);
+        double r = getValue(right, column);
+        return ascending ? l < r : r < l;
+    }
+};
+
+void DatabaseStatisticsFrame::showTables()
+{
+    DbStatsTableComparer comparer = { tableSortColumnM, tableSortAscendingM };
+    std::stable_sort(tablesM.begin(), tablesM.end(), comparer);
+
+    listctrl_tables->Freeze();
+    listctrl_tables->DeleteAllItems();
+    for (size_t i = 0; i < tablesM.size(); ++i)
+    {
+        const DbStatsTable& t = tablesM[i];
+        long item = listctrl_tables->InsertItem(long(i), toWx(t.name));
+        listctrl_tables->SetItem(item, tcRecords, formatInt64(t.records));
+        listctrl_tables->SetItem(item, tcRecordLength,
+            wxString::Format("%.2f", t.avgRecordLength));
+        listctrl_tables->SetItem(item, tcVersions, formatInt64(t.versions));
+        listctrl_tables->SetItem(item, tcMaxVersions,
+            formatInt64(t.maxVersions));
+        listctrl_tables->SetItem(item, tcVersionLength,
+            wxString::Format("%.2f", t.avgVersionLength));
+        listctrl_tables->SetItem(item, tcDataPages, formatInt64(t.dataPages));
+        listctrl_tables->SetItem(item, tcPageSlots,
+            formatInt64(t.dataPageSlots));
+        listctrl_tables->SetItem(item, tcAverageFill,
+            wxString::Format("%d", t.averageFill));
+        for (int b = 0; b < dbStatsFillBuckets; ++b)
+            listctrl_tables->SetItem(item, tcFill0 + b, formatInt64(t.fill[b]));
+
+        // long back-version chains make every read walk them, and garbage
+        // collection has to clean them up sooner or later
+        if (t.maxVersions >= 10 || (t.versions > 0 && t.versions >= t.records))
+            listctrl_tables->SetItemTextColour(item, *wxRED);
+        else if (t.versions > t.records / 10)
+            listctrl_tables->SetItemTextColour(item, *wxBLUE);
+    }
+    listctrl_tables->Thaw();
+}
+
+void DatabaseStatisticsFrame::showIndices()
+{
+    DbStatsIndexComparer comparer = { indexSortColumnM, indexSortAscendingM };
+    std::stable_sort(indicesM.begin(), indicesM.end(), comparer);
+
+    listctrl_indices->Freeze();
+    listctrl_indices->DeleteAllItems();
+    for (size_t i = 0; i < indicesM.size(); ++i)
+    {
+        const DbStatsIndex& x = indicesM[i];
+        long item = listctrl_indices->InsertItem(long(i), toWx(x.table));
+        listctrl_indices->SetItem(item, icIndex, toWx(x.name));
+        listctrl_indices->SetItem(item, icDepth,
+            wxString::Format("%d", x.depth));
+        listctrl_indices->SetItem(item, icLeafBuckets,
+            formatInt64(x.leafBuckets));
+        listctrl_indices->SetItem(item, icNodes, formatInt64(x.nodes));
+        listctrl_indices->SetItem(item, icDataLength,
+            wxString::Format("%.2f", x.avgDataLength));
+        listctrl_indices->SetItem(item, icTotalDup, formatInt64(x.totalDup));
+        listctrl_indices->SetItem(item, icMaxDup, formatInt64(x.maxDup));
+        for (int b = 0; b < dbStatsFillBuckets; ++b)
+        {
+            listctrl_indices->SetItem(item, icFill0 + b,
+                formatInt64(x.fill[b]));
+        }
+
+        // every level more is one more page read per lookup, more than
+        // three levels usually call for a bigger page size
+        if (x.depth > 3)
+            listctrl_indices->SetItemTextColour(item, *wxRED);
+    }
+    listctrl_indices->Thaw();
+}
+
+void DatabaseStatisticsFrame::showHeader(
+    const std::vector<std::string>& header)
+{
+    wxString text;
+    for (size_t i = 0; i < header.size(); ++i)
+        text += toWx(header[i]) + "\n";
+    text_ctrl_header->SetValue(text);
+}
+
+void DatabaseStatisticsFrame::subjectRemoved(Subject* subject)
+{
+    DatabasePtr db = getDatabase();
+    if (!db || !db->isConnected() || subject == db.get())
+        Close();
+}
+
+void DatabaseStatisticsFrame::update()
+{
+    DatabasePtr db = getDatabase();
+    if (!db || !db->isConnected())
+        Close();
+}
+
+void DatabaseStatisticsFrame::doReadConfigSettings(const wxString& prefix)
+{
+    BaseFrame::doReadConfigSettings(prefix);
+    bool system = false;
+    config().getValue(prefix + Config::pathSeparator + "systemtables",
+        system);
+    checkbox_system->SetValue(system);
+}
+
+void DatabaseStatisticsFrame::doWriteConfigSettings(
+    const wxString& prefix) const
+{
+    BaseFrame::doWriteConfigSettings(prefix);
+    config().setValue(prefix + Config::pathSeparator + "systemtables",
+        checkbox_system->IsChecked());
+}
+
+const wxString DatabaseStatisticsFrame::getName() const
+{
+    return "DatabaseStatisticsFrame";
+}
+
+wxString DatabaseStatisticsFrame::getFrameId(DatabasePtr db)
+{
+    if (db)
+        return wxString("DatabaseStatisticsFrame/" + db->getItemPath());
+    else
+        return wxEmptyString;
+}
+
+DatabaseStatisticsFrame* DatabaseStatisticsFrame::findFrameFor(
+    DatabasePtr db)
+{
+    BaseFrame* bf = frameFromIdString(getFrameId(db));
+    if (!bf)
+        return 0;
+    return dynamic_cast<DatabaseStatisticsFrame*>(bf);
+}
+
+BEGIN_EVENT_TABLE(DatabaseStatisticsFrame, wxFrame)
+    EVT_BUTTON(DatabaseStatisticsFrame::ID_button_start, DatabaseStatisticsFrame::OnButtonStartStopClick)
+    EVT_LIST_COL_CLICK(DatabaseStatisticsFrame::ID_listctrl_tables, DatabaseStatisticsFrame::OnListColumnClick)
+    EVT_LIST_COL_CLICK(DatabaseStatisticsFrame::ID_listctrl_indices, DatabaseStatisticsFrame::OnListColumnClick)
+    EVT_TIMER(DatabaseStatisticsFrame::ID_timer, DatabaseStatisticsFrame::OnTimer)
+END_EVENT_TABLE()
+
+void DatabaseStatisticsFrame::OnButtonStartStopClick(
+    wxCommandEvent& WXUNUSED(event))
+{
+    if (isRunning())
+    {
+        stopStatistics();
+        button_start->SetLabel(_("Stopping..."));
+        button_start->Enable(false);
+    }
+    else
+    {
+        startStatistics();
+        updateControls();
+    }
+}
+
+void DatabaseStatisticsFrame::OnListColumnClick(wxListEvent& event)
+{
+    int column = event.GetColumn();
+    if (column < 0)
+        return;
+    // names read best in alphabetical order, for the counters the
+    // biggest values are of interest
+    if (event.GetId() == ID_listctrl_tables)
+    {
+        if (column == tableSortColumnM)
+            tableSortAscendingM = !tableSortAscendingM;
+        else
+        {
+            tableSortColumnM = column;
+            tableSortAscendingM = column == tcTable;
+        }
+        showTables();
+    }
+    else
+    {
+        if (column == indexSortColumnM)
+            indexSortAscendingM = !indexSortAscendingM;
+        else
+        {
+            indexSortColumnM = column;
+            indexSortAscendingM = column == icTable || column == icIndex;
+        }
+        showIndices();
+    }
+}
+
+void DatabaseStatisticsFrame::OnTimer(wxTimerEvent& WXUNUSED(event))
+{
+    bool finished, changed;
+    wxString error;
+    std::vector<std::string> header;
+    {
+        wxCriticalSectionLocker locker(parserCritsectM);
+        finished = readerFinishedM;
+        error = readerErrorM;
+        changed = parserM.checkChanged();
+        if (changed)
+        {
+            tablesM = parserM.getTables();
+            indicesM = parserM.getIndices();
+            header = parserM.getHeader();
+        }
+    }
+
+    if (changed)
+    {
+        showTables();
+        showIndices();
+        showHeader(header);
+    }
+
+    if (finished && readerM)
+    {
+        joinReader();
+        button_start->Enable(true);
+        updateControls();
+        if (!error.empty())
+            static_text_status->SetLabel(error);
+        else
+        {
+            static_text_status->SetLabel(wxString::Format(
+                _("%d tables, %d indices"), (int)tablesM.size(),
+                (int)indicesM.size()));
+        }
+        panel_controls->Layout();
+    }
+    else if (changed)
+    {
+        static_text_status->SetLabel(wxString::Format(
+            _("Analyzing database pages... %d tables, %d indices"),
+            (int)tablesM.size(), (int)indicesM.size()));
+        panel_controls->Layout();
+    }
+}
@@ -0,0 +1,129 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef FR_DATABASE_STATISTICS_FRAME_H
+#define FR_DATABASE_STATISTICS_FRAME_H
+
+#include <wx/wx.h>
+#include <wx/button.h>
+#include <wx/checkbox.h>
+#include <wx/listctrl.h>
+#include <wx/notebook.h>
+#include <wx/panel.h>
+#include <wx/thread.h>
+
+#include <vector>
+
+#include "core/Observer.h"
+#include "engine/DbStatsParser.h"
+#include "gui/BaseFrame.h"
+#include "metadata/database.h"
+#include "metadata/MetadataClasses.h"
+
+class DbStatsReaderThread;
+
+// Runs the database statistics service (gstat) and shows the page usage
+// of all tables and indices as the report arrives
+class DatabaseStatisticsFrame : public BaseFrame, public Observer
+{
+private:
+    friend class DbStatsReaderThread;
+
+    DatabaseWeakPtr databaseM;
+    DbStatsReaderThread* readerM;
+    // shows the parsed report while it is read
+    wxTimer timerM;
+
+    // fed by the reader thread
+    wxCriticalSection parserCritsectM;
+    DbStatsParser parserM;
+    wxString readerErrorM;
+    bool readerFinishedM;
+
+    // what is shown in the list controls, in list order
+    std::vector<DbStatsTable> tablesM;
+    std::vector<DbStatsIndex> indicesM;
+    int tableSortColumnM;
+    bool tableSortAscendingM;
+    int indexSortColumnM;
+    bool indexSortAscendingM;
+
+    wxPanel* panel_controls;
+    wxNotebook* notebook_views;
+    wxListCtrl* listctrl_tables;
+    wxListCtrl* listctrl_indices;
+    wxTextCtrl* text_ctrl_header;
+    wxCheckBox* checkbox_system;
+    wxStaticText* static_text_status;
+    wxButton* button_start;
+    void createControls();
+    void layoutControls();
+    void updateControls();
+
+    static wxString getFrameId(DatabasePtr db);
+
+    DatabasePtr getDatabase() const;
+    wxString toWx(const std::string& s) const;
+    bool isRunning() const;
+    void startStatistics();
+    void stopStatistics();
+    void joinReader();
+
+    void showTables();
+    void showIndices();
+    void showHeader(const std::vector<std::string>& header);
+
+    // observer stuff
+    virtual void subjectRemoved(Subject* subject);
+    virtual void update();
+
+protected:
+    virtual void doReadConfigSettings(const wxString& prefix);
+    virtual void doWriteConfigSettings(const wxString& prefix) const;
+    virtual const wxString getName() const;
+public:
+    DatabaseStatisticsFrame(wxWindow* parent, DatabasePtr db);
+
+    // make sure that the reader thread is stopped
+    virtual bool Destroy();
+
+    static DatabaseStatisticsFrame* findFrameFor(DatabasePtr db);
+private:
+    // event handling
+    enum
+    {
+        ID_listctrl_tables = 101,
+        ID_listctrl_indices,
+        ID_button_start,
+        ID_timer
+    };
+
+    void OnButtonStartStopClick(wxCommandEvent& event);
+    void OnListColumnClick(wxListEvent& event);
+    void OnTimer(wxTimerEvent& event);
+
+    DECLARE_EVENT_TABLE()
+};
+
+#endif
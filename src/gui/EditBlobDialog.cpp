@@ -30,10 +30,16 @@
     #include "wx/wx.h"
 #endif
 
+#include <wx/file.h>
+#include <wx/filename.h>
 #include <wx/stream.h>
 #include <wx/wfstream.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "AdvancedMessageDialog.h"
+#include "config/Config.h"
 #include "core/FRError.h"
 #include "core/StringUtils.h"
 #include "gui/CommandIds.h"
@@ -43,6 +49,7 @@
 #include "gui/EditBlobDialog.h"
 #include "gui/FRLayoutConfig.h"
 #include "gui/StyleGuide.h"
+#include "metadata/database.h"
 
 // Static members
 /* maybe later needed if plugin will be implemented
@@ -254,7 +261,7 @@ class FRInputBlobStream : public wxInputStream
 class FROutputBlobStream : public wxOutputStream
 {
     public:
-        FROutputBlobStream(IBPP::Blob blob);
+        FROutputBlobStream(IBPP::Blob blob, bool streamBlob = false);
         virtual ~FROutputBlobStream();
         
         virtual bool Close();
@@ -376,6 +383,269 @@ void EditBlobDialogProgressSizer::stepProgress(int stepAmount)
 }
 
 
+
+// Helper Class - Pager - reads pages of BLOBs that are too large to be
+// loaded into the editor as a whole
+// Stream BLOBs are positioned with Seek(), segmented BLOBs can only be
+// read sequentially, so what has been read is spooled to a temporary
+// file which serves all later page reads and the search
+class EditBlobDialogPager
+{
+public:
+    EditBlobDialogPager(IBPP::Blob blob, int size, int pageSize);
+    ~EditBlobDialogPager();
+
+    int getSize() const;
+    bool isSeekable() const;
+    int getPageCount() const;
+    int getPage(int offset) const;
+    int getPageStart(int page) const;
+    int getPageEnd(int page) const;
+    // number of bytes that need to be spooled before reading up to end
+    int getSpoolNeeded(int end) const;
+    wxString getSpoolFileName() const;
+
+    // returns false if it was canceled
+    bool spool(int end, EditBlobDialogProgressSizer* progress);
+    void readPage(int page, std::string& data);
+private:
+    IBPP::Blob blobM;
+    bool seekableM;
+    int sizeM;
+    int pageSizeM;
+    wxString spoolFileNameM;
+    wxFile spoolM;
+    int spooledM;
+
+    int readBlob(char* buffer, int size);
+};
+
+EditBlobDialogPager::EditBlobDialogPager(IBPP::Blob blob, int size,
+        int pageSize)
+    : blobM(blob), seekableM(false), sizeM(size), pageSizeM(pageSize),
+        spooledM(0)
+{
+    blobM->Close();
+    blobM->Open();
+    seekableM = blobM->IsStream();
+    spoolFileNameM = wxFileName::CreateTempFileName("frblob");
+    if (spoolFileNameM.empty()
+        || !spoolM.Open(spoolFileNameM, wxFile::read_write))
+    {
+        throw FRError(_("Cannot create a temporary file for the BLOB."));
+    }
+}
+
+EditBlobDialogPager::~EditBlobDialogPager()
+{
+    spoolM.Close();
+    wxRemoveFile(spoolFileNameM);
+    try
+    {
+        blobM->Close();
+    }
+    catch (...)
+    {
+        // the transaction may already be gone
+    }
+}
+
+int EditBlobDialogPager::getSize() const
+{
+    return sizeM;
+}
+
+bool EditBlobDialogPager::isSeekable() const
+{
+    return seekableM;
+}
+
+int EditBlobDialogPager::getPage(int offset) const
+{
+    return offset / pageSizeM;
+}
+
+int EditBlobDialogPager::getPageCount() const
+{
+    return std::max(1, (sizeM + pageSizeM - 1) / pageSizeM);
+}
+
+int EditBlobDialogPager::getPageStart(int page) const
+{
+    return std::min(sizeM, page * pageSizeM);
+}
+
+int EditBlobDialogPager::getPageEnd(int page) const
+{
+    return std::min(sizeM, (page + 1) * pageSizeM);
+}
+
+int EditBlobDialogPager::getSpoolNeeded(int end) const
+{
+    return std::max(0, std::min(end, sizeM) - spooledM);
+}
+
+wxString EditBlobDialogPager::getSpoolFileName() const
+{
+    return spoolFileNameM;
+}
+
+int EditBlobDialogPager::readBlob(char* buffer, int size)
+{
+    int done = 0;
+    while (done < size)
+    {
+        // segments are at most 64 KB - 1, and the buffers of the client
+        // library work best with 32 KB
+        int len = blobM->Read(buffer + done, std::min(32767, size - done));
+        if (len < 1)
+            break;
+        done += len;
+    }
+    return done;
+}
+
+bool EditBlobDialogPager::spool(int end, EditBlobDialogProgressSizer* progress)
+{
+    end = std::min(end, sizeM);
+    if (spooledM >= end)
+        return true;
+    // reading pages has moved the position of stream BLOBs
+    if (seekableM)
+        blobM->Seek(spooledM);
+
+    std::vector<char> buffer(256 * 1024);
+    spoolM.Seek(spooledM);
+    while (spooledM < end)
+    {
+        if (progress && progress->isCanceled())
+            return false;
+        int len = readBlob(&buffer[0], int(buffer.size()));
+        if (len < 1)
+        {
+            // the BLOB is shorter than reported
+            sizeM = spooledM;
+            break;
+        }
+        if (spoolM.Write(&buffer[0], len) != size_t(len))
+            throw FRError(_("Cannot write the temporary file for the BLOB."));
+        spooledM += len;
+        if (progress)
+            progress->stepProgress(len);
+    }
+    return true;
+}
+
+void EditBlobDialogPager::readPage(int page, std::string& data)
+{
+    int start = getPageStart(page);
+    int length = getPageEnd(page) - start;
+    data.resize(length);
+    if (length == 0)
+        return;
+    if (start + length <= spooledM)
+    {
+        spoolM.Seek(start);
+        length = spoolM.Read(&data[0], length);
+    }
+    else
+    {
+        // segmented BLOBs are spooled by the caller before
+        wxASSERT(seekableM);
+        blobM->Seek(start);
+        length = readBlob(&data[0], length);
+    }
+    data.resize(std::max(0, length));
+}
+
+
+// Helper Class - SearchThread - searches the spooled BLOB
+class EditBlobDialogSearchThread : public wxThread
+{
+public:
+    EditBlobDialogSearchThread(wxEvtHandler* handler,
+        const wxString& fileName, const std::string& pattern, int from);
+    virtual ExitCode Entry();
+    void cancel();
+private:
+    wxEvtHandler* handlerM;
+    wxString fileNameM;
+    std::string patternM;
+    int fromM;
+    volatile bool canceledM;
+};
+
+EditBlobDialogSearchThread::EditBlobDialogSearchThread(wxEvtHandler* handler,
+        const wxString& fileName, const std::string& pattern, int from)
+    : wxThread(wxTHREAD_JOINABLE), handlerM(handler), fileNameM(fileName),
+        patternM(pattern), fromM(from), canceledM(false)
+{
+}
+
+void EditBlobDialogSearchThread::cancel()
+{
+    canceledM = true;
+}
+
+wxThread::ExitCode EditBlobDialogSearchThread::Entry()
+{
+    int found = -1;
+    wxFile file;
+    if (!patternM.empty() && file.Open(fileNameM))
+    {
+        // chunks overlap by the pattern length, so no match is missed
+        const size_t chunkSize = 1024 * 1024;
+        std::vector<char> buffer(chunkSize + patternM.size());
+        wxFileOffset offset = fromM;
+        while (!canceledM && found < 0)
+        {
+            file.Seek(offset);
+            ssize_t len = file.Read(&buffer[0], buffer.size());
+            if (len < ssize_t(patternM.size()))
+                break;
+            std::vector<char>::iterator end = buffer.begin() + len;
+            std::vector<char>::iterator it = std::search(buffer.begin(),
+                end, patternM.begin(), patternM.end());
+            if (it != end)
+                found = int(offset + (it - buffer.begin()));
+            offset += len - patternM.size() + 1;
+        }
+    }
+
+    wxCommandEvent event(wxEVT_COMMAND_MENU_SELECTED,
+        Cmds::BlobEditor_SearchDone);
+    event.SetInt(canceledM ? -1 : found);
+    event.SetExtraLong(long(patternM.size()));
+    wxPostEvent(handlerM, event);
+    return 0;
+}
+
+
+static int getBlobSize(IBPP::Blob& blob)
+{
+    int size = 0;
+    blob->Close();
+    blob->Open();
+    blob->Info(&size, 0, 0);
+    blob->Close();
+    return size;
+}
+
+static int getBlobEditorPageSize()
+{
+    // whole lines of 32 bytes in the binary view
+    int size = config().get("BlobEditorPageSize", 64 * 1024);
+    return std::max(32, size / 32 * 32);
+}
+
+// position of a byte of the page in the binary view, with 32 bytes and
+// 4 spaces on each line
+static int getBinaryTextPos(int offset)
+{
+    return (offset / 32) * 69 + (offset % 32) * 2 + (offset % 32) / 8;
+}
+
+
 // Main (dialog) class for blob editor
 EditBlobDialog::EditBlobDialog(wxWindow* parent)
     :BaseDialog(parent, -1, wxEmptyString)    
@@ -395,6 +665,11 @@ EditBlobDialog::EditBlobDialog(wxWindow* parent)
     loadingM = false;
     statementM = 0;
     readonlyM = false;
+    converterM = wxConvCurrent;
+    pagerM = 0;
+    pageM = 0;
+    searchThreadM = 0;
+    searchFromM = 0;
 
     notebook = new wxNotebook(getControlsPanel(), wxID_ANY);
     blob_noData = new wxPanel(notebook, wxID_ANY);
@@ -402,6 +677,18 @@ EditBlobDialog::EditBlobDialog(wxWindow* parent)
     blob_text = new EditBlobDialogSTCText(notebook, wxID_ANY);
     blob_binary = new EditBlobDialogSTC(notebook, wxID_ANY);
     progress = new EditBlobDialogProgressSizer(getControlsPanel());
+
+    // page controls, only shown for large BLOBs
+    button_page_prev = new wxButton(getControlsPanel(),
+        Cmds::BlobEditor_PagePrev, "<", wxDefaultPosition,
+        wxDefaultSize, wxBU_EXACTFIT);
+    button_page_next = new wxButton(getControlsPanel(),
+        Cmds::BlobEditor_PageNext, ">", wxDefaultPosition,
+        wxDefaultSize, wxBU_EXACTFIT);
+    label_page = new wxStaticText(getControlsPanel(), wxID_ANY, "");
+    text_find = new wxTextCtrl(getControlsPanel(), wxID_ANY, "");
+    button_find = new wxButton(getControlsPanel(), Cmds::BlobEditor_Find,
+        _("&Find"));
    
     // dialog "menu" buttons
     button_menu_blob = new wxButton(getControlsPanel(),
@@ -434,6 +721,7 @@ EditBlobDialog::~EditBlobDialog()
     */
     delete menu_blob;
     cacheDelete();
+    pagerDelete();
 }
 
 void EditBlobDialog::buildMenus(CommandManager& cm)
@@ -522,6 +810,9 @@ void EditBlobDialog::closeDontSave()
 {
     // We dont want to save the blob data back to DB.
     dataModifiedM = false;
+    editedPagesM.clear();
+    // the BLOB handle is useless after the transaction has ended
+    pagerDelete();
     Close();
 }
 
@@ -540,6 +831,8 @@ bool EditBlobDialog::setBlob(DataGrid* dg, DataGridTable* dgt,
     rowM = row;
     colM = col;
     readonlyM = dataGridTableM->isReadonlyColumn(colM);
+    if (Database* db = dataGridTableM->getDatabase())
+        converterM = db->getCharsetConverter();
 
     // generator blob fieldname
     wxString tableName = dgt->getTableName();
@@ -564,6 +857,9 @@ bool EditBlobDialog::loadBlob()
     // if the user changes data and switches the notebook-page
     // the cach will be created again
     cacheDelete();
+    pagerDelete();
+    editedPagesM.clear();
+    searchFromM = 0;
     dataUpdateGUI();
 
     if (isBlob)
@@ -575,17 +871,26 @@ bool EditBlobDialog::loadBlob()
         else
             blobM = 0;
 
-        FRInputBlobStream inpblob(blobM);
-
-        if (!isTextual)
+        editorModeM = isTextual ? text : binary;
+        // large BLOBs are shown one page at a time
+        int size = (blobM != 0) ? getBlobSize(blobM) : 0;
+        int threshold = config().get("BlobEditorPagingThreshold",
+            4 * 1024 * 1024);
+        if (threshold > 0 && size > threshold)
         {
-            res = loadFromStreamAsBinary(inpblob, blobM == 0, _("Loading BLOB into editor."));
-            editorModeM = binary;
+            pagerM = new EditBlobDialogPager(blobM, size,
+                getBlobEditorPageSize());
+            res = pageLoad(0);
+            if (!res)
+                pagerDelete();
         }
         else
         {
-            res = loadFromStreamAsText(inpblob, blobM == 0, _("Loading BLOB into editor."));
-            editorModeM = text;
+            FRInputBlobStream inpblob(blobM);
+            if (!isTextual)
+                res = loadFromStreamAsBinary(inpblob, blobM == 0, _("Loading BLOB into editor."));
+            else
+                res = loadFromStreamAsText(inpblob, blobM == 0, _("Loading BLOB into editor."));
         }
 
         dataValidM.insert(editorModeM);
@@ -634,12 +939,157 @@ bool EditBlobDialog::loadBlob()
         res = true;
     }
 
+    pageUpdateControls();
     // enable wxNotebookPageChanged-Events
     runningM = true;
 
     return res;
 }
 
+void EditBlobDialog::pagerDelete()
+{
+    searchStop();
+    delete pagerM;
+    pagerM = 0;
+    pageM = 0;
+}
+
+// keeps the changes of the current page until the BLOB is saved
+bool EditBlobDialog::pageKeepEdits()
+{
+    if (!pagerM || !dataModifiedM)
+        return true;
+
+    wxMemoryOutputStream mos;
+    bool isNull;
+    if (!saveToStream(mos, &isNull, _("Keeping the changes of the page.")))
+        return false;
+    std::string data(mos.GetSize(), '\0');
+    if (!data.empty())
+        mos.CopyTo(&data[0], data.size());
+    editedPagesM[pageM] = data;
+    dataSetModified(false, editorModeM);
+    dataUpdateGUI();
+    return true;
+}
+
+bool EditBlobDialog::pageRead(int page, std::string& data)
+{
+    std::map<int, std::string>::iterator it = editedPagesM.find(page);
+    if (it != editedPagesM.end())
+    {
+        data = (*it).second;
+        return true;
+    }
+
+    int end = pagerM->getPageEnd(page);
+    int needed = pagerM->getSpoolNeeded(end);
+    if (!pagerM->isSeekable() && needed > 0)
+    {
+        progressBegin(_("Reading BLOB."), needed, true);
+        bool ok = pagerM->spool(end, progress);
+        progressEnd();
+        if (!ok)
+            return false;
+    }
+    pagerM->readPage(page, data);
+    return true;
+}
+
+bool EditBlobDialog::pageLoad(int page)
+{
+    std::string data;
+    if (!pageRead(page, data))
+        return false;
+
+    wxMemoryInputStream mis(data.data(), data.size());
+    wxString title(_("Loading BLOB page into editor."));
+    bool res;
+    if (editorModeM == binary)
+        res = loadFromStreamAsBinary(mis, false, title);
+    else
+        res = loadFromStreamAsText(mis, false, title);
+    if (!res)
+        return false;
+
+    pageM = page;
+    // a page border can split a multi-byte character, such a page can't
+    // be changed without damaging the character
+    if (editorModeM == text && !readonlyM
+        && wx2std(blob_text->GetText(), converterM) != data)
+    {
+        blob_textSetReadonly(true);
+    }
+    pageUpdateControls();
+    return true;
+}
+
+// writes all pages with their changes, in BLOB segments when the stream
+// is a FROutputBlobStream
+bool EditBlobDialog::pagesSaveToStream(wxOutputStream& stream,
+    const wxString& progressTitle)
+{
+    if (!pageKeepEdits())
+        return false;
+
+    // spool segmented BLOBs first, so that there's only one progress
+    int needed = pagerM->getSpoolNeeded(pagerM->getSize());
+    if (!pagerM->isSeekable() && needed > 0)
+    {
+        progressBegin(_("Reading BLOB."), needed, true);
+        bool ok = pagerM->spool(pagerM->getSize(), progress);
+        progressEnd();
+        if (!ok)
+            return false;
+    }
+
+    int pageCount = pagerM->getPageCount();
+    progressBegin(progressTitle, pageCount, true);
+    bool ok = true;
+    for (int page = 0; ok && page < pageCount; ++page)
+    {
+        std::string data;
+        ok = !progress->isCanceled() && pageRead(page, data);
+        if (ok && !data.empty())
+            stream.Write(data.data(), data.size());
+        progress->stepProgress(1);
+    }
+    progressEnd();
+    return ok;
+}
+
+void EditBlobDialog::pageUpdateControls()
+{
+    bool paged = (pagerM != 0);
+    button_page_prev->Show(paged);
+    button_page_next->Show(paged);
+    label_page->Show(paged);
+    text_find->Show(paged);
+    button_find->Show(paged);
+    if (paged)
+    {
+        int pageCount = pagerM->getPageCount();
+        label_page->SetLabel(searchThreadM ? _("Searching...")
+            : wxString::Format(_("Bytes %d - %d of %d"),
+                pagerM->getPageStart(pageM), pagerM->getPageEnd(pageM),
+                pagerM->getSize()));
+        button_page_prev->Enable(!searchThreadM && pageM > 0);
+        button_page_next->Enable(!searchThreadM && pageM + 1 < pageCount);
+        button_find->Enable(!searchThreadM);
+    }
+    getControlsPanel()->Layout();
+}
+
+void EditBlobDialog::searchStop()
+{
+    if (!searchThreadM)
+        return;
+    searchThreadM->cancel();
+    searchThreadM->Wait();
+    delete searchThreadM;
+    searchThreadM = 0;
+}
+
 bool EditBlobDialog::loadFromStreamAsText(wxInputStream& stream, bool isNull, const wxString& progressTitle)
 {
     if (isNull)
@@ -691,7 +1141,7 @@ bool EditBlobDialog::loadFromStreamAsText(wxInputStream& stream, bool isNull, co
 
     if (!progress->isCanceled())
     {
-        blob_text->SetText(buffer);
+        blob_text->SetText(wxString(buffer, *converterM, readed));
     }
 
     free(buffer);
@@ -877,7 +1327,7 @@ bool EditBlobDialog::saveToStream(wxOutputStream& stream, bool* isNull, const wx
                 if (*isNull)
                   break;
 
-                std::string txt = wx2std(blob_text->GetText());
+                std::string txt = wx2std(blob_text->GetText(), converterM);
                 stream.Write(txt.c_str(), txt.length());
             }
             break;
@@ -966,9 +1416,22 @@ void EditBlobDialog::do_layout()
     sizerTop->AddSpacer(styleguide().getUnrelatedControlMargin(wxVERTICAL));
     sizerTop->Add(progress, 1, wxEXPAND);
     
+    wxBoxSizer* sizerPages = new wxBoxSizer(wxHORIZONTAL);
+    sizerPages->Add(button_page_prev, 0, wxALIGN_CENTER_VERTICAL);
+    sizerPages->AddSpacer(styleguide().getRelatedControlMargin(wxHORIZONTAL));
+    sizerPages->Add(button_page_next, 0, wxALIGN_CENTER_VERTICAL);
+    sizerPages->AddSpacer(styleguide().getRelatedControlMargin(wxHORIZONTAL));
+    sizerPages->Add(label_page, 1, wxALIGN_CENTER_VERTICAL);
+    sizerPages->AddSpacer(styleguide().getUnrelatedControlMargin(wxHORIZONTAL));
+    sizerPages->Add(text_find, 1, wxALIGN_CENTER_VERTICAL);
+    sizerPages->AddSpacer(styleguide().getRelatedControlMargin(wxHORIZONTAL));
+    sizerPages->Add(button_find, 0, wxALIGN_CENTER_VERTICAL);
+
     wxBoxSizer* sizerControls = new wxBoxSizer(wxVERTICAL);
     //sizerControls->Add(button_menu_blob, 0, wxALIGN_LEFT);
     sizerControls->Add(sizerTop, 0, wxEXPAND);
+    sizerControls->Add(sizerPages, 0, wxEXPAND | wxTOP,
+        styleguide().getRelatedControlMargin(wxVERTICAL));
     sizerControls->AddSpacer(styleguide().getFrameMargin(wxLEFT));
     sizerControls->Add(notebook, 1, wxEXPAND);
     //sizerControls->AddSpacer(styleguide().getFrameMargin(wxLEFT));
@@ -981,10 +1444,39 @@ void EditBlobDialog::do_layout()
     Centre();
     
     progress->Layout();
+    pageUpdateControls();
 }
 
 void EditBlobDialog::saveBlob()
 {
+    if (pagerM)
+    {
+        if (!pageKeepEdits() || editedPagesM.empty())
+            return;
+
+        // the new BLOB is a stream BLOB, so it can be paged with Seek()
+        DataGridRowsBlob b = dataGridTableM->setBlobPrepare(rowM, colM);
+        FROutputBlobStream bs(b.blob, true);
+        bool ok = pagesSaveToStream(bs, _("Saving editor-data."));
+        bs.Close();
+        if (!ok)
+            return;
+        dataGridTableM->setBlob(b);
+        dataGridM->refreshAndInvalidateAttributes();
+
+        // continue with the saved BLOB on the same page
+        int page = pageM;
+        pagerDelete();
+        editedPagesM.clear();
+        blobM = b.blob;
+        pagerM = new EditBlobDialogPager(blobM, getBlobSize(blobM),
+            getBlobEditorPageSize());
+        dataSetModified(false, editorModeM);
+        dataUpdateGUI();
+        pageLoad(std::min(page, pagerM->getPageCount() - 1));
+        return;
+    }
+
     // If there is no blob loaded (no Data) OR
     // data wasn't modified and cache isn't initialized (cacheM = 0)
     // then data was not changed.
@@ -1105,6 +1597,26 @@ void EditBlobDialog::OnNotebookPageChanged(wxNotebookEvent& event)
     if (pageId == noData)
         return;
 
+    // pages are shown in the other mode as they are
+    if (pagerM)
+    {
+        if (!pageKeepEdits())
+        {
+            notebook->ChangeSelection(oldPage);
+            return;
+        }
+        editorModeM = (EditorMode)pageId;
+        if (!pageLoad(pageM))
+        {
+            showErrorDialog(this, _("ERROR"),
+                _("A error occured while switching editor-mode. (Loading)"),
+                AdvancedMessageDialogButtonsOk());
+        }
+        dataValidM.clear();
+        dataValidM.insert(editorModeM);
+        return;
+    }
+
     // Save data to cache
     // We only store the data if it was changed by the user
     if (dataModifiedM)
@@ -1197,6 +1709,18 @@ void EditBlobDialog::OnMenuBLOBLoadFromFile(wxCommandEvent& WXUNUSED(event))
     if (filename.IsEmpty())
         return;
 
+    // large BLOBs are replaced by the file without loading it
+    if (pagerM)
+    {
+        pagerDelete();
+        editedPagesM.clear();
+        dataSetModified(false, editorModeM);
+        dataGridTableM->importBlobFile(filename, rowM, colM);
+        dataGridM->refreshAndInvalidateAttributes();
+        loadBlob();
+        return;
+    }
+
     cacheDelete();
     
     bool res;
@@ -1230,6 +1754,11 @@ void EditBlobDialog::OnMenuBLOBSaveToFile(wxCommandEvent& WXUNUSED(event))
     //dgt->exportBlobFile(filename, grid_data->GetGridCursorRow(),
     //    grid_data->GetGridCursorCol(), &pd);
     wxFileOutputStream fs(filename);
+    if (pagerM)
+    {
+        pagesSaveToStream(fs, _("Saving BLOB to file"));
+        return;
+    }
     bool dummy;
     saveToStream(fs, &dummy, _("Importing BLOB from file"));
 }
@@ -1238,7 +1767,7 @@ void EditBlobDialog::dataUpdateGUI()
 {
     wxString status;
     bool canSave;
-    if ((dataModifiedM) || (cacheM))
+    if ((dataModifiedM) || (cacheM) || (!editedPagesM.empty()))
     {
         status = "*";
         canSave = true;
@@ -1286,6 +1815,9 @@ void EditBlobDialog::progressBegin(const wxString& progressTitle, int maxPositio
 {
     button_menu_blob->Enable(false);
     notebook->Enable(false);
+    button_page_prev->Enable(false);
+    button_page_next->Enable(false);
+    button_find->Enable(false);
     
     progressCancel();
     progress->initProgress(progressTitle, maxPosition, canCancel);
@@ -1315,6 +1847,120 @@ void EditBlobDialog::progressEnd()
 
     button_menu_blob->Enable(true);
     notebook->Enable(true);
+    pageUpdateControls();
+}
+
+void EditBlobDialog::OnPagePrev(wxCommandEvent& WXUNUSED(event))
+{
+    if (pagerM && pageM > 0 && pageKeepEdits() && pageLoad(pageM - 1))
+        searchFromM = pagerM->getPageStart(pageM);
+}
+
+void EditBlobDialog::OnPageNext(wxCommandEvent& WXUNUSED(event))
+{
+    if (pagerM && pageM + 1 < pagerM->getPageCount() && pageKeepEdits()
+        && pageLoad(pageM + 1))
+    {
+        searchFromM = pagerM->getPageStart(pageM);
+    }
+}
+
+int EditBlobDialog::getTextPos(const std::string& text, int offset)
+{
+    // the editor stores its text as UTF-8, whatever the character set
+    // of the BLOB is
+    offset = std::min(offset, int(text.size()));
+    wxString prefix(text.data(), *converterM, offset);
+    return int(prefix.utf8_str().length());
+}
+
+void EditBlobDialog::OnFind(wxCommandEvent& WXUNUSED(event))
+{
+    if (!pagerM || searchThreadM)
+        return;
+
+    wxString what(text_find->GetValue());
+    std::string pattern;
+    if (editorModeM == binary)
+    {
+        // hexadecimal digits, spaces are ignored
+        what.Replace(" ", "");
+        if (what.length() % 2 != 0)
+            throw FRError(_("Enter the bytes to find as hexadecimal digits."));
+        for (size_t i = 0; i < what.length(); i += 2)
+        {
+            unsigned long value;
+            if (!what.Mid(i, 2).ToULong(&value, 16))
+                throw FRError(_("Enter the bytes to find as hexadecimal digits."));
+            pattern += char(value);
+        }
+    }
+    else
+        pattern = wx2std(what, converterM);
+    if (pattern.empty())
+        return;
+
+    // the thread searches the spooled BLOB, so changed pages that are not
+    // saved yet are searched with their original content
+    int needed = pagerM->getSpoolNeeded(pagerM->getSize());
+    if (needed > 0)
+    {
+        progressBegin(_("Reading BLOB."), needed, true);
+        bool ok = pagerM->spool(pagerM->getSize(), progress);
+        progressEnd();
+        if (!ok)
+            return;
+    }
+
+    searchThreadM = new EditBlobDialogSearchThread(this,
+        pagerM->getSpoolFileName(), pattern, searchFromM);
+    if (searchThreadM->Run() != wxTHREAD_NO_ERROR)
+    {
+        delete searchThreadM;
+        searchThreadM = 0;
+        throw FRError(_("Cannot start the search."));
+    }
+    pageUpdateControls();
+}
+
+void EditBlobDialog::OnSearchDone(wxCommandEvent& event)
+{
+    // events of stopped searches are ignored
+    if (!searchThreadM)
+        return;
+    searchThreadM->Wait();
+    delete searchThreadM;
+    searchThreadM = 0;
+    pageUpdateControls();
+
+    int found = event.GetInt();
+    if (!pagerM || found < 0)
+    {
+        wxMessageBox(_("The data was not found after the current position."),
+            _("Find"), wxOK | wxICON_INFORMATION, this);
+        return;
+    }
+    int page = pagerM->getPage(found);
+    if (page != pageM && !(pageKeepEdits() && pageLoad(page)))
+        return;
+    searchFromM = found + 1;
+
+    // select the data that was found
+    int from = found - pagerM->getPageStart(page);
+    int to = from + int(event.GetExtraLong());
+    if (editorModeM == binary)
+    {
+        blob_binary->SetSelection(getBinaryTextPos(from),
+            getBinaryTextPos(to - 1) + 2);
+        blob_binary->EnsureCaretVisible();
+    }
+    else
+    {
+        std::string text(wx2std(blob_text->GetText(), converterM));
+        blob_text->SetSelection(getTextPos(text, from),
+            getTextPos(text, to));
+        blob_text->EnsureCaretVisible();
+    }
 }
 
 //! event handling
@@ -1337,6 +1983,12 @@ BEGIN_EVENT_TABLE(EditBlobDialog, BaseDialog)
 
     // Progress
     EVT_BUTTON(Cmds::BlobEditor_ProgressCancel, EditBlobDialog::OnProgressCancel)
+
+    // Pages
+    EVT_BUTTON(Cmds::BlobEditor_PagePrev, EditBlobDialog::OnPagePrev)
+    EVT_BUTTON(Cmds::BlobEditor_PageNext, EditBlobDialog::OnPageNext)
+    EVT_BUTTON(Cmds::BlobEditor_Find, EditBlobDialog::OnFind)
+    EVT_MENU(Cmds::BlobEditor_SearchDone, EditBlobDialog::OnSearchDone)
 END_EVENT_TABLE()
 
 // Helper-Class for streaming into blob / buffer
@@ -1376,11 +2028,14 @@ size_t FRInputBlobStream::GetSize() const
 
 // Helper-Class for streaming into blob / buffer
 // frOutputBlobStream
-FROutputBlobStream::FROutputBlobStream(IBPP::Blob blob)
+FROutputBlobStream::FROutputBlobStream(IBPP::Blob blob, bool streamBlob)
     :wxOutputStream()
 {
     blobM = blob;
-    blobM->Create();
+    if (streamBlob)
+        blobM->CreateStream();
+    else
+        blobM->Create();
 }
 
 FROutputBlobStream::~FROutputBlobStream()
@@ -1393,7 +2048,14 @@ size_t FROutputBlobStream::OnSysWrite(const void* buffer, size_t bufsize)
     if (bufsize == 0)
         return 0;
 
-    blobM->Write(buffer, bufsize);
+    // segments can't be larger than 64 KB - 1
+    const char* data = (const char*)buffer;
+    for (size_t done = 0; done < bufsize; )
+    {
+        int len = int(std::min(bufsize - done, size_t(32767)));
+        blobM->Write(data + done, len);
+        done += len;
+    }
     return bufsize;
 }
 
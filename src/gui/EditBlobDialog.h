@@ -29,14 +29,18 @@
 #include <wx/stc/stc.h>
 #include <wx/wx.h>
 
+#include <map>
 #include <set>
+#include <string>
 
 #include "controls/DataGrid.h"
 #include "gui/BaseDialog.h"
 #include "gui/CommandManager.h"
 
 
+class EditBlobDialogPager; // declared in cpp
 class EditBlobDialogProgressSizer; // declared in cpp
+class EditBlobDialogSearchThread; // declared in cpp
 class EditBlobDialogSTCText; // declared in cpp
 class EditBlobDialogSTC;     // declared in cpp
 
@@ -73,6 +77,16 @@ private:
     bool dataModifiedM;
     bool loadingM;
     bool readonlyM;
+    // character set of the text in text mode, that of the connection
+    wxMBConv* converterM;
+
+    // BLOBs above the configured size are shown one page at a time,
+    // edited pages are kept until the BLOB is saved
+    EditBlobDialogPager* pagerM;
+    int pageM;
+    std::map<int, std::string> editedPagesM;
+    EditBlobDialogSearchThread* searchThreadM;
+    int searchFromM;
     /*
     // activate later if plugin will be implemented
     // Dialog-Plugin-lib
@@ -116,6 +130,18 @@ private:
     // Saving (Blob/Stream)
     bool saveToStream(wxOutputStream& stream, bool* isNull, const wxString& progressTitle);
 
+    // paging
+    void pagerDelete();
+    bool pageKeepEdits();
+    bool pageLoad(int page);
+    bool pageRead(int page, std::string& data);
+    bool pagesSaveToStream(wxOutputStream& stream, const wxString& progressTitle);
+    void pageUpdateControls();
+    // searching (pages only)
+    void searchStop();
+    // position in the text editor of a byte offset into its encoded text
+    int getTextPos(const std::string& text, int offset);
+
     // initialization
     void buildMenus(CommandManager& cm);
     void do_layout();
@@ -137,6 +163,10 @@ private:
     void OnMenuBLOBSaveToFile(wxCommandEvent& WXUNUSED(event));
     void OnNotebookPageChanged(wxNotebookEvent& WXUNUSED(event));
     void OnProgressCancel(wxCommandEvent& WXUNUSED(event));
+    void OnPagePrev(wxCommandEvent& WXUNUSED(event));
+    void OnPageNext(wxCommandEvent& WXUNUSED(event));
+    void OnFind(wxCommandEvent& WXUNUSED(event));
+    void OnSearchDone(wxCommandEvent& event);
     void OnResetButtonClick(wxCommandEvent& WXUNUSED(event));
     void OnSaveButtonClick(wxCommandEvent& WXUNUSED(event));
 protected:
@@ -149,6 +179,11 @@ protected:
     wxButton* button_reset;
     wxButton* button_save;
     wxButton* button_menu_blob;
+    wxButton* button_page_prev;
+    wxButton* button_page_next;
+    wxStaticText* label_page;
+    wxTextCtrl* text_find;
+    wxButton* button_find;
     wxMenu* menu_blob;
     DECLARE_EVENT_TABLE()
 };
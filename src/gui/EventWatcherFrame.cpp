@@ -43,12 +43,16 @@
 #include "gui/StyleGuide.h"
 #include "metadata/database.h"
 
+// events received within this interval are shown together
+static const long eventCoalesceMillis = 100;
+
 class EventLogControl: public LogTextControl
 {
 public:
     EventLogControl(wxWindow* parent, wxWindowID id = wxID_ANY);
     void logAction(const wxString& action);
-    void logEvent(const wxString& name, int count);
+    void logError(const wxString& error);
+    void logEvents(const std::map<std::string, int>& counts);
 };
 
 EventLogControl::EventLogControl(wxWindow* parent, wxWindowID id)
@@ -63,16 +67,62 @@ void EventLogControl::logAction(const wxString& action)
     logMsg(action + "\n");
 }
 
-void EventLogControl::logEvent(const wxString& name, int count)
+void EventLogControl::logError(const wxString& error)
+{
+    wxString now(wxDateTime::Now().Format("%H:%M:%S  "));
+    addStyledText(now, logStyleImportant);
+    logErrorMsg(error + "\n");
+}
+
+// logs all events received together on one line
+void EventLogControl::logEvents(const std::map<std::string, int>& counts)
 {
     wxString now(wxDateTime::Now().Format("%H:%M:%S  "));
     addStyledText(now, logStyleImportant);
-    logMsg(name);
-    addStyledText(wxString::Format(" (%d)\n", count), logStyleError);
+    std::map<std::string, int>::const_iterator it;
+    for (it = counts.begin(); it != counts.end(); ++it)
+    {
+        if (it != counts.begin())
+            logMsg(", ");
+        logMsg(wxString((*it).first.c_str(), *wxConvCurrent));
+        addStyledText(wxString::Format(" (%d)", (*it).second), logStyleError);
+    }
+    logMsg("\n");
+}
+
+// EventListenerThread class
+// Waits until the Firebird client signals trapped events and dispatches
+// them, so that the frame is only woken when there is something to show
+class EventListenerThread: public wxThread
+{
+private:
+    EventWatcherFrame* frameM;
+public:
+    EventListenerThread(EventWatcherFrame* frame);
+    virtual ExitCode Entry();
+};
+
+EventListenerThread::EventListenerThread(EventWatcherFrame* frame)
+    : wxThread(wxTHREAD_JOINABLE), frameM(frame)
+{
+}
+
+wxThread::ExitCode EventListenerThread::Entry()
+{
+    while (!TestDestroy())
+    {
+        if (frameM->trappedM.WaitTimeout(eventCoalesceMillis)
+            == wxSEMA_NO_ERROR)
+        {
+            frameM->dispatchEvents();
+        }
+        frameM->notifyPendingEvents();
+    }
+    return 0;
 }
 
 EventWatcherFrame::EventWatcherFrame(wxWindow* parent, DatabasePtr db)
-    : BaseFrame(parent, -1, wxEmptyString), databaseM(db), eventsM(0)
+    : BaseFrame(parent, -1, wxEmptyString), databaseM(db), listenerM(0)
 {
     wxASSERT(db);
     timerM.SetOwner(this, ID_timer);
@@ -96,6 +146,12 @@ EventWatcherFrame::EventWatcherFrame(wxWindow* parent, DatabasePtr db)
     SetIcon(icon);
 }
 
+bool EventWatcherFrame::Destroy()
+{
+    stopMonitoring();
+    return BaseFrame::Destroy();
+}
+
 void EventWatcherFrame::createControls()
 {
     panel_controls = new wxPanel(this, -1, wxDefaultPosition, wxDefaultSize,
@@ -104,8 +160,11 @@ void EventWatcherFrame::createControls()
         _("Monitored events"));
     static_text_received = new wxStaticText(panel_controls, wxID_ANY,
         _("Received events"));
-    listbox_monitored = new wxListBox(panel_controls, ID_listbox_monitored,
-        wxDefaultPosition, wxDefaultSize, 0, 0, wxLB_EXTENDED);
+    listctrl_monitored = new wxListCtrl(panel_controls, ID_listctrl_monitored,
+        wxDefaultPosition, wxDefaultSize, wxLC_REPORT);
+    listctrl_monitored->InsertColumn(0, _("Event"));
+    listctrl_monitored->InsertColumn(1, _("Received"), wxLIST_FORMAT_RIGHT);
+    listctrl_monitored->InsertColumn(2, _("Events/sec"), wxLIST_FORMAT_RIGHT);
     eventlog_received = new EventLogControl(panel_controls,
         ID_log_received);
     button_add = new wxButton(panel_controls, ID_button_add, _("&Add Events"));
@@ -122,7 +181,7 @@ void EventWatcherFrame::layoutControls()
     wxBoxSizer* sizerList = new wxBoxSizer(wxVERTICAL);
     sizerList->Add(static_text_monitored);
     sizerList->AddSpacer(styleguide().getControlLabelMargin());
-    sizerList->Add(listbox_monitored, 1, wxEXPAND);
+    sizerList->Add(listctrl_monitored, 1, wxEXPAND);
 
     wxBoxSizer* sizerLog = new wxBoxSizer(wxVERTICAL);
     sizerLog->Add(static_text_received);
@@ -168,26 +227,24 @@ void EventWatcherFrame::layoutControls()
 
 void EventWatcherFrame::updateControls()
 {
-    bool isSelected = false;
-    bool hasEvents = !listbox_monitored->IsEmpty();
-    if (hasEvents)
-    {
-        wxArrayInt sel;
-        isSelected = listbox_monitored->GetSelections(sel) > 0;
-    }
+    bool hasEvents = listctrl_monitored->GetItemCount() > 0;
+    bool isSelected = listctrl_monitored->GetSelectedItemCount() > 0;
     button_remove->Enable(isSelected);
     button_save->Enable(hasEvents);
-    button_monitor->Enable(hasEvents || timerM.IsRunning());
+    button_monitor->Enable(hasEvents || isMonitoring());
 }
 
 void EventWatcherFrame::addEvents(wxString& s)
 {
     // deselect all items so user can cleanly see what is added
-    for (int ix = 0; ix < (int)listbox_monitored->GetCount(); ++ix)
+    long item = -1;
+    while ((item = listctrl_monitored->GetNextItem(item, wxLIST_NEXT_ALL,
+        wxLIST_STATE_SELECTED)) != -1)
     {
-        if (listbox_monitored->IsSelected(ix))
-            listbox_monitored->Deselect(ix);
+        listctrl_monitored->SetItemState(item, 0, wxLIST_STATE_SELECTED);
     }
+
+    listctrl_monitored->Freeze();
     while (true)
     {
         int p = s.Find("\n");
@@ -200,40 +257,67 @@ void EventWatcherFrame::addEvents(wxString& s)
             s.Remove(0, p);
             s.Trim(false);
         }
-        if (!s2.IsEmpty() && listbox_monitored->FindString(s2) == wxNOT_FOUND)
-            listbox_monitored->Select(listbox_monitored->Append(s2));
+        if (!s2.IsEmpty() && listctrl_monitored->FindItem(-1, s2) == -1)
+        {
+            item = listctrl_monitored->InsertItem(
+                listctrl_monitored->GetItemCount(), s2);
+            listctrl_monitored->SetItemState(item, wxLIST_STATE_SELECTED,
+                wxLIST_STATE_SELECTED);
+        }
         if (p == -1)
             break;
     }
+    listctrl_monitored->Thaw();
+    resetEventStats();
     updateControls();
 }
 
-void EventWatcherFrame::defineMonitoredEvents()
+wxArrayString EventWatcherFrame::getMonitoredEvents() const
 {
-    if (eventsM != 0)
+    wxArrayString events;
+    for (long i = 0; i < listctrl_monitored->GetItemCount(); i++)
+        events.Add(listctrl_monitored->GetItemText(i));
+    return events;
+}
+
+// list items are indexed by event name, the index has to be rebuilt
+// whenever items are added or removed
+void EventWatcherFrame::resetEventStats()
+{
+    statsM.clear();
+    for (long i = 0; i < listctrl_monitored->GetItemCount(); i++)
     {
-        // prevent timer from messing our business
-        bool timerRunning = timerM.IsRunning();
-        setTimerActive(false);
-
-        // get a list of events to be monitored
-        std::vector<std::string> events;
-        for (int i = 0; i < (int)listbox_monitored->GetCount(); i++)
-            events.push_back(wx2std(listbox_monitored->GetString(i)));
-
-        eventsM->Clear();
-        std::vector<std::string>::const_iterator it;
-        for (it = events.begin(); it != events.end(); it++)
-        {
-            eventsM->Add(*it, this);
-            // make IBPP::Events pick up the initial event count
-            eventsM->Dispatch();
-        }
+        EventStats stats = { i, 0, 0, 0.0 };
+        statsM[wx2std(listctrl_monitored->GetItemText(i))] = stats;
+        listctrl_monitored->SetItem(i, 1, wxEmptyString);
+        listctrl_monitored->SetItem(i, 2, wxEmptyString);
+    }
+    rateWindowStartMillisM = ::wxGetLocalTimeMillis();
+}
+
+void EventWatcherFrame::defineMonitoredEvents()
+{
+    if (!isMonitoring())
+        return;
 
-        updateControls();
-        if (timerRunning)
-            setTimerActive(true);
+    // get a list of events to be monitored
+    std::vector<std::string> events;
+    for (long i = 0; i < listctrl_monitored->GetItemCount(); i++)
+        events.push_back(wx2std(listctrl_monitored->GetItemText(i)));
+
+    wxCriticalSectionLocker locker(eventsCritsectM);
+    eventsM.clear();
+    // every IBPP::Events object is queued once for all the names it takes,
+    // the initial counts are picked up by the listener thread
+    std::vector<std::string>::const_iterator it = events.begin();
+    while (it != events.end())
+    {
+        IBPP::Events ev = IBPP::EventsFactory(ibppDatabaseM);
+        ev->SetTrapInterface(this);
+        eventsM.push_back(ev);
+        it += ev->Add(std::vector<std::string>(it, events.end()), this);
     }
+    updateControls();
 }
 
 DatabasePtr EventWatcherFrame::getDatabase() const
@@ -241,40 +325,116 @@ DatabasePtr EventWatcherFrame::getDatabase() const
     return databaseM.lock();
 }
 
-bool EventWatcherFrame::setTimerActive(bool active)
+bool EventWatcherFrame::isMonitoring() const
 {
-    if (active && !timerM.Start(100))
-        wxMessageBox(_("Can not start timer"), _("Error"), wxOK | wxICON_ERROR);
-        
-    if (!active && timerM.IsRunning())
+    return listenerM != 0;
+}
+
+void EventWatcherFrame::startMonitoring()
+{
+    DatabasePtr database = getDatabase();
+    if (!database)
+    {
+        Close();
+        return;
+    }
+    ibppDatabaseM = database->getIBPPDatabase();
+
+    EventListenerThread* listener = new EventListenerThread(this);
+    if (listener->Create() != wxTHREAD_NO_ERROR
+        || listener->Run() != wxTHREAD_NO_ERROR)
     {
-        timerM.Stop();
-        wxSafeYield();
+        delete listener;
+        wxMessageBox(_("Can not start event listener thread"), _("Error"),
+            wxOK | wxICON_ERROR);
+        return;
     }
-    return active == timerM.IsRunning();
+    listenerM = listener;
+    pendingNotifiedMillisM = 0;
+    resetEventStats();
+    timerM.Start(1000);
+    defineMonitoredEvents();
+}
+
+void EventWatcherFrame::stopMonitoring()
+{
+    timerM.Stop();
+    {
+        // cancels the events, so no more notifications arrive
+        wxCriticalSectionLocker locker(eventsCritsectM);
+        eventsM.clear();
+    }
+    if (listenerM)
+    {
+        listenerM->Delete();
+        delete listenerM;
+        listenerM = 0;
+    }
+    ibppDatabaseM.clear();
+
+    wxCriticalSectionLocker locker(pendingCritsectM);
+    pendingCountsM.clear();
+    pendingErrorM.clear();
 }
 
 void EventWatcherFrame::updateMonitoringActive()
 {
-    if (eventsM != 0)
+    if (isMonitoring())
     {
-        setTimerActive(true);
         button_monitor->SetLabel(_("Stop &Monitoring"));
         eventlog_received->logAction(_("Monitoring started"));
     }
     else
     {
-        timerM.Stop();
         button_monitor->SetLabel(_("Start &Monitoring"));
         eventlog_received->logAction(_("Monitoring stopped"));
     }
     updateControls();
 }
 
-void EventWatcherFrame::ibppEventHandler(IBPP::Events events,
+void EventWatcherFrame::dispatchEvents()
+{
+    wxCriticalSectionLocker locker(eventsCritsectM);
+    try
+    {
+        for (size_t i = 0; i < eventsM.size(); i++)
+            eventsM[i]->Dispatch();
+    }
+    catch (IBPP::Exception& e)
+    {
+        wxCriticalSectionLocker pendingLocker(pendingCritsectM);
+        pendingErrorM = e.what();
+    }
+}
+
+// wakes the frame at most once per coalesce interval
+void EventWatcherFrame::notifyPendingEvents()
+{
+    wxLongLong millisNow = ::wxGetLocalTimeMillis();
+    {
+        wxCriticalSectionLocker locker(pendingCritsectM);
+        if (pendingCountsM.empty() && pendingErrorM.empty())
+            return;
+        if (millisNow - pendingNotifiedMillisM < eventCoalesceMillis)
+            return;
+        pendingNotifiedMillisM = millisNow;
+    }
+    wxCommandEvent event(wxEVT_COMMAND_MENU_SELECTED, ID_events_received);
+    wxPostEvent(this, event);
+}
+
+// called by the listener thread from within Dispatch()
+void EventWatcherFrame::ibppEventHandler(IBPP::Events WXUNUSED(events),
     const std::string& name, int count)
 {
-    eventlog_received->logEvent(name, count);
+    wxCriticalSectionLocker locker(pendingCritsectM);
+    pendingCountsM[name] += count;
+}
+
+// called on a thread of the Firebird client library
+void EventWatcherFrame::ibppEventsTrapped(IBPP::IEvents* WXUNUSED(events))
+{
+    trappedM.Post();
 }
 
 //! closes window if database is removed (unregistered)
@@ -297,7 +457,10 @@ void EventWatcherFrame::doReadConfigSettings(const wxString& prefix)
     BaseFrame::doReadConfigSettings(prefix);
     wxArrayString events;
     config().getValue(prefix + Config::pathSeparator + "events", events);
-    listbox_monitored->Append(events);
+    for (size_t i = 0; i < events.GetCount(); i++)
+        listctrl_monitored->InsertItem(listctrl_monitored->GetItemCount(),
+            events[i]);
+    resetEventStats();
     updateControls();
 }
 
@@ -305,7 +468,7 @@ void EventWatcherFrame::doWriteConfigSettings(const wxString& prefix) const
 {
     BaseFrame::doWriteConfigSettings(prefix);
     config().setValue(prefix + Config::pathSeparator + "events",
-        listbox_monitored->GetStrings());
+        getMonitoredEvents());
 }
 
 const wxString EventWatcherFrame::getName() const
@@ -335,7 +498,9 @@ BEGIN_EVENT_TABLE(EventWatcherFrame, wxFrame)
     EVT_BUTTON(EventWatcherFrame::ID_button_load, EventWatcherFrame::OnButtonLoadClick)
     EVT_BUTTON(EventWatcherFrame::ID_button_save, EventWatcherFrame::OnButtonSaveClick)
     EVT_BUTTON(EventWatcherFrame::ID_button_monitor, EventWatcherFrame::OnButtonStartStopClick)
-    EVT_LISTBOX(EventWatcherFrame::ID_listbox_monitored, EventWatcherFrame::OnListBoxSelected)
+    EVT_LIST_ITEM_SELECTED(EventWatcherFrame::ID_listctrl_monitored, EventWatcherFrame::OnListSelectionChanged)
+    EVT_LIST_ITEM_DESELECTED(EventWatcherFrame::ID_listctrl_monitored, EventWatcherFrame::OnListSelectionChanged)
+    EVT_MENU(EventWatcherFrame::ID_events_received, EventWatcherFrame::OnEventsReceived)
     EVT_TIMER(EventWatcherFrame::ID_timer, EventWatcherFrame::OnTimer)
 END_EVENT_TABLE()
 
@@ -371,8 +536,8 @@ void EventWatcherFrame::OnButtonSaveClick(wxCommandEvent& WXUNUSED(event))
 
     wxBusyCursor wait;
     wxString s;
-    for (int i = 0; i < (int)listbox_monitored->GetCount(); ++i)
-        s += listbox_monitored->GetString(i) + "\n";
+    for (long i = 0; i < listctrl_monitored->GetItemCount(); ++i)
+        s += listctrl_monitored->GetItemText(i) + "\n";
 
     wxFile f;
     if (!f.Open(fd.GetPath(), wxFile::write) || !f.Write(s))
@@ -399,46 +564,102 @@ void EventWatcherFrame::OnButtonAddClick(wxCommandEvent& WXUNUSED(event))
 
 void EventWatcherFrame::OnButtonRemoveClick(wxCommandEvent& WXUNUSED(event))
 {
-    wxArrayInt sel;
-    if (listbox_monitored->GetSelections(sel) == 0)
+    std::vector<long> sel;
+    long item = -1;
+    while ((item = listctrl_monitored->GetNextItem(item, wxLIST_NEXT_ALL,
+        wxLIST_STATE_SELECTED)) != -1)
+    {
+        sel.push_back(item);
+    }
+    if (sel.empty())
         return;
 
     wxBusyCursor wait;
     // going backwards to keep indexes valid
-    for (int ix = sel.GetCount() - 1; ix >= 0; --ix)
-        listbox_monitored->Delete(sel.Item(ix));
+    listctrl_monitored->Freeze();
+    for (std::vector<long>::reverse_iterator it = sel.rbegin();
+        it != sel.rend(); ++it)
+    {
+        listctrl_monitored->DeleteItem(*it);
+    }
+    listctrl_monitored->Thaw();
+    resetEventStats();
     defineMonitoredEvents();
+    updateControls();
 }
 
 void EventWatcherFrame::OnButtonStartStopClick(wxCommandEvent& WXUNUSED(event))
 {
-    if (eventsM != 0)
-        eventsM.clear();
+    if (isMonitoring())
+        stopMonitoring();
     else
+        startMonitoring();
+    updateMonitoringActive();
+}
+
+void EventWatcherFrame::OnEventsReceived(wxCommandEvent& WXUNUSED(event))
+{
+    std::map<std::string, int> counts;
+    wxString error;
     {
-        DatabasePtr database = getDatabase();
-        if (!database)
-        {
-            Close();
-            return;
-        }
-        IBPP::Database db(database->getIBPPDatabase());
-        eventsM = IBPP::EventsFactory(db);
-        defineMonitoredEvents();
+        wxCriticalSectionLocker locker(pendingCritsectM);
+        counts.swap(pendingCountsM);
+        error.swap(pendingErrorM);
+    }
+
+    if (!error.empty())
+    {
+        eventlog_received->logError(error);
+        stopMonitoring();
+        updateMonitoringActive();
+        return;
+    }
+    if (counts.empty())
+        return;
+
+    eventlog_received->logEvents(counts);
+    std::map<std::string, int>::const_iterator it;
+    for (it = counts.begin(); it != counts.end(); ++it)
+    {
+        std::map<std::string, EventStats>::iterator st =
+            statsM.find((*it).first);
+        if (st == statsM.end())
+            continue;
+        EventStats& stats = (*st).second;
+        stats.total += (*it).second;
+        stats.windowCount += (*it).second;
+        listctrl_monitored->SetItem(stats.item, 1,
+            wxString::Format("%ld", stats.total));
     }
-    updateMonitoringActive();
 }
 
-void EventWatcherFrame::OnListBoxSelected(wxCommandEvent& WXUNUSED(event))
+void EventWatcherFrame::OnListSelectionChanged(wxListEvent& WXUNUSED(event))
 {
     updateControls();
 }
 
 void EventWatcherFrame::OnTimer(wxTimerEvent& WXUNUSED(event))
 {
-    if (eventsM != 0)
-        eventsM->Dispatch();
-    else // stop timer, update UI
-        updateMonitoringActive();
-}
+    if (!isMonitoring())
+        return;
+
+    wxLongLong millisNow = ::wxGetLocalTimeMillis();
+    double seconds = (millisNow - rateWindowStartMillisM).ToDouble() / 1000.0;
+    if (seconds <= 0)
+        return;
+    rateWindowStartMillisM = millisNow;
 
+    std::map<std::string, EventStats>::iterator it;
+    for (it = statsM.begin(); it != statsM.end(); ++it)
+    {
+        EventStats& stats = (*it).second;
+        double rate = stats.windowCount / seconds;
+        stats.windowCount = 0;
+        // only touch the items whose rate has changed
+        if (rate == stats.rate)
+            continue;
+        stats.rate = rate;
+        listctrl_monitored->SetItem(stats.item, 2,
+            wxString::Format("%.1f", rate));
+    }
+}
@@ -27,10 +27,13 @@
 
 #include <wx/wx.h>
 #include <wx/button.h>
-#include <wx/listbox.h>
+#include <wx/listctrl.h>
 #include <wx/panel.h>
+#include <wx/thread.h>
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include <ibpp.h>
 
@@ -40,20 +43,49 @@
 #include "metadata/database.h"
 #include "metadata/MetadataClasses.h"
 
+class EventListenerThread;
 class EventLogControl;
 
 class EventWatcherFrame : public BaseFrame, public Observer,
-    public IBPP::EventInterface
+    public IBPP::EventInterface, public IBPP::EventsTrapInterface
 {
 private:
+    friend class EventListenerThread;
+
     DatabaseWeakPtr databaseM;
+    IBPP::Database ibppDatabaseM;
+    // refreshes the events/sec column
     wxTimer timerM;
-    IBPP::Events eventsM;
+
+    // one events block holds a limited number of names, so large lists
+    // are spread over several IBPP::Events objects
+    std::vector<IBPP::Events> eventsM;
+    // guards eventsM, which is dispatched by the listener thread
+    wxCriticalSection eventsCritsectM;
+    // posted from the Firebird client thread when events were trapped
+    wxSemaphore trappedM;
+    EventListenerThread* listenerM;
+
+    // counts collected by the listener thread but not shown yet
+    wxCriticalSection pendingCritsectM;
+    std::map<std::string, int> pendingCountsM;
+    wxString pendingErrorM;
+    wxLongLong pendingNotifiedMillisM;
+
+    struct EventStats
+    {
+        long item;
+        long total;
+        long windowCount;
+        double rate;
+    };
+    std::map<std::string, EventStats> statsM;
+    wxLongLong rateWindowStartMillisM;
 
     wxPanel* panel_controls;
     wxStaticText* static_text_monitored;
     wxStaticText* static_text_received;
-    wxListBox* listbox_monitored;
+    wxListCtrl* listctrl_monitored;
     EventLogControl* eventlog_received;
     wxButton *button_add;
     wxButton *button_remove;
@@ -67,13 +99,22 @@ private:
     static wxString getFrameId(DatabasePtr db);
 
     void addEvents(wxString& s);    // multiline allowed
+    wxArrayString getMonitoredEvents() const;
+    void resetEventStats();
     void defineMonitoredEvents();
     DatabasePtr getDatabase() const;
-    bool setTimerActive(bool active);
+    bool isMonitoring() const;
+    void startMonitoring();
+    void stopMonitoring();
     void updateMonitoringActive();
 
+    // called by the listener thread
+    void dispatchEvents();
+    void notifyPendingEvents();
+
     virtual void ibppEventHandler(IBPP::Events events,
         const std::string& name, int count);
+    virtual void ibppEventsTrapped(IBPP::IEvents* events);
 
     // observer stuff
     virtual void subjectRemoved(Subject* subject);
@@ -86,19 +127,23 @@ protected:
 public:
     EventWatcherFrame(wxWindow* parent, DatabasePtr db);
 
+    // make sure that the listener thread gets stopped
+    virtual bool Destroy();
+
     static EventWatcherFrame* findFrameFor(DatabasePtr db);
 private:
     // event handling
     enum
     {
-        ID_listbox_monitored = 101,
+        ID_listctrl_monitored = 101,
         ID_log_received,
         ID_button_add,
         ID_button_remove,
         ID_button_load,
         ID_button_save,
         ID_button_monitor,
-        ID_timer
+        ID_timer,
+        ID_events_received
     };
 
     void OnButtonAddClick(wxCommandEvent& event);
@@ -106,7 +151,8 @@ private:
     void OnButtonLoadClick(wxCommandEvent& event);
     void OnButtonSaveClick(wxCommandEvent& event);
     void OnButtonStartStopClick(wxCommandEvent& event);
-    void OnListBoxSelected(wxCommandEvent& event);
+    void OnEventsReceived(wxCommandEvent& event);
+    void OnListSelectionChanged(wxListEvent& event);
     void OnTimer(wxTimerEvent& event);
 
     DECLARE_EVENT_TABLE()
@@ -554,6 +554,14 @@ ExecuteSqlFrame::ExecuteSqlFrame(wxWindow* WXUNUSED(parent), int id,
     grid_data = new DataGrid(notebook_pane_2, ID_grid_data);
     notebook_1->AddPage(notebook_pane_2, _("Data"));
 
+    notebook_pane_3 = new wxPanel(notebook_1, -1);
+    table_profile = new TableProfileControl(notebook_pane_3);
+    notebook_1->AddPage(notebook_pane_3, _("Table Profile"));
+
+    notebook_pane_4 = new wxPanel(notebook_1, -1);
+    plan_tree = new PlanTreeControl(notebook_pane_4);
+    notebook_1->AddPage(notebook_pane_4, _("Plan"));
+
     statusbar_1 = CreateStatusBar(4);
     SetStatusBarPane(-1);
 
@@ -755,6 +763,8 @@ void ExecuteSqlFrame::buildMainMenu(CommandManager& cm)
     wxMenu* gridMenu = new wxMenu();
     gridMenu->Append(Cmds::DataGrid_Insert_row,      _("I&nsert row"));
     gridMenu->Append(Cmds::DataGrid_Delete_row,      _("&Delete row"));
+    gridMenu->Append(Cmds::DataGrid_Paste_rows,      _("Paste as ne&w rows"));
+    gridMenu->Append(Cmds::DataGrid_Import_csv,      _("&Import rows from CSV file..."));
     gridMenu->AppendSeparator();
     gridMenu->Append(wxID_COPY,                      _("&Copy"));
     gridMenu->Append(Cmds::DataGrid_Copy_as_insert,  _("Copy &as insert statements"));
@@ -763,6 +773,7 @@ void ExecuteSqlFrame::buildMainMenu(CommandManager& cm)
     gridMenu->Append(Cmds::DataGrid_EditBlob, _("Edit BLOB..."));
     gridMenu->Append(Cmds::DataGrid_ImportBlob, _("Import BLOB from file..."));
     gridMenu->Append(Cmds::DataGrid_ExportBlob, _("Save BLOB to file..."));
+    gridMenu->Append(Cmds::DataGrid_ExportBlobs, _("Save selected BLOBs to folder..."));
     gridMenu->AppendSeparator();
     gridMenu->Append(Cmds::DataGrid_SetFieldToNULL,  _("Set field to &NULL"));
     gridMenu->AppendSeparator();
@@ -776,12 +787,17 @@ void ExecuteSqlFrame::buildMainMenu(CommandManager& cm)
     gridMenu->Append(Cmds::DataGrid_Set_cell_font,   _("Set cell f&ont"));
     gridMenu->AppendSeparator();
     gridMenu->AppendCheckItem(Cmds::DataGrid_Log_changes, _("&Log data changes"));
+    gridMenu->AppendCheckItem(Cmds::DataGrid_Defer_edits, _("Defe&r data changes"));
+    gridMenu->Append(Cmds::DataGrid_Apply_edits,     _("A&pply pending changes"));
+    gridMenu->Append(Cmds::DataGrid_Discard_edits,   _("Discard pending c&hanges"));
     menuBarM->Append(gridMenu, _("&Grid"));
 
     SetMenuBar(menuBarM);
 
     // logging is always enabled by default
     menuBarM->Check(Cmds::History_EnableLogging, true);
+    menuBarM->Check(Cmds::DataGrid_Defer_edits,
+        config().get("DataGridDeferEdits", false));
 }
 
 void ExecuteSqlFrame::set_properties()
@@ -796,7 +812,9 @@ void ExecuteSqlFrame::set_properties()
     statusbar_1->SetStatusText("Cursor position", 2);
     statusbar_1->SetStatusText("Transaction status", 3);
 
-    grid_data->SetTable(new DataGridTable(statementM, databaseM), true);
+    DataGridTable* table = new DataGridTable(statementM, databaseM);
+    table->setDeferEdits(menuBarM->IsChecked(Cmds::DataGrid_Defer_edits));
+    grid_data->SetTable(table, true);
     splitter_window_1->Initialize(styled_text_ctrl_sql);
     viewModeM = vmEditor;
 
@@ -818,6 +836,16 @@ void ExecuteSqlFrame::do_layout()
     sizerPane2->Add(grid_data, 1, wxEXPAND);
     notebook_pane_2->SetSizer(sizerPane2);
 
+    // per-table statistics notebook pane
+    wxBoxSizer* sizerPane3 = new wxBoxSizer(wxHORIZONTAL);
+    sizerPane3->Add(table_profile, 1, wxEXPAND);
+    notebook_pane_3->SetSizer(sizerPane3);
+
+    // plan tree notebook pane
+    wxBoxSizer* sizerPane4 = new wxBoxSizer(wxHORIZONTAL);
+    sizerPane4->Add(plan_tree, 1, wxEXPAND);
+    notebook_pane_4->SetSizer(sizerPane4);
+
     // splitter is only control in panel_contents
     wxBoxSizer* sizerContents = new wxBoxSizer(wxHORIZONTAL);
     sizerContents->Add(splitter_window_1, 1, wxEXPAND);
@@ -966,25 +994,36 @@ BEGIN_EVENT_TABLE(ExecuteSqlFrame, wxFrame)
     EVT_MENU(Cmds::DataGrid_EditBlob,        ExecuteSqlFrame::OnMenuGridEditBlob)
     EVT_MENU(Cmds::DataGrid_ImportBlob,      ExecuteSqlFrame::OnMenuGridImportBlob)
     EVT_MENU(Cmds::DataGrid_ExportBlob,      ExecuteSqlFrame::OnMenuGridExportBlob)
+    EVT_MENU(Cmds::DataGrid_ExportBlobs,     ExecuteSqlFrame::OnMenuGridExportBlobs)
     EVT_MENU(Cmds::DataGrid_Save_as_html,    ExecuteSqlFrame::OnMenuGridSaveAsHtml)
     EVT_MENU(Cmds::DataGrid_Save_as_csv,     ExecuteSqlFrame::OnMenuGridSaveAsCsv)
+    EVT_MENU(Cmds::DataGrid_Paste_rows,      ExecuteSqlFrame::OnMenuGridPasteRows)
+    EVT_MENU(Cmds::DataGrid_Import_csv,      ExecuteSqlFrame::OnMenuGridImportCsv)
     EVT_MENU(Cmds::DataGrid_Set_header_font, ExecuteSqlFrame::OnMenuGridGridHeaderFont)
     EVT_MENU(Cmds::DataGrid_Set_cell_font,   ExecuteSqlFrame::OnMenuGridGridCellFont)
     EVT_MENU(Cmds::DataGrid_FetchAll,        ExecuteSqlFrame::OnMenuGridFetchAll)
     EVT_MENU(Cmds::DataGrid_CancelFetchAll,  ExecuteSqlFrame::OnMenuGridCancelFetchAll)
+    EVT_MENU(Cmds::DataGrid_Defer_edits,     ExecuteSqlFrame::OnMenuGridDeferEdits)
+    EVT_MENU(Cmds::DataGrid_Apply_edits,     ExecuteSqlFrame::OnMenuGridApplyEdits)
+    EVT_MENU(Cmds::DataGrid_Discard_edits,   ExecuteSqlFrame::OnMenuGridDiscardEdits)
 
     EVT_UPDATE_UI(Cmds::DataGrid_Insert_row,     ExecuteSqlFrame::OnMenuUpdateGridInsertRow)
     EVT_UPDATE_UI(Cmds::DataGrid_Delete_row,     ExecuteSqlFrame::OnMenuUpdateGridDeleteRow)
+    EVT_UPDATE_UI(Cmds::DataGrid_Paste_rows,     ExecuteSqlFrame::OnMenuUpdateGridInsertRow)
+    EVT_UPDATE_UI(Cmds::DataGrid_Import_csv,     ExecuteSqlFrame::OnMenuUpdateGridInsertRow)
     EVT_UPDATE_UI(Cmds::DataGrid_SetFieldToNULL, ExecuteSqlFrame::OnMenuUpdateGridCanSetFieldToNULL)
     EVT_UPDATE_UI(Cmds::DataGrid_Copy_as_insert, ExecuteSqlFrame::OnMenuUpdateGridHasData)
     EVT_UPDATE_UI(Cmds::DataGrid_Copy_as_update, ExecuteSqlFrame::OnMenuUpdateGridHasData)
     EVT_UPDATE_UI(Cmds::DataGrid_EditBlob,       ExecuteSqlFrame::OnMenuUpdateGridCellIsBlob)
     EVT_UPDATE_UI(Cmds::DataGrid_ImportBlob,     ExecuteSqlFrame::OnMenuUpdateGridCellIsBlob)
     EVT_UPDATE_UI(Cmds::DataGrid_ExportBlob,     ExecuteSqlFrame::OnMenuUpdateGridCellIsBlob)
+    EVT_UPDATE_UI(Cmds::DataGrid_ExportBlobs,    ExecuteSqlFrame::OnMenuUpdateGridHasData)
     EVT_UPDATE_UI(Cmds::DataGrid_Save_as_html,   ExecuteSqlFrame::OnMenuUpdateGridHasSelection)
     EVT_UPDATE_UI(Cmds::DataGrid_Save_as_csv,    ExecuteSqlFrame::OnMenuUpdateGridHasSelection)
     EVT_UPDATE_UI(Cmds::DataGrid_FetchAll,       ExecuteSqlFrame::OnMenuUpdateGridFetchAll)
     EVT_UPDATE_UI(Cmds::DataGrid_CancelFetchAll, ExecuteSqlFrame::OnMenuUpdateGridCancelFetchAll)
+    EVT_UPDATE_UI(Cmds::DataGrid_Apply_edits,    ExecuteSqlFrame::OnMenuUpdateGridHasPendingEdits)
+    EVT_UPDATE_UI(Cmds::DataGrid_Discard_edits,  ExecuteSqlFrame::OnMenuUpdateGridHasPendingEdits)
 
 
     EVT_COMMAND(ExecuteSqlFrame::ID_grid_data, wxEVT_FRDG_ROWCOUNT_CHANGED, \
@@ -1596,6 +1635,31 @@ void ExecuteSqlFrame::OnMenuGridCancelFetchAll(wxCommandEvent& WXUNUSED(event))
     grid_data->cancelFetchAll();
 }
 
+void ExecuteSqlFrame::OnMenuGridDeferEdits(wxCommandEvent& event)
+{
+    DataGridTable* table = grid_data->getDataGridTable();
+    // changes made so far are written before they would be lost
+    if (!event.IsChecked() && !applyGridEdits())
+    {
+        menuBarM->Check(Cmds::DataGrid_Defer_edits, true);
+        return;
+    }
+    if (table)
+        table->setDeferEdits(event.IsChecked());
+    config().setValue("DataGridDeferEdits", event.IsChecked());
+}
+
+void ExecuteSqlFrame::OnMenuGridApplyEdits(wxCommandEvent& WXUNUSED(event))
+{
+    applyGridEdits();
+}
+
+void ExecuteSqlFrame::OnMenuGridDiscardEdits(wxCommandEvent& WXUNUSED(event))
+{
+    if (DataGridTable* table = grid_data->getDataGridTable())
+        table->discardEdits();
+}
+
 void ExecuteSqlFrame::OnMenuUpdateGridCellIsBlob(wxUpdateUIEvent& event)
 {
     DataGridTable* dgt = grid_data->getDataGridTable();
@@ -1680,26 +1744,75 @@ void ExecuteSqlFrame::OnMenuGridImportBlob(wxCommandEvent& WXUNUSED(event))
         grid_data->GetGridCursorCol(), &pd);
 }
 
-void ExecuteSqlFrame::OnMenuGridInsertRow(wxCommandEvent& WXUNUSED(event))
+void ExecuteSqlFrame::OnMenuGridExportBlobs(wxCommandEvent& WXUNUSED(event))
 {
-    DataGridTable *tb = grid_data->getDataGridTable();
-    if (tb && grid_data->GetNumberCols())
-    {
-        wxArrayString tables;
-        tb->getTableNames(tables);
-        wxString tab;
-        if (tables.GetCount() == 0)
-            throw FRError(_("No valid tables found."));
-        if (tables.GetCount() == 1)
-            tab = tables[0];
-        else
-        {   // show list of tables for user to select into which one to insert
-            tab = wxGetSingleChoice(_("Select a table"),
-                _("Multiple tables found"), tables, this);
-            if (tab.IsEmpty())
-                return;
+    DataGridTable* dgt = grid_data->getDataGridTable();
+    if (!dgt || !grid_data->GetNumberRows())
+        return;
+
+    // all selected cells of BLOB columns, or the current cell
+    std::vector<std::pair<unsigned, unsigned> > cells;
+    std::vector<bool> selRows(grid_data->getRowsWithSelectedCells());
+    for (size_t row = 0; row < selRows.size(); ++row)
+    {
+        if (!selRows[row])
+            continue;
+        std::vector<bool> selCells(grid_data->getSelectedCellsInRow(row));
+        for (size_t col = 0; col < selCells.size(); ++col)
+        {
+            if (selCells[col] && dgt->isBlobColumn(col))
+                cells.push_back(std::make_pair(row, col));
         }
+    }
+    if (cells.empty() && dgt->isBlobColumn(grid_data->GetGridCursorCol()))
+    {
+        cells.push_back(std::make_pair(grid_data->GetGridCursorRow(),
+            grid_data->GetGridCursorCol()));
+    }
+    if (cells.empty())
+        throw FRError(_("No BLOB cells selected"));
+
+    wxString dir = ::wxDirSelector(_("Select a folder"), "",
+        wxDD_DEFAULT_STYLE, wxDefaultPosition, this);
+    if (dir.IsEmpty())
+        return;
+
+    unsigned files;
+    {
+        ProgressDialog pd(this, _("Saving BLOBs to folder"), 2);
+        pd.doShow();
+        files = dgt->exportBlobFiles(dir, cells, &pd);
+    }
+    log(wxString::Format(_("%d BLOBs saved to %s"), int(files),
+        dir.c_str()));
+}
 
+bool ExecuteSqlFrame::selectGridTable(wxString& table)
+{
+    DataGridTable *tb = grid_data->getDataGridTable();
+    if (!tb || !grid_data->GetNumberCols())
+        return false;
+
+    wxArrayString tables;
+    tb->getTableNames(tables);
+    if (tables.GetCount() == 0)
+        throw FRError(_("No valid tables found."));
+    if (tables.GetCount() == 1)
+        table = tables[0];
+    else
+    {   // show list of tables for user to select into which one to insert
+        table = wxGetSingleChoice(_("Select a table"),
+            _("Multiple tables found"), tables, this);
+    }
+    return !table.IsEmpty();
+}
+
+void ExecuteSqlFrame::OnMenuGridInsertRow(wxCommandEvent& WXUNUSED(event))
+{
+    DataGridTable *tb = grid_data->getDataGridTable();
+    wxString tab;
+    if (selectGridTable(tab))
+    {
         // show dialog to enter values
         InsertDialog* id = new InsertDialog(this, tab, tb, statementM,
             databaseM);
@@ -1909,6 +2022,44 @@ void ExecuteSqlFrame::OnMenuGridSaveAsCsv(wxCommandEvent& WXUNUSED(event))
     grid_data->saveAsCSV(fileName, fieldDelimiter, textDelimiter);
 }
 
+wxString millisToTimeString(long millis);
+
+void ExecuteSqlFrame::importGridRows(const wxString& fileName)
+{
+    wxString table;
+    if (!selectGridTable(table))
+        return;
+
+    unsigned rows;
+    wxStopWatch sw;
+    {
+        ProgressDialog pd(this, _("Importing rows"));
+        pd.doShow();
+        if (fileName.empty())
+            rows = grid_data->importRowsFromClipboard(table, &pd);
+        else
+            rows = grid_data->importRowsFromCSV(table, fileName, &pd);
+    }
+    // the rows are committed by a transaction of their own, so they show
+    // up in the grid only when the statement is executed again
+    log(wxString::Format(_("%d rows inserted into %s in %s"), int(rows),
+        table.c_str(), millisToTimeString(sw.Time()).c_str()), ttSql);
+}
+
+void ExecuteSqlFrame::OnMenuGridPasteRows(wxCommandEvent& WXUNUSED(event))
+{
+    importGridRows(wxEmptyString);
+}
+
+void ExecuteSqlFrame::OnMenuGridImportCsv(wxCommandEvent& WXUNUSED(event))
+{
+    wxString fileName = ::wxFileSelector(_("Select a CSV file"), "", "",
+        "csv", _("CSV files (*.csv)|*.csv|Text files (*.txt)|*.txt|All files (*.*)|*.*"),
+        wxFD_OPEN | wxFD_FILE_MUST_EXIST, this);
+    if (!fileName.IsEmpty())
+        importGridRows(fileName);
+}
+
 void ExecuteSqlFrame::OnMenuGridGridHeaderFont(wxCommandEvent& WXUNUSED(event))
 {
     grid_data->setHeaderFont();
@@ -2162,7 +2313,10 @@ wxString IBPPtype2string(Database *db, IBPP::SDT t, int subtype, int size,
     int scale)
 {
     if (scale > 0)
-        return wxString::Format("NUMERIC(%d,%d)", size==4 ? 9:18, scale);
+    {
+        int precision = t == IBPP::sdInt128 ? 38 : (size == 4 ? 9 : 18);
+        return wxString::Format("NUMERIC(%d,%d)", precision, scale);
+    }
     if (t == IBPP::sdString)
     {
         int bpc = db->getCharsetById(subtype).getBytesPerChar();
@@ -2181,56 +2335,171 @@ wxString IBPPtype2string(Database *db, IBPP::SDT t, int subtype, int size,
         case IBPP::sdLargeint:  return "BIGINT";
         case IBPP::sdFloat:     return "FLOAT";
         case IBPP::sdDouble:    return "DOUBLE PRECISION";
+        case IBPP::sdBoolean:   return "BOOLEAN";
+        case IBPP::sdInt128:    return "INT128";
+        case IBPP::sdDecFloat:  return wxString::Format("DECFLOAT(%d)",
+                                    size == 8 ? 16 : 34);
+        case IBPP::sdTimeTz:    return "TIME WITH TIME ZONE";
+        case IBPP::sdTimestampTz: return "TIMESTAMP WITH TIME ZONE";
         default:                return "UNKNOWN";
     }
 }
 
+wxString ExecuteSqlFrame::getRelationName(int relationId, bool& reloaded)
+{
+    std::map<int, wxString>::const_iterator it =
+        relationNamesM.find(relationId);
+    if (it == relationNamesM.end() && !reloaded)
+    {
+        // one query for all relations, tables may have been created since
+        // the cache was filled
+        reloaded = true;
+        relationNamesM.clear();
+        try
+        {
+            IBPP::Statement st = IBPP::StatementFactory(
+                databaseM->getIBPPDatabase(), transactionM);
+            st->Prepare(
+                "select rdb$relation_id, rdb$relation_name "
+                "from rdb$relations");
+            st->Execute();
+            while (st->Fetch())
+            {
+                int16_t id;
+                std::string name;
+                st->Get(1, id);
+                st->Get(2, name);
+                relationNamesM[id] = std2wxIdentifier(name,
+                    databaseM->getCharsetConverter());
+            }
+        }
+        catch (...)
+        {
+        }
+        it = relationNamesM.find(relationId);
+    }
+    if (it != relationNamesM.end())
+        return (*it).second;
+    return wxString::Format(_("Relation #%d"), relationId);
+}
+
+void ExecuteSqlFrame::loadRowEstimates()
+{
+    // The reciprocal selectivity of the most selective index is the number
+    // of distinct keys, for a unique index that is the number of rows.
+    // Relations without index statistics get an estimate of 0 (unknown).
+    rowEstimatesM.clear();
+    try
+    {
+        IBPP::Statement st = IBPP::StatementFactory(
+            databaseM->getIBPPDatabase(), transactionM);
+        st->Prepare(
+            "select r.rdb$relation_name, max(1 / i.rdb$statistics) "
+            "from rdb$relations r left join rdb$indices i "
+            "on i.rdb$relation_name = r.rdb$relation_name "
+            "and i.rdb$statistics > 0 "
+            "group by r.rdb$relation_name");
+        st->Execute();
+        while (st->Fetch())
+        {
+            std::string name;
+            double rows = 0;
+            st->Get(1, name);
+            if (!st->IsNull(2))
+                st->Get(2, rows);
+            std::string::size_type end = name.find_last_not_of(' ');
+            name.erase(end == std::string::npos ? 0 : end + 1);
+            rowEstimatesM[name] = rows;
+        }
+    }
+    catch (IBPP::Exception&)
+    {
+        // the plan is shown without row estimates
+    }
+}
+
+void ExecuteSqlFrame::showPlan(const std::string& explained,
+    const std::string& legacy)
+{
+    PlanNodes nodes;
+    if (!PlanParser::parse(explained, legacy, nodes))
+    {
+        plan_tree->clearPlan();
+        return;
+    }
+
+    // index statistics are loaded once, they only change with
+    // SET STATISTICS or a restore
+    std::vector<std::string> scans(PlanParser::getNaturalScans(nodes));
+    if (rowEstimatesM.empty())
+        loadRowEstimates();
+
+    double warningRows = config().get("SQLEditorPlanWarningRows", 10000);
+    int warnings = plan_tree->setPlan(nodes, rowEstimatesM, warningRows,
+        databaseM->getCharsetConverter());
+    if (warnings == 0)
+        return;
+    for (std::vector<std::string>::const_iterator it = scans.begin();
+        it != scans.end(); ++it)
+    {
+        std::map<std::string, double>::const_iterator est =
+            rowEstimatesM.find(*it);
+        if (est == rowEstimatesM.end() || (*est).second < warningRows)
+            continue;
+        log(wxString::Format(
+            _("Warning: natural scan of table %s (about %.0f rows)."),
+            std2wxIdentifier(*it, databaseM->getCharsetConverter()).c_str(),
+            (*est).second), ttError);
+    }
+}
+
 void ExecuteSqlFrame::compareCounts(IBPP::DatabaseCounts& one,
     IBPP::DatabaseCounts& two)
 {
+    TableProfileControl::TableProfiles profiles;
+    bool reloaded = false;
     for (IBPP::DatabaseCounts::iterator it = two.begin(); it != two.end();
         ++it)
     {
-        wxString s;
         IBPP::DatabaseCounts::iterator i2 = one.find((*it).first);
-        IBPP::CountInfo c;
+        IBPP::CountInfo r2;
         IBPP::CountInfo& r1 = (*it).second;
-        IBPP::CountInfo& r2 = c;
         if (i2 != one.end())
             r2 = (*i2).second;
-        if (r1.inserts > r2.inserts)
-            s += wxString::Format(_("%d inserts. "), r1.inserts - r2.inserts);
-        if (r1.updates > r2.updates)
-            s += wxString::Format(_("%d updates. "), r1.updates - r2.updates);
-        if (r1.deletes > r2.deletes)
-            s += wxString::Format(_("%d deletes. "), r1.deletes - r2.deletes);
-        if (!s.IsEmpty())
+
+        IBPP::CountInfo delta;
+        delta.inserts = r1.inserts - r2.inserts;
+        delta.updates = r1.updates - r2.updates;
+        delta.deletes = r1.deletes - r2.deletes;
+        delta.seqReads = r1.seqReads - r2.seqReads;
+        delta.idxReads = r1.idxReads - r2.idxReads;
+        delta.backouts = r1.backouts - r2.backouts;
+        delta.purges = r1.purges - r2.purges;
+        delta.expunges = r1.expunges - r2.expunges;
+        if (delta.inserts <= 0 && delta.updates <= 0 && delta.deletes <= 0
+            && delta.seqReads <= 0 && delta.idxReads <= 0
+            && delta.backouts <= 0 && delta.purges <= 0
+            && delta.expunges <= 0)
         {
-            wxString relName;
-            try
-            {
-                IBPP::Statement st = IBPP::StatementFactory(
-                    databaseM->getIBPPDatabase(), transactionM);
-                st->Prepare(
-                    "select rdb$relation_name "
-                    "from rdb$relations where rdb$relation_id = ?");
-                st->Set(1, (*it).first);
-                st->Execute();
-                if (st->Fetch())
-                {
-                    std::string s;
-                    st->Get(1, s);
-                    relName = std2wxIdentifier(s, databaseM->getCharsetConverter());
-                }
-            }
-            catch (...)
-            {
-            }
-            if (relName.IsEmpty())
-                relName.Format(_("Relation #%d"), (*it).first);
-            log(relName + ": " + s, ttSql);
+            continue;
         }
+
+        TableProfileControl::TableProfile profile;
+        profile.tableName = getRelationName((*it).first, reloaded);
+        profile.counts = delta;
+        profiles.push_back(profile);
+
+        wxString s;
+        if (delta.inserts > 0)
+            s += wxString::Format(_("%d inserts. "), delta.inserts);
+        if (delta.updates > 0)
+            s += wxString::Format(_("%d updates. "), delta.updates);
+        if (delta.deletes > 0)
+            s += wxString::Format(_("%d deletes. "), delta.deletes);
+        if (!s.IsEmpty())
+            log(profile.tableName + ": " + s, ttSql);
     }
+    table_profile->setProfiles(profiles);
 }
 
 wxString millisToTimeString(long millis)
@@ -2275,6 +2544,10 @@ bool ExecuteSqlFrame::execute(wxString sql, const wxString& terminator,
         return true;
     }
 
+    // the grid is cleared below, deferred changes would be lost
+    if (!applyGridEdits())
+        return false;
+
     if (styled_text_ctrl_sql->AutoCompActive())
         styled_text_ctrl_sql->AutoCompCancel();    // remove the list if needed
     notebook_1->SetSelection(0);
@@ -2319,6 +2592,8 @@ bool ExecuteSqlFrame::execute(wxString sql, const wxString& terminator,
         int fetch2, mark2, read2, write2, ins2, upd2, del2, ridx2, rseq2, mem2;
         IBPP::DatabaseCounts counts1, counts2;
         bool doShowStats = config().get("SQLEditorShowStats", true);
+        if (!prepareOnly)
+            table_profile->clearProfiles();
         if (!prepareOnly && doShowStats)
         {
             databaseM->getIBPPDatabase()->
@@ -2379,14 +2654,36 @@ bool ExecuteSqlFrame::execute(wxString sql, const wxString& terminator,
             std::string plan;
             statementM->Plan(plan);
             log(wxString(plan.c_str(), *databaseM->getCharsetConverter()));
+
+            // the explained plan is shown as a tree if the server has it,
+            // the legacy plan otherwise
+            std::string explained;
+            if (databaseM->getInfo().getODSVersionIsHigherOrEqualTo(12))
+            {
+                try
+                {
+                    statementM->ExplainedPlan(explained);
+                }
+                catch(IBPP::Exception&)
+                {
+                }
+            }
+            showPlan(explained, plan);
         }
         catch(IBPP::Exception&)
         {
             log(_("Plan not available."));
+            plan_tree->clearPlan();
         }
 
         if (prepareOnly)
+        {
+            // "Show plan" goes straight to the plan tree
+            int planPage = notebook_1->FindPage(notebook_pane_4);
+            if (plan_tree->GetCount() > 0 && planPage != wxNOT_FOUND)
+                notebook_1->SetSelection(planPage);
             return true;
+        }
 
         log(wxEmptyString);
         log(wxEmptyString);
@@ -2566,6 +2863,24 @@ void ExecuteSqlFrame::OnMenuCommit(wxCommandEvent& WXUNUSED(event))
         setViewMode(false, vmEditor);
 }
 
+bool ExecuteSqlFrame::applyGridEdits()
+{
+    DataGridTable* table = grid_data->getDataGridTable();
+    if (!table || !table->hasPendingEdits())
+        return true;
+
+    wxBusyCursor cr;
+    ScrollAtEnd sae(styled_text_ctrl_stats);
+    log(_("Applying pending data changes..."));
+    sae.scroll();
+    wxStopWatch sw;
+    if (!table->applyEdits())
+        return false;
+    log(wxString::Format(_("Pending data changes applied (elapsed time: %s)."),
+        millisToTimeString(sw.Time()).c_str()));
+    return true;
+}
+
 bool ExecuteSqlFrame::commitTransaction()
 {
     if (transactionM == 0 || !transactionM->Started())    // check
@@ -2575,6 +2890,8 @@ bool ExecuteSqlFrame::commitTransaction()
     }
 
     closeBlobEditor(true);
+    if (!applyGridEdits())
+        return false;
 
     wxBusyCursor cr;
     ScrollAtEnd sae(styled_text_ctrl_stats);
@@ -2604,6 +2921,7 @@ bool ExecuteSqlFrame::commitTransaction()
                 if (!Logger::logStatement(*it, databaseM))
                     break;
             }
+            Logger::flush();
         }
 
         // parse all successfully executed statements
@@ -2665,6 +2983,9 @@ bool ExecuteSqlFrame::rollbackTransaction()
 {
     if (transactionM == 0 || !transactionM->Started())    // check
     {
+        // deferred grid edits must not survive a rollback
+        if (DataGridTable* table = grid_data->getDataGridTable())
+            table->discardEdits();
         executedStatementsM.clear();
         inTransaction(false);
         return true;
@@ -2685,6 +3006,9 @@ bool ExecuteSqlFrame::rollbackTransaction()
             log(wxString::Format(_("Transaction rolled back (elapsed time: %s)."),
                 millisToTimeString(sw.Time()).c_str()));
         }
+        // otherwise they would be written in the next transaction
+        if (DataGridTable* table = grid_data->getDataGridTable())
+            table->discardEdits();
         statusbar_1->SetStatusText(_("Transaction rolled back"), 3);
         inTransaction(false);
         executedStatementsM.clear();
@@ -2727,6 +3051,12 @@ void ExecuteSqlFrame::OnMenuUpdateGridHasData(wxUpdateUIEvent& event)
         && grid_data->GetNumberRows());
 }
 
+void ExecuteSqlFrame::OnMenuUpdateGridHasPendingEdits(wxUpdateUIEvent& event)
+{
+    DataGridTable* table = grid_data->getDataGridTable();
+    event.Enable(table && table->hasPendingEdits());
+}
+
 void ExecuteSqlFrame::OnMenuUpdateGridDeleteRow(wxUpdateUIEvent& event)
 {
     DataGridTable *tb = grid_data->getDataGridTable();
@@ -2776,6 +3106,9 @@ void ExecuteSqlFrame::OnGridRowCountChanged(wxCommandEvent& event)
     long rowsFetched = event.GetExtraLong();
     s.Printf(_("%ld row(s) fetched"), rowsFetched);
     statusbar_1->SetStatusText(s, 1);
+    // fetch statistics, only sent if enabled in the database settings
+    if (!event.GetString().empty())
+        log(event.GetString());
 
     // TODO: we could make some bool flag, so that this happens only once per execute()
     //       to fix the problem when user does the select, unsplits the window
@@ -2836,10 +3169,10 @@ void ExecuteSqlFrame::OnSplitterUnsplit(wxSplitterEvent& WXUNUSED(event))
         setViewMode(vmEditor);
     else if (splitter_window_1->GetWindow1() == notebook_1)
     {
-        if (notebook_1->GetSelection() == 0)
-            setViewMode(vmLogCtrl);
-        else
+        if (notebook_1->GetSelection() == 1)
             setViewMode(vmGrid);
+        else
+            setViewMode(vmLogCtrl);
     }
 }
 
@@ -37,6 +37,8 @@
 #include "core/Observer.h"
 #include "core/StringUtils.h"
 #include "controls/DataGridTable.h"
+#include "controls/PlanTreeControl.h"
+#include "controls/TableProfileControl.h"
 #include "gui/BaseFrame.h"
 #include "gui/EditBlobDialog.h"
 #include "gui/FindDialog.h"
@@ -97,6 +99,15 @@ private:
     wxDateTime filenameModificationTimeM;
 
     void compareCounts(IBPP::DatabaseCounts& one, IBPP::DatabaseCounts& two);
+    // relation ids are mapped to names without a query per relation,
+    // the cache is reloaded when an unknown id is found
+    std::map<int, wxString> relationNamesM;
+    wxString getRelationName(int relationId, bool& reloaded);
+    // table sizes estimated from the index statistics, used to warn about
+    // natural scans of large tables in the plan
+    std::map<std::string, double> rowEstimatesM;
+    void loadRowEstimates();
+    void showPlan(const std::string& explained, const std::string& legacy);
 
     void showProperties(wxString objectName);
 
@@ -120,6 +131,10 @@ private:
     void inTransaction(bool started);       // changes controls (enable/disable)
     bool commitTransaction();
     bool rollbackTransaction();
+    // writes the deferred grid changes, returns false when that failed
+    bool applyGridEdits();
+    bool selectGridTable(wxString& table);
+    void importGridRows(const wxString& fileName);
 
     void autoComplete(bool force);
     void autoCompleteColumns(int pos, int len = 0);
@@ -226,16 +241,23 @@ private:
     void OnMenuGridEditBlob(wxCommandEvent& event);
     void OnMenuGridImportBlob(wxCommandEvent& event);
     void OnMenuGridExportBlob(wxCommandEvent& event);
+    void OnMenuGridExportBlobs(wxCommandEvent& event);
     void OnMenuUpdateGridCellIsBlob(wxUpdateUIEvent& event);
     void OnMenuGridCopyAsInList(wxCommandEvent& event);
     void OnMenuGridCopyAsInsert(wxCommandEvent& event);
     void OnMenuGridCopyAsUpdate(wxCommandEvent& event);
     void OnMenuGridSaveAsHtml(wxCommandEvent& event);
     void OnMenuGridSaveAsCsv(wxCommandEvent& event);
+    void OnMenuGridPasteRows(wxCommandEvent& event);
+    void OnMenuGridImportCsv(wxCommandEvent& event);
     void OnMenuGridGridHeaderFont(wxCommandEvent& event);
     void OnMenuGridGridCellFont(wxCommandEvent& event);
     void OnMenuGridFetchAll(wxCommandEvent& event);
     void OnMenuGridCancelFetchAll(wxCommandEvent& event);
+    void OnMenuGridDeferEdits(wxCommandEvent& event);
+    void OnMenuGridApplyEdits(wxCommandEvent& event);
+    void OnMenuGridDiscardEdits(wxCommandEvent& event);
+    void OnMenuUpdateGridHasPendingEdits(wxUpdateUIEvent& event);
     void OnMenuUpdateGridHasSelection(wxUpdateUIEvent& event);
     void OnMenuUpdateGridHasData(wxUpdateUIEvent& event);
     void OnMenuUpdateGridFetchAll(wxUpdateUIEvent& event);
@@ -269,6 +291,10 @@ protected:
     wxPanel* notebook_pane_1;
     wxPanel* notebook_pane_2;
     DataGrid* grid_data;
+    wxPanel* notebook_pane_3;
+    TableProfileControl* table_profile;
+    wxPanel* notebook_pane_4;
+    PlanTreeControl* plan_tree;
     wxStyledTextCtrl* styled_text_ctrl_stats;
 
     wxStatusBar* statusbar_1;
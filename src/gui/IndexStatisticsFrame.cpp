@@ -0,0 +1,688 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+
+#include "config/Config.h"
+#include "config/DatabaseConfig.h"
+#include "core/StringUtils.h"
+#include "engine/ConnectionPool.h"
+#include "gui/IndexStatisticsFrame.h"
+#include "gui/StyleGuide.h"
+#include "metadata/database.h"
+
+// IndexStatisticsWorker class
+// Recomputes index statistics on an attachment leased from the connection
+// pool, the workers take the next index from the frame until none is left
+class IndexStatisticsWorker: public wxThread
+{
+private:
+    IndexStatisticsFrame* frameM;
+    IBPP::Database databaseM;
+
+    std::string getSetStatisticsSql(const std::string& name);
+public:
+    IndexStatisticsWorker(IndexStatisticsFrame* frame,
+        IBPP::Database database);
+    virtual ExitCode Entry();
+
+    // only to be used after the thread has been waited for
+    IBPP::Database& getDatabase();
+};
+
+IndexStatisticsWorker::IndexStatisticsWorker(IndexStatisticsFrame* frame,
+        IBPP::Database database)
+    : wxThread(wxTHREAD_JOINABLE), frameM(frame), databaseM(database)
+{
+}
+
+IBPP::Database& IndexStatisticsWorker::getDatabase()
+{
+    return databaseM;
+}
+
+std::string IndexStatisticsWorker::getSetStatisticsSql(
+    const std::string& name)
+{
+    // dialect 1 has no quoted identifiers, but the names are all
+    // uppercase there anyway
+    if (databaseM->Dialect() == 1)
+        return "SET STATISTICS INDEX " + name;
+    std::string quoted;
+    for (std::string::const_iterator it = name.begin(); it != name.end();
+        ++it)
+    {
+        if (*it == '"')
+            quoted += '"';
+        quoted += *it;
+    }
+    return "SET STATISTICS INDEX \"" + quoted + "\"";
+}
+
+wxThread::ExitCode IndexStatisticsWorker::Entry()
+{
+    wxString connectError;
+    try
+    {
+        // does nothing for a pre-warmed attachment
+        databaseM->Connect();
+    }
+    catch (IBPP::Exception& e)
+    {
+        connectError = e.what();
+    }
+
+    std::string name;
+    while (frameM->getNextIndex(name))
+    {
+        wxString error(connectError);
+        if (error.empty())
+        {
+            try
+            {
+                IBPP::Transaction tr = IBPP::TransactionFactory(databaseM);
+                tr->Start();
+                IBPP::Statement st = IBPP::StatementFactory(databaseM, tr);
+                st->ExecuteImmediate(getSetStatisticsSql(name));
+                tr->Commit();
+            }
+            catch (IBPP::Exception& e)
+            {
+                error = e.what();
+            }
+        }
+        frameM->indexFinished(name, error);
+        // without a connection all remaining indices fail at once
+        if (!connectError.empty())
+            break;
+    }
+
+    // the attachment is returned to the pool by the frame
+    frameM->workerFinished();
+    return 0;
+}
+
+// IndexStatisticsFrame class
+IndexStatisticsFrame::IndexStatisticsFrame(wxWindow* parent, DatabasePtr db)
+    : BaseFrame(parent, -1, wxEmptyString), databaseM(db),
+        runningWorkersM(0), totalCountM(0), doneCountM(0), errorCountM(0)
+{
+    wxASSERT(db);
+
+    setIdString(this, getFrameId(db));
+    // observe database object to close on disconnect / destruction
+    db->attachObserver(this, false);
+    SetTitle(wxString::Format(_("Index Statistics: %s"),
+        db->getName_().c_str()));
+
+    createControls();
+    layoutControls();
+
+    #include "new.xpm"
+    wxBitmap bmp(new_xpm);
+    wxIcon icon;
+    icon.CopyFromBitmap(bmp);
+    SetIcon(icon);
+
+    loadIndices();
+    updateControls();
+}
+
+bool IndexStatisticsFrame::Destroy()
+{
+    stopRecompute();
+    joinWorkers();
+    return BaseFrame::Destroy();
+}
+
+void IndexStatisticsFrame::createControls()
+{
+    panel_controls = new wxPanel(this, -1, wxDefaultPosition, wxDefaultSize,
+        wxTAB_TRAVERSAL | wxCLIP_CHILDREN);
+
+    listctrl_indices = new wxListCtrl(panel_controls, ID_listctrl_indices,
+        wxDefaultPosition, wxDefaultSize, wxLC_REPORT);
+    listctrl_indices->InsertColumn(0, _("Table"));
+    listctrl_indices->InsertColumn(1, _("Index"));
+    listctrl_indices->InsertColumn(2, _("Segments"));
+    listctrl_indices->InsertColumn(3, _("Constraint"));
+    listctrl_indices->InsertColumn(4, _("Statistics"), wxLIST_FORMAT_RIGHT);
+    listctrl_indices->InsertColumn(5, _("Distinct keys"),
+        wxLIST_FORMAT_RIGHT);
+    listctrl_indices->InsertColumn(6, _("Est. rows"), wxLIST_FORMAT_RIGHT);
+    listctrl_indices->InsertColumn(7, _("Problems"));
+
+    checkbox_problems = new wxCheckBox(panel_controls, ID_checkbox_problems,
+        _("Show only indices with &problems"));
+    gauge_progress = new wxGauge(panel_controls, wxID_ANY, 100,
+        wxDefaultPosition, wxDefaultSize, wxGA_HORIZONTAL | wxGA_SMOOTH);
+    static_text_status = new wxStaticText(panel_controls, wxID_ANY,
+        wxEmptyString);
+    button_refresh = new wxButton(panel_controls, ID_button_refresh,
+        _("&Refresh"));
+    button_select = new wxButton(panel_controls, ID_button_select,
+        _("Select &Outdated"));
+    button_recompute = new wxButton(panel_controls, ID_button_recompute,
+        _("Re&compute Selected"));
+}
+
+void IndexStatisticsFrame::layoutControls()
+{
+    wxBoxSizer* sizerProgress = new wxBoxSizer(wxHORIZONTAL);
+    sizerProgress->Add(checkbox_problems, 0, wxALIGN_CENTER_VERTICAL);
+    sizerProgress->AddSpacer(
+        styleguide().getUnrelatedControlMargin(wxHORIZONTAL));
+    sizerProgress->Add(gauge_progress, 1, wxALIGN_CENTER_VERTICAL);
+
+    wxBoxSizer* sizerButtons = new wxBoxSizer(wxHORIZONTAL);
+    sizerButtons->Add(static_text_status, 0, wxALIGN_CENTER_VERTICAL);
+    sizerButtons->Add(styleguide().getUnrelatedControlMargin(wxHORIZONTAL), 0,
+        1, wxEXPAND);
+    sizerButtons->Add(button_refresh);
+    sizerButtons->AddSpacer(styleguide().getBetweenButtonsMargin(wxHORIZONTAL));
+    sizerButtons->Add(button_select);
+    sizerButtons->AddSpacer(styleguide().getUnrelatedControlMargin(wxHORIZONTAL));
+    sizerButtons->Add(button_recompute);
+
+    wxBoxSizer* sizerPanelV = new wxBoxSizer(wxVERTICAL);
+    sizerPanelV->AddSpacer(styleguide().getFrameMargin(wxTOP));
+    sizerPanelV->Add(listctrl_indices, 1, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getRelatedControlMargin(wxVERTICAL));
+    sizerPanelV->Add(sizerProgress, 0, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getUnrelatedControlMargin(wxVERTICAL));
+    sizerPanelV->Add(sizerButtons, 0, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getFrameMargin(wxBOTTOM));
+
+    wxBoxSizer* sizerPanelH = new wxBoxSizer(wxHORIZONTAL);
+    sizerPanelH->AddSpacer(styleguide().getFrameMargin(wxLEFT));
+    sizerPanelH->Add(sizerPanelV, 1, wxEXPAND);
+    sizerPanelH->AddSpacer(styleguide().getFrameMargin(wxRIGHT));
+
+    wxBoxSizer* sizerAll = new wxBoxSizer(wxHORIZONTAL);
+    sizerAll->Add(sizerPanelH, 1, wxEXPAND);
+
+    panel_controls->SetSizer(sizerAll);
+    sizerAll->Fit(this);
+    sizerAll->SetSizeHints(this);
+}
+
+void IndexStatisticsFrame::updateControls()
+{
+    bool recomputing = isRecomputing();
+    button_refresh->Enable(!recomputing);
+    button_select->Enable(!recomputing && !shownM.empty());
+    if (recomputing)
+    {
+        button_recompute->SetLabel(_("&Stop"));
+        button_recompute->Enable(true);
+    }
+    else
+    {
+        button_recompute->SetLabel(_("Re&compute Selected"));
+        button_recompute->Enable(
+            listctrl_indices->GetSelectedItemCount() > 0);
+    }
+}
+
+DatabasePtr IndexStatisticsFrame::getDatabase() const
+{
+    return databaseM.lock();
+}
+
+wxString IndexStatisticsFrame::toWx(const std::string& s) const
+{
+    DatabasePtr db = getDatabase();
+    if (db && db->getCharsetConverter())
+        return wxString(s.c_str(), *db->getCharsetConverter());
+    return wxString(s.c_str(), *wxConvCurrent);
+}
+
+wxString IndexStatisticsFrame::getProblemsText(const IndexHealth& index) const
+{
+    wxString text;
+    if (index.problems & ipInactive)
+        text += _("inactive; ");
+    if (index.problems & ipNoStatistics)
+        text += _("no statistics; ");
+    if (index.problems & ipStale)
+        text += _("outdated statistics; ");
+    if (index.problems & ipLowSelectivity)
+        text += _("low selectivity; ");
+    if (index.problems & ipDuplicate)
+    {
+        text += wxString::Format(_("duplicate of %s; "),
+            toWx(index.coveredBy).c_str());
+    }
+    if (index.problems & ipRedundantPrefix)
+    {
+        text += wxString::Format(_("covered by %s; "),
+            toWx(index.coveredBy).c_str());
+    }
+    if (!text.empty())
+        text.RemoveLast(2);
+    return text;
+}
+
+void IndexStatisticsFrame::loadIndices()
+{
+    DatabasePtr db = getDatabase();
+    if (!db)
+        return;
+
+    wxBusyCursor wait;
+    try
+    {
+        IBPP::Database& ibppDb = db->getIBPPDatabase();
+        IBPP::Transaction tr = IBPP::TransactionFactory(ibppDb, IBPP::amRead);
+        tr->Start();
+        IndexAnalyzer::load(ibppDb, tr, indicesM);
+        tr->Commit();
+    }
+    catch (IBPP::Exception& e)
+    {
+        indicesM.clear();
+        static_text_status->SetLabel(e.what());
+        showIndices();
+        return;
+    }
+    IndexAnalyzer().analyze(indicesM);
+    showIndices();
+
+    int problems = 0;
+    for (size_t i = 0; i < indicesM.size(); ++i)
+    {
+        if (indicesM[i].problems != ipNone)
+            ++problems;
+    }
+    static_text_status->SetLabel(wxString::Format(
+        _("%d indices, %d with problems"), (int)indicesM.size(), problems));
+    panel_controls->Layout();
+}
+
+static wxString formatCount(double value)
+{
+    if (value <= 0)
+        return wxEmptyString;
+    return wxString::Format("%.0f", value);
+}
+
+void IndexStatisticsFrame::showIndices()
+{
+    bool problemsOnly = checkbox_problems->IsChecked();
+    shownM.clear();
+    for (size_t i = 0; i < indicesM.size(); ++i)
+    {
+        if (!problemsOnly || indicesM[i].problems != ipNone)
+            shownM.push_back(i);
+    }
+
+    listctrl_indices->Freeze();
+    listctrl_indices->DeleteAllItems();
+    for (size_t i = 0; i < shownM.size(); ++i)
+    {
+        const IndexHealth& index = indicesM[shownM[i]];
+        long item = listctrl_indices->InsertItem(long(i),
+            toWx(index.relation));
+        listctrl_indices->SetItem(item, 1, toWx(index.name));
+
+        wxString segments;
+        if (index.expression)
+            segments = _("(expression)");
+        for (size_t j = 0; j < index.segments.size(); ++j)
+        {
+            if (j > 0)
+                segments += ", ";
+            segments += toWx(index.segments[j]);
+        }
+        if (index.descending)
+            segments += _(" (descending)");
+        listctrl_indices->SetItem(item, 2, segments);
+
+        wxString constraint(toWx(index.constraintType));
+        if (constraint.empty() && index.unique)
+            constraint = _("unique");
+        listctrl_indices->SetItem(item, 3, constraint);
+        listctrl_indices->SetItem(item, 4,
+            wxString::Format("%g", index.statistics));
+        listctrl_indices->SetItem(item, 5, formatCount(index.distinctKeys));
+        listctrl_indices->SetItem(item, 6, formatCount(index.estimatedRows));
+        listctrl_indices->SetItem(item, 7, getProblemsText(index));
+
+        if (index.problems & (ipNoStatistics | ipStale))
+            listctrl_indices->SetItemTextColour(item, *wxRED);
+        else if (index.problems != ipNone)
+            listctrl_indices->SetItemTextColour(item, *wxBLUE);
+    }
+    if (!shownM.empty())
+    {
+        for (int col = 0; col < 8; ++col)
+            listctrl_indices->SetColumnWidth(col, wxLIST_AUTOSIZE_USEHEADER);
+    }
+    listctrl_indices->Thaw();
+    updateControls();
+}
+
+bool IndexStatisticsFrame::isRecomputing() const
+{
+    return !workersM.empty();
+}
+
+void IndexStatisticsFrame::startRecompute(
+    const std::vector<std::string>& names)
+{
+    DatabasePtr db = getDatabase();
+    if (!db || names.empty() || isRecomputing())
+        return;
+
+    DatabaseConfig dc(db.get(), config());
+    int connections = std::max(1, dc.get("IndexStatisticsConnections", 4));
+    connections = std::min(connections, int(names.size()));
+
+    {
+        wxCriticalSectionLocker locker(workCritsectM);
+        pendingM.assign(names.begin(), names.end());
+        finishedM.clear();
+        runningWorkersM = 0;
+    }
+    totalCountM = int(names.size());
+    doneCountM = 0;
+    errorCountM = 0;
+    lastErrorM.clear();
+    gauge_progress->SetRange(totalCountM);
+    gauge_progress->SetValue(0);
+
+    // attachments leased from the connection pool, or dedicated ones with
+    // the parameters of the existing one when the pool is exhausted
+    ConnectionPool& pool = db->getConnectionPool();
+    for (int i = 0; i < connections; ++i)
+    {
+        IBPP::Database workerDb = pool.acquireOrCreate(
+            db->getIBPPDatabase());
+        IndexStatisticsWorker* worker = new IndexStatisticsWorker(this,
+            workerDb);
+        workerDb.clear();
+        if (worker->Create() != wxTHREAD_NO_ERROR)
+        {
+            pool.release(worker->getDatabase());
+            delete worker;
+            break;
+        }
+        {
+            wxCriticalSectionLocker locker(workCritsectM);
+            ++runningWorkersM;
+        }
+        if (worker->Run() != wxTHREAD_NO_ERROR)
+        {
+            {
+                wxCriticalSectionLocker locker(workCritsectM);
+                --runningWorkersM;
+            }
+            pool.release(worker->getDatabase());
+            delete worker;
+            break;
+        }
+        workersM.push_back(worker);
+    }
+
+    if (workersM.empty())
+    {
+        wxMessageBox(_("Can not start the index statistics threads"),
+            _("Error"), wxOK | wxICON_ERROR);
+        return;
+    }
+    static_text_status->SetLabel(wxString::Format(
+        _("Recomputing %d indices on %d connections..."), totalCountM,
+        (int)workersM.size()));
+    panel_controls->Layout();
+    updateControls();
+}
+
+// the workers finish the index they are working on and exit
+void IndexStatisticsFrame::stopRecompute()
+{
+    wxCriticalSectionLocker locker(workCritsectM);
+    pendingM.clear();
+}
+
+void IndexStatisticsFrame::joinWorkers()
+{
+    DatabasePtr db = getDatabase();
+    for (size_t i = 0; i < workersM.size(); ++i)
+    {
+        workersM[i]->Wait();
+        if (db)
+            db->getConnectionPool().release(workersM[i]->getDatabase());
+        else
+            ConnectionPool::discard(workersM[i]->getDatabase());
+        delete workersM[i];
+    }
+    workersM.clear();
+}
+
+bool IndexStatisticsFrame::getNextIndex(std::string& name)
+{
+    wxCriticalSectionLocker locker(workCritsectM);
+    if (pendingM.empty())
+        return false;
+    name = pendingM.front();
+    pendingM.pop_front();
+    return true;
+}
+
+void IndexStatisticsFrame::indexFinished(const std::string& name,
+    const wxString& error)
+{
+    {
+        wxCriticalSectionLocker locker(workCritsectM);
+        finishedM.push_back(std::make_pair(name, error));
+    }
+    wxCommandEvent event(wxEVT_COMMAND_MENU_SELECTED, ID_index_finished);
+    wxPostEvent(this, event);
+}
+
+void IndexStatisticsFrame::workerFinished()
+{
+    {
+        wxCriticalSectionLocker locker(workCritsectM);
+        --runningWorkersM;
+    }
+    wxCommandEvent event(wxEVT_COMMAND_MENU_SELECTED, ID_index_finished);
+    wxPostEvent(this, event);
+}
+
+void IndexStatisticsFrame::subjectRemoved(Subject* subject)
+{
+    DatabasePtr db = getDatabase();
+    if (!db || !db->isConnected() || subject == db.get())
+        Close();
+}
+
+void IndexStatisticsFrame::update()
+{
+    DatabasePtr db = getDatabase();
+    if (!db || !db->isConnected())
+        Close();
+}
+
+void IndexStatisticsFrame::doReadConfigSettings(const wxString& prefix)
+{
+    BaseFrame::doReadConfigSettings(prefix);
+    bool problemsOnly = false;
+    config().getValue(prefix + Config::pathSeparator + "problemsOnly",
+        problemsOnly);
+    if (problemsOnly != checkbox_problems->IsChecked())
+    {
+        checkbox_problems->SetValue(problemsOnly);
+        showIndices();
+    }
+}
+
+void IndexStatisticsFrame::doWriteConfigSettings(const wxString& prefix) const
+{
+    BaseFrame::doWriteConfigSettings(prefix);
+    config().setValue(prefix + Config::pathSeparator + "problemsOnly",
+        checkbox_problems->IsChecked());
+}
+
+const wxString IndexStatisticsFrame::getName() const
+{
+    return "IndexStatisticsFrame";
+}
+
+wxString IndexStatisticsFrame::getFrameId(DatabasePtr db)
+{
+    if (db)
+        return wxString("IndexStatisticsFrame/" + db->getItemPath());
+    else
+        return wxEmptyString;
+}
+
+IndexStatisticsFrame* IndexStatisticsFrame::findFrameFor(DatabasePtr db)
+{
+    BaseFrame* bf = frameFromIdString(getFrameId(db));
+    if (!bf)
+        return 0;
+    return dynamic_cast<IndexStatisticsFrame*>(bf);
+}
+
+BEGIN_EVENT_TABLE(IndexStatisticsFrame, wxFrame)
+    EVT_BUTTON(IndexStatisticsFrame::ID_button_refresh, IndexStatisticsFrame::OnButtonRefreshClick)
+    EVT_BUTTON(IndexStatisticsFrame::ID_button_select, IndexStatisticsFrame::OnButtonSelectClick)
+    EVT_BUTTON(IndexStatisticsFrame::ID_button_recompute, IndexStatisticsFrame::OnButtonRecomputeClick)
+    EVT_CHECKBOX(IndexStatisticsFrame::ID_checkbox_problems, IndexStatisticsFrame::OnCheckboxProblemsClick)
+    EVT_LIST_ITEM_SELECTED(IndexStatisticsFrame::ID_listctrl_indices, IndexStatisticsFrame::OnListSelectionChanged)
+    EVT_LIST_ITEM_DESELECTED(IndexStatisticsFrame::ID_listctrl_indices, IndexStatisticsFrame::OnListSelectionChanged)
+    EVT_MENU(IndexStatisticsFrame::ID_index_finished, IndexStatisticsFrame::OnIndexFinished)
+END_EVENT_TABLE()
+
+void IndexStatisticsFrame::OnButtonRefreshClick(
+    wxCommandEvent& WXUNUSED(event))
+{
+    loadIndices();
+}
+
+// selects the indices whose statistics are missing or outdated
+void IndexStatisticsFrame::OnButtonSelectClick(
+    wxCommandEvent& WXUNUSED(event))
+{
+    listctrl_indices->Freeze();
+    for (size_t i = 0; i < shownM.size(); ++i)
+    {
+        bool outdated = (indicesM[shownM[i]].problems
+            & (ipNoStatistics | ipStale)) != 0;
+        listctrl_indices->SetItemState(long(i),
+            outdated ? wxLIST_STATE_SELECTED : 0, wxLIST_STATE_SELECTED);
+    }
+    listctrl_indices->Thaw();
+    updateControls();
+}
+
+void IndexStatisticsFrame::OnButtonRecomputeClick(
+    wxCommandEvent& WXUNUSED(event))
+{
+    if (isRecomputing())
+    {
+        stopRecompute();
+        static_text_status->SetLabel(_("Stopping..."));
+        panel_controls->Layout();
+        return;
+    }
+
+    std::vector<std::string> names;
+    long item = -1;
+    while ((item = listctrl_indices->GetNextItem(item, wxLIST_NEXT_ALL,
+        wxLIST_STATE_SELECTED)) != -1)
+    {
+        const IndexHealth& index = indicesM[shownM[item]];
+        // SET STATISTICS fails for inactive indices
+        if (index.active)
+            names.push_back(index.name);
+    }
+    startRecompute(names);
+}
+
+void IndexStatisticsFrame::OnCheckboxProblemsClick(
+    wxCommandEvent& WXUNUSED(event))
+{
+    showIndices();
+}
+
+void IndexStatisticsFrame::OnIndexFinished(wxCommandEvent& WXUNUSED(event))
+{
+    std::vector<std::pair<std::string, wxString> > finished;
+    int running;
+    {
+        wxCriticalSectionLocker locker(workCritsectM);
+        finished.swap(finishedM);
+        running = runningWorkersM;
+    }
+
+    for (size_t i = 0; i < finished.size(); ++i)
+    {
+        ++doneCountM;
+        if (!finished[i].second.empty())
+        {
+            ++errorCountM;
+            lastErrorM = toWx(finished[i].first) + ": " + finished[i].second;
+        }
+    }
+    if (isRecomputing())
+        gauge_progress->SetValue(std::min(doneCountM, totalCountM));
+
+    if (running > 0 || !isRecomputing())
+    {
+        if (!finished.empty())
+        {
+            static_text_status->SetLabel(wxString::Format(
+                _("Recomputed %d of %d indices"), doneCountM, totalCountM));
+            panel_controls->Layout();
+        }
+        return;
+    }
+
+    // all workers are done, show the new statistics
+    joinWorkers();
+    loadIndices();
+    wxString status(wxString::Format(
+        _("Recomputed %d of %d indices, %d failed"),
+        doneCountM - errorCountM, totalCountM, errorCountM));
+    if (!lastErrorM.empty())
+        status += " (" + lastErrorM.BeforeFirst('\n') + ")";
+    static_text_status->SetLabel(status);
+    panel_controls->Layout();
+    updateControls();
+}
+
+void IndexStatisticsFrame::OnListSelectionChanged(wxListEvent& WXUNUSED(event))
+{
+    updateControls();
+}
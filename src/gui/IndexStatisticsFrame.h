@@ -0,0 +1,141 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef FR_INDEX_STATISTICS_FRAME_H
+#define FR_INDEX_STATISTICS_FRAME_H
+
+#include <wx/wx.h>
+#include <wx/button.h>
+#include <wx/checkbox.h>
+#include <wx/gauge.h>
+#include <wx/listctrl.h>
+#include <wx/panel.h>
+#include <wx/thread.h>
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/Observer.h"
+#include "engine/IndexAnalyzer.h"
+#include "gui/BaseFrame.h"
+#include "metadata/database.h"
+#include "metadata/MetadataClasses.h"
+
+class IndexStatisticsWorker;
+
+// Shows the statistics of all indices of a database with the problems found
+// by the IndexAnalyzer, and recomputes the statistics of selected indices
+// on several connections in parallel.
+class IndexStatisticsFrame : public BaseFrame, public Observer
+{
+private:
+    friend class IndexStatisticsWorker;
+
+    DatabaseWeakPtr databaseM;
+    IndexHealthList indicesM;
+    // indices of indicesM in list order
+    std::vector<size_t> shownM;
+
+    // shared with the worker threads
+    wxCriticalSection workCritsectM;
+    std::deque<std::string> pendingM;
+    std::vector<std::pair<std::string, wxString> > finishedM;
+    int runningWorkersM;
+
+    std::vector<IndexStatisticsWorker*> workersM;
+    int totalCountM;
+    int doneCountM;
+    int errorCountM;
+    wxString lastErrorM;
+
+    wxPanel* panel_controls;
+    wxListCtrl* listctrl_indices;
+    wxCheckBox* checkbox_problems;
+    wxGauge* gauge_progress;
+    wxStaticText* static_text_status;
+    wxButton* button_refresh;
+    wxButton* button_select;
+    wxButton* button_recompute;
+    void createControls();
+    void layoutControls();
+    void updateControls();
+
+    static wxString getFrameId(DatabasePtr db);
+
+    DatabasePtr getDatabase() const;
+    wxString toWx(const std::string& s) const;
+    wxString getProblemsText(const IndexHealth& index) const;
+    void loadIndices();
+    void showIndices();
+
+    bool isRecomputing() const;
+    void startRecompute(const std::vector<std::string>& names);
+    void stopRecompute();
+    void joinWorkers();
+
+    // called by the worker threads
+    bool getNextIndex(std::string& name);
+    void indexFinished(const std::string& name, const wxString& error);
+    void workerFinished();
+
+    // observer stuff
+    virtual void subjectRemoved(Subject* subject);
+    virtual void update();
+
+protected:
+    virtual void doReadConfigSettings(const wxString& prefix);
+    virtual void doWriteConfigSettings(const wxString& prefix) const;
+    virtual const wxString getName() const;
+public:
+    IndexStatisticsFrame(wxWindow* parent, DatabasePtr db);
+
+    // make sure that the worker threads are stopped
+    virtual bool Destroy();
+
+    static IndexStatisticsFrame* findFrameFor(DatabasePtr db);
+private:
+    // event handling
+    enum
+    {
+        ID_listctrl_indices = 101,
+        ID_checkbox_problems,
+        ID_button_refresh,
+        ID_button_select,
+        ID_button_recompute,
+        ID_index_finished
+    };
+
+    void OnButtonRefreshClick(wxCommandEvent& event);
+    void OnButtonSelectClick(wxCommandEvent& event);
+    void OnButtonRecomputeClick(wxCommandEvent& event);
+    void OnCheckboxProblemsClick(wxCommandEvent& event);
+    void OnIndexFinished(wxCommandEvent& event);
+    void OnListSelectionChanged(wxListEvent& event);
+
+    DECLARE_EVENT_TABLE()
+};
+
+#endif
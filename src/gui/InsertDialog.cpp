@@ -30,13 +30,12 @@
     #include "wx/wx.h"
 #endif
 
-#include <wx/ffile.h>
-
 #include <set>
 
 #include "core/ArtProvider.h"
 #include "core/FRError.h"
 #include "core/StringUtils.h"
+#include "engine/BlobTransfer.h"
 #include "gui/controls/DataGridRowBuffer.h"
 #include "gui/controls/DataGridTable.h"
 #include "gui/InsertDialog.h"
@@ -573,22 +572,10 @@ void InsertDialog::OnOkButtonClick(wxCommandEvent& WXUNUSED(event))
     {
         if (getInsertOption(gridM, (*it).row) != ioFile)
             continue;
-        wxFFile fl(gridM->GetCellValue((*it).row, 3), "rb");
-        if (!fl.IsOpened())
-            throw FRError(_("Cannot open BLOB file."));
         IBPP::Blob b = IBPP::BlobFactory(st1->DatabasePtr(),
             st1->TransactionPtr());
         b->Create();
-        uint8_t buffer[32768];
-        while (!fl.Eof())
-        {
-            size_t len = fl.Read(buffer, 32767);    // slow when not 32k
-            if (len < 1)
-                break;
-            b->Write(buffer, len);
-        }
-        fl.Close();
-        b->Close();
+        importBlobFromFile(b, gridM->GetCellValue((*it).row, 3), 0);
         st1->Set(index++, b);
         bufferM->setBlob((*it).columnDef->getIndex(), b);
     }
@@ -34,6 +34,7 @@
 #include <wx/dir.h>
 #include <wx/dnd.h>
 #include <wx/arrstr.h>
+#include <wx/stopwatch.h>
 
 #include "config/Config.h"
 #include "config/DatabaseConfig.h"
@@ -51,16 +52,22 @@
 #include "gui/controls/DBHTreeControl.h"
 #include "gui/DataGeneratorFrame.h"
 #include "gui/DatabaseRegistrationDialog.h"
+#include "gui/DatabaseStatisticsFrame.h"
 #include "gui/EventWatcherFrame.h"
 #include "gui/ExecuteSql.h"
 #include "gui/ExecuteSqlFrame.h"
+#include "gui/IndexStatisticsFrame.h"
 #include "gui/MainFrame.h"
+#include "gui/MaintenanceFrame.h"
 #include "gui/MetadataItemPropertiesFrame.h"
+#include "gui/MonitoringFrame.h"
 #include "gui/PreferencesDialog.h"
 #include "gui/ProgressDialog.h"
 #include "gui/RestoreFrame.h"
+#include "gui/ResultDiffFrame.h"
 #include "gui/ServerRegistrationDialog.h"
 #include "gui/SimpleHtmlFrame.h"
+#include "gui/TraceFrame.h"
 #include "main.h"
 #include "metadata/column.h"
 #include "metadata/domain.h"
@@ -189,6 +196,8 @@ void MainFrame::buildMainMenu()
     databaseMenuM->Append(Cmds::Menu_RegisterDatabase, _("R&egister existing database..."));
     databaseMenuM->Append(Cmds::Menu_CreateDatabase, _("Create &new database..."));
     databaseMenuM->Append(Cmds::Menu_RestoreIntoNew, _("Restore bac&kup into new database..."));
+    databaseMenuM->Append(Cmds::Menu_MaintenanceScheduler, _("&Maintenance scheduler..."));
+    databaseMenuM->Append(Cmds::Menu_CompareResults, _("Com&pare query results..."));
     databaseMenuM->AppendSeparator();
     menuBarM->Append(databaseMenuM, _("&Database"));
 
@@ -280,7 +289,10 @@ void MainFrame::set_properties()
 {
     SetTitle(_("FlameRobin Database Admin"));
 
-    if (!rootM->load())
+    wxStopWatch sw;
+    bool loaded = rootM->load();
+    wxLogVerbose(_("Registrations loaded in %ld ms"), sw.Time());
+    if (!loaded)
     {
         wxString confile = config().getDBHFileName();
         if (confile.Length() > 20)
@@ -298,8 +310,10 @@ void MainFrame::set_properties()
         rootM->addServer(s);
         rootM->save();
     }
+    sw.Start();
     wxTreeItemId rootNode = treeMainM->addRootNode(rootM.get());
     treeMainM->Expand(rootNode);
+    wxLogVerbose(_("Tree nodes created in %ld ms"), sw.Time());
 
     // make the first server active
     wxTreeItemIdValue cookie;
@@ -367,6 +381,8 @@ BEGIN_EVENT_TABLE(MainFrame, wxFrame)
     EVT_UPDATE_UI(Cmds::Menu_CreateDatabase, MainFrame::OnMenuUpdateIfServerSelected)
     EVT_MENU(Cmds::Menu_RestoreIntoNew, MainFrame::OnMenuRestoreIntoNewDatabase)
     EVT_UPDATE_UI(Cmds::Menu_RestoreIntoNew, MainFrame::OnMenuUpdateIfServerSelected)
+    EVT_MENU(Cmds::Menu_MaintenanceScheduler, MainFrame::OnMenuMaintenanceScheduler)
+    EVT_MENU(Cmds::Menu_CompareResults, MainFrame::OnMenuCompareResults)
     EVT_MENU(Cmds::Menu_ManageUsers, MainFrame::OnMenuManageUsers)
     EVT_UPDATE_UI(Cmds::Menu_ManageUsers, MainFrame::OnMenuUpdateIfServerSelected)
     EVT_MENU(Cmds::Menu_UnRegisterServer, MainFrame::OnMenuUnRegisterServer)
@@ -380,6 +396,14 @@ BEGIN_EVENT_TABLE(MainFrame, wxFrame)
     EVT_UPDATE_UI(Cmds::Menu_GetServerVersion, MainFrame::OnMenuUpdateIfServerSelected)
     EVT_MENU(Cmds::Menu_MonitorEvents, MainFrame::OnMenuMonitorEvents)
     EVT_UPDATE_UI(Cmds::Menu_MonitorEvents, MainFrame::OnMenuUpdateIfDatabaseConnectedOrAutoConnect)
+    EVT_MENU(Cmds::Menu_MonitorDatabase, MainFrame::OnMenuMonitorDatabase)
+    EVT_UPDATE_UI(Cmds::Menu_MonitorDatabase, MainFrame::OnMenuUpdateIfDatabaseConnectedOrAutoConnect)
+    EVT_MENU(Cmds::Menu_TraceDatabase, MainFrame::OnMenuTraceDatabase)
+    EVT_UPDATE_UI(Cmds::Menu_TraceDatabase, MainFrame::OnMenuUpdateIfDatabaseConnectedOrAutoConnect)
+    EVT_MENU(Cmds::Menu_IndexStatistics, MainFrame::OnMenuIndexStatistics)
+    EVT_UPDATE_UI(Cmds::Menu_IndexStatistics, MainFrame::OnMenuUpdateIfDatabaseConnectedOrAutoConnect)
+    EVT_MENU(Cmds::Menu_DatabaseStatistics, MainFrame::OnMenuDatabaseStatistics)
+    EVT_UPDATE_UI(Cmds::Menu_DatabaseStatistics, MainFrame::OnMenuUpdateIfDatabaseConnectedOrAutoConnect)
     EVT_MENU(Cmds::Menu_GenerateData, MainFrame::OnMenuGenerateData)
     EVT_UPDATE_UI(Cmds::Menu_GenerateData, MainFrame::OnMenuUpdateIfDatabaseConnectedOrAutoConnect)
     EVT_MENU(Cmds::Menu_CloneDatabase, MainFrame::OnMenuCloneDatabase)
@@ -919,6 +943,29 @@ void MainFrame::OnMenuCreateDatabase(wxCommandEvent& WXUNUSED(event))
     }
 }
 
+void MainFrame::OnMenuMaintenanceScheduler(wxCommandEvent& WXUNUSED(event))
+{
+    if (MaintenanceFrame* mf = MaintenanceFrame::findFrame())
+    {
+        mf->Raise();
+        return;
+    }
+    MaintenanceFrame* mf = new MaintenanceFrame(this, rootM);
+    mf->Show();
+}
+
+void MainFrame::OnMenuCompareResults(wxCommandEvent& WXUNUSED(event))
+{
+    if (ResultDiffFrame* rf = ResultDiffFrame::findFrame())
+    {
+        rf->Raise();
+        return;
+    }
+    DatabasePtr db = getDatabase(treeMainM->getSelectedMetadataItem());
+    ResultDiffFrame* rf = new ResultDiffFrame(this, rootM, db);
+    rf->Show();
+}
+
 void MainFrame::OnMenuManageUsers(wxCommandEvent& WXUNUSED(event))
 {
     ServerPtr s = getServer(treeMainM->getSelectedMetadataItem());
@@ -1052,6 +1099,78 @@ void MainFrame::OnMenuMonitorEvents(wxCommandEvent& WXUNUSED(event))
     ewf->Show();
 }
 
+void MainFrame::OnMenuMonitorDatabase(wxCommandEvent& WXUNUSED(event))
+{
+    DatabasePtr db = getDatabase(treeMainM->getSelectedMetadataItem());
+    if (!checkValidDatabase(db))
+        return;
+    if (!tryAutoConnectDatabase(db))
+        return;
+
+    MonitoringFrame* mf = MonitoringFrame::findFrameFor(db);
+    if (mf)
+    {
+        mf->Raise();
+        return;
+    }
+    mf = new MonitoringFrame(this, db);
+    mf->Show();
+}
+
+void MainFrame::OnMenuTraceDatabase(wxCommandEvent& WXUNUSED(event))
+{
+    DatabasePtr db = getDatabase(treeMainM->getSelectedMetadataItem());
+    if (!checkValidDatabase(db))
+        return;
+    if (!tryAutoConnectDatabase(db))
+        return;
+
+    TraceFrame* tf = TraceFrame::findFrameFor(db);
+    if (tf)
+    {
+        tf->Raise();
+        return;
+    }
+    tf = new TraceFrame(this, db);
+    tf->Show();
+}
+
+void MainFrame::OnMenuIndexStatistics(wxCommandEvent& WXUNUSED(event))
+{
+    DatabasePtr db = getDatabase(treeMainM->getSelectedMetadataItem());
+    if (!checkValidDatabase(db))
+        return;
+    if (!tryAutoConnectDatabase(db))
+        return;
+
+    IndexStatisticsFrame* isf = IndexStatisticsFrame::findFrameFor(db);
+    if (isf)
+    {
+        isf->Raise();
+        return;
+    }
+    isf = new IndexStatisticsFrame(this, db);
+    isf->Show();
+}
+
+void MainFrame::OnMenuDatabaseStatistics(wxCommandEvent& WXUNUSED(event))
+{
+    DatabasePtr db = getDatabase(treeMainM->getSelectedMetadataItem());
+    if (!checkValidDatabase(db))
+        return;
+    if (!tryAutoConnectDatabase(db))
+        return;
+
+    DatabaseStatisticsFrame* dsf = DatabaseStatisticsFrame::findFrameFor(db);
+    if (dsf)
+    {
+        dsf->Raise();
+        return;
+    }
+    dsf = new DatabaseStatisticsFrame(this, db);
+    dsf->Show();
+}
+
 void MainFrame::OnMenuBackup(wxCommandEvent& WXUNUSED(event))
 {
     DatabasePtr db = getDatabase(treeMainM->getSelectedMetadataItem());
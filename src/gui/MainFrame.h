@@ -64,12 +64,18 @@ public:
     void OnMenuRecreateDatabase(wxCommandEvent& event);
     void OnMenuDropDatabase(wxCommandEvent& event);
     void OnMenuRestoreIntoNewDatabase(wxCommandEvent& event);
+    void OnMenuMaintenanceScheduler(wxCommandEvent& event);
+    void OnMenuCompareResults(wxCommandEvent& event);
     void OnMenuManageUsers(wxCommandEvent& event);
     void OnMenuUnRegisterServer(wxCommandEvent& event);
     void OnMenuServerProperties(wxCommandEvent& event);
     void OnMenuUnRegisterDatabase(wxCommandEvent& event);
     void OnMenuGetServerVersion(wxCommandEvent& event);
     void OnMenuMonitorEvents(wxCommandEvent& event);
+    void OnMenuMonitorDatabase(wxCommandEvent& event);
+    void OnMenuTraceDatabase(wxCommandEvent& event);
+    void OnMenuIndexStatistics(wxCommandEvent& event);
+    void OnMenuDatabaseStatistics(wxCommandEvent& event);
     void OnMenuGenerateData(wxCommandEvent& event);
     void OnMenuBackup(wxCommandEvent& event);
     void OnMenuExecuteStatements(wxCommandEvent& event);
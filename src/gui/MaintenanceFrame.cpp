@@ -0,0 +1,843 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <wx/datetime.h>
+#include <wx/filename.h>
+
+#include <atomic>
+
+#include <ibpp.h>
+
+#include "config/Config.h"
+#include "core/StringUtils.h"
+#include "engine/BackupStream.h"
+#include "gui/AdvancedMessageDialog.h"
+#include "gui/MaintenanceFrame.h"
+#include "gui/StyleGuide.h"
+#include "gui/UsernamePasswordDialog.h"
+#include "metadata/database.h"
+#include "metadata/root.h"
+#include "metadata/server.h"
+
+// MaintenanceJobThread class
+// Runs one job on its own connection. Sweep and validation can't be
+// interrupted, the other jobs stop at the next chance after cancel().
+class MaintenanceJobThread: public wxThread, public BackupStreamProgress
+{
+private:
+    MaintenanceFrame* frameM;
+    int jobIdM;
+    MaintenanceJobKind kindM;
+    MaintenanceTarget targetM;
+    std::atomic<bool> canceledM;
+
+    IBPP::Database attach();
+    IBPP::Service connectService();
+    int64_t getDatabasePages();
+    void recomputeIndexStatistics();
+    void backup();
+    virtual bool isBackupCanceled();
+    virtual void backupReceived(const wxULongLong& bytes, bool finished);
+public:
+    MaintenanceJobThread(MaintenanceFrame* frame, int jobId,
+        MaintenanceJobKind kind, const MaintenanceTarget& target);
+    virtual ExitCode Entry();
+    void cancel() { canceledM = true; }
+    bool isCanceled() const { return canceledM; }
+
+    MaintenanceJobKind getKind() const { return kindM; }
+
+    // the results, valid after the thread has finished, amountM can be
+    // read while the job runs
+    bool successM;
+    std::atomic<int64_t> amountM;
+    wxString messageM;
+};
+
+MaintenanceJobThread::MaintenanceJobThread(MaintenanceFrame* frame,
+        int jobId, MaintenanceJobKind kind, const MaintenanceTarget& target)
+    : wxThread(wxTHREAD_JOINABLE), frameM(frame), jobIdM(jobId),
+        kindM(kind), targetM(target), canceledM(false), successM(false),
+        amountM(0)
+{
+}
+
+IBPP::Database MaintenanceJobThread::attach()
+{
+    IBPP::Database db = IBPP::DatabaseFactory(wx2std(targetM.server),
+        wx2std(targetM.path), wx2std(targetM.username),
+        wx2std(targetM.password), wx2std(targetM.role),
+        wx2std(targetM.charset), "");
+    db->Connect();
+    return db;
+}
+
+IBPP::Service MaintenanceJobThread::connectService()
+{
+    IBPP::Service svc = IBPP::ServiceFactory(wx2std(targetM.server),
+        wx2std(targetM.username), wx2std(targetM.password));
+    svc->Connect();
+    return svc;
+}
+
+int64_t MaintenanceJobThread::getDatabasePages()
+{
+    IBPP::Database db = attach();
+    int ods, odsMinor, pageSize, pages, buffers, sweep;
+    bool sync, reserve, readOnly;
+    db->Info(&ods, &odsMinor, &pageSize, &pages, &buffers, &sweep, &sync,
+        &reserve, &readOnly);
+    db->Disconnect();
+    return pages;
+}
+
+void MaintenanceJobThread::recomputeIndexStatistics()
+{
+    IBPP::Database db = attach();
+    IBPP::Transaction tr = IBPP::TransactionFactory(db, IBPP::amRead);
+    tr->Start();
+    IBPP::Statement st = IBPP::StatementFactory(db, tr);
+    st->Execute("select rdb$index_name from rdb$indices"
+        " where coalesce(rdb$system_flag, 0) = 0"
+        " and coalesce(rdb$index_inactive, 0) = 0"
+        " order by rdb$relation_name, rdb$index_name");
+    std::vector<std::string> names;
+    while (st->Fetch())
+    {
+        std::string name;
+        st->Get(1, name);
+        names.push_back(name.substr(0, name.find_last_not_of(' ') + 1));
+    }
+    tr->Commit();
+
+    for (std::vector<std::string>::const_iterator it = names.begin();
+        it != names.end() && !canceledM; ++it)
+    {
+        std::string sql("SET STATISTICS INDEX ");
+        if (db->Dialect() == 1)
+            sql += *it;
+        else
+        {
+            sql += '"';
+            for (std::string::const_iterator c = it->begin(); c != it->end();
+                ++c)
+            {
+                if (*c == '"')
+                    sql += '"';
+                sql += *c;
+            }
+            sql += '"';
+        }
+        tr = IBPP::TransactionFactory(db);
+        tr->Start();
+        st = IBPP::StatementFactory(db, tr);
+        st->ExecuteImmediate(sql);
+        tr->Commit();
+        ++amountM;
+    }
+    db->Disconnect();
+}
+
+void MaintenanceJobThread::backup()
+{
+    IBPP::Service svc = connectService();
+    svc->StartBackupStream(wx2std(targetM.path));
+
+    wxULongLong written;
+    BackupStreamResult result = receiveBackupStream(svc, targetM.backupFile,
+        true, *this, written);
+    svc->Disconnect();
+
+    if (result == bsCreateFailed)
+    {
+        messageM.Printf(_("Could not create the backup file \"%s\""),
+            targetM.backupFile.c_str());
+    }
+    else if (result == bsWriteFailed)
+    {
+        messageM.Printf(_("Writing to \"%s\" failed"),
+            targetM.backupFile.c_str());
+    }
+    else if (result == bsFinished)
+        messageM = targetM.backupFile;
+    successM = result == bsFinished;
+}
+
+bool MaintenanceJobThread::isBackupCanceled()
+{
+    return canceledM;
+}
+
+void MaintenanceJobThread::backupReceived(const wxULongLong& bytes,
+    bool WXUNUSED(finished))
+{
+    amountM = int64_t(bytes.GetValue());
+}
+
+wxThread::ExitCode MaintenanceJobThread::Entry()
+{
+    try
+    {
+        switch (kindM)
+        {
+            case mjSweep:
+            case mjValidate:
+            {
+                amountM = getDatabasePages();
+                IBPP::Service svc = connectService();
+                if (kindM == mjSweep)
+                    svc->Sweep(wx2std(targetM.path));
+                else
+                {
+                    svc->Repair(wx2std(targetM.path), IBPP::RPF(
+                        IBPP::rpValidateFull | IBPP::rpReadOnly));
+                    messageM = _("Errors found are written to the server log");
+                }
+                svc->Disconnect();
+                successM = true;
+                break;
+            }
+            case mjIndexStatistics:
+                recomputeIndexStatistics();
+                successM = !canceledM;
+                break;
+            case mjBackup:
+                backup();
+                break;
+        }
+        if (canceledM)
+            messageM = _("Canceled");
+    }
+    catch (IBPP::Exception& e)
+    {
+        successM = false;
+        messageM = e.what();
+    }
+    catch (...)
+    {
+        successM = false;
+        messageM = _("Unexpected exception");
+    }
+
+    wxCommandEvent event(wxEVT_COMMAND_MENU_SELECTED,
+        MaintenanceFrame::ID_job_finished);
+    event.SetInt(jobIdM);
+    wxPostEvent(frameM, event);
+    return 0;
+}
+
+// MaintenanceFrame class
+MaintenanceFrame::MaintenanceFrame(wxWindow* parent, RootPtr root)
+    : BaseFrame(parent, -1, wxEmptyString), rootM(root),
+        timerM(this, ID_timer)
+{
+    setIdString(this, getFrameId());
+    SetTitle(_("Maintenance Scheduler"));
+    historyFileNameM = config().getUserHomePath() + "fr_maintenance.log";
+
+    createControls();
+    layoutControls();
+
+    #include "new.xpm"
+    wxBitmap bmp(new_xpm);
+    wxIcon icon;
+    icon.CopyFromBitmap(bmp);
+    SetIcon(icon);
+
+    loadDatabases();
+    loadHistory();
+    updateControls();
+}
+
+bool MaintenanceFrame::doCanClose()
+{
+    if (!hasUninterruptibleJobs())
+        return true;
+    showInformationDialog(this,
+        _("The window can not be closed while jobs are running"),
+        _("Sweep and validation jobs can not be canceled, they run until the server has finished them. Cancel the other jobs and close the window when the remaining jobs are done."),
+        AdvancedMessageDialogButtonsOk());
+    return false;
+}
+
+bool MaintenanceFrame::Destroy()
+{
+    if (!threadsM.empty())
+    {
+        wxBusyCursor wait;
+        cancelJobs();
+        joinThreads();
+    }
+    timerM.Stop();
+    return BaseFrame::Destroy();
+}
+
+void MaintenanceFrame::createControls()
+{
+    panel_controls = new wxPanel(this, -1, wxDefaultPosition, wxDefaultSize,
+        wxTAB_TRAVERSAL | wxCLIP_CHILDREN);
+
+    checklist_databases = new wxCheckListBox(panel_controls, wxID_ANY);
+    checkbox_sweep = new wxCheckBox(panel_controls, wxID_ANY, _("&Sweep"));
+    checkbox_validate = new wxCheckBox(panel_controls, wxID_ANY,
+        _("&Validate (read only)"));
+    checkbox_statistics = new wxCheckBox(panel_controls, wxID_ANY,
+        _("Recompute &index statistics"));
+    checkbox_backup = new wxCheckBox(panel_controls, wxID_ANY,
+        _("&Backup to local directory (gzip)"));
+    label_backupdir = new wxStaticText(panel_controls, wxID_ANY,
+        _("Backup directory:"));
+    text_ctrl_backupdir = new wxTextCtrl(panel_controls, wxID_ANY);
+    button_browse = new wxButton(panel_controls, ID_button_browse, _("..."),
+        wxDefaultPosition, wxDefaultSize, wxBU_EXACTFIT);
+    label_concurrency = new wxStaticText(panel_controls, wxID_ANY,
+        _("Jobs per server:"));
+    spinctrl_concurrency = new wxSpinCtrl(panel_controls,
+        ID_spinctrl_concurrency, "2", wxDefaultPosition, wxDefaultSize,
+        wxSP_ARROW_KEYS, 1, 16, 2);
+    button_queue = new wxButton(panel_controls, ID_button_queue,
+        _("&Queue Jobs"));
+
+    notebook_jobs = new wxNotebook(panel_controls, wxID_ANY);
+    listctrl_jobs = new wxListCtrl(notebook_jobs, wxID_ANY,
+        wxDefaultPosition, wxDefaultSize, wxLC_REPORT);
+    listctrl_history = new wxListCtrl(notebook_jobs, wxID_ANY,
+        wxDefaultPosition, wxDefaultSize, wxLC_REPORT);
+    wxListCtrl* lists[] = { listctrl_jobs, listctrl_history };
+    for (size_t i = 0; i < sizeof(lists) / sizeof(wxListCtrl*); ++i)
+    {
+        lists[i]->InsertColumn(0, _("Database"));
+        lists[i]->InsertColumn(1, _("Server"));
+        lists[i]->InsertColumn(2, _("Job"));
+        lists[i]->InsertColumn(3, _("State"));
+        lists[i]->InsertColumn(4, _("Started"));
+        lists[i]->InsertColumn(5, _("Duration"), wxLIST_FORMAT_RIGHT);
+        lists[i]->InsertColumn(6, _("Amount"), wxLIST_FORMAT_RIGHT);
+        lists[i]->InsertColumn(7, _("Throughput"), wxLIST_FORMAT_RIGHT);
+        lists[i]->InsertColumn(8, _("Message"));
+    }
+    notebook_jobs->AddPage(listctrl_jobs, _("Jobs"));
+    notebook_jobs->AddPage(listctrl_history, _("History"));
+
+    gauge_progress = new wxGauge(panel_controls, wxID_ANY, 100,
+        wxDefaultPosition, wxDefaultSize, wxGA_HORIZONTAL | wxGA_SMOOTH);
+    static_text_status = new wxStaticText(panel_controls, wxID_ANY,
+        wxEmptyString);
+    button_clear = new wxButton(panel_controls, ID_button_clear,
+        _("C&lear Completed"));
+    button_cancel = new wxButton(panel_controls, ID_button_cancel,
+        _("&Cancel Jobs"));
+}
+
+void MaintenanceFrame::layoutControls()
+{
+    wxBoxSizer* sizerJobs = new wxBoxSizer(wxVERTICAL);
+    sizerJobs->Add(checkbox_sweep);
+    sizerJobs->AddSpacer(styleguide().getCheckboxSpacing());
+    sizerJobs->Add(checkbox_validate);
+    sizerJobs->AddSpacer(styleguide().getCheckboxSpacing());
+    sizerJobs->Add(checkbox_statistics);
+    sizerJobs->AddSpacer(styleguide().getCheckboxSpacing());
+    sizerJobs->Add(checkbox_backup);
+    sizerJobs->AddSpacer(styleguide().getRelatedControlMargin(wxVERTICAL));
+
+    wxBoxSizer* sizerBackupDir = new wxBoxSizer(wxHORIZONTAL);
+    sizerBackupDir->Add(label_backupdir, 0, wxALIGN_CENTER_VERTICAL);
+    sizerBackupDir->AddSpacer(styleguide().getControlLabelMargin());
+    sizerBackupDir->Add(text_ctrl_backupdir, 1, wxALIGN_CENTER_VERTICAL);
+    sizerBackupDir->AddSpacer(styleguide().getBrowseButtonMargin());
+    sizerBackupDir->Add(button_browse, 0, wxALIGN_CENTER_VERTICAL);
+    sizerJobs->Add(sizerBackupDir, 0, wxEXPAND);
+    sizerJobs->AddSpacer(styleguide().getUnrelatedControlMargin(wxVERTICAL));
+
+    wxBoxSizer* sizerQueue = new wxBoxSizer(wxHORIZONTAL);
+    sizerQueue->Add(label_concurrency, 0, wxALIGN_CENTER_VERTICAL);
+    sizerQueue->AddSpacer(styleguide().getControlLabelMargin());
+    sizerQueue->Add(spinctrl_concurrency, 0, wxALIGN_CENTER_VERTICAL);
+    sizerQueue->AddStretchSpacer(1);
+    sizerQueue->Add(button_queue);
+    sizerJobs->AddStretchSpacer(1);
+    sizerJobs->Add(sizerQueue, 0, wxEXPAND);
+
+    wxBoxSizer* sizerTop = new wxBoxSizer(wxHORIZONTAL);
+    sizerTop->Add(checklist_databases, 1, wxEXPAND);
+    sizerTop->AddSpacer(styleguide().getUnrelatedControlMargin(wxHORIZONTAL));
+    sizerTop->Add(sizerJobs, 1, wxEXPAND);
+
+    wxBoxSizer* sizerButtons = new wxBoxSizer(wxHORIZONTAL);
+    sizerButtons->Add(gauge_progress, 1, wxALIGN_CENTER_VERTICAL);
+    sizerButtons->AddSpacer(styleguide().getUnrelatedControlMargin(wxHORIZONTAL));
+    sizerButtons->Add(static_text_status, 0, wxALIGN_CENTER_VERTICAL);
+    sizerButtons->AddSpacer(styleguide().getUnrelatedControlMargin(wxHORIZONTAL));
+    sizerButtons->Add(button_clear);
+    sizerButtons->AddSpacer(styleguide().getBetweenButtonsMargin(wxHORIZONTAL));
+    sizerButtons->Add(button_cancel);
+
+    wxBoxSizer* sizerPanelV = new wxBoxSizer(wxVERTICAL);
+    sizerPanelV->AddSpacer(styleguide().getFrameMargin(wxTOP));
+    sizerPanelV->Add(sizerTop, 2, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getUnrelatedControlMargin(wxVERTICAL));
+    sizerPanelV->Add(notebook_jobs, 3, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getRelatedControlMargin(wxVERTICAL));
+    sizerPanelV->Add(sizerButtons, 0, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getFrameMargin(wxBOTTOM));
+
+    wxBoxSizer* sizerPanelH = new wxBoxSizer(wxHORIZONTAL);
+    sizerPanelH->AddSpacer(styleguide().getFrameMargin(wxLEFT));
+    sizerPanelH->Add(sizerPanelV, 1, wxEXPAND);
+    sizerPanelH->AddSpacer(styleguide().getFrameMargin(wxRIGHT));
+
+    wxBoxSizer* sizerAll = new wxBoxSizer(wxHORIZONTAL);
+    sizerAll->Add(sizerPanelH, 1, wxEXPAND);
+
+    panel_controls->SetSizer(sizerAll);
+    sizerAll->Fit(this);
+    sizerAll->SetSizeHints(this);
+}
+
+void MaintenanceFrame::updateControls()
+{
+    bool backup = checkbox_backup->IsChecked();
+    label_backupdir->Enable(backup);
+    text_ctrl_backupdir->Enable(backup);
+    button_browse->Enable(backup);
+    button_queue->Enable(checkbox_sweep->IsChecked()
+        || checkbox_validate->IsChecked()
+        || checkbox_statistics->IsChecked() || backup);
+    button_cancel->Enable(isRunning()
+        || queueM.getCount(mjsQueued) > 0);
+    button_clear->Enable(queueM.getJobs().size()
+        > queueM.getCount(mjsQueued) + queueM.getCount(mjsRunning));
+
+    size_t total = queueM.getJobs().size();
+    size_t queued = queueM.getCount(mjsQueued);
+    size_t running = queueM.getCount(mjsRunning);
+    gauge_progress->SetValue(total == 0 ? 0
+        : int(100 * (total - queued - running) / total));
+    static_text_status->SetLabel(wxString::Format(
+        _("%d running, %d queued, %d failed"), int(running), int(queued),
+        int(queueM.getCount(mjsFailed))));
+    panel_controls->Layout();
+}
+
+void MaintenanceFrame::loadDatabases()
+{
+    databasesM.clear();
+    checklist_databases->Clear();
+    ServerPtrs servers(rootM->getServers());
+    for (ServerPtrs::iterator its = servers.begin(); its != servers.end();
+        ++its)
+    {
+        DatabasePtrs databases((*its)->getDatabases());
+        for (DatabasePtrs::iterator itd = databases.begin();
+            itd != databases.end(); ++itd)
+        {
+            databasesM.push_back(*itd);
+            checklist_databases->Append(wxString::Format("%s: %s",
+                (*its)->getName_().c_str(), (*itd)->getName_().c_str()));
+        }
+    }
+}
+
+void MaintenanceFrame::loadHistory()
+{
+    MaintenanceHistory::load(wx2std(historyFileNameM), historyM, 1000);
+    showHistory();
+}
+
+bool MaintenanceFrame::queueJobs(DatabasePtr database,
+    const std::vector<MaintenanceJobKind>& kinds)
+{
+    ServerPtr server = database->getServer();
+    if (!server)
+        return false;
+
+    MaintenanceTarget target;
+    if (!getConnectionCredentials(this, database, target.username,
+        target.password))
+    {
+        return false;
+    }
+    target.server = server->getConnectionString();
+    target.path = database->getPath();
+    target.role = database->getRole();
+    target.charset = database->getConnectionCharset();
+
+    MaintenanceJob job;
+    job.server = wx2std(target.server);
+    job.database = wx2std(database->getName_());
+    for (std::vector<MaintenanceJobKind>::const_iterator it = kinds.begin();
+        it != kinds.end(); ++it)
+    {
+        job.kind = *it;
+        target.backupFile.clear();
+        if (job.kind == mjBackup)
+        {
+            wxFileName fn(text_ctrl_backupdir->GetValue(),
+                wxString::Format("%s-%s.fbk.gz",
+                    database->getName_().c_str(),
+                    wxDateTime::Now().Format("%Y%m%d-%H%M%S").c_str()));
+            target.backupFile = fn.GetFullPath();
+        }
+        targetsM[queueM.add(job)] = target;
+    }
+    return true;
+}
+
+void MaintenanceFrame::startJobs()
+{
+    wxString started(wxDateTime::Now().Format("%Y-%m-%d %H:%M:%S"));
+    std::vector<int> ids(queueM.startJobs(
+        ::wxGetLocalTimeMillis().GetValue(), wx2std(started)));
+    for (std::vector<int>::const_iterator it = ids.begin(); it != ids.end();
+        ++it)
+    {
+        const MaintenanceJob* job = queueM.findJob(*it);
+        MaintenanceJobThread* thread = new MaintenanceJobThread(this, *it,
+            job->kind, targetsM[*it]);
+        if (thread->Create() != wxTHREAD_NO_ERROR
+            || thread->Run() != wxTHREAD_NO_ERROR)
+        {
+            delete thread;
+            queueM.finishJob(*it, mjsFailed, 0,
+                wx2std(_("Error starting thread!")),
+                ::wxGetLocalTimeMillis().GetValue());
+            continue;
+        }
+        threadsM[*it] = thread;
+    }
+    if (!threadsM.empty() && !timerM.IsRunning())
+        timerM.Start(1000);
+}
+
+void MaintenanceFrame::jobFinished(int id)
+{
+    std::map<int, MaintenanceJobThread*>::iterator it = threadsM.find(id);
+    if (it == threadsM.end())
+        return;
+    MaintenanceJobThread* thread = it->second;
+    thread->Wait();
+    threadsM.erase(it);
+
+    MaintenanceJobState state = mjsFinished;
+    if (!thread->successM)
+        state = thread->isCanceled() ? mjsCanceled : mjsFailed;
+    queueM.finishJob(id, state, thread->amountM,
+        wx2std(thread->messageM), ::wxGetLocalTimeMillis().GetValue());
+    delete thread;
+    targetsM.erase(id);
+
+    if (const MaintenanceJob* job = queueM.findJob(id))
+    {
+        MaintenanceHistory::append(wx2std(historyFileNameM), *job);
+        historyM.insert(historyM.begin(), *job);
+        showHistory();
+    }
+    startJobs();
+    if (threadsM.empty())
+        timerM.Stop();
+}
+
+bool MaintenanceFrame::isRunning() const
+{
+    return !threadsM.empty();
+}
+
+bool MaintenanceFrame::hasUninterruptibleJobs() const
+{
+    for (std::map<int, MaintenanceJobThread*>::const_iterator it =
+        threadsM.begin(); it != threadsM.end(); ++it)
+    {
+        MaintenanceJobKind kind = it->second->getKind();
+        if (kind == mjSweep || kind == mjValidate)
+            return true;
+    }
+    return false;
+}
+
+void MaintenanceFrame::cancelJobs()
+{
+    queueM.cancelQueued();
+    for (std::map<int, MaintenanceJobThread*>::iterator it =
+        threadsM.begin(); it != threadsM.end(); ++it)
+    {
+        it->second->cancel();
+    }
+}
+
+void MaintenanceFrame::joinThreads()
+{
+    for (std::map<int, MaintenanceJobThread*>::iterator it =
+        threadsM.begin(); it != threadsM.end(); ++it)
+    {
+        it->second->Wait();
+        delete it->second;
+    }
+    threadsM.clear();
+}
+
+wxString MaintenanceFrame::getAmountText(const MaintenanceJob& job) const
+{
+    if (job.amount <= 0)
+        return wxEmptyString;
+    if (job.kind == mjBackup)
+        return wxFileName::GetHumanReadableSize(wxULongLong(job.amount));
+    return wxString::Format("%" wxLongLongFmtSpec "d %s",
+        wxLongLong_t(job.amount),
+        wxGetTranslation(MaintenanceJob::getAmountUnit(job.kind)).c_str());
+}
+
+void MaintenanceFrame::setJobItem(wxListCtrl* list, long item,
+    const MaintenanceJob& job)
+{
+    list->SetItem(item, 1, wxString(job.server.c_str(), *wxConvCurrent));
+    list->SetItem(item, 2,
+        wxGetTranslation(MaintenanceJob::getKindName(job.kind)));
+    list->SetItem(item, 3,
+        wxGetTranslation(MaintenanceJob::getStateName(job.state)));
+    list->SetItem(item, 4, wxString(job.started.c_str(), *wxConvCurrent));
+
+    int64_t millis = job.durationMillis;
+    if (job.state == mjsRunning)
+        millis = ::wxGetLocalTimeMillis().GetValue() - job.startMillis;
+    wxString duration;
+    if (job.state != mjsQueued && job.state != mjsCanceled)
+        duration = wxTimeSpan::Milliseconds(millis).Format("%H:%M:%S");
+    list->SetItem(item, 5, duration);
+    list->SetItem(item, 6, getAmountText(job));
+
+    wxString throughput;
+    double perSecond = job.getThroughput();
+    if (perSecond > 0)
+    {
+        if (job.kind == mjBackup)
+        {
+            throughput = wxFileName::GetHumanReadableSize(
+                wxULongLong(wxULongLong_t(perSecond))) + "/s";
+        }
+        else
+            throughput = wxString::Format("%.1f/s", perSecond);
+    }
+    list->SetItem(item, 7, throughput);
+    list->SetItem(item, 8, wxString(job.message.c_str(), *wxConvCurrent));
+
+    if (job.state == mjsFailed)
+        list->SetItemTextColour(item, *wxRED);
+    else if (job.state == mjsRunning)
+        list->SetItemTextColour(item, *wxBLUE);
+    else
+        list->SetItemTextColour(item, list->GetTextColour());
+}
+
+void MaintenanceFrame::showJobs()
+{
+    const std::vector<MaintenanceJob>& jobs = queueM.getJobs();
+    listctrl_jobs->Freeze();
+    if (listctrl_jobs->GetItemCount() != long(jobs.size()))
+    {
+        listctrl_jobs->DeleteAllItems();
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            listctrl_jobs->InsertItem(long(i),
+                wxString(jobs[i].database.c_str(), *wxConvCurrent));
+        }
+    }
+    for (size_t i = 0; i < jobs.size(); ++i)
+        setJobItem(listctrl_jobs, long(i), jobs[i]);
+    listctrl_jobs->Thaw();
+    updateControls();
+}
+
+void MaintenanceFrame::showHistory()
+{
+    listctrl_history->Freeze();
+    listctrl_history->DeleteAllItems();
+    for (size_t i = 0; i < historyM.size(); ++i)
+    {
+        long item = listctrl_history->InsertItem(long(i),
+            wxString(historyM[i].database.c_str(), *wxConvCurrent));
+        setJobItem(listctrl_history, item, historyM[i]);
+    }
+    if (!historyM.empty())
+    {
+        for (int col = 0; col < 9; ++col)
+            listctrl_history->SetColumnWidth(col, wxLIST_AUTOSIZE_USEHEADER);
+    }
+    listctrl_history->Thaw();
+}
+
+void MaintenanceFrame::doReadConfigSettings(const wxString& prefix)
+{
+    BaseFrame::doReadConfigSettings(prefix);
+    int concurrency = 2;
+    config().getValue(prefix + Config::pathSeparator + "jobsPerServer",
+        concurrency);
+    spinctrl_concurrency->SetValue(concurrency);
+    queueM.setMaxPerServer(spinctrl_concurrency->GetValue());
+
+    wxString dir;
+    config().getValue(prefix + Config::pathSeparator + "backupDirectory",
+        dir);
+    text_ctrl_backupdir->SetValue(dir);
+}
+
+void MaintenanceFrame::doWriteConfigSettings(const wxString& prefix) const
+{
+    BaseFrame::doWriteConfigSettings(prefix);
+    config().setValue(prefix + Config::pathSeparator + "jobsPerServer",
+        spinctrl_concurrency->GetValue());
+    config().setValue(prefix + Config::pathSeparator + "backupDirectory",
+        text_ctrl_backupdir->GetValue());
+}
+
+const wxString MaintenanceFrame::getName() const
+{
+    return "MaintenanceFrame";
+}
+
+/*static*/
+wxString MaintenanceFrame::getFrameId()
+{
+    return "MaintenanceFrame";
+}
+
+/*static*/
+MaintenanceFrame* MaintenanceFrame::findFrame()
+{
+    BaseFrame* bf = frameFromIdString(getFrameId());
+    if (!bf)
+        return 0;
+    return dynamic_cast<MaintenanceFrame*>(bf);
+}
+
+BEGIN_EVENT_TABLE(MaintenanceFrame, BaseFrame)
+    EVT_BUTTON(MaintenanceFrame::ID_button_browse, MaintenanceFrame::OnBrowseButtonClick)
+    EVT_BUTTON(MaintenanceFrame::ID_button_queue, MaintenanceFrame::OnQueueButtonClick)
+    EVT_BUTTON(MaintenanceFrame::ID_button_clear, MaintenanceFrame::OnClearButtonClick)
+    EVT_BUTTON(MaintenanceFrame::ID_button_cancel, MaintenanceFrame::OnCancelButtonClick)
+    EVT_CHECKBOX(wxID_ANY, MaintenanceFrame::OnCheckboxClick)
+    EVT_SPINCTRL(MaintenanceFrame::ID_spinctrl_concurrency, MaintenanceFrame::OnConcurrencyChange)
+    EVT_MENU(MaintenanceFrame::ID_job_finished, MaintenanceFrame::OnJobFinished)
+    EVT_TIMER(MaintenanceFrame::ID_timer, MaintenanceFrame::OnTimer)
+END_EVENT_TABLE()
+
+void MaintenanceFrame::OnBrowseButtonClick(wxCommandEvent& WXUNUSED(event))
+{
+    wxString dir = ::wxDirSelector(_("Select Backup Directory"),
+        text_ctrl_backupdir->GetValue(), wxDD_DEFAULT_STYLE, wxDefaultPosition,
+        this);
+    if (!dir.empty())
+        text_ctrl_backupdir->SetValue(dir);
+}
+
+void MaintenanceFrame::OnQueueButtonClick(wxCommandEvent& WXUNUSED(event))
+{
+    std::vector<MaintenanceJobKind> kinds;
+    if (checkbox_sweep->IsChecked())
+        kinds.push_back(mjSweep);
+    if (checkbox_validate->IsChecked())
+        kinds.push_back(mjValidate);
+    if (checkbox_statistics->IsChecked())
+        kinds.push_back(mjIndexStatistics);
+    if (checkbox_backup->IsChecked())
+    {
+        if (!wxDirExists(text_ctrl_backupdir->GetValue()))
+        {
+            ::wxMessageBox(_("Please select an existing backup directory."),
+                _("Maintenance Scheduler"), wxOK | wxICON_EXCLAMATION, this);
+            return;
+        }
+        kinds.push_back(mjBackup);
+    }
+
+    wxArrayInt checked;
+    checklist_databases->GetCheckedItems(checked);
+    if (kinds.empty() || checked.IsEmpty())
+        return;
+    for (size_t i = 0; i < checked.GetCount(); ++i)
+    {
+        DatabasePtr db = databasesM[checked[i]].lock();
+        // the jobs of databases already queued are still queued, when the
+        // user cancels the credentials dialog of a later one
+        if (db && !queueJobs(db, kinds))
+            break;
+    }
+    startJobs();
+    showJobs();
+}
+
+void MaintenanceFrame::OnClearButtonClick(wxCommandEvent& WXUNUSED(event))
+{
+    queueM.clearCompleted();
+    showJobs();
+}
+
+void MaintenanceFrame::OnCancelButtonClick(wxCommandEvent& WXUNUSED(event))
+{
+    cancelJobs();
+    showJobs();
+}
+
+void MaintenanceFrame::OnCheckboxClick(wxCommandEvent& WXUNUSED(event))
+{
+    updateControls();
+}
+
+void MaintenanceFrame::OnConcurrencyChange(wxSpinEvent& WXUNUSED(event))
+{
+    queueM.setMaxPerServer(spinctrl_concurrency->GetValue());
+    startJobs();
+    showJobs();
+}
+
+void MaintenanceFrame::OnJobFinished(wxCommandEvent& event)
+{
+    jobFinished(event.GetInt());
+    showJobs();
+}
+
+void MaintenanceFrame::OnTimer(wxTimerEvent& WXUNUSED(event))
+{
+    int64_t nowMillis = ::wxGetLocalTimeMillis().GetValue();
+    for (std::map<int, MaintenanceJobThread*>::iterator it =
+        threadsM.begin(); it != threadsM.end(); ++it)
+    {
+        // the amount of sweep and validation jobs is known beforehand,
+        // they don't report any progress
+        MaintenanceJobKind kind = it->second->getKind();
+        if (kind != mjSweep && kind != mjValidate)
+        {
+            queueM.setProgress(it->first, it->second->amountM, nowMillis);
+        }
+    }
+    showJobs();
+}
@@ -0,0 +1,158 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_MAINTENANCE_FRAME_H
+#define FR_MAINTENANCE_FRAME_H
+
+#include <wx/wx.h>
+#include <wx/checklst.h>
+#include <wx/gauge.h>
+#include <wx/listctrl.h>
+#include <wx/notebook.h>
+#include <wx/panel.h>
+#include <wx/spinctrl.h>
+#include <wx/thread.h>
+#include <wx/timer.h>
+
+#include <map>
+#include <vector>
+
+#include "engine/MaintenanceScheduler.h"
+#include "gui/BaseFrame.h"
+#include "metadata/MetadataClasses.h"
+
+class MaintenanceJobThread;
+
+// everything a job needs to connect, copied when the job is queued
+struct MaintenanceTarget
+{
+    wxString server;
+    wxString path;
+    wxString username;
+    wxString password;
+    wxString role;
+    wxString charset;
+    wxString backupFile;
+};
+
+// Queues sweep, validation, index statistics and backup jobs for any
+// number of registered databases, and runs them with a limited number of
+// jobs per server at the same time. Finished jobs are appended to the
+// job history file.
+class MaintenanceFrame : public BaseFrame
+{
+private:
+    friend class MaintenanceJobThread;
+
+    RootPtr rootM;
+    // the databases in checklist_databases
+    std::vector<DatabaseWeakPtr> databasesM;
+
+    MaintenanceQueue queueM;
+    std::map<int, MaintenanceTarget> targetsM;
+    std::map<int, MaintenanceJobThread*> threadsM;
+    std::vector<MaintenanceJob> historyM;
+    wxString historyFileNameM;
+    // updates the durations and the progress of the running jobs
+    wxTimer timerM;
+
+    wxPanel* panel_controls;
+    wxCheckListBox* checklist_databases;
+    wxCheckBox* checkbox_sweep;
+    wxCheckBox* checkbox_validate;
+    wxCheckBox* checkbox_statistics;
+    wxCheckBox* checkbox_backup;
+    wxStaticText* label_backupdir;
+    wxTextCtrl* text_ctrl_backupdir;
+    wxButton* button_browse;
+    wxStaticText* label_concurrency;
+    wxSpinCtrl* spinctrl_concurrency;
+    wxButton* button_queue;
+    wxNotebook* notebook_jobs;
+    wxListCtrl* listctrl_jobs;
+    wxListCtrl* listctrl_history;
+    wxGauge* gauge_progress;
+    wxStaticText* static_text_status;
+    wxButton* button_clear;
+    wxButton* button_cancel;
+    void createControls();
+    void layoutControls();
+    void updateControls();
+
+    static wxString getFrameId();
+
+    void loadDatabases();
+    void loadHistory();
+    bool queueJobs(DatabasePtr database,
+        const std::vector<MaintenanceJobKind>& kinds);
+    void startJobs();
+    void jobFinished(int id);
+    bool isRunning() const;
+    // sweep and validation run until the server has finished them
+    bool hasUninterruptibleJobs() const;
+    void cancelJobs();
+    void joinThreads();
+
+    wxString getAmountText(const MaintenanceJob& job) const;
+    void setJobItem(wxListCtrl* list, long item, const MaintenanceJob& job);
+    void showJobs();
+    void showHistory();
+protected:
+    virtual bool doCanClose();
+    virtual void doReadConfigSettings(const wxString& prefix);
+    virtual void doWriteConfigSettings(const wxString& prefix) const;
+    virtual const wxString getName() const;
+public:
+    MaintenanceFrame(wxWindow* parent, RootPtr root);
+
+    // make sure that the job threads are stopped, closing the frame is
+    // refused while jobs run that can't be canceled
+    virtual bool Destroy();
+
+    static MaintenanceFrame* findFrame();
+private:
+    // event handling
+    enum
+    {
+        ID_button_browse = 101,
+        ID_button_queue,
+        ID_button_clear,
+        ID_button_cancel,
+        ID_spinctrl_concurrency,
+        ID_job_finished,
+        ID_timer
+    };
+
+    void OnBrowseButtonClick(wxCommandEvent& event);
+    void OnQueueButtonClick(wxCommandEvent& event);
+    void OnClearButtonClick(wxCommandEvent& event);
+    void OnCancelButtonClick(wxCommandEvent& event);
+    void OnConcurrencyChange(wxSpinEvent& event);
+    void OnJobFinished(wxCommandEvent& event);
+    void OnTimer(wxTimerEvent& event);
+    void OnCheckboxClick(wxCommandEvent& event);
+
+    DECLARE_EVENT_TABLE()
+};
+
+#endif // FR_MAINTENANCE_FRAME_H
@@ -0,0 +1,844 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+#include <map>
+
+#include "config/Config.h"
+#include "config/DatabaseConfig.h"
+#include "core/StringUtils.h"
+#include "engine/ConnectionPool.h"
+#include "gui/MonitoringFrame.h"
+#include "gui/StyleGuide.h"
+#include "metadata/database.h"
+
+// MonitoringSamplerThread class
+// Samples the MON$ tables on an attachment leased from the connection pool,
+// so that neither the user's transactions nor the GUI are blocked by the
+// monitoring queries
+class MonitoringSamplerThread: public wxThread
+{
+private:
+    MonitoringFrame* frameM;
+    IBPP::Database databaseM;
+    long intervalMillisM;
+    wxSemaphore wakeupM;
+    wxCriticalSection stopCritsectM;
+    bool stopM;
+
+    bool isStopRequested();
+    void cancelStatements();
+    MonitoringSamplePtr takeSample();
+public:
+    MonitoringSamplerThread(MonitoringFrame* frame, IBPP::Database database,
+        long intervalMillis);
+    virtual ExitCode Entry();
+
+    void wakeup();
+    void requestStop();
+    // only to be used after the thread has been waited for
+    IBPP::Database& getDatabase();
+};
+
+MonitoringSamplerThread::MonitoringSamplerThread(MonitoringFrame* frame,
+        IBPP::Database database, long intervalMillis)
+    : wxThread(wxTHREAD_JOINABLE), frameM(frame), databaseM(database),
+        intervalMillisM(intervalMillis), stopM(false)
+{
+}
+
+IBPP::Database& MonitoringSamplerThread::getDatabase()
+{
+    return databaseM;
+}
+
+void MonitoringSamplerThread::wakeup()
+{
+    wakeupM.Post();
+}
+
+void MonitoringSamplerThread::requestStop()
+{
+    {
+        wxCriticalSectionLocker locker(stopCritsectM);
+        stopM = true;
+    }
+    wakeupM.Post();
+}
+
+bool MonitoringSamplerThread::isStopRequested()
+{
+    wxCriticalSectionLocker locker(stopCritsectM);
+    return stopM;
+}
+
+wxThread::ExitCode MonitoringSamplerThread::Entry()
+{
+    wxString error;
+    try
+    {
+        databaseM->Connect();
+        while (!isStopRequested())
+        {
+            cancelStatements();
+            MonitoringSamplePtr sample(takeSample());
+            {
+                wxCriticalSectionLocker locker(frameM->samplesCritsectM);
+                frameM->samplesM.push(sample);
+            }
+            wxCommandEvent event(wxEVT_COMMAND_MENU_SELECTED,
+                MonitoringFrame::ID_sample_taken);
+            wxPostEvent(frameM, event);
+
+            wakeupM.WaitTimeout(intervalMillisM);
+        }
+    }
+    catch (IBPP::Exception& e)
+    {
+        error = e.what();
+    }
+    catch (...)
+    {
+        error = _("Unexpected error while sampling the monitoring tables");
+    }
+
+    // the attachment is returned to the pool by the frame
+    if (!error.empty() && !isStopRequested())
+    {
+        {
+            wxCriticalSectionLocker locker(frameM->samplesCritsectM);
+            frameM->samplerErrorM = error;
+        }
+        wxCommandEvent event(wxEVT_COMMAND_MENU_SELECTED,
+            MonitoringFrame::ID_sample_taken);
+        wxPostEvent(frameM, event);
+    }
+    return 0;
+}
+
+// deleting from MON$STATEMENTS cancels the running statement
+void MonitoringSamplerThread::cancelStatements()
+{
+    std::vector<int64_t> ids;
+    {
+        wxCriticalSectionLocker locker(frameM->samplesCritsectM);
+        ids.swap(frameM->pendingCancelsM);
+    }
+    if (ids.empty())
+        return;
+
+    IBPP::Transaction tr = IBPP::TransactionFactory(databaseM,
+        IBPP::amWrite, IBPP::ilReadCommitted, IBPP::lrNoWait);
+    tr->Start();
+    IBPP::Statement st = IBPP::StatementFactory(databaseM, tr);
+    st->Prepare(
+        "delete from mon$statements where mon$statement_id = ?");
+    for (std::vector<int64_t>::const_iterator it = ids.begin();
+        it != ids.end(); ++it)
+    {
+        st->Set(1, *it);
+        st->Execute();
+    }
+    tr->Commit();
+}
+
+static void readCounters(IBPP::Statement& st, int col,
+    MonitoringCounters& counters)
+{
+    st->Get(col, counters.pageReads);
+    st->Get(col + 1, counters.pageWrites);
+    st->Get(col + 2, counters.pageFetches);
+    st->Get(col + 3, counters.seqReads);
+    st->Get(col + 4, counters.idxReads);
+    st->Get(col + 5, counters.inserts);
+    st->Get(col + 6, counters.updates);
+    st->Get(col + 7, counters.deletes);
+}
+
+// all MON$ tables are read in one snapshot transaction, the server
+// builds a consistent copy of the monitoring data for it
+MonitoringSamplePtr MonitoringSamplerThread::takeSample()
+{
+    static const char* countersColumns =
+        " io.mon$page_reads, io.mon$page_writes, io.mon$page_fetches,"
+        " r.mon$record_seq_reads, r.mon$record_idx_reads,"
+        " r.mon$record_inserts, r.mon$record_updates, r.mon$record_deletes";
+
+    std::shared_ptr<MonitoringSample> sample(new MonitoringSample);
+    sample->time = wxDateTime::UNow();
+
+    IBPP::Transaction tr = IBPP::TransactionFactory(databaseM,
+        IBPP::amRead, IBPP::ilConcurrency);
+    tr->Start();
+    IBPP::Statement st = IBPP::StatementFactory(databaseM, tr);
+
+    st->Execute(
+        "select d.mon$oldest_transaction, d.mon$oldest_active,"
+        " d.mon$oldest_snapshot, d.mon$next_transaction,"
+        " (select count(*) from mon$transactions t where t.mon$state = 1),"
+        " (select t.mon$attachment_id from mon$transactions t"
+        "   where t.mon$transaction_id = d.mon$oldest_active)"
+        " from mon$database d");
+    sample->oldestTransaction = 0;
+    sample->oldestActive = 0;
+    sample->oldestSnapshot = 0;
+    sample->nextTransaction = 0;
+    sample->activeTransactions = 0;
+    sample->oldestActiveAttachment = 0;
+    if (st->Fetch())
+    {
+        st->Get(1, sample->oldestTransaction);
+        st->Get(2, sample->oldestActive);
+        st->Get(3, sample->oldestSnapshot);
+        st->Get(4, sample->nextTransaction);
+        st->Get(5, sample->activeTransactions);
+        if (st->Get(6, sample->oldestActiveAttachment))
+            sample->oldestActiveAttachment = 0;
+    }
+
+    st->Execute(std::string(
+        "select a.mon$attachment_id, a.mon$state, a.mon$user,"
+        " a.mon$remote_address, a.mon$remote_process,")
+        + countersColumns +
+        " from mon$attachments a"
+        " join mon$io_stats io on io.mon$stat_id = a.mon$stat_id"
+        " join mon$record_stats r on r.mon$stat_id = a.mon$stat_id"
+        " where a.mon$attachment_id <> current_connection"
+        " order by a.mon$attachment_id");
+    while (st->Fetch())
+    {
+        MonitoredAttachment att;
+        st->Get(1, att.id);
+        st->Get(2, att.state);
+        st->Get(3, att.user);
+        st->Get(4, att.remoteAddress);
+        st->Get(5, att.remoteProcess);
+        readCounters(st, 6, att.counters);
+        sample->attachments.push_back(att);
+    }
+
+    // only statements executing right now are of interest, idle ones
+    // would make every sample carry all prepared statements' SQL text
+    st->Execute(std::string(
+        "select s.mon$statement_id, s.mon$attachment_id,"
+        " s.mon$transaction_id, s.mon$state,"
+        " datediff(second from s.mon$timestamp to current_timestamp),"
+        " s.mon$sql_text,")
+        + countersColumns +
+        " from mon$statements s"
+        " join mon$io_stats io on io.mon$stat_id = s.mon$stat_id"
+        " join mon$record_stats r on r.mon$stat_id = s.mon$stat_id"
+        " where s.mon$attachment_id <> current_connection"
+        " and s.mon$state <> 0");
+    while (st->Fetch())
+    {
+        MonitoredStatement stmt;
+        st->Get(1, stmt.id);
+        st->Get(2, stmt.attachmentId);
+        if (st->Get(3, stmt.transactionId))
+            stmt.transactionId = 0;
+        st->Get(4, stmt.state);
+        if (st->Get(5, stmt.elapsedSeconds))
+            stmt.elapsedSeconds = 0;
+        st->Get(6, stmt.sql);
+        readCounters(st, 7, stmt.counters);
+        sample->statements.push_back(stmt);
+    }
+    tr->Commit();
+
+    sample->durationMillis =
+        (wxDateTime::UNow() - sample->time).GetMilliseconds().ToLong();
+    return sample;
+}
+
+// MonitoringFrame class
+MonitoringFrame::MonitoringFrame(wxWindow* parent, DatabasePtr db)
+    : BaseFrame(parent, -1, wxEmptyString), databaseM(db), samplerM(0),
+        samplesM(1)
+{
+    wxASSERT(db);
+
+    DatabaseConfig dc(db.get(), config());
+    sampleIntervalM = std::max(1, dc.get("MonitoringSampleInterval", 5));
+    topStatementsM = std::max(1, dc.get("MonitoringTopStatements", 20));
+    samplesM = RingBuffer<MonitoringSamplePtr>(
+        std::max(2, dc.get("MonitoringHistorySize", 120)));
+
+    setIdString(this, getFrameId(db));
+    // observe database object to close on disconnect / destruction
+    db->attachObserver(this, false);
+    SetTitle(wxString::Format(_("Monitoring Database: %s"),
+        db->getName_().c_str()));
+
+    createControls();
+    layoutControls();
+    updateControls();
+
+    button_monitor->SetFocus();
+
+    #include "new.xpm"
+    wxBitmap bmp(new_xpm);
+    wxIcon icon;
+    icon.CopyFromBitmap(bmp);
+    SetIcon(icon);
+
+    startMonitoring();
+    updateMonitoringActive();
+}
+
+bool MonitoringFrame::Destroy()
+{
+    stopMonitoring();
+    return BaseFrame::Destroy();
+}
+
+void MonitoringFrame::createControls()
+{
+    panel_controls = new wxPanel(this, -1, wxDefaultPosition, wxDefaultSize,
+        wxTAB_TRAVERSAL | wxCLIP_CHILDREN);
+    notebook_views = new wxNotebook(panel_controls, ID_notebook_views);
+
+    listctrl_attachments = new wxListCtrl(notebook_views,
+        ID_listctrl_attachments, wxDefaultPosition, wxDefaultSize,
+        wxLC_REPORT | wxLC_SINGLE_SEL);
+    listctrl_attachments->InsertColumn(0, _("Id"), wxLIST_FORMAT_RIGHT);
+    listctrl_attachments->InsertColumn(1, _("User"));
+    listctrl_attachments->InsertColumn(2, _("Address"));
+    listctrl_attachments->InsertColumn(3, _("Process"));
+    listctrl_attachments->InsertColumn(4, _("State"));
+    listctrl_attachments->InsertColumn(5, _("Fetches/sec"), wxLIST_FORMAT_RIGHT);
+    listctrl_attachments->InsertColumn(6, _("Reads/sec"), wxLIST_FORMAT_RIGHT);
+    listctrl_attachments->InsertColumn(7, _("Writes/sec"), wxLIST_FORMAT_RIGHT);
+    listctrl_attachments->InsertColumn(8, _("Natural/sec"), wxLIST_FORMAT_RIGHT);
+    listctrl_attachments->InsertColumn(9, _("Indexed/sec"), wxLIST_FORMAT_RIGHT);
+    listctrl_attachments->InsertColumn(10, _("Changes/sec"), wxLIST_FORMAT_RIGHT);
+    listctrl_attachments->InsertColumn(11, _("Fetches"), wxLIST_FORMAT_RIGHT);
+    notebook_views->AddPage(listctrl_attachments, _("Attachments"));
+
+    listctrl_statements = new wxListCtrl(notebook_views,
+        ID_listctrl_statements, wxDefaultPosition, wxDefaultSize,
+        wxLC_REPORT);
+    listctrl_statements->InsertColumn(0, _("Id"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(1, _("Attachment"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(2, _("Transaction"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(3, _("Running (s)"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(4, _("Fetches/sec"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(5, _("Reads/sec"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(6, _("Natural/sec"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(7, _("Indexed/sec"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(8, _("SQL"));
+    notebook_views->AddPage(listctrl_statements, _("Hot Statements"));
+
+    listctrl_transactions = new wxListCtrl(notebook_views,
+        ID_listctrl_transactions, wxDefaultPosition, wxDefaultSize,
+        wxLC_REPORT | wxLC_SINGLE_SEL);
+    listctrl_transactions->InsertColumn(0, _("Time"));
+    listctrl_transactions->InsertColumn(1, _("OIT"), wxLIST_FORMAT_RIGHT);
+    listctrl_transactions->InsertColumn(2, _("OAT"), wxLIST_FORMAT_RIGHT);
+    listctrl_transactions->InsertColumn(3, _("OST"), wxLIST_FORMAT_RIGHT);
+    listctrl_transactions->InsertColumn(4, _("Next"), wxLIST_FORMAT_RIGHT);
+    listctrl_transactions->InsertColumn(5, _("Next - OAT"), wxLIST_FORMAT_RIGHT);
+    listctrl_transactions->InsertColumn(6, _("Growth"), wxLIST_FORMAT_RIGHT);
+    listctrl_transactions->InsertColumn(7, _("Active"), wxLIST_FORMAT_RIGHT);
+    listctrl_transactions->InsertColumn(8, _("OAT attachment"),
+        wxLIST_FORMAT_RIGHT);
+    notebook_views->AddPage(listctrl_transactions, _("Transaction Gap"));
+
+    static_text_status = new wxStaticText(panel_controls, wxID_ANY,
+        wxEmptyString);
+    button_cancel_statement = new wxButton(panel_controls,
+        ID_button_cancel_statement, _("&Cancel Statement"));
+    button_monitor = new wxButton(panel_controls, ID_button_monitor,
+        _("Start &Monitoring"));
+}
+
+void MonitoringFrame::layoutControls()
+{
+    wxBoxSizer* sizerButtons = new wxBoxSizer(wxHORIZONTAL);
+    sizerButtons->Add(static_text_status, 0, wxALIGN_CENTER_VERTICAL);
+    sizerButtons->Add(styleguide().getUnrelatedControlMargin(wxHORIZONTAL), 0,
+        1, wxEXPAND);
+    sizerButtons->Add(button_cancel_statement);
+    sizerButtons->AddSpacer(styleguide().getUnrelatedControlMargin(wxHORIZONTAL));
+    sizerButtons->Add(button_monitor);
+
+    wxBoxSizer* sizerPanelV = new wxBoxSizer(wxVERTICAL);
+    sizerPanelV->AddSpacer(styleguide().getFrameMargin(wxTOP));
+    sizerPanelV->Add(notebook_views, 1, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getUnrelatedControlMargin(wxVERTICAL));
+    sizerPanelV->Add(sizerButtons, 0, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getFrameMargin(wxBOTTOM));
+
+    wxBoxSizer* sizerPanelH = new wxBoxSizer(wxHORIZONTAL);
+    sizerPanelH->AddSpacer(styleguide().getFrameMargin(wxLEFT));
+    sizerPanelH->Add(sizerPanelV, 1, wxEXPAND);
+    sizerPanelH->AddSpacer(styleguide().getFrameMargin(wxRIGHT));
+
+    wxBoxSizer* sizerAll = new wxBoxSizer(wxHORIZONTAL);
+    sizerAll->Add(sizerPanelH, 1, wxEXPAND);
+
+    panel_controls->SetSizer(sizerAll);
+    sizerAll->Fit(this);
+    sizerAll->SetSizeHints(this);
+}
+
+void MonitoringFrame::updateControls()
+{
+    bool statementsShown = notebook_views->GetSelection() == 1;
+    button_cancel_statement->Enable(isMonitoring() && statementsShown
+        && listctrl_statements->GetSelectedItemCount() > 0);
+}
+
+DatabasePtr MonitoringFrame::getDatabase() const
+{
+    return databaseM.lock();
+}
+
+bool MonitoringFrame::isMonitoring() const
+{
+    return samplerM != 0;
+}
+
+void MonitoringFrame::startMonitoring()
+{
+    DatabasePtr database = getDatabase();
+    if (!database)
+    {
+        Close();
+        return;
+    }
+
+    // leased from the connection pool, or a dedicated attachment with the
+    // parameters of the existing one when the pool is exhausted
+    ConnectionPool& pool = database->getConnectionPool();
+    IBPP::Database monitorDb = pool.acquireOrCreate(
+        database->getIBPPDatabase());
+
+    {
+        wxCriticalSectionLocker locker(samplesCritsectM);
+        samplesM.clear();
+        samplerErrorM.clear();
+        pendingCancelsM.clear();
+    }
+    MonitoringSamplerThread* sampler = new MonitoringSamplerThread(this,
+        monitorDb, 1000L * sampleIntervalM);
+    monitorDb.clear();
+    if (sampler->Create() != wxTHREAD_NO_ERROR
+        || sampler->Run() != wxTHREAD_NO_ERROR)
+    {
+        pool.release(sampler->getDatabase());
+        delete sampler;
+        wxMessageBox(_("Can not start monitoring thread"), _("Error"),
+            wxOK | wxICON_ERROR);
+        return;
+    }
+    samplerM = sampler;
+}
+
+void MonitoringFrame::stopMonitoring()
+{
+    if (samplerM)
+    {
+        samplerM->requestStop();
+        samplerM->Wait();
+        DatabasePtr database = getDatabase();
+        if (database)
+            database->getConnectionPool().release(samplerM->getDatabase());
+        else
+            ConnectionPool::discard(samplerM->getDatabase());
+        delete samplerM;
+        samplerM = 0;
+    }
+}
+
+void MonitoringFrame::updateMonitoringActive()
+{
+    if (isMonitoring())
+        button_monitor->SetLabel(_("Stop &Monitoring"));
+    else
+        button_monitor->SetLabel(_("Start &Monitoring"));
+    updateControls();
+}
+
+wxString MonitoringFrame::toWx(const std::string& s) const
+{
+    DatabasePtr db = getDatabase();
+    if (db && db->getCharsetConverter())
+        return wxString(s.c_str(), *db->getCharsetConverter());
+    return wxString(s.c_str(), *wxConvCurrent);
+}
+
+static wxString formatRate(int64_t current, int64_t previous, double seconds)
+{
+    if (seconds <= 0 || current < previous)
+        return wxEmptyString;
+    return wxString::Format("%.1f", (current - previous) / seconds);
+}
+
+static wxString formatInt64(int64_t value)
+{
+    return wxString::Format("%" wxLongLongFmtSpec "d", (wxLongLong_t)value);
+}
+
+void MonitoringFrame::showAttachments(const MonitoringSample& sample,
+    const MonitoringSample* previous, double seconds)
+{
+    std::map<int64_t, const MonitoringCounters*> before;
+    if (previous)
+    {
+        for (size_t i = 0; i < previous->attachments.size(); i++)
+        {
+            before[previous->attachments[i].id] =
+                &previous->attachments[i].counters;
+        }
+    }
+
+    static const wxString states[] = { _("idle"), _("active") };
+    listctrl_attachments->Freeze();
+    listctrl_attachments->DeleteAllItems();
+    for (size_t i = 0; i < sample.attachments.size(); i++)
+    {
+        const MonitoredAttachment& att = sample.attachments[i];
+        long item = listctrl_attachments->InsertItem(i, formatInt64(att.id));
+        listctrl_attachments->SetItem(item, 1, toWx(att.user).Trim());
+        listctrl_attachments->SetItem(item, 2, toWx(att.remoteAddress));
+        listctrl_attachments->SetItem(item, 3, toWx(att.remoteProcess));
+        listctrl_attachments->SetItem(item, 4,
+            (att.state == 0 || att.state == 1) ? states[att.state]
+                : wxString::Format("%d", att.state));
+        listctrl_attachments->SetItem(item, 11,
+            formatInt64(att.counters.pageFetches));
+
+        std::map<int64_t, const MonitoringCounters*>::const_iterator it =
+            before.find(att.id);
+        if (it == before.end())
+            continue;
+        const MonitoringCounters& now = att.counters;
+        const MonitoringCounters& then = *(*it).second;
+        listctrl_attachments->SetItem(item, 5,
+            formatRate(now.pageFetches, then.pageFetches, seconds));
+        listctrl_attachments->SetItem(item, 6,
+            formatRate(now.pageReads, then.pageReads, seconds));
+        listctrl_attachments->SetItem(item, 7,
+            formatRate(now.pageWrites, then.pageWrites, seconds));
+        listctrl_attachments->SetItem(item, 8,
+            formatRate(now.seqReads, then.seqReads, seconds));
+        listctrl_attachments->SetItem(item, 9,
+            formatRate(now.idxReads, then.idxReads, seconds));
+        listctrl_attachments->SetItem(item, 10,
+            formatRate(now.inserts + now.updates + now.deletes,
+                then.inserts + then.updates + then.deletes, seconds));
+    }
+    listctrl_attachments->Thaw();
+}
+
+void MonitoringFrame::showStatements(const MonitoringSample& sample,
+    const MonitoringSample* previous, double seconds)
+{
+    std::map<int64_t, const MonitoringCounters*> before;
+    if (previous)
+    {
+        for (size_t i = 0; i < previous->statements.size(); i++)
+        {
+            before[previous->statements[i].id] =
+                &previous->statements[i].counters;
+        }
+    }
+
+    // statements are ranked by the page fetches since the previous
+    // sample, the ones that just started by their total
+    std::vector<std::pair<int64_t, size_t> > ranking;
+    for (size_t i = 0; i < sample.statements.size(); i++)
+    {
+        const MonitoredStatement& stmt = sample.statements[i];
+        int64_t fetches = stmt.counters.pageFetches;
+        std::map<int64_t, const MonitoringCounters*>::const_iterator it =
+            before.find(stmt.id);
+        if (it != before.end() && (*it).second->pageFetches <= fetches)
+            fetches -= (*it).second->pageFetches;
+        ranking.push_back(std::make_pair(-fetches, i));
+    }
+    size_t count = std::min(ranking.size(), topStatementsM);
+    std::partial_sort(ranking.begin(), ranking.begin() + count,
+        ranking.end());
+
+    // keep the selection while the list is refilled
+    std::vector<int64_t> selectedIds;
+    long item = -1;
+    while ((item = listctrl_statements->GetNextItem(item, wxLIST_NEXT_ALL,
+        wxLIST_STATE_SELECTED)) != -1)
+    {
+        selectedIds.push_back(statementIdsM[item]);
+    }
+
+    listctrl_statements->Freeze();
+    listctrl_statements->DeleteAllItems();
+    statementIdsM.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        const MonitoredStatement& stmt = sample.statements[ranking[i].second];
+        item = listctrl_statements->InsertItem(i, formatInt64(stmt.id));
+        statementIdsM.push_back(stmt.id);
+        listctrl_statements->SetItem(item, 1, formatInt64(stmt.attachmentId));
+        if (stmt.transactionId)
+        {
+            listctrl_statements->SetItem(item, 2,
+                formatInt64(stmt.transactionId));
+        }
+        listctrl_statements->SetItem(item, 3,
+            wxString::Format("%d", stmt.elapsedSeconds));
+
+        wxString sql(toWx(stmt.sql));
+        sql.Replace("\r", " ");
+        sql.Replace("\n", " ");
+        listctrl_statements->SetItem(item, 8, sql);
+
+        if (std::find(selectedIds.begin(), selectedIds.end(), stmt.id)
+            != selectedIds.end())
+        {
+            listctrl_statements->SetItemState(item, wxLIST_STATE_SELECTED,
+                wxLIST_STATE_SELECTED);
+        }
+
+        std::map<int64_t, const MonitoringCounters*>::const_iterator it =
+            before.find(stmt.id);
+        if (it == before.end())
+            continue;
+        const MonitoringCounters& now = stmt.counters;
+        const MonitoringCounters& then = *(*it).second;
+        listctrl_statements->SetItem(item, 4,
+            formatRate(now.pageFetches, then.pageFetches, seconds));
+        listctrl_statements->SetItem(item, 5,
+            formatRate(now.pageReads, then.pageReads, seconds));
+        listctrl_statements->SetItem(item, 6,
+            formatRate(now.seqReads, then.seqReads, seconds));
+        listctrl_statements->SetItem(item, 7,
+            formatRate(now.idxReads, then.idxReads, seconds));
+    }
+    listctrl_statements->Thaw();
+}
+
+// shows the sampled transaction counters, newest first
+void MonitoringFrame::showTransactions()
+{
+    std::vector<MonitoringSamplePtr> samples;
+    {
+        wxCriticalSectionLocker locker(samplesCritsectM);
+        for (size_t i = 0; i < samplesM.size(); i++)
+            samples.push_back(samplesM.fromBack(i));
+    }
+
+    listctrl_transactions->Freeze();
+    listctrl_transactions->DeleteAllItems();
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        const MonitoringSample& s = *samples[i];
+        long item = listctrl_transactions->InsertItem(i,
+            s.time.Format("%H:%M:%S"));
+        listctrl_transactions->SetItem(item, 1,
+            formatInt64(s.oldestTransaction));
+        listctrl_transactions->SetItem(item, 2, formatInt64(s.oldestActive));
+        listctrl_transactions->SetItem(item, 3,
+            formatInt64(s.oldestSnapshot));
+        listctrl_transactions->SetItem(item, 4,
+            formatInt64(s.nextTransaction));
+        int64_t gap = s.nextTransaction - s.oldestActive;
+        listctrl_transactions->SetItem(item, 5, formatInt64(gap));
+        if (i + 1 < samples.size())
+        {
+            const MonitoringSample& p = *samples[i + 1];
+            int64_t growth = gap - (p.nextTransaction - p.oldestActive);
+            listctrl_transactions->SetItem(item, 6, (growth > 0 ? "+" : "")
+                + formatInt64(growth));
+            // a growing gap means a transaction stays open for too long
+            if (growth > 0)
+                listctrl_transactions->SetItemTextColour(item, *wxRED);
+        }
+        listctrl_transactions->SetItem(item, 7,
+            wxString::Format("%d", s.activeTransactions));
+        if (s.oldestActiveAttachment)
+        {
+            listctrl_transactions->SetItem(item, 8,
+                formatInt64(s.oldestActiveAttachment));
+        }
+    }
+    listctrl_transactions->Thaw();
+}
+
+//! closes window if database is removed (unregistered)
+void MonitoringFrame::subjectRemoved(Subject* subject)
+{
+    DatabasePtr db = getDatabase();
+    if (!db || !db->isConnected() || subject == db.get())
+        Close();
+}
+
+void MonitoringFrame::update()
+{
+    DatabasePtr db = getDatabase();
+    if (!db || !db->isConnected())
+        Close();
+}
+
+void MonitoringFrame::doReadConfigSettings(const wxString& prefix)
+{
+    BaseFrame::doReadConfigSettings(prefix);
+    int page = 0;
+    config().getValue(prefix + Config::pathSeparator + "page", page);
+    if (page >= 0 && page < (int)notebook_views->GetPageCount())
+        notebook_views->SetSelection(page);
+    updateControls();
+}
+
+void MonitoringFrame::doWriteConfigSettings(const wxString& prefix) const
+{
+    BaseFrame::doWriteConfigSettings(prefix);
+    config().setValue(prefix + Config::pathSeparator + "page",
+        notebook_views->GetSelection());
+}
+
+const wxString MonitoringFrame::getName() const
+{
+    return "MonitoringFrame";
+}
+
+wxString MonitoringFrame::getFrameId(DatabasePtr db)
+{
+    if (db)
+        return wxString("MonitoringFrame/" + db->getItemPath());
+    else
+        return wxEmptyString;
+}
+
+MonitoringFrame* MonitoringFrame::findFrameFor(DatabasePtr db)
+{
+    BaseFrame* bf = frameFromIdString(getFrameId(db));
+    if (!bf)
+        return 0;
+    return dynamic_cast<MonitoringFrame*>(bf);
+}
+
+BEGIN_EVENT_TABLE(MonitoringFrame, wxFrame)
+    EVT_BUTTON(MonitoringFrame::ID_button_cancel_statement, MonitoringFrame::OnButtonCancelStatementClick)
+    EVT_BUTTON(MonitoringFrame::ID_button_monitor, MonitoringFrame::OnButtonStartStopClick)
+    EVT_LIST_ITEM_SELECTED(MonitoringFrame::ID_listctrl_statements, MonitoringFrame::OnListSelectionChanged)
+    EVT_LIST_ITEM_DESELECTED(MonitoringFrame::ID_listctrl_statements, MonitoringFrame::OnListSelectionChanged)
+    EVT_NOTEBOOK_PAGE_CHANGED(MonitoringFrame::ID_notebook_views, MonitoringFrame::OnPageChanged)
+    EVT_MENU(MonitoringFrame::ID_sample_taken, MonitoringFrame::OnSampleTaken)
+END_EVENT_TABLE()
+
+void MonitoringFrame::OnButtonCancelStatementClick(
+    wxCommandEvent& WXUNUSED(event))
+{
+    std::vector<int64_t> ids;
+    long item = -1;
+    while ((item = listctrl_statements->GetNextItem(item, wxLIST_NEXT_ALL,
+        wxLIST_STATE_SELECTED)) != -1)
+    {
+        ids.push_back(statementIdsM[item]);
+    }
+    if (ids.empty() || !isMonitoring())
+        return;
+
+    if (wxMessageBox(wxString::Format(
+            _("Cancel %d selected statement(s)?"), (int)ids.size()),
+        _("Confirm"), wxYES_NO | wxICON_QUESTION, this) != wxYES)
+    {
+        return;
+    }
+    {
+        wxCriticalSectionLocker locker(samplesCritsectM);
+        pendingCancelsM.insert(pendingCancelsM.end(), ids.begin(), ids.end());
+    }
+    samplerM->wakeup();
+}
+
+void MonitoringFrame::OnButtonStartStopClick(wxCommandEvent& WXUNUSED(event))
+{
+    if (isMonitoring())
+        stopMonitoring();
+    else
+        startMonitoring();
+    updateMonitoringActive();
+}
+
+void MonitoringFrame::OnSampleTaken(wxCommandEvent& WXUNUSED(event))
+{
+    MonitoringSamplePtr sample, previous;
+    wxString error;
+    {
+        wxCriticalSectionLocker locker(samplesCritsectM);
+        error.swap(samplerErrorM);
+        if (!samplesM.empty())
+            sample = samplesM.fromBack(0);
+        if (samplesM.size() > 1)
+            previous = samplesM.fromBack(1);
+    }
+
+    if (!error.empty())
+    {
+        stopMonitoring();
+        updateMonitoringActive();
+        static_text_status->SetLabel(error);
+        panel_controls->Layout();
+        return;
+    }
+    if (!sample)
+        return;
+
+    double seconds = 0;
+    if (previous)
+    {
+        seconds = (sample->time - previous->time).GetMilliseconds().ToDouble()
+            / 1000.0;
+    }
+    showAttachments(*sample, previous.get(), seconds);
+    showStatements(*sample, previous.get(), seconds);
+    showTransactions();
+
+    static_text_status->SetLabel(wxString::Format(
+        _("%d attachments, %d running statements, sampled in %ld ms"),
+        (int)sample->attachments.size(), (int)sample->statements.size(),
+        sample->durationMillis));
+    panel_controls->Layout();
+    updateControls();
+}
+
+void MonitoringFrame::OnListSelectionChanged(wxListEvent& WXUNUSED(event))
+{
+    updateControls();
+}
+
+void MonitoringFrame::OnPageChanged(wxNotebookEvent& WXUNUSED(event))
+{
+    updateControls();
+}
@@ -0,0 +1,220 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef FR_MONITORING_FRAME_H
+#define FR_MONITORING_FRAME_H
+
+#include <wx/wx.h>
+#include <wx/button.h>
+#include <wx/datetime.h>
+#include <wx/listctrl.h>
+#include <wx/notebook.h>
+#include <wx/panel.h>
+#include <wx/thread.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ibpp.h>
+
+#include "core/Observer.h"
+#include "gui/BaseFrame.h"
+#include "metadata/database.h"
+#include "metadata/MetadataClasses.h"
+
+class MonitoringSamplerThread;
+
+// fixed capacity buffer, the oldest element is overwritten when full
+template <typename T>
+class RingBuffer
+{
+private:
+    std::vector<T> itemsM;
+    size_t firstM;
+    size_t countM;
+public:
+    RingBuffer(size_t capacity)
+        : itemsM(capacity > 0 ? capacity : 1), firstM(0), countM(0) {}
+
+    size_t capacity() const { return itemsM.size(); }
+    size_t size() const { return countM; }
+    bool empty() const { return countM == 0; }
+    void clear() { firstM = 0; countM = 0; }
+
+    void push(const T& item)
+    {
+        if (countM < itemsM.size())
+            itemsM[(firstM + countM++) % itemsM.size()] = item;
+        else
+        {
+            itemsM[firstM] = item;
+            firstM = (firstM + 1) % itemsM.size();
+        }
+    }
+    // index 0 is the oldest element
+    const T& operator[](size_t index) const
+    {
+        return itemsM[(firstM + index) % itemsM.size()];
+    }
+    // index 0 is the newest element
+    const T& fromBack(size_t index) const
+    {
+        return (*this)[countM - 1 - index];
+    }
+};
+
+struct MonitoringCounters
+{
+    int64_t pageReads;
+    int64_t pageWrites;
+    int64_t pageFetches;
+    int64_t seqReads;
+    int64_t idxReads;
+    int64_t inserts;
+    int64_t updates;
+    int64_t deletes;
+};
+
+struct MonitoredAttachment
+{
+    int64_t id;
+    int state;
+    std::string user;
+    std::string remoteAddress;
+    std::string remoteProcess;
+    MonitoringCounters counters;
+};
+
+struct MonitoredStatement
+{
+    int64_t id;
+    int64_t attachmentId;
+    int64_t transactionId;
+    int state;
+    int elapsedSeconds;
+    std::string sql;
+    MonitoringCounters counters;
+};
+
+struct MonitoringSample
+{
+    wxDateTime time;
+    long durationMillis;
+    int64_t oldestTransaction;
+    int64_t oldestActive;
+    int64_t oldestSnapshot;
+    int64_t nextTransaction;
+    int activeTransactions;
+    int64_t oldestActiveAttachment;
+    std::vector<MonitoredAttachment> attachments;
+    std::vector<MonitoredStatement> statements;
+};
+
+typedef std::shared_ptr<const MonitoringSample> MonitoringSamplePtr;
+
+class MonitoringFrame : public BaseFrame, public Observer
+{
+private:
+    friend class MonitoringSamplerThread;
+
+    DatabaseWeakPtr databaseM;
+    MonitoringSamplerThread* samplerM;
+    int sampleIntervalM;
+    size_t topStatementsM;
+
+    // filled by the sampler thread, read when ID_sample_taken arrives
+    wxCriticalSection samplesCritsectM;
+    RingBuffer<MonitoringSamplePtr> samplesM;
+    wxString samplerErrorM;
+    // statements to be cancelled by the sampler thread
+    std::vector<int64_t> pendingCancelsM;
+
+    wxPanel* panel_controls;
+    wxNotebook* notebook_views;
+    wxListCtrl* listctrl_attachments;
+    wxListCtrl* listctrl_statements;
+    wxListCtrl* listctrl_transactions;
+    wxStaticText* static_text_status;
+    // ids of the statements shown, in list order
+    std::vector<int64_t> statementIdsM;
+    wxButton* button_cancel_statement;
+    wxButton* button_monitor;
+    void createControls();
+    void layoutControls();
+    void updateControls();
+
+    static wxString getFrameId(DatabasePtr db);
+
+    DatabasePtr getDatabase() const;
+    bool isMonitoring() const;
+    void startMonitoring();
+    void stopMonitoring();
+    void updateMonitoringActive();
+
+    void showAttachments(const MonitoringSample& sample,
+        const MonitoringSample* previous, double seconds);
+    void showStatements(const MonitoringSample& sample,
+        const MonitoringSample* previous, double seconds);
+    void showTransactions();
+    wxString toWx(const std::string& s) const;
+
+    // observer stuff
+    virtual void subjectRemoved(Subject* subject);
+    virtual void update();
+
+protected:
+    virtual void doReadConfigSettings(const wxString& prefix);
+    virtual void doWriteConfigSettings(const wxString& prefix) const;
+    virtual const wxString getName() const;
+public:
+    MonitoringFrame(wxWindow* parent, DatabasePtr db);
+
+    // make sure that the sampler thread gets stopped
+    virtual bool Destroy();
+
+    static MonitoringFrame* findFrameFor(DatabasePtr db);
+private:
+    // event handling
+    enum
+    {
+        ID_notebook_views = 101,
+        ID_listctrl_attachments,
+        ID_listctrl_statements,
+        ID_listctrl_transactions,
+        ID_button_cancel_statement,
+        ID_button_monitor,
+        ID_sample_taken
+    };
+
+    void OnButtonCancelStatementClick(wxCommandEvent& event);
+    void OnButtonStartStopClick(wxCommandEvent& event);
+    void OnSampleTaken(wxCommandEvent& event);
+    void OnListSelectionChanged(wxListEvent& event);
+    void OnPageChanged(wxNotebookEvent& event);
+
+    DECLARE_EVENT_TABLE()
+};
+
+#endif
@@ -32,8 +32,12 @@
 
 #include <wx/datetime.h>
 #include <wx/filename.h>
+#include <wx/spinctrl.h>
+#include <wx/wfstream.h>
+#include <wx/zstream.h>
 
 #include <algorithm>
+#include <vector>
 
 #include <ibpp.h>
 
@@ -53,7 +57,7 @@ class RestoreThread: public wxThread {
 public:
     RestoreThread(RestoreFrame* frame, wxString server, wxString username,
         wxString password, wxString bkfilename, wxString dbfilename,
-        int pagesize, IBPP::BRF flags);
+        int pagesize, IBPP::BRF flags, bool stream, int parallelWorkers);
 
     virtual void* Entry();
     virtual void OnExit();
@@ -66,6 +70,9 @@ private:
     wxString dbfileM;
     int pagesizeM;
     IBPP::BRF brfM;
+    bool streamM;
+    int parallelWorkersM;
+    bool streamRestore(IBPP::Service& svc);
     void logError(wxString& msg);
     void logImportant(wxString& msg);
     void logProgress(wxString& msg);
@@ -73,7 +80,8 @@ private:
 
 RestoreThread::RestoreThread(RestoreFrame* frame, wxString server,
         wxString username, wxString password, wxString bkfilename,
-        wxString dbfilename, int pagesize, IBPP::BRF flags)
+        wxString dbfilename, int pagesize, IBPP::BRF flags, bool stream,
+        int parallelWorkers)
     : wxThread()
 {
     frameM = frame;
@@ -85,6 +93,8 @@ RestoreThread::RestoreThread(RestoreFrame* frame, wxString server,
     pagesizeM = pagesize;
     // always use verbose flag
     brfM = (IBPP::BRF)((int)flags | (int)IBPP::brVerbose);
+    streamM = stream;
+    parallelWorkersM = parallelWorkers;
 }
 
 void* RestoreThread::Entry()
@@ -100,6 +110,13 @@ void* RestoreThread::Entry()
             wx2std(usernameM), wx2std(passwordM));
         svc->Connect();
 
+        if (streamM)
+        {
+            streamRestore(svc);
+            svc->Disconnect();
+            return 0;
+        }
+
         now = wxDateTime::Now();
         msg.Printf(_("Database restore started %s"), now.FormatTime().c_str());
         logImportant(msg);
@@ -146,6 +163,150 @@ void* RestoreThread::Entry()
     return 0;
 }
 
+// sends the local backup file to the service input, gzip compressed
+// files are recognized by their header
+bool RestoreThread::streamRestore(IBPP::Service& svc)
+{
+    wxDateTime now;
+    wxString msg;
+
+    int workers = parallelWorkersM;
+    if (workers > 0)
+    {
+        std::string version;
+        svc->GetVersion(version);
+        if (BackupRestoreBaseFrame::getServerMajorVersion(version) < 5)
+        {
+            msg = _("Parallel workers need Firebird 5, the restore runs in a single thread");
+            logImportant(msg);
+            workers = 0;
+        }
+    }
+
+    wxFileInputStream file(bkfileM);
+    if (!file.IsOk())
+    {
+        msg.Printf(_("Could not open the backup file \"%s\""),
+            bkfileM.c_str());
+        logError(msg);
+        return false;
+    }
+    unsigned char magic[2] = { 0, 0 };
+    file.Read(magic, sizeof(magic));
+    bool compressed = file.LastRead() == sizeof(magic)
+        && magic[0] == 0x1f && magic[1] == 0x8b;
+    file.SeekI(0);
+    std::auto_ptr<wxZlibInputStream> zlib;
+    wxInputStream* in = &file;
+    if (compressed)
+    {
+        zlib.reset(new wxZlibInputStream(file, wxZLIB_GZIP));
+        in = zlib.get();
+    }
+
+    now = wxDateTime::Now();
+    msg.Printf(_("Database restore from local file started %s"),
+        now.FormatTime().c_str());
+    logImportant(msg);
+    svc->StartRestoreStream(wx2std(dbfileM), pagesizeM, brfM, workers);
+
+    wxLongLong startMillis = ::wxGetLocalTimeMillis();
+    wxLongLong reportMillis = startMillis;
+    wxULongLong bytes = 0;
+    wxULongLong rows = 0;
+    std::vector<char> buffer(32000);
+    int requested = 0;
+    bool inputEnded = false;
+    std::string output;
+    // the output of one call may end in the middle of a line
+    std::string partialLine;
+    bool serviceRunning = true;
+    while (serviceRunning)
+    {
+        if (TestDestroy())
+        {
+            now = wxDateTime::Now();
+            msg.Printf(_("Database restore canceled %s"),
+                now.FormatTime().c_str());
+            logImportant(msg);
+            return false;
+        }
+
+        const char* data = 0;
+        int size = 0;
+        if (requested > 0 && !inputEnded)
+        {
+            in->Read(&buffer[0], std::min(requested, int(buffer.size())));
+            size = int(in->LastRead());
+            if (size == 0)
+            {
+                if (in->GetLastError() != wxSTREAM_EOF)
+                {
+                    msg.Printf(_("Database restore canceled, reading \"%s\" failed"),
+                        bkfileM.c_str());
+                    logError(msg);
+                    return false;
+                }
+                inputEnded = true;
+            }
+            data = &buffer[0];
+        }
+        serviceRunning = svc->WriteInput(data, size, requested, output, 1);
+        if (serviceRunning)
+            bytes += (unsigned long)size;
+
+        // the verbose output reports the rows of each restored table
+        partialLine += output;
+        std::string::size_type start = 0;
+        while (start < partialLine.size())
+        {
+            std::string::size_type end = partialLine.find('\n', start);
+            if (end == std::string::npos)
+            {
+                // completed by the next output, unless there is none
+                if (serviceRunning)
+                    break;
+                end = partialLine.size();
+            }
+            std::string line(partialLine, start, end - start);
+            start = end + 1;
+            if (line.empty())
+                continue;
+            if (line.find("records restored") != std::string::npos)
+            {
+                std::string::size_type digits = line.find_first_of("0123456789");
+                if (digits != std::string::npos)
+                    rows += strtoul(line.c_str() + digits, 0, 10);
+            }
+            msg = wxString(line.c_str(), *wxConvCurrent);
+            logProgress(msg);
+        }
+        partialLine.erase(0, std::min(start, partialLine.size()));
+
+        wxLongLong nowMillis = ::wxGetLocalTimeMillis();
+        if (nowMillis - reportMillis >= 1000)
+        {
+            reportMillis = nowMillis;
+            wxLongLong elapsed = nowMillis - startMillis;
+            msg.Printf(_("%s sent, %s rows (%.0f rows/s)"),
+                BackupRestoreBaseFrame::formatTransferProgress(bytes,
+                    elapsed).c_str(),
+                rows.ToString().c_str(),
+                rows.ToDouble() * 1000.0 / elapsed.ToDouble());
+            logProgress(msg);
+        }
+    }
+
+    wxLongLong elapsed = ::wxGetLocalTimeMillis() - startMillis;
+    now = wxDateTime::Now();
+    msg.Printf(_("Database restore finished %s, %s rows restored from %s"),
+        now.FormatTime().c_str(), rows.ToString().c_str(),
+        BackupRestoreBaseFrame::formatTransferProgress(bytes,
+            elapsed).c_str());
+    logImportant(msg);
+    return true;
+}
+
 void RestoreThread::OnExit()
 {
     if (frameM != 0)
@@ -225,12 +386,21 @@ void RestoreFrame::createControls()
         wxDefaultPosition, wxDefaultSize,
         sizeof(pagesize_choices) / sizeof(wxString), pagesize_choices);
 
+    checkbox_stream = new wxCheckBox(panel_controls, ID_checkbox_stream,
+        _("Transfer from local file (plain or gzip)"));
+    label_workers = new wxStaticText(panel_controls, wxID_ANY,
+        _("Parallel workers:"));
+    spinctrl_workers = new wxSpinCtrl(panel_controls, wxID_ANY, "0",
+        wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 0, 64, 0);
+    spinctrl_workers->SetToolTip(
+        _("Number of parallel workers (Firebird 5), 0 for the server default"));
+
     checkbox_showlog = new wxCheckBox(panel_controls, ID_checkbox_showlog,
         _("Show complete log"));
     button_start = new wxButton(panel_controls, ID_button_start,
         _("&Start Restore"));
 
-    text_ctrl_log = new LogTextControl(this, ID_text_ctrl_log);
+    createLogControls();
 }
 
 void RestoreFrame::layoutControls()
@@ -266,6 +436,13 @@ void RestoreFrame::layoutControls()
     sizerCombo->Add(styleguide().getControlLabelMargin(), 0);
     sizerCombo->Add(choice_pagesize, 1, wxEXPAND);
 
+    wxBoxSizer* sizerStream = new wxBoxSizer(wxHORIZONTAL);
+    sizerStream->Add(checkbox_stream, 0, wxALIGN_CENTER_VERTICAL);
+    sizerStream->Add(styleguide().getUnrelatedControlMargin(wxHORIZONTAL), 0);
+    sizerStream->Add(label_workers, 0, wxALIGN_CENTER_VERTICAL);
+    sizerStream->Add(styleguide().getControlLabelMargin(), 0);
+    sizerStream->Add(spinctrl_workers, 0, wxALIGN_CENTER_VERTICAL);
+
     wxBoxSizer* sizerButtons = new wxBoxSizer(wxHORIZONTAL);
     sizerButtons->Add(checkbox_showlog, 0, wxALIGN_CENTER_VERTICAL);
     sizerButtons->Add(0, 0, 1, wxEXPAND);
@@ -278,6 +455,8 @@ void RestoreFrame::layoutControls()
     sizerPanelV->Add(sizerChecks);
     sizerPanelV->Add(0, styleguide().getRelatedControlMargin(wxVERTICAL));
     sizerPanelV->Add(sizerCombo);
+    sizerPanelV->Add(0, styleguide().getRelatedControlMargin(wxVERTICAL));
+    sizerPanelV->Add(sizerStream);
     sizerPanelV->Add(0, styleguide().getUnrelatedControlMargin(wxVERTICAL));
     sizerPanelV->Add(sizerButtons, 0, wxEXPAND);
     sizerPanelV->Add(0, styleguide().getRelatedControlMargin(wxVERTICAL));
@@ -289,7 +468,7 @@ void RestoreFrame::layoutControls()
 
     wxBoxSizer* sizerMain = new wxBoxSizer(wxVERTICAL);
     sizerMain->Add(panel_controls, 0, wxEXPAND);
-    sizerMain->Add(text_ctrl_log, 1, wxEXPAND);
+    sizerMain->Add(layoutLogControls(), 1, wxEXPAND);
 
     // show at least 3 lines of text since it is default size too
     sizerMain->SetItemMinSize(text_ctrl_log,
@@ -309,6 +488,9 @@ void RestoreFrame::updateControls()
     checkbox_commit->Enable(!running);
     checkbox_space->Enable(!running);
     choice_pagesize->Enable(!running);
+    checkbox_stream->Enable(!running);
+    label_workers->Enable(!running && checkbox_stream->IsChecked());
+    spinctrl_workers->Enable(!running && checkbox_stream->IsChecked());
     DatabasePtr db = getDatabase();
     button_start->Enable(!running && !text_ctrl_filename->GetValue().empty()
         && db && !db->isConnected());
@@ -342,6 +524,14 @@ void RestoreFrame::doReadConfigSettings(const wxString& prefix)
             flags.end() != std::find(flags.begin(), flags.end(), "commit_per_table"));
         checkbox_space->SetValue(
             flags.end() != std::find(flags.begin(), flags.end(), "use_all_space"));
+        checkbox_stream->SetValue(
+            flags.end() != std::find(flags.begin(), flags.end(), "stream_local"));
+    }
+    int workers = 0;
+    if (config().getValue(prefix + Config::pathSeparator + "parallel_workers",
+        workers))
+    {
+        spinctrl_workers->SetValue(workers);
     }
     updateControls();
 }
@@ -365,7 +555,11 @@ void RestoreFrame::doWriteConfigSettings(const wxString& prefix) const
         flags.push_back("commit_per_table");
     if (checkbox_space->IsChecked())
         flags.push_back("use_all_space");
+    if (checkbox_stream->IsChecked())
+        flags.push_back("stream_local");
     config().setValue(prefix + Config::pathSeparator + "options", flags);
+    config().setValue(prefix + Config::pathSeparator + "parallel_workers",
+        spinctrl_workers->GetValue());
 }
 
 const wxString RestoreFrame::getName() const
@@ -393,6 +587,7 @@ RestoreFrame* RestoreFrame::findFrameFor(DatabasePtr db)
 BEGIN_EVENT_TABLE(RestoreFrame, BackupRestoreBaseFrame)
     EVT_BUTTON(BackupRestoreBaseFrame::ID_button_browse, RestoreFrame::OnBrowseButtonClick)
     EVT_BUTTON(BackupRestoreBaseFrame::ID_button_start, RestoreFrame::OnStartButtonClick)
+    EVT_CHECKBOX(RestoreFrame::ID_checkbox_stream, RestoreFrame::OnStreamCheckboxClick)
 END_EVENT_TABLE()
 
 void RestoreFrame::OnBrowseButtonClick(wxCommandEvent& WXUNUSED(event))
@@ -400,7 +595,9 @@ void RestoreFrame::OnBrowseButtonClick(wxCommandEvent& WXUNUSED(event))
     wxFileName origName(text_ctrl_filename->GetValue());
     wxString filename = ::wxFileSelector(_("Select Backup File"),
         origName.GetPath(), origName.GetFullName(), "*.fbk",
-        _("Backup file (*.fbk, *.gbk)|*.fbk;*.gbk|All files (*.*)|*.*"),
+        checkbox_stream->IsChecked()
+            ? _("Backup file (*.fbk, *.gbk, *.gz)|*.fbk;*.gbk;*.gz|All files (*.*)|*.*")
+            : _("Backup file (*.fbk, *.gbk)|*.fbk;*.gbk|All files (*.*)|*.*"),
         wxFD_OPEN, this);
     if (!filename.empty())
         text_ctrl_filename->SetValue(filename);
@@ -444,8 +641,14 @@ void RestoreFrame::OnStartButtonClick(wxCommandEvent& WXUNUSED(event))
     std::auto_ptr<wxThread> thread(new RestoreThread(this,
         server->getConnectionString(), username, password,
         text_ctrl_filename->GetValue(), database->getPath(), pagesize,
-        (IBPP::BRF)flags));
+        (IBPP::BRF)flags, checkbox_stream->IsChecked(),
+        spinctrl_workers->GetValue()));
     startThread(thread);
     updateControls();
 }
 
+void RestoreFrame::OnStreamCheckboxClick(wxCommandEvent& WXUNUSED(event))
+{
+    updateControls();
+}
+
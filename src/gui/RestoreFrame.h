@@ -26,6 +26,7 @@
 #define RESTOREFRAME_H
 
 #include <wx/wx.h>
+#include <wx/spinctrl.h>
 
 #include "BackupRestoreBaseFrame.h"
 
@@ -42,6 +43,9 @@ private:
     wxCheckBox* checkbox_space;
     wxStaticText* label_pagesize;
     wxChoice* choice_pagesize;
+    wxCheckBox* checkbox_stream;
+    wxStaticText* label_workers;
+    wxSpinCtrl* spinctrl_workers;
     void createControls();
     void layoutControls();
     virtual void updateControls();
@@ -57,8 +61,13 @@ public:
     static RestoreFrame* findFrameFor(DatabasePtr db);
 private:
     // event handling
+    enum {
+        ID_checkbox_stream = 201
+    };
+
     void OnBrowseButtonClick(wxCommandEvent& event);
     void OnStartButtonClick(wxCommandEvent& event);
+    void OnStreamCheckboxClick(wxCommandEvent& event);
 
     DECLARE_EVENT_TABLE()
 };
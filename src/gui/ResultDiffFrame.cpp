@@ -0,0 +1,844 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <wx/datetime.h>
+
+#include <deque>
+
+#include <ibpp.h>
+
+#include "config/Config.h"
+#include "core/FRError.h"
+#include "core/StringUtils.h"
+#include "gui/controls/DataGridRowBuffer.h"
+#include "gui/controls/DataGridRows.h"
+#include "gui/ResultDiffFrame.h"
+#include "gui/StyleGuide.h"
+#include "gui/UsernamePasswordDialog.h"
+#include "metadata/database.h"
+#include "metadata/root.h"
+#include "metadata/server.h"
+
+// the number of rows of each kind that are listed
+static const size_t maxRowsShown = 1000;
+
+// ResultFetchThread class
+// Executes one of the statements on its own connection and hands the rows
+// over to the comparison in batches. At most maxBatches batches are
+// queued, so a fast statement waits for the comparison instead of
+// filling the memory.
+class ResultFetchThread: public wxThread, public ResultDiffSource
+{
+private:
+    enum { batchSize = 256, maxBatches = 16 };
+
+    const std::atomic<bool>& canceledM;
+    IBPP::Database databaseM;
+    IBPP::Transaction transactionM;
+    IBPP::Statement statementM;
+    std::unique_ptr<DataGridRows> rowsM;
+
+    wxMutex mutexM;
+    wxCondition conditionM;
+    std::deque<std::vector<ResultDiffRow> > batchesM;
+    bool finishedM;
+    wxString errorM;
+
+    // only used by the comparison thread
+    std::vector<ResultDiffRow> currentM;
+    size_t currentPosM;
+
+    bool push(std::vector<ResultDiffRow>& batch);
+public:
+    ResultFetchThread(const std::atomic<bool>& canceled);
+
+    // connects and prepares the statement, throws on errors
+    void prepare(DatabasePtr database, const wxString& username,
+        const wxString& password, const wxString& sql);
+    DataGridRows& getRows() { return *rowsM; }
+
+    virtual ExitCode Entry();
+    virtual bool fetch(ResultDiffRow& row);
+
+    std::atomic<int64_t> rowCountM;
+};
+
+ResultFetchThread::ResultFetchThread(const std::atomic<bool>& canceled)
+    : wxThread(wxTHREAD_JOINABLE), canceledM(canceled),
+        conditionM(mutexM), finishedM(false), currentPosM(0), rowCountM(0)
+{
+}
+
+void ResultFetchThread::prepare(DatabasePtr database,
+    const wxString& username, const wxString& password, const wxString& sql)
+{
+    ServerPtr server = database->getServer();
+    if (!server)
+        throw FRError(_("The database is not registered with a server."));
+
+    databaseM = IBPP::DatabaseFactory(wx2std(server->getConnectionString()),
+        wx2std(database->getPath()), wx2std(username), wx2std(password),
+        wx2std(database->getRole()),
+        wx2std(database->getConnectionCharset()), "");
+    databaseM->Connect();
+    transactionM = IBPP::TransactionFactory(databaseM, IBPP::amRead);
+    transactionM->Start();
+    statementM = IBPP::StatementFactory(databaseM, transactionM);
+    statementM->Prepare(wx2std(sql, database->getCharsetConverter()));
+    if (statementM->Type() != IBPP::stSelect
+        && statementM->Type() != IBPP::stSelectUpdate)
+    {
+        throw FRError(_("Only SELECT statements can be compared."));
+    }
+
+    // read-only, so the result columns are not looked up in the metadata
+    rowsM.reset(new DataGridRows(database.get(), true));
+    rowsM->initialize(statementM);
+}
+
+bool ResultFetchThread::push(std::vector<ResultDiffRow>& batch)
+{
+    wxMutexLocker lock(mutexM);
+    while (batchesM.size() >= maxBatches && !canceledM)
+        conditionM.WaitTimeout(100);
+    if (canceledM)
+        return false;
+    batchesM.push_back(std::vector<ResultDiffRow>());
+    batchesM.back().swap(batch);
+    conditionM.Broadcast();
+    return true;
+}
+
+wxThread::ExitCode ResultFetchThread::Entry()
+{
+    wxString error;
+    try
+    {
+        statementM->Execute();
+        unsigned columns = rowsM->getRowFieldCount();
+        std::vector<ResultDiffRow> batch;
+        batch.reserve(batchSize);
+        IBPP::ColumnViews views;
+        while (!canceledM && statementM->Fetch(views))
+        {
+            std::unique_ptr<DataGridRowBuffer> buffer(rowsM->readRow(views));
+            batch.push_back(ResultDiffRow());
+            ResultDiffRow& row = batch.back();
+            row.values.resize(columns);
+            row.nulls.resize(columns);
+            for (unsigned col = 0; col < columns; ++col)
+            {
+                row.nulls[col] = buffer->isFieldNull(col);
+                if (!row.nulls[col])
+                {
+                    // both sides in UTF-8, whatever their connection
+                    // character sets are, BLOBs by the hash of their bytes
+                    row.values[col] = wx2std(rowsM->getColumnDef(col)->
+                        getAsComparableString(buffer.get()), &wxConvUTF8);
+                }
+            }
+            ++rowCountM;
+            if (batch.size() == batchSize)
+            {
+                if (!push(batch))
+                    break;
+                batch.reserve(batchSize);
+            }
+        }
+        if (!batch.empty())
+            push(batch);
+        transactionM->Commit();
+        databaseM->Disconnect();
+    }
+    catch (IBPP::Exception& e)
+    {
+        error = e.what();
+    }
+    catch (std::exception& e)
+    {
+        error = e.what();
+    }
+    catch (...)
+    {
+        error = _("Unexpected exception");
+    }
+
+    wxMutexLocker lock(mutexM);
+    errorM = error;
+    finishedM = true;
+    conditionM.Broadcast();
+    return 0;
+}
+
+bool ResultFetchThread::fetch(ResultDiffRow& row)
+{
+    if (currentPosM >= currentM.size())
+    {
+        wxMutexLocker lock(mutexM);
+        while (batchesM.empty() && !finishedM && !canceledM)
+            conditionM.WaitTimeout(100);
+        if (batchesM.empty())
+        {
+            if (!errorM.empty())
+                throw FRError(errorM);
+            return false;
+        }
+        currentM.swap(batchesM.front());
+        batchesM.pop_front();
+        currentPosM = 0;
+        conditionM.Broadcast();
+    }
+    row.values.swap(currentM[currentPosM].values);
+    row.nulls.swap(currentM[currentPosM].nulls);
+    ++currentPosM;
+    return true;
+}
+
+// ResultDiffThread class
+// Compares the rows of the two fetch threads.
+class ResultDiffThread: public wxThread
+{
+private:
+    ResultDiffFrame* frameM;
+    ResultDiff& diffM;
+    ResultDiffSource& leftM;
+    ResultDiffSource& rightM;
+public:
+    ResultDiffThread(ResultDiffFrame* frame, ResultDiff& diff,
+        ResultDiffSource& left, ResultDiffSource& right);
+    virtual ExitCode Entry();
+
+    // valid after the thread has finished
+    wxString errorM;
+};
+
+ResultDiffThread::ResultDiffThread(ResultDiffFrame* frame, ResultDiff& diff,
+        ResultDiffSource& left, ResultDiffSource& right)
+    : wxThread(wxTHREAD_JOINABLE), frameM(frame), diffM(diff), leftM(left),
+        rightM(right)
+{
+}
+
+wxThread::ExitCode ResultDiffThread::Entry()
+{
+    try
+    {
+        diffM.run(leftM, rightM);
+    }
+    catch (std::exception& e)
+    {
+        errorM = e.what();
+    }
+    catch (...)
+    {
+        errorM = _("Unexpected exception");
+    }
+
+    wxCommandEvent event(wxEVT_COMMAND_MENU_SELECTED,
+        ResultDiffFrame::ID_compare_finished);
+    wxPostEvent(frameM, event);
+    return 0;
+}
+
+// ResultDiffFrame class
+ResultDiffFrame::ResultDiffFrame(wxWindow* parent, RootPtr root,
+        DatabasePtr selected, const wxString& sql)
+    : BaseFrame(parent, -1, wxEmptyString), rootM(root), diffThreadM(0),
+        canceledM(false), timerM(this, ID_timer)
+{
+    fetchersM[0] = fetchersM[1] = 0;
+    setIdString(this, getFrameId());
+    SetTitle(_("Compare Query Results"));
+
+    createControls();
+    layoutControls();
+
+    #include "new.xpm"
+    wxBitmap bmp(new_xpm);
+    wxIcon icon;
+    icon.CopyFromBitmap(bmp);
+    SetIcon(icon);
+
+    loadDatabases(selected);
+    text_ctrl_left_sql->SetValue(sql);
+    text_ctrl_right_sql->SetValue(sql);
+    updateControls();
+}
+
+bool ResultDiffFrame::Destroy()
+{
+    if (isRunning())
+    {
+        wxBusyCursor wait;
+        cancelCompare();
+        joinThreads();
+    }
+    timerM.Stop();
+    return BaseFrame::Destroy();
+}
+
+wxPanel* ResultDiffFrame::createStatementPanel(wxWindow* parent,
+    const wxString& caption, wxChoice*& choice, wxTextCtrl*& text)
+{
+    wxPanel* panel = new wxPanel(parent, wxID_ANY);
+    wxStaticText* label = new wxStaticText(panel, wxID_ANY, caption);
+    choice = new wxChoice(panel, wxID_ANY);
+    text = new wxTextCtrl(panel, wxID_ANY, wxEmptyString,
+        wxDefaultPosition, wxSize(300, 100), wxTE_MULTILINE);
+
+    wxBoxSizer* sizerDb = new wxBoxSizer(wxHORIZONTAL);
+    sizerDb->Add(label, 0, wxALIGN_CENTER_VERTICAL);
+    sizerDb->AddSpacer(styleguide().getControlLabelMargin());
+    sizerDb->Add(choice, 1, wxALIGN_CENTER_VERTICAL);
+
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(sizerDb, 0, wxEXPAND);
+    sizer->AddSpacer(styleguide().getRelatedControlMargin(wxVERTICAL));
+    sizer->Add(text, 1, wxEXPAND);
+    panel->SetSizer(sizer);
+    return panel;
+}
+
+void ResultDiffFrame::createControls()
+{
+    panel_controls = new wxPanel(this, -1, wxDefaultPosition, wxDefaultSize,
+        wxTAB_TRAVERSAL | wxCLIP_CHILDREN);
+
+    splitter_statements = new wxSplitterWindow(panel_controls, wxID_ANY,
+        wxDefaultPosition, wxDefaultSize, wxSP_LIVE_UPDATE);
+    panel_left = createStatementPanel(splitter_statements, _("&Left:"),
+        choice_left_db, text_ctrl_left_sql);
+    panel_right = createStatementPanel(splitter_statements, _("&Right:"),
+        choice_right_db, text_ctrl_right_sql);
+    splitter_statements->SplitVertically(panel_left, panel_right);
+    splitter_statements->SetSashGravity(0.5);
+    splitter_statements->SetMinimumPaneSize(100);
+
+    label_keys = new wxStaticText(panel_controls, wxID_ANY,
+        _("&Key columns:"));
+    spinctrl_keys = new wxSpinCtrl(panel_controls, wxID_ANY, "1",
+        wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 0, 32, 1);
+    static_text_keys_info = new wxStaticText(panel_controls, wxID_ANY,
+        _("The statements have to be ordered by the first columns, 0 compares whole rows in any order."));
+
+    notebook_results = new wxNotebook(panel_controls, wxID_ANY);
+    listctrl_removed = new wxListCtrl(notebook_results, wxID_ANY,
+        wxDefaultPosition, wxDefaultSize, wxLC_REPORT);
+    listctrl_added = new wxListCtrl(notebook_results, wxID_ANY,
+        wxDefaultPosition, wxDefaultSize, wxLC_REPORT);
+    listctrl_changed = new wxListCtrl(notebook_results, wxID_ANY,
+        wxDefaultPosition, wxDefaultSize, wxLC_REPORT);
+    notebook_results->AddPage(listctrl_removed, _("Only left"));
+    notebook_results->AddPage(listctrl_added, _("Only right"));
+    notebook_results->AddPage(listctrl_changed, _("Changed"));
+
+    static_text_status = new wxStaticText(panel_controls, wxID_ANY,
+        wxEmptyString);
+    button_compare = new wxButton(panel_controls, ID_button_compare,
+        _("C&ompare"));
+    button_cancel = new wxButton(panel_controls, ID_button_cancel,
+        _("&Cancel"));
+}
+
+void ResultDiffFrame::layoutControls()
+{
+    wxBoxSizer* sizerKeys = new wxBoxSizer(wxHORIZONTAL);
+    sizerKeys->Add(label_keys, 0, wxALIGN_CENTER_VERTICAL);
+    sizerKeys->AddSpacer(styleguide().getControlLabelMargin());
+    sizerKeys->Add(spinctrl_keys, 0, wxALIGN_CENTER_VERTICAL);
+    sizerKeys->AddSpacer(styleguide().getRelatedControlMargin(wxHORIZONTAL));
+    sizerKeys->Add(static_text_keys_info, 1, wxALIGN_CENTER_VERTICAL);
+
+    wxBoxSizer* sizerButtons = new wxBoxSizer(wxHORIZONTAL);
+    sizerButtons->Add(static_text_status, 1, wxALIGN_CENTER_VERTICAL);
+    sizerButtons->AddSpacer(styleguide().getUnrelatedControlMargin(wxHORIZONTAL));
+    sizerButtons->Add(button_compare);
+    sizerButtons->AddSpacer(styleguide().getBetweenButtonsMargin(wxHORIZONTAL));
+    sizerButtons->Add(button_cancel);
+
+    wxBoxSizer* sizerPanelV = new wxBoxSizer(wxVERTICAL);
+    sizerPanelV->AddSpacer(styleguide().getFrameMargin(wxTOP));
+    sizerPanelV->Add(splitter_statements, 2, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getRelatedControlMargin(wxVERTICAL));
+    sizerPanelV->Add(sizerKeys, 0, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getUnrelatedControlMargin(wxVERTICAL));
+    sizerPanelV->Add(notebook_results, 3, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getRelatedControlMargin(wxVERTICAL));
+    sizerPanelV->Add(sizerButtons, 0, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getFrameMargin(wxBOTTOM));
+
+    wxBoxSizer* sizerPanelH = new wxBoxSizer(wxHORIZONTAL);
+    sizerPanelH->AddSpacer(styleguide().getFrameMargin(wxLEFT));
+    sizerPanelH->Add(sizerPanelV, 1, wxEXPAND);
+    sizerPanelH->AddSpacer(styleguide().getFrameMargin(wxRIGHT));
+
+    wxBoxSizer* sizerAll = new wxBoxSizer(wxHORIZONTAL);
+    sizerAll->Add(sizerPanelH, 1, wxEXPAND);
+
+    panel_controls->SetSizer(sizerAll);
+    sizerAll->Fit(this);
+    sizerAll->SetSizeHints(this);
+}
+
+void ResultDiffFrame::updateControls()
+{
+    bool running = isRunning();
+    choice_left_db->Enable(!running);
+    choice_right_db->Enable(!running);
+    text_ctrl_left_sql->SetEditable(!running);
+    text_ctrl_right_sql->SetEditable(!running);
+    spinctrl_keys->Enable(!running);
+    button_compare->Enable(!running);
+    button_cancel->Enable(running);
+}
+
+void ResultDiffFrame::loadDatabases(DatabasePtr selected)
+{
+    databasesM.clear();
+    choice_left_db->Clear();
+    choice_right_db->Clear();
+    ServerPtrs servers(rootM->getServers());
+    for (ServerPtrs::iterator its = servers.begin(); its != servers.end();
+        ++its)
+    {
+        DatabasePtrs databases((*its)->getDatabases());
+        for (DatabasePtrs::iterator itd = databases.begin();
+            itd != databases.end(); ++itd)
+        {
+            wxString name(wxString::Format("%s: %s",
+                (*its)->getName_().c_str(), (*itd)->getName_().c_str()));
+            if (*itd == selected)
+            {
+                choice_left_db->SetSelection(choice_left_db->Append(name));
+                choice_right_db->SetSelection(choice_right_db->Append(name));
+            }
+            else
+            {
+                choice_left_db->Append(name);
+                choice_right_db->Append(name);
+            }
+            databasesM.push_back(*itd);
+        }
+    }
+}
+
+ResultFetchThread* ResultDiffFrame::prepareSide(int side, wxChoice* choice,
+    wxTextCtrl* text)
+{
+    wxString which(side == 0 ? _("left") : _("right"));
+    int sel = choice->GetSelection();
+    DatabasePtr db;
+    if (sel != wxNOT_FOUND)
+        db = databasesM[sel].lock();
+    if (!db)
+    {
+        ::wxMessageBox(wxString::Format(
+            _("Please select the database of the %s statement."),
+            which.c_str()), _("Compare Query Results"),
+            wxOK | wxICON_EXCLAMATION, this);
+        return 0;
+    }
+    wxString sql(text->GetValue().Strip(wxString::both));
+    if (sql.EndsWith(";"))
+        sql.RemoveLast();
+    if (sql.empty())
+    {
+        ::wxMessageBox(wxString::Format(
+            _("Please enter the %s statement."), which.c_str()),
+            _("Compare Query Results"), wxOK | wxICON_EXCLAMATION, this);
+        return 0;
+    }
+
+    wxString username, password;
+    if (!getConnectionCredentials(this, db, username, password))
+        return 0;
+
+    std::unique_ptr<ResultFetchThread> fetcher(
+        new ResultFetchThread(canceledM));
+    wxString error;
+    try
+    {
+        wxBusyCursor wait;
+        fetcher->prepare(db, username, password, sql);
+        return fetcher.release();
+    }
+    catch (IBPP::Exception& e)
+    {
+        error = e.what();
+    }
+    catch (std::exception& e)
+    {
+        error = e.what();
+    }
+    ::wxMessageBox(wxString::Format(_("The %s statement failed:\n\n%s"),
+        which.c_str(), error.c_str()), _("Compare Query Results"),
+        wxOK | wxICON_ERROR, this);
+    return 0;
+}
+
+void ResultDiffFrame::startCompare()
+{
+    if (isRunning())
+        return;
+
+    std::unique_ptr<ResultFetchThread> left(
+        prepareSide(0, choice_left_db, text_ctrl_left_sql));
+    if (!left.get())
+        return;
+    std::unique_ptr<ResultFetchThread> right(
+        prepareSide(1, choice_right_db, text_ctrl_right_sql));
+    if (!right.get())
+        return;
+
+    DataGridRows& leftRows = left->getRows();
+    unsigned columns = leftRows.getRowFieldCount();
+    if (columns != right->getRows().getRowFieldCount())
+    {
+        ::wxMessageBox(_("The statements have to return the same number of columns."),
+            _("Compare Query Results"), wxOK | wxICON_EXCLAMATION, this);
+        return;
+    }
+    size_t keyColumns = spinctrl_keys->GetValue();
+    if (keyColumns > columns)
+    {
+        ::wxMessageBox(_("There are more key columns than result columns."),
+            _("Compare Query Results"), wxOK | wxICON_EXCLAMATION, this);
+        return;
+    }
+
+    columnsM.clear();
+    for (unsigned col = 0; col < columns; ++col)
+    {
+        ResultDiffColumn column;
+        column.name = wx2std(leftRows.getRowFieldName(col), &wxConvUTF8);
+        column.numeric = leftRows.isColumnNumeric(col)
+            && right->getRows().isColumnNumeric(col);
+        columnsM.push_back(column);
+    }
+
+    canceledM = false;
+    errorM.clear();
+    diffM.reset(new ResultDiff(columnsM, keyColumns, maxRowsShown));
+    diffM->setCancelFlag(&canceledM);
+
+    diffThreadM = new ResultDiffThread(this, *diffM, *left, *right);
+    fetchersM[0] = left.release();
+    fetchersM[1] = right.release();
+    wxThread* threads[] = { fetchersM[0], fetchersM[1], diffThreadM };
+    const int threadCount = sizeof(threads) / sizeof(threads[0]);
+    int created = 0, started = 0;
+    while (created < threadCount
+        && threads[created]->Create() == wxTHREAD_NO_ERROR)
+    {
+        ++created;
+    }
+    while (created == threadCount && started < threadCount
+        && threads[started]->Run() == wxTHREAD_NO_ERROR)
+    {
+        ++started;
+    }
+    if (started < threadCount)
+    {
+        // only the threads that were run can be waited for
+        canceledM = true;
+        for (int i = 0; i < threadCount; ++i)
+        {
+            if (i < started)
+                threads[i]->Wait();
+            delete threads[i];
+        }
+        diffThreadM = 0;
+        fetchersM[0] = fetchersM[1] = 0;
+        ::wxMessageBox(_("Error starting thread!"),
+            _("Compare Query Results"), wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    startMillisM = ::wxGetLocalTimeMillis();
+    timerM.Start(500);
+    showResults();
+    updateControls();
+}
+
+bool ResultDiffFrame::isRunning() const
+{
+    return diffThreadM != 0;
+}
+
+void ResultDiffFrame::cancelCompare()
+{
+    canceledM = true;
+}
+
+void ResultDiffFrame::joinThreads()
+{
+    // all threads have been run, see startCompare(), and joinable
+    // threads have to be waited for even when they have finished already
+    if (diffThreadM)
+    {
+        diffThreadM->Wait();
+        delete diffThreadM;
+        diffThreadM = 0;
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        if (fetchersM[i])
+        {
+            fetchersM[i]->Wait();
+            delete fetchersM[i];
+            fetchersM[i] = 0;
+        }
+    }
+}
+
+void ResultDiffFrame::compareFinished()
+{
+    if (!diffThreadM)
+        return;
+    diffThreadM->Wait();
+    errorM = diffThreadM->errorM;
+    if (errorM.empty() && canceledM)
+        errorM = _("Canceled");
+    // the fetch threads stop early when the comparison failed
+    canceledM = true;
+    joinThreads();
+    timerM.Stop();
+
+    showResults();
+    updateControls();
+    if (!errorM.empty() && errorM != _("Canceled"))
+    {
+        ::wxMessageBox(errorM, _("Compare Query Results"),
+            wxOK | wxICON_ERROR, this);
+    }
+}
+
+void ResultDiffFrame::setupList(wxListCtrl* list)
+{
+    list->ClearAll();
+    for (size_t i = 0; i < columnsM.size(); ++i)
+    {
+        list->InsertColumn(long(i),
+            wxString::FromUTF8(columnsM[i].name.c_str()),
+            columnsM[i].numeric ? wxLIST_FORMAT_RIGHT : wxLIST_FORMAT_LEFT);
+    }
+}
+
+static wxString getValueText(const ResultDiffRow& row, size_t col)
+{
+    if (row.nulls[col])
+        return "[null]";
+    return wxString::FromUTF8(row.values[col].c_str());
+}
+
+static void addRows(wxListCtrl* list, const std::vector<ResultDiffRow>& rows)
+{
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        long item = list->InsertItem(long(i), getValueText(rows[i], 0));
+        for (size_t col = 1; col < rows[i].values.size(); ++col)
+            list->SetItem(item, long(col), getValueText(rows[i], col));
+    }
+}
+
+void ResultDiffFrame::showResults()
+{
+    wxListCtrl* lists[] = { listctrl_removed, listctrl_added,
+        listctrl_changed };
+    for (size_t i = 0; i < sizeof(lists) / sizeof(wxListCtrl*); ++i)
+    {
+        lists[i]->Freeze();
+        setupList(lists[i]);
+    }
+
+    if (diffM.get() && !isRunning())
+    {
+        addRows(listctrl_removed, diffM->getRemovedRows());
+        addRows(listctrl_added, diffM->getAddedRows());
+
+        // the changed values are shown as "left -> right"
+        const std::vector<ResultDiff::ChangedRow>& changed =
+            diffM->getChangedRows();
+        for (size_t i = 0; i < changed.size(); ++i)
+        {
+            const ResultDiffRow& left = changed[i].first;
+            const ResultDiffRow& right = changed[i].second;
+            long item = listctrl_changed->InsertItem(long(i),
+                getValueText(left, 0));
+            for (size_t col = 1; col < columnsM.size(); ++col)
+            {
+                bool same = left.nulls[col] == right.nulls[col]
+                    && (left.nulls[col] || (columnsM[col].numeric
+                        ? ResultDiff::compareNumbers(left.values[col],
+                            right.values[col]) == 0
+                        : left.values[col] == right.values[col]));
+                wxString text(getValueText(left, col));
+                if (!same)
+                    text += " -> " + getValueText(right, col);
+                listctrl_changed->SetItem(item, long(col), text);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(lists) / sizeof(wxListCtrl*); ++i)
+    {
+        if (lists[i]->GetItemCount())
+        {
+            for (size_t col = 0; col < columnsM.size(); ++col)
+            {
+                lists[i]->SetColumnWidth(long(col),
+                    wxLIST_AUTOSIZE_USEHEADER);
+            }
+        }
+        lists[i]->Thaw();
+    }
+    showStatus();
+}
+
+void ResultDiffFrame::showStatus()
+{
+    int64_t leftRows, rightRows;
+    if (isRunning())
+    {
+        leftRows = fetchersM[0]->rowCountM;
+        rightRows = fetchersM[1]->rowCountM;
+    }
+    else if (diffM.get())
+    {
+        leftRows = diffM->getLeftRowCount();
+        rightRows = diffM->getRightRowCount();
+    }
+    else
+    {
+        static_text_status->SetLabel(wxEmptyString);
+        return;
+    }
+
+    wxString duration(wxTimeSpan::Milliseconds(
+        ::wxGetLocalTimeMillis() - startMillisM).Format("%H:%M:%S"));
+    wxString status(wxString::Format(
+        _("Left: %" wxLongLongFmtSpec "d rows, right: %" wxLongLongFmtSpec "d rows"),
+        wxLongLong_t(leftRows), wxLongLong_t(rightRows)));
+    if (isRunning())
+        status += wxString::Format(_(", comparing for %s"), duration.c_str());
+    else
+    {
+        wxString counts[] = {
+            wxString::Format(_("Only left (%" wxLongLongFmtSpec "d)"),
+                wxLongLong_t(diffM->getRemovedCount())),
+            wxString::Format(_("Only right (%" wxLongLongFmtSpec "d)"),
+                wxLongLong_t(diffM->getAddedCount())),
+            wxString::Format(_("Changed (%" wxLongLongFmtSpec "d)"),
+                wxLongLong_t(diffM->getChangedCount()))
+        };
+        for (size_t i = 0; i < 3; ++i)
+            notebook_results->SetPageText(i, counts[i]);
+
+        status += wxString::Format(
+            _(", %" wxLongLongFmtSpec "d equal"),
+            wxLongLong_t(diffM->getEqualCount()));
+        if (!errorM.empty())
+            status += " (" + errorM + ")";
+        else if (diffM->getRemovedCount() > int64_t(maxRowsShown)
+            || diffM->getAddedCount() > int64_t(maxRowsShown)
+            || diffM->getChangedCount() > int64_t(maxRowsShown))
+        {
+            status += wxString::Format(
+                _(", only the first %d rows of each kind are listed"),
+                int(maxRowsShown));
+        }
+    }
+    static_text_status->SetLabel(status);
+    panel_controls->Layout();
+}
+
+void ResultDiffFrame::doReadConfigSettings(const wxString& prefix)
+{
+    BaseFrame::doReadConfigSettings(prefix);
+    int keys = 1;
+    config().getValue(prefix + Config::pathSeparator + "keyColumns", keys);
+    spinctrl_keys->SetValue(keys);
+}
+
+void ResultDiffFrame::doWriteConfigSettings(const wxString& prefix) const
+{
+    BaseFrame::doWriteConfigSettings(prefix);
+    config().setValue(prefix + Config::pathSeparator + "keyColumns",
+        spinctrl_keys->GetValue());
+}
+
+const wxString ResultDiffFrame::getName() const
+{
+    return "ResultDiffFrame";
+}
+
+/*static*/
+wxString ResultDiffFrame::getFrameId()
+{
+    return "ResultDiffFrame";
+}
+
+/*static*/
+ResultDiffFrame* ResultDiffFrame::findFrame()
+{
+    BaseFrame* bf = frameFromIdString(getFrameId());
+    if (!bf)
+        return 0;
+    return dynamic_cast<ResultDiffFrame*>(bf);
+}
+
+BEGIN_EVENT_TABLE(ResultDiffFrame, BaseFrame)
+    EVT_BUTTON(ResultDiffFrame::ID_button_compare, ResultDiffFrame::OnCompareButtonClick)
+    EVT_BUTTON(ResultDiffFrame::ID_button_cancel, ResultDiffFrame::OnCancelButtonClick)
+    EVT_MENU(ResultDiffFrame::ID_compare_finished, ResultDiffFrame::OnCompareFinished)
+    EVT_TIMER(ResultDiffFrame::ID_timer, ResultDiffFrame::OnTimer)
+END_EVENT_TABLE()
+
+void ResultDiffFrame::OnCompareButtonClick(wxCommandEvent& WXUNUSED(event))
+{
+    startCompare();
+}
+
+void ResultDiffFrame::OnCancelButtonClick(wxCommandEvent& WXUNUSED(event))
+{
+    cancelCompare();
+}
+
+void ResultDiffFrame::OnCompareFinished(wxCommandEvent& WXUNUSED(event))
+{
+    compareFinished();
+}
+
+void ResultDiffFrame::OnTimer(wxTimerEvent& WXUNUSED(event))
+{
+    showStatus();
+}
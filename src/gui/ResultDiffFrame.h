@@ -0,0 +1,137 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_RESULTDIFF_FRAME_H
+#define FR_RESULTDIFF_FRAME_H
+
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+#include <wx/notebook.h>
+#include <wx/panel.h>
+#include <wx/spinctrl.h>
+#include <wx/splitter.h>
+#include <wx/thread.h>
+#include <wx/timer.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "engine/ResultDiff.h"
+#include "gui/BaseFrame.h"
+#include "metadata/MetadataClasses.h"
+
+class ResultDiffThread;
+class ResultFetchThread;
+
+// Runs two select statements, on the same or on two registered databases,
+// on their own connections and in parallel, and shows the rows that only
+// one of them returns and the rows whose values differ.
+class ResultDiffFrame : public BaseFrame
+{
+private:
+    friend class ResultDiffThread;
+
+    RootPtr rootM;
+    // the databases in choice_left_db and choice_right_db
+    std::vector<DatabaseWeakPtr> databasesM;
+
+    std::vector<ResultDiffColumn> columnsM;
+    ResultFetchThread* fetchersM[2];
+    ResultDiffThread* diffThreadM;
+    std::atomic<bool> canceledM;
+    std::unique_ptr<ResultDiff> diffM;
+    wxString errorM;
+    wxLongLong startMillisM;
+    // updates the row counts while comparing
+    wxTimer timerM;
+
+    wxPanel* panel_controls;
+    wxSplitterWindow* splitter_statements;
+    wxPanel* panel_left;
+    wxPanel* panel_right;
+    wxChoice* choice_left_db;
+    wxChoice* choice_right_db;
+    wxTextCtrl* text_ctrl_left_sql;
+    wxTextCtrl* text_ctrl_right_sql;
+    wxStaticText* label_keys;
+    wxSpinCtrl* spinctrl_keys;
+    wxStaticText* static_text_keys_info;
+    wxNotebook* notebook_results;
+    wxListCtrl* listctrl_removed;
+    wxListCtrl* listctrl_added;
+    wxListCtrl* listctrl_changed;
+    wxStaticText* static_text_status;
+    wxButton* button_compare;
+    wxButton* button_cancel;
+    void createControls();
+    wxPanel* createStatementPanel(wxWindow* parent, const wxString& caption,
+        wxChoice*& choice, wxTextCtrl*& text);
+    void layoutControls();
+    void updateControls();
+
+    static wxString getFrameId();
+
+    void loadDatabases(DatabasePtr selected);
+    ResultFetchThread* prepareSide(int side, wxChoice* choice,
+        wxTextCtrl* text);
+    void startCompare();
+    bool isRunning() const;
+    void cancelCompare();
+    void joinThreads();
+    void compareFinished();
+
+    void setupList(wxListCtrl* list);
+    void showResults();
+    void showStatus();
+protected:
+    virtual void doReadConfigSettings(const wxString& prefix);
+    virtual void doWriteConfigSettings(const wxString& prefix) const;
+    virtual const wxString getName() const;
+public:
+    ResultDiffFrame(wxWindow* parent, RootPtr root, DatabasePtr selected,
+        const wxString& sql = wxEmptyString);
+
+    // make sure that the threads are stopped
+    virtual bool Destroy();
+
+    static ResultDiffFrame* findFrame();
+private:
+    // event handling
+    enum
+    {
+        ID_button_compare = 101,
+        ID_button_cancel,
+        ID_compare_finished,
+        ID_timer
+    };
+
+    void OnCompareButtonClick(wxCommandEvent& event);
+    void OnCancelButtonClick(wxCommandEvent& event);
+    void OnCompareFinished(wxCommandEvent& event);
+    void OnTimer(wxTimerEvent& event);
+
+    DECLARE_EVENT_TABLE()
+};
+
+#endif // FR_RESULTDIFF_FRAME_H
@@ -0,0 +1,728 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+
+#include "config/Config.h"
+#include "config/DatabaseConfig.h"
+#include "controls/LogTextControl.h"
+#include "core/StringUtils.h"
+#include "engine/MetadataLoader.h"
+#include "gui/StyleGuide.h"
+#include "gui/TraceFrame.h"
+#include "gui/UsernamePasswordDialog.h"
+#include "metadata/database.h"
+#include "metadata/server.h"
+
+// escapes the characters that have a meaning in SIMILAR TO patterns
+static wxString escapeSimilarPattern(const wxString& text)
+{
+    static const wxString special("[]()|^-+*%_?{}\\");
+    wxString result;
+    for (wxString::const_iterator it = text.begin(); it != text.end(); ++it)
+    {
+        if (special.Find(*it) != wxNOT_FOUND)
+            result += '\\';
+        result += *it;
+    }
+    return result;
+}
+
+// the configuration format has changed with Firebird 3
+static wxString buildTraceConfiguration(const wxString& serverVersion,
+    const wxString& fileName, int timeThreshold)
+{
+    long major = 0;
+    int pos = serverVersion.Find('V');
+    if (pos != wxNOT_FOUND)
+        serverVersion.Mid(pos + 1).BeforeFirst('.').ToLong(&major);
+
+    wxString pattern("%[\\\\/]" + escapeSimilarPattern(fileName));
+    wxString items[] = {
+        "enabled", "true",
+        "log_statement_finish", "true",
+        "print_plan", "true",
+        "print_perf", "true",
+        "time_threshold", wxString::Format("%d", timeThreshold),
+        "max_sql_length", "65535"
+    };
+    const size_t itemCount = sizeof(items) / sizeof(items[0]);
+
+    wxString cfg;
+    if (major >= 3)
+    {
+        cfg = "database = " + pattern + "\n{\n";
+        for (size_t i = 0; i < itemCount; i += 2)
+            cfg += "\t" + items[i] + " = " + items[i + 1] + "\n";
+        cfg += "}\n";
+    }
+    else
+    {
+        cfg = "<database " + pattern + ">\n";
+        for (size_t i = 0; i < itemCount; i += 2)
+            cfg += "\t" + items[i] + " " + items[i + 1] + "\n";
+        cfg += "</database>\n";
+    }
+    return cfg;
+}
+
+// TraceReaderThread class
+// Runs the trace session and feeds its output to the parser as it arrives
+class TraceReaderThread: public wxThread
+{
+private:
+    TraceFrame* frameM;
+    TraceParser parserM;
+    wxString serverM;
+    wxString usernameM;
+    wxString passwordM;
+    wxString fileNameM;
+    int timeThresholdM;
+    wxCriticalSection stopCritsectM;
+    bool stopM;
+
+    bool isStopRequested();
+    void stopSession(int sessionId);
+public:
+    TraceReaderThread(TraceFrame* frame, const wxString& server,
+        const wxString& username, const wxString& password,
+        const wxString& fileName, int timeThreshold);
+    virtual ExitCode Entry();
+
+    void requestStop();
+};
+
+TraceReaderThread::TraceReaderThread(TraceFrame* frame,
+        const wxString& server, const wxString& username,
+        const wxString& password, const wxString& fileName,
+        int timeThreshold)
+    : wxThread(wxTHREAD_JOINABLE), frameM(frame),
+        parserM(frame->statisticsM), serverM(server), usernameM(username),
+        passwordM(password), fileNameM(fileName),
+        timeThresholdM(timeThreshold), stopM(false)
+{
+}
+
+void TraceReaderThread::requestStop()
+{
+    wxCriticalSectionLocker locker(stopCritsectM);
+    stopM = true;
+}
+
+bool TraceReaderThread::isStopRequested()
+{
+    wxCriticalSectionLocker locker(stopCritsectM);
+    return stopM;
+}
+
+// the service running the session is busy, so it has to be stopped
+// through another one
+void TraceReaderThread::stopSession(int sessionId)
+{
+    IBPP::Service svc = IBPP::ServiceFactory(wx2std(serverM),
+        wx2std(usernameM), wx2std(passwordM));
+    svc->Connect();
+    svc->StopTrace(sessionId);
+    svc->Disconnect();
+}
+
+wxThread::ExitCode TraceReaderThread::Entry()
+{
+    try
+    {
+        IBPP::Service svc = IBPP::ServiceFactory(wx2std(serverM),
+            wx2std(usernameM), wx2std(passwordM));
+        svc->Connect();
+
+        std::string version;
+        svc->GetVersion(version);
+        wxString cfg(buildTraceConfiguration(
+            wxString(version.c_str(), *wxConvCurrent), fileNameM,
+            timeThresholdM));
+        int sessionId = svc->StartTrace(wx2std(cfg), "FlameRobin");
+        frameM->addMessage(wxString::Format(_("Trace session %d started"),
+            sessionId));
+
+        bool stopping = false;
+        std::string chunk;
+        while (svc->ReadOutput(chunk, 1))
+        {
+            if (!chunk.empty())
+            {
+                wxCriticalSectionLocker locker(frameM->statisticsCritsectM);
+                parserM.feed(chunk);
+            }
+            if (!stopping && isStopRequested())
+            {
+                stopping = true;
+                // keep reading until the session has ended, unless its
+                // id is unknown, then detaching ends it
+                if (sessionId == 0)
+                    break;
+                stopSession(sessionId);
+            }
+        }
+        {
+            wxCriticalSectionLocker locker(frameM->statisticsCritsectM);
+            parserM.flush();
+        }
+        svc->Disconnect();
+        frameM->addMessage(_("Trace session stopped"));
+    }
+    catch (IBPP::Exception& e)
+    {
+        frameM->addMessage(e.what(), true);
+    }
+    catch (...)
+    {
+        frameM->addMessage(_("Unexpected error while reading trace output"),
+            true);
+    }
+
+    wxCriticalSectionLocker locker(frameM->statisticsCritsectM);
+    frameM->readerFinishedM = true;
+    return 0;
+}
+
+// TraceFrame class
+TraceFrame::TraceFrame(wxWindow* parent, DatabasePtr db)
+    : BaseFrame(parent, -1, wxEmptyString), databaseM(db), readerM(0),
+        readerFinishedM(false), sortColumnM(0), sortAscendingM(false)
+{
+    wxASSERT(db);
+    timerM.SetOwner(this, ID_timer);
+
+    // the number of distinct statements kept limits the memory used
+    DatabaseConfig dc(db.get(), config());
+    topStatementsM = std::max(1, dc.get("TraceTopStatements", 100));
+    timeThresholdM = std::max(0, dc.get("TraceTimeThreshold", 0));
+    statisticsM = TraceStatistics(
+        std::max(10, dc.get("TraceMaxStatements", 1000)));
+
+    setIdString(this, getFrameId(db));
+    // observe database object to close on disconnect / destruction
+    db->attachObserver(this, false);
+    SetTitle(wxString::Format(_("Trace Statements of Database: %s"),
+        db->getName_().c_str()));
+
+    createControls();
+    layoutControls();
+    updateControls();
+
+    button_trace->SetFocus();
+
+    #include "new.xpm"
+    wxBitmap bmp(new_xpm);
+    wxIcon icon;
+    icon.CopyFromBitmap(bmp);
+    SetIcon(icon);
+}
+
+bool TraceFrame::Destroy()
+{
+    if (readerM)
+    {
+        readerM->requestStop();
+        readerM->Wait();
+        delete readerM;
+        readerM = 0;
+    }
+    return BaseFrame::Destroy();
+}
+
+void TraceFrame::createControls()
+{
+    panel_controls = new wxPanel(this, -1, wxDefaultPosition, wxDefaultSize,
+        wxTAB_TRAVERSAL | wxCLIP_CHILDREN);
+    splitter_views = new wxSplitterWindow(panel_controls, wxID_ANY,
+        wxDefaultPosition, wxDefaultSize, wxSP_3D | wxSP_LIVE_UPDATE);
+
+    listctrl_statements = new wxListCtrl(splitter_views,
+        ID_listctrl_statements, wxDefaultPosition, wxDefaultSize,
+        wxLC_REPORT | wxLC_SINGLE_SEL);
+    listctrl_statements->InsertColumn(0, _("Total ms"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(1, _("Count"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(2, _("Avg ms"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(3, _("Max ms"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(4, _("Fetches"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(5, _("Reads"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(6, _("Writes"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(7, _("Natural"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(8, _("Indexed"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(9, _("Records"), wxLIST_FORMAT_RIGHT);
+    listctrl_statements->InsertColumn(10, _("SQL"));
+
+    text_ctrl_details = new wxTextCtrl(splitter_views, wxID_ANY,
+        wxEmptyString, wxDefaultPosition, wxDefaultSize,
+        wxTE_MULTILINE | wxTE_READONLY | wxTE_DONTWRAP);
+    splitter_views->SplitHorizontally(listctrl_statements, text_ctrl_details);
+    splitter_views->SetSashGravity(0.7);
+
+    log_messages = new LogTextControl(panel_controls);
+    log_messages->SetMinSize(wxSize(-1, 60));
+    static_text_status = new wxStaticText(panel_controls, wxID_ANY,
+        wxEmptyString);
+    button_clear = new wxButton(panel_controls, ID_button_clear, _("C&lear"));
+    button_sessions = new wxButton(panel_controls, ID_button_sessions,
+        _("&Sessions"));
+    button_trace = new wxButton(panel_controls, ID_button_trace,
+        _("Start &Trace"));
+}
+
+void TraceFrame::layoutControls()
+{
+    wxBoxSizer* sizerButtons = new wxBoxSizer(wxHORIZONTAL);
+    sizerButtons->Add(static_text_status, 0, wxALIGN_CENTER_VERTICAL);
+    sizerButtons->Add(styleguide().getUnrelatedControlMargin(wxHORIZONTAL), 0,
+        1, wxEXPAND);
+    sizerButtons->Add(button_clear);
+    sizerButtons->AddSpacer(styleguide().getBetweenButtonsMargin(wxHORIZONTAL));
+    sizerButtons->Add(button_sessions);
+    sizerButtons->AddSpacer(styleguide().getUnrelatedControlMargin(wxHORIZONTAL));
+    sizerButtons->Add(button_trace);
+
+    wxBoxSizer* sizerPanelV = new wxBoxSizer(wxVERTICAL);
+    sizerPanelV->AddSpacer(styleguide().getFrameMargin(wxTOP));
+    sizerPanelV->Add(splitter_views, 1, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getRelatedControlMargin(wxVERTICAL));
+    sizerPanelV->Add(log_messages, 0, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getUnrelatedControlMargin(wxVERTICAL));
+    sizerPanelV->Add(sizerButtons, 0, wxEXPAND);
+    sizerPanelV->AddSpacer(styleguide().getFrameMargin(wxBOTTOM));
+
+    wxBoxSizer* sizerPanelH = new wxBoxSizer(wxHORIZONTAL);
+    sizerPanelH->AddSpacer(styleguide().getFrameMargin(wxLEFT));
+    sizerPanelH->Add(sizerPanelV, 1, wxEXPAND);
+    sizerPanelH->AddSpacer(styleguide().getFrameMargin(wxRIGHT));
+
+    wxBoxSizer* sizerAll = new wxBoxSizer(wxHORIZONTAL);
+    sizerAll->Add(sizerPanelH, 1, wxEXPAND);
+
+    panel_controls->SetSizer(sizerAll);
+    sizerAll->Fit(this);
+    sizerAll->SetSizeHints(this);
+}
+
+void TraceFrame::updateControls()
+{
+    button_sessions->Enable(!isTracing());
+}
+
+DatabasePtr TraceFrame::getDatabase() const
+{
+    return databaseM.lock();
+}
+
+// trace sessions match the database by its file name, which is not
+// known when the database was registered with an alias
+wxString TraceFrame::getDatabaseFileName()
+{
+    DatabasePtr db = getDatabase();
+    if (!db)
+        return wxEmptyString;
+
+    wxString path(db->getPath());
+    try
+    {
+        MetadataLoader* loader = db->getMetadataLoader();
+        MetadataLoaderTransaction tr(loader);
+        IBPP::Statement& st = loader->getStatement(
+            "select mon$database_name from mon$database");
+        st->Execute();
+        if (st->Fetch())
+        {
+            std::string s;
+            st->Get(1, s);
+            path = std2wxIdentifier(s, db->getCharsetConverter());
+        }
+    }
+    catch (IBPP::Exception&)
+    {
+        // no MON$ tables, stick with the registered path
+    }
+    return path.AfterLast('/').AfterLast('\\');
+}
+
+bool TraceFrame::isTracing() const
+{
+    return readerM != 0;
+}
+
+void TraceFrame::startTrace()
+{
+    DatabasePtr database = getDatabase();
+    if (!database)
+    {
+        Close();
+        return;
+    }
+    ServerPtr server = database->getServer();
+    wxCHECK_RET(server, "Cannot trace database without assigned server");
+
+    wxString username;
+    wxString password;
+    if (!getConnectionCredentials(this, database, username, password))
+        return;
+
+    readerFinishedM = false;
+    TraceReaderThread* reader = new TraceReaderThread(this,
+        server->getConnectionString(), username, password,
+        getDatabaseFileName(), timeThresholdM);
+    if (reader->Create() != wxTHREAD_NO_ERROR
+        || reader->Run() != wxTHREAD_NO_ERROR)
+    {
+        delete reader;
+        wxMessageBox(_("Can not start trace reader thread"), _("Error"),
+            wxOK | wxICON_ERROR);
+        return;
+    }
+    readerM = reader;
+    timerM.Start(1000);
+}
+
+void TraceFrame::stopTrace()
+{
+    if (readerM)
+    {
+        readerM->requestStop();
+        button_trace->SetLabel(_("Stopping..."));
+        button_trace->Enable(false);
+    }
+}
+
+void TraceFrame::updateTracingActive()
+{
+    button_trace->Enable(true);
+    if (isTracing())
+        button_trace->SetLabel(_("Stop &Trace"));
+    else
+        button_trace->SetLabel(_("Start &Trace"));
+    updateControls();
+}
+
+void TraceFrame::addMessage(const wxString& message, bool error)
+{
+    wxCriticalSectionLocker locker(statisticsCritsectM);
+    pendingMessagesM.push_back(std::make_pair(message, error));
+}
+
+static wxString formatInt64(int64_t value)
+{
+    return wxString::Format("%" wxLongLongFmtSpec "d", (wxLongLong_t)value);
+}
+
+struct TraceStatsComparer
+{
+    int column;
+    bool ascending;
+
+    static int64_t getValue(const TraceStatementStats& stats, int column)
+    {
+        switch (column)
+        {
+            case 1: return stats.count;
+            case 2: return stats.count ? stats.totalMillis / stats.count : 0;
+            case 3: return stats.maxMillis;
+            case 4: return stats.fetches;
+            case 5: return stats.reads;
+            case 6: return stats.writes;
+            case 7: return stats.naturalReads;
+            case 8: return stats.indexReads;
+            case 9: return stats.records;
+            default: return stats.totalMillis;
+        }
+    }
+
+    bool operator()(const TraceStatementStats& left,
+        const TraceStatementStats& right) const
+    {
+        if (column == 10)
+            return ascending ? left.sql < right.sql : right.sql < left.sql;
+        int64_t l = getValue(left, column);
+        int64_t r = getValue(right, column);
+        return ascending ? l < r : r < l;
+    }
+};
+
+void TraceFrame::sortStatements()
+{
+    TraceStatsComparer comparer = { sortColumnM, sortAscendingM };
+    std::stable_sort(shownM.begin(), shownM.end(), comparer);
+}
+
+void TraceFrame::showStatements()
+{
+    // keep the selection while the list is refilled
+    std::string selectedSql;
+    long item = listctrl_statements->GetNextItem(-1, wxLIST_NEXT_ALL,
+        wxLIST_STATE_SELECTED);
+    if (item != -1)
+        selectedSql = shownM[item].sql;
+
+    sortStatements();
+    listctrl_statements->Freeze();
+    listctrl_statements->DeleteAllItems();
+    for (size_t i = 0; i < shownM.size(); i++)
+    {
+        const TraceStatementStats& stats = shownM[i];
+        item = listctrl_statements->InsertItem(i,
+            formatInt64(stats.totalMillis));
+        for (int col = 1; col < 10; col++)
+        {
+            listctrl_statements->SetItem(item, col,
+                formatInt64(TraceStatsComparer::getValue(stats, col)));
+        }
+        wxString sql(stats.sql.c_str(), *wxConvCurrent);
+        listctrl_statements->SetItem(item, 10, sql.Left(200));
+        if (!selectedSql.empty() && stats.sql == selectedSql)
+        {
+            listctrl_statements->SetItemState(item, wxLIST_STATE_SELECTED,
+                wxLIST_STATE_SELECTED);
+        }
+    }
+    listctrl_statements->Thaw();
+}
+
+void TraceFrame::showDetails()
+{
+    long item = listctrl_statements->GetNextItem(-1, wxLIST_NEXT_ALL,
+        wxLIST_STATE_SELECTED);
+    if (item == -1)
+    {
+        text_ctrl_details->Clear();
+        return;
+    }
+    const TraceStatementStats& stats = shownM[item];
+    text_ctrl_details->SetValue(wxString(stats.sql.c_str(), *wxConvCurrent)
+        + "\n\n" + wxString(stats.plan.c_str(), *wxConvCurrent));
+}
+
+//! closes window if database is removed (unregistered)
+void TraceFrame::subjectRemoved(Subject* subject)
+{
+    DatabasePtr db = getDatabase();
+    if (!db || !db->isConnected() || subject == db.get())
+        Close();
+}
+
+void TraceFrame::update()
+{
+    DatabasePtr db = getDatabase();
+    if (!db || !db->isConnected())
+        Close();
+}
+
+void TraceFrame::doReadConfigSettings(const wxString& prefix)
+{
+    BaseFrame::doReadConfigSettings(prefix);
+    config().getValue(prefix + Config::pathSeparator + "sortcolumn",
+        sortColumnM);
+    config().getValue(prefix + Config::pathSeparator + "sortascending",
+        sortAscendingM);
+}
+
+void TraceFrame::doWriteConfigSettings(const wxString& prefix) const
+{
+    BaseFrame::doWriteConfigSettings(prefix);
+    config().setValue(prefix + Config::pathSeparator + "sortcolumn",
+        sortColumnM);
+    config().setValue(prefix + Config::pathSeparator + "sortascending",
+        sortAscendingM);
+}
+
+const wxString TraceFrame::getName() const
+{
+    return "TraceFrame";
+}
+
+wxString TraceFrame::getFrameId(DatabasePtr db)
+{
+    if (db)
+        return wxString("TraceFrame/" + db->getItemPath());
+    else
+        return wxEmptyString;
+}
+
+TraceFrame* TraceFrame::findFrameFor(DatabasePtr db)
+{
+    BaseFrame* bf = frameFromIdString(getFrameId(db));
+    if (!bf)
+        return 0;
+    return dynamic_cast<TraceFrame*>(bf);
+}
+
+BEGIN_EVENT_TABLE(TraceFrame, wxFrame)
+    EVT_BUTTON(TraceFrame::ID_button_clear, TraceFrame::OnButtonClearClick)
+    EVT_BUTTON(TraceFrame::ID_button_sessions, TraceFrame::OnButtonSessionsClick)
+    EVT_BUTTON(TraceFrame::ID_button_trace, TraceFrame::OnButtonStartStopClick)
+    EVT_LIST_COL_CLICK(TraceFrame::ID_listctrl_statements, TraceFrame::OnListColumnClick)
+    EVT_LIST_ITEM_SELECTED(TraceFrame::ID_listctrl_statements, TraceFrame::OnListSelectionChanged)
+    EVT_LIST_ITEM_DESELECTED(TraceFrame::ID_listctrl_statements, TraceFrame::OnListSelectionChanged)
+    EVT_TIMER(TraceFrame::ID_timer, TraceFrame::OnTimer)
+END_EVENT_TABLE()
+
+void TraceFrame::OnButtonClearClick(wxCommandEvent& WXUNUSED(event))
+{
+    {
+        wxCriticalSectionLocker locker(statisticsCritsectM);
+        statisticsM.clear();
+    }
+    shownM.clear();
+    listctrl_statements->DeleteAllItems();
+    text_ctrl_details->Clear();
+    static_text_status->SetLabel(wxEmptyString);
+}
+
+void TraceFrame::OnButtonSessionsClick(wxCommandEvent& WXUNUSED(event))
+{
+    DatabasePtr database = getDatabase();
+    if (!database || !database->getServer())
+        return;
+    wxString username;
+    wxString password;
+    if (!getConnectionCredentials(this, database, username, password))
+        return;
+
+    wxBusyCursor wait;
+    try
+    {
+        IBPP::Service svc = IBPP::ServiceFactory(
+            wx2std(database->getServer()->getConnectionString()),
+            wx2std(username), wx2std(password));
+        svc->Connect();
+        std::vector<IBPP::TraceSession> sessions;
+        svc->ListTraces(sessions);
+        svc->Disconnect();
+
+        if (sessions.empty())
+            log_messages->logMsg(_("No trace sessions are running") + "\n");
+        for (size_t i = 0; i < sessions.size(); i++)
+        {
+            const IBPP::TraceSession& s = sessions[i];
+            log_messages->logMsg(wxString::Format(
+                _("Session %d \"%s\" of %s, started %s (%s)"), s.id,
+                wxString(s.name).c_str(), wxString(s.user).c_str(),
+                wxString(s.date).c_str(), wxString(s.flags).c_str()) + "\n");
+        }
+    }
+    catch (IBPP::Exception& e)
+    {
+        log_messages->logErrorMsg(wxString(e.what()) + "\n");
+    }
+}
+
+void TraceFrame::OnButtonStartStopClick(wxCommandEvent& WXUNUSED(event))
+{
+    if (isTracing())
+        stopTrace();
+    else
+    {
+        startTrace();
+        updateTracingActive();
+    }
+}
+
+void TraceFrame::OnListColumnClick(wxListEvent& event)
+{
+    int column = event.GetColumn();
+    if (column < 0)
+        return;
+    if (column == sortColumnM)
+        sortAscendingM = !sortAscendingM;
+    else
+    {
+        sortColumnM = column;
+        // the statement text reads best in alphabetical order, for the
+        // counters the biggest values are of interest
+        sortAscendingM = column == 10;
+    }
+    showStatements();
+}
+
+void TraceFrame::OnListSelectionChanged(wxListEvent& WXUNUSED(event))
+{
+    showDetails();
+}
+
+void TraceFrame::OnTimer(wxTimerEvent& WXUNUSED(event))
+{
+    std::vector<std::pair<wxString, bool> > messages;
+    bool finished, changed;
+    int64_t events = 0, dropped = 0;
+    size_t statements = 0;
+    {
+        wxCriticalSectionLocker locker(statisticsCritsectM);
+        messages.swap(pendingMessagesM);
+        finished = readerFinishedM;
+        changed = statisticsM.checkChanged();
+        if (changed)
+        {
+            statisticsM.getTopStatements(shownM, topStatementsM);
+            events = statisticsM.getEventCount();
+            dropped = statisticsM.getDroppedCount();
+            statements = statisticsM.getStatementCount();
+        }
+    }
+
+    for (size_t i = 0; i < messages.size(); i++)
+    {
+        if (messages[i].second)
+            log_messages->logErrorMsg(messages[i].first + "\n");
+        else
+            log_messages->logMsg(messages[i].first + "\n");
+    }
+
+    if (changed)
+    {
+        showStatements();
+        showDetails();
+        wxString status(wxString::Format(
+            _("%s statements executed, %d distinct"),
+            formatInt64(events).c_str(), (int)statements));
+        if (dropped)
+        {
+            status += wxString::Format(_(", %s dropped"),
+                formatInt64(dropped).c_str());
+        }
+        static_text_status->SetLabel(status);
+        panel_controls->Layout();
+    }
+
+    if (finished && readerM)
+    {
+        readerM->Wait();
+        delete readerM;
+        readerM = 0;
+        timerM.Stop();
+        updateTracingActive();
+    }
+}
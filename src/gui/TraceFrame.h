@@ -0,0 +1,135 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef FR_TRACE_FRAME_H
+#define FR_TRACE_FRAME_H
+
+#include <wx/wx.h>
+#include <wx/button.h>
+#include <wx/listctrl.h>
+#include <wx/panel.h>
+#include <wx/splitter.h>
+#include <wx/thread.h>
+
+#include <utility>
+#include <vector>
+
+#include "core/Observer.h"
+#include "engine/TraceParser.h"
+#include "gui/BaseFrame.h"
+#include "metadata/database.h"
+#include "metadata/MetadataClasses.h"
+
+class LogTextControl;
+class TraceReaderThread;
+
+class TraceFrame : public BaseFrame, public Observer
+{
+private:
+    friend class TraceReaderThread;
+
+    DatabaseWeakPtr databaseM;
+    TraceReaderThread* readerM;
+    size_t topStatementsM;
+    int timeThresholdM;
+    // refreshes the statement list from the statistics
+    wxTimer timerM;
+
+    // fed by the reader thread
+    wxCriticalSection statisticsCritsectM;
+    TraceStatistics statisticsM;
+    std::vector<std::pair<wxString, bool> > pendingMessagesM;
+    bool readerFinishedM;
+
+    // what is shown in listctrl_statements, in list order
+    std::vector<TraceStatementStats> shownM;
+    int sortColumnM;
+    bool sortAscendingM;
+
+    wxPanel* panel_controls;
+    wxSplitterWindow* splitter_views;
+    wxListCtrl* listctrl_statements;
+    wxTextCtrl* text_ctrl_details;
+    LogTextControl* log_messages;
+    wxStaticText* static_text_status;
+    wxButton* button_clear;
+    wxButton* button_sessions;
+    wxButton* button_trace;
+    void createControls();
+    void layoutControls();
+    void updateControls();
+
+    static wxString getFrameId(DatabasePtr db);
+
+    DatabasePtr getDatabase() const;
+    wxString getDatabaseFileName();
+    bool isTracing() const;
+    void startTrace();
+    void stopTrace();
+    void updateTracingActive();
+
+    void showStatements();
+    void sortStatements();
+    void showDetails();
+
+    // called by the reader thread
+    void addMessage(const wxString& message, bool error = false);
+
+    // observer stuff
+    virtual void subjectRemoved(Subject* subject);
+    virtual void update();
+
+protected:
+    virtual void doReadConfigSettings(const wxString& prefix);
+    virtual void doWriteConfigSettings(const wxString& prefix) const;
+    virtual const wxString getName() const;
+public:
+    TraceFrame(wxWindow* parent, DatabasePtr db);
+
+    // make sure that the trace session gets stopped
+    virtual bool Destroy();
+
+    static TraceFrame* findFrameFor(DatabasePtr db);
+private:
+    // event handling
+    enum
+    {
+        ID_listctrl_statements = 101,
+        ID_button_clear,
+        ID_button_sessions,
+        ID_button_trace,
+        ID_timer
+    };
+
+    void OnButtonClearClick(wxCommandEvent& event);
+    void OnButtonSessionsClick(wxCommandEvent& event);
+    void OnButtonStartStopClick(wxCommandEvent& event);
+    void OnListColumnClick(wxListEvent& event);
+    void OnListSelectionChanged(wxListEvent& event);
+    void OnTimer(wxTimerEvent& event);
+
+    DECLARE_EVENT_TABLE()
+};
+
+#endif
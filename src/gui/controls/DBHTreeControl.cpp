@@ -162,7 +162,7 @@ class DBHTreeImageList: public wxImageList
 {
 private:
     std::map<wxArtID, int> artIdIndicesM;
-    void addImage(const wxArtID& art);
+    int addImage(const wxArtID& art);
 public:
     DBHTreeImageList();
 
@@ -170,43 +170,11 @@ public:
     int getImageIndex(const wxArtID& id);
 };
 
+// images are loaded when a node first needs them, at startup only the
+// root, server and database images are used
 DBHTreeImageList::DBHTreeImageList()
     : wxImageList(16, 16)
 {
-    addImage(ART_Object);
-    addImage(ART_Column);
-    addImage(ART_Computed);
-    addImage(ART_DatabaseConnected);
-    addImage(ART_DatabaseDisconnected);
-    addImage(ART_Domain);
-    addImage(ART_Domains);
-    addImage(ART_Exception);
-    addImage(ART_Exceptions);
-    addImage(ART_ForeignKey);
-    addImage(ART_Function);
-    addImage(ART_Functions);
-    addImage(ART_Generator);
-    addImage(ART_Generators);
-    addImage(ART_ParameterInput);
-    addImage(ART_ParameterOutput);
-    addImage(ART_PrimaryAndForeignKey);
-    addImage(ART_PrimaryKey);
-    addImage(ART_Procedure);
-    addImage(ART_Procedures);
-    addImage(ART_Role);
-    addImage(ART_Roles);
-    addImage(ART_Root);
-    addImage(ART_Server);
-    addImage(ART_SystemRole);
-    addImage(ART_SystemRoles);
-    addImage(ART_SystemTable);
-    addImage(ART_SystemTables);
-    addImage(ART_Table);
-    addImage(ART_Tables);
-    addImage(ART_Trigger);
-    addImage(ART_Triggers);
-    addImage(ART_View);
-    addImage(ART_Views);
 }
 
 /*static*/ DBHTreeImageList& DBHTreeImageList::get()
@@ -215,14 +183,19 @@ DBHTreeImageList::DBHTreeImageList()
     return til;
 }
 
-void DBHTreeImageList::addImage(const wxArtID& art)
+int DBHTreeImageList::addImage(const wxArtID& art)
 {
+    // missing images are remembered too, so they are looked up only once
+    int index = -1;
     wxBitmap bmp(wxArtProvider::GetBitmap(art, wxART_OTHER, wxSize(16, 16)));
-    if (!bmp.Ok())
-        return;
-    wxIcon icon;
-    icon.CopyFromBitmap(bmp);
-    artIdIndicesM[art] = Add(icon);
+    if (bmp.Ok())
+    {
+        wxIcon icon;
+        icon.CopyFromBitmap(bmp);
+        index = Add(icon);
+    }
+    artIdIndicesM[art] = index;
+    return index;
 }
 
 int DBHTreeImageList::getImageIndex(const wxArtID& id)
@@ -230,7 +203,7 @@ int DBHTreeImageList::getImageIndex(const wxArtID& id)
     std::map<wxArtID, int>::const_iterator it = artIdIndicesM.find(id);
     if (it != artIdIndicesM.end())
         return (*it).second;
-    return -1;
+    return addImage(id);
 }
 
 // DBHTreeItemVisitor class
@@ -247,6 +220,7 @@ private:
     bool showNodeExpanderM;
     bool sortChildrenM;
     bool nodeConfigSensitiveM;
+    bool deferChildrenM;
 
     void setNodeProperties(MetadataItem* metadataItem, const wxArtID& artId);
 protected:
@@ -262,6 +236,7 @@ public:
     bool getShowNodeExpander() { return showNodeExpanderM; }
     bool getSortChildren() { return sortChildrenM; }
     bool isConfigSensitive() { return nodeConfigSensitiveM; }
+    bool getDeferChildren() { return deferChildrenM; }
 
     virtual void visitColumn(Column& column);
     virtual void visitDatabase(Database& database);
@@ -294,7 +269,8 @@ DBHTreeItemVisitor::DBHTreeItemVisitor(DBHTreeControl* tree)
     : MetadataItemVisitor(), treeM(tree), nodeVisibleM(true),
         nodeTextBoldM(false), nodeTextM(), nodeImageIndexM(-1),
         showChildrenM(false), showNodeExpanderM(false),
-        sortChildrenM(false), nodeConfigSensitiveM(false)
+        sortChildrenM(false), nodeConfigSensitiveM(false),
+        deferChildrenM(false)
 {
 }
 
@@ -529,6 +505,8 @@ void DBHTreeItemVisitor::visitServer(Server& server)
     sortChildrenM = DBHTreeConfigCache::get().getSortDatabases();
     // update if settings change (sort databases?)
     nodeConfigSensitiveM = true;
+    // create Database nodes only when the server node is expanded
+    deferChildrenM = true;
 }
 
 void DBHTreeItemVisitor::visitSysTables(SysTables& tables)
@@ -659,6 +637,126 @@ TreeSelectionRestorer::SelectionMap& TreeSelectionRestorer::getSelections()
     return sm;
 }
 
+// DBHTreeSearchIndex class: name index over all nodes of a tree control,
+// including the nodes of collapsed collections
+// prefix searches use the sorted label map, substring searches scan a
+// compact array of character masks and only compare the candidate labels
+class DBHTreeSearchIndex
+{
+private:
+    typedef std::multimap<wxString, DBHTreeItemData*> LabelMap;
+    struct Entry
+    {
+        DBHTreeItemData* item;
+        wxULongLong_t charMask;
+        LabelMap::iterator labelPos;
+    };
+    LabelMap labelsM;
+    std::vector<Entry> entriesM;
+    std::map<DBHTreeItemData*, size_t> positionsM;
+
+    static wxULongLong_t getCharMask(const wxString& text);
+public:
+    void clear();
+    void remove(DBHTreeItemData* item);
+    void update(DBHTreeItemData* item, const wxString& nodeText);
+
+    // searchText must be upper case, return number of matches found
+    size_t findPrefix(const wxString& searchText,
+        std::vector<DBHTreeItemData*>& matches) const;
+    size_t findSubstring(const wxString& searchText,
+        std::vector<DBHTreeItemData*>& matches) const;
+};
+
+/*static*/ wxULongLong_t DBHTreeSearchIndex::getCharMask(const wxString& text)
+{
+    wxULongLong_t mask = 0;
+    for (wxString::const_iterator it = text.begin(); it != text.end(); ++it)
+        mask |= wxULongLong_t(1) << (wxUint32(*it) % 64);
+    return mask;
+}
+
+void DBHTreeSearchIndex::clear()
+{
+    labelsM.clear();
+    entriesM.clear();
+    positionsM.clear();
+}
+
+void DBHTreeSearchIndex::remove(DBHTreeItemData* item)
+{
+    std::map<DBHTreeItemData*, size_t>::iterator pos = positionsM.find(item);
+    if (pos == positionsM.end())
+        return;
+    size_t index = (*pos).second;
+    labelsM.erase(entriesM[index].labelPos);
+    positionsM.erase(pos);
+    // fill the gap with the last entry to keep the array compact
+    if (index != entriesM.size() - 1)
+    {
+        entriesM[index] = entriesM.back();
+        positionsM[entriesM[index].item] = index;
+    }
+    entriesM.pop_back();
+}
+
+void DBHTreeSearchIndex::update(DBHTreeItemData* item,
+    const wxString& nodeText)
+{
+    wxString label(nodeText.Upper());
+    std::map<DBHTreeItemData*, size_t>::iterator pos = positionsM.find(item);
+    if (pos != positionsM.end())
+    {
+        Entry& entry = entriesM[(*pos).second];
+        if ((*entry.labelPos).first == label)
+            return;
+        labelsM.erase(entry.labelPos);
+        entry.labelPos = labelsM.insert(LabelMap::value_type(label, item));
+        entry.charMask = getCharMask(label);
+        return;
+    }
+
+    Entry entry;
+    entry.item = item;
+    entry.charMask = getCharMask(label);
+    entry.labelPos = labelsM.insert(LabelMap::value_type(label, item));
+    positionsM[item] = entriesM.size();
+    entriesM.push_back(entry);
+}
+
+size_t DBHTreeSearchIndex::findPrefix(const wxString& searchText,
+    std::vector<DBHTreeItemData*>& matches) const
+{
+    size_t found = 0;
+    for (LabelMap::const_iterator it = labelsM.lower_bound(searchText);
+        it != labelsM.end() && (*it).first.StartsWith(searchText); ++it)
+    {
+        matches.push_back((*it).second);
+        ++found;
+    }
+    return found;
+}
+
+size_t DBHTreeSearchIndex::findSubstring(const wxString& searchText,
+    std::vector<DBHTreeItemData*>& matches) const
+{
+    wxULongLong_t searchMask = getCharMask(searchText);
+    size_t found = 0;
+    for (std::vector<Entry>::const_iterator it = entriesM.begin();
+        it != entriesM.end(); ++it)
+    {
+        // labels that lack any of the characters can't possibly match
+        if (((*it).charMask & searchMask) != searchMask)
+            continue;
+        if ((*(*it).labelPos).first.find(searchText) != wxString::npos)
+        {
+            matches.push_back((*it).item);
+            ++found;
+        }
+    }
+    return found;
+}
+
 // DBHTreeItem is a special kind of observer, which observes special kind
 // of subjects: MetadataItem instances
 class DBHTreeItemData: public wxTreeItemData, public Observer
@@ -666,19 +764,57 @@ class DBHTreeItemData: public wxTreeItemData, public Observer
 private:
     DBHTreeControl* treeM;
     MetadataItem* observedItemM;
+    unsigned siblingIndexM;
+    bool allowDeferChildrenM;
+    bool childrenDeferredM;
+    void setNodeText(wxTreeItemId id, const wxString& text);
 protected:
     virtual void update();
 public:
     DBHTreeItemData(DBHTreeControl* tree);
+    ~DBHTreeItemData();
 
     wxTreeItemId findSubNode(MetadataItem* item);
     MetadataItem* getObservedMetadata();
     void setObservedMetadata(MetadataItem* item);
+    // position among the visible child nodes of the parent node
+    unsigned getSiblingIndex() { return siblingIndexM; }
+    void setSiblingIndex(unsigned index) { siblingIndexM = index; }
+    // child nodes of collapsed nodes may be deferred until they are needed,
+    // once created they are kept up to date like all other nodes
+    void createDeferredChildren();
 };
 
 DBHTreeItemData::DBHTreeItemData(DBHTreeControl* tree)
-    : Observer(), treeM(tree), observedItemM(0)
+    : Observer(), treeM(tree), observedItemM(0), siblingIndexM(0),
+        allowDeferChildrenM(true), childrenDeferredM(false)
+{
+}
+
+void DBHTreeItemData::createDeferredChildren()
+{
+    allowDeferChildrenM = false;
+    if (childrenDeferredM)
+    {
+        childrenDeferredM = false;
+        treeM->deferredItemsM.erase(this);
+        update();
+    }
+}
+
+DBHTreeItemData::~DBHTreeItemData()
 {
+    treeM->searchIndexM->remove(this);
+    treeM->deferredItemsM.erase(this);
+}
+
+void DBHTreeItemData::setNodeText(wxTreeItemId id, const wxString& text)
+{
+    if (treeM->GetItemText(id) != text)
+        treeM->SetItemText(id, text);
+    DBHTreeItemData* data = (DBHTreeItemData*)treeM->GetItemData(id);
+    if (data)
+        treeM->searchIndexM->update(data, text);
 }
 
 //! returns tree subnode that points to given metadata object
@@ -803,8 +939,7 @@ void DBHTreeItemData::update()
     DBHTreeItemVisitor tivObject(treeM);
     object->loadPendingData();
     object->acceptVisitor(&tivObject);
-    if (treeM->GetItemText(id) != tivObject.getNodeText())
-        treeM->SetItemText(id, tivObject.getNodeText());
+    setNodeText(id, tivObject.getNodeText());
     if (treeM->GetItemImage(id) != tivObject.getNodeImage())
         treeM->SetItemImage(id, tivObject.getNodeImage());
 
@@ -813,6 +948,23 @@ void DBHTreeItemData::update()
     // check subitems
     std::vector<MetadataItem*> children;
     std::vector<MetadataItem*>::iterator itChild;
+
+    // with hundreds of registered databases creating all nodes would delay
+    // the start of the application, so the child nodes of collapsed nodes
+    // are created when the node is expanded or the tree is searched
+    if (tivObject.getShowChildren() && tivObject.getDeferChildren()
+        && allowDeferChildrenM && !treeM->IsExpanded(id)
+        && treeM->GetChildrenCount(id, false) == 0)
+    {
+        childrenDeferredM = true;
+        treeM->deferredItemsM.insert(this);
+        treeM->SetItemHasChildren(id,
+            object->getChildren(children) && !children.empty());
+        treeM->SetItemBold(id, tivObject.getNodeTextBold()
+            || treeM->ItemHasChildren(id));
+        return;
+    }
+
     if (tivObject.getShowChildren())
     {
         if (object->getChildren(children))
@@ -865,6 +1017,7 @@ void DBHTreeItemData::update()
                     // setObservedMetadata() calls attachObserver(), which
                     // calls update() on the newly created child node
                     // this will correctly populate the tree
+                    newItem->setSiblingIndex(numVisibleChildren - 1);
                     newItem->setObservedMetadata(*itChild);
                     // tree node data objects may optionally observe the settings
                     // cache object, for example to create / delete column and
@@ -874,8 +1027,11 @@ void DBHTreeItemData::update()
                 }
                 else
                 {
-                    if (treeM->GetItemText(childId) != tivChild.getNodeText())
-                        treeM->SetItemText(childId, tivChild.getNodeText());
+                    DBHTreeItemData* childData =
+                        (DBHTreeItemData*)treeM->GetItemData(childId);
+                    if (childData)
+                        childData->setSiblingIndex(numVisibleChildren - 1);
+                    setNodeText(childId, tivChild.getNodeText());
                     if (treeM->GetItemImage(childId) != tivChild.getNodeImage())
                         treeM->SetItemImage(childId, tivChild.getNodeImage());
                 }
@@ -1022,12 +1178,15 @@ void DBHTreeControl::OnTreeItemExpanding(wxTreeEvent& event)
     MetadataItem* mi = getMetadataItem(event.GetItem());
     if (mi)
         mi->ensureChildrenLoaded();
+    if (DBHTreeItemData* tid = (DBHTreeItemData*)GetItemData(event.GetItem()))
+        tid->createDeferredChildren();
     event.Skip();
 }
 
 DBHTreeControl::DBHTreeControl(wxWindow* parent, const wxPoint& pos,
         const wxSize& size, long style)
-    : wxTreeCtrl(parent, ID_tree_ctrl, pos, size, style)
+    : wxTreeCtrl(parent, ID_tree_ctrl, pos, size, style),
+        searchIndexM(new DBHTreeSearchIndex())
 {
     allowContextMenuM = true;
 /*  FIXME: dows not play nice with wxGenericImageList...
@@ -1039,6 +1198,14 @@ DBHTreeControl::DBHTreeControl(wxWindow* parent, const wxPoint& pos,
     SetImageList(&DBHTreeImageList::get());
 }
 
+DBHTreeControl::~DBHTreeControl()
+{
+    // item data objects unregister from the search index when deleted,
+    // so this has to happen before the index is gone
+    DeleteAllItems();
+    delete searchIndexM;
+}
+
 void DBHTreeControl::allowContextMenu(bool doAllow)
 {
     allowContextMenuM = doAllow;
@@ -1092,6 +1259,8 @@ bool DBHTreeControl::findMetadataItem(MetadataItem *item, wxTreeItemId parent)
         EnsureVisible(parent);
         return true;
     }
+    if (DBHTreeItemData* tid = (DBHTreeItemData*)GetItemData(parent))
+        tid->createDeferredChildren();
     for (wxTreeItemId node = GetFirstChild(parent, cookie); node.IsOk();
         node = GetNextChild(parent, cookie))
     {
@@ -1106,6 +1275,14 @@ bool DBHTreeControl::selectMetadataItem(MetadataItem* item)
     return item && findMetadataItem(item, GetRootItem());
 }
 
+// creates all deferred child nodes, so that searches can find nodes that
+// haven't been shown yet
+void DBHTreeControl::createDeferredNodes()
+{
+    while (!deferredItemsM.empty())
+        (*deferredItemsM.begin())->createDeferredChildren();
+}
+
 //! recursively get the last child of item
 wxTreeItemId DBHTreeControl::getLastItem(wxTreeItemId id)
 {
@@ -1157,9 +1334,83 @@ wxTreeItemId DBHTreeControl::getNextItem(wxTreeItemId current)
     return temp;
 }
 
+//! returns the sibling indices of item and all its parents, starting at
+//! the root node, comparing two paths gives the vertical order of the items
+void DBHTreeControl::getItemPath(wxTreeItemId item,
+    std::vector<unsigned>& path)
+{
+    path.clear();
+    for (; item.IsOk(); item = GetItemParent(item))
+    {
+        DBHTreeItemData* tid = (DBHTreeItemData*)GetItemData(item);
+        path.push_back(tid ? tid->getSiblingIndex() : 0);
+    }
+    std::reverse(path.begin(), path.end());
+}
+
+//! searches for next node whose text starts with "text", or contains "text"
+//! if no node text starts with it, using the name index of the tree
+//! "text" can contain wildcards: * and ?, those searches walk the tree
+bool DBHTreeControl::findText(const wxString& text, bool forward)
+{
+    createDeferredNodes();
+    if (text.empty() || text.find_first_of("*?") != wxString::npos)
+        return findTextByWalking(text, forward);
+
+    wxString searchText(text.Upper());
+    std::vector<DBHTreeItemData*> matches;
+    if (!searchIndexM->findPrefix(searchText, matches)
+        && !searchIndexM->findSubstring(searchText, matches))
+    {
+        return false;
+    }
+
+    // find the first match at or after the current position in tree
+    // (or at or before it when searching backwards), wrap around otherwise
+    wxTreeItemId start = GetSelection();
+    std::vector<unsigned> startPath, path, bestPath, wrapPath;
+    getItemPath(start, startPath);
+    wxTreeItemId best, wrap;
+    for (std::vector<DBHTreeItemData*>::iterator it = matches.begin();
+        it != matches.end(); ++it)
+    {
+        wxTreeItemId id = (*it)->GetId();
+        if (!id.IsOk())
+            continue;
+        getItemPath(id, path);
+        bool inRange = forward ? !(path < startPath) : !(startPath < path);
+        if (inRange)
+        {
+            if (!best.IsOk() || (forward ? path < bestPath : bestPath < path))
+            {
+                best = id;
+                bestPath.swap(path);
+            }
+        }
+        else if (!best.IsOk())
+        {
+            if (!wrap.IsOk() || (forward ? path < wrapPath : wrapPath < path))
+            {
+                wrap = id;
+                wrapPath.swap(path);
+            }
+        }
+    }
+    if (!best.IsOk())
+        best = wrap;
+    if (!best.IsOk())
+        return false;
+
+    if (best != start)
+        SelectItem(best);
+    // expands all parent nodes as necessary
+    EnsureVisible(best);
+    return true;
+}
+
 //! searches for next node whose text starts with "text"
 //! where "text" can contain wildcards: * and ?
-bool DBHTreeControl::findText(const wxString& text, bool forward)
+bool DBHTreeControl::findTextByWalking(const wxString& text, bool forward)
 {
     wxString searchString = text.Upper() + "*";
     // start from the current position in tree and look forward
@@ -27,15 +27,31 @@
 #include <wx/wx.h>
 #include <wx/treectrl.h>
 
+#include <set>
+#include <vector>
+
+class DBHTreeItemData;
+class DBHTreeSearchIndex;
 class MetadataItem;
 
 class DBHTreeControl: public wxTreeCtrl
 {
 private:
+    friend class DBHTreeItemData;
+
     // recursive function used by selectMetadataItem
     bool findMetadataItem(MetadataItem *item, wxTreeItemId parent);
     bool allowContextMenuM;
 
+    // name index over all tree nodes, maintained by DBHTreeItemData
+    DBHTreeSearchIndex* searchIndexM;
+    void getItemPath(wxTreeItemId item, std::vector<unsigned>& path);
+    // linear search, used for wildcard patterns the index can't handle
+    bool findTextByWalking(const wxString& text, bool forward);
+    // nodes whose child nodes have been deferred until they are needed
+    std::set<DBHTreeItemData*> deferredItemsM;
+    void createDeferredNodes();
+
 protected:
     short m_spacing;    // fix wxWidgets bug (or lack of feature)
 
@@ -69,6 +85,7 @@ public:
 
     DBHTreeControl(wxWindow* parent, const wxPoint& pos = wxDefaultPosition,
         const wxSize& size = wxDefaultSize, long style = wxTR_HAS_BUTTONS);
+    ~DBHTreeControl();
 
     DECLARE_EVENT_TABLE()
 };
@@ -33,10 +33,13 @@
 #include <wx/clipbrd.h>
 #include <wx/fontdlg.h>
 #include <wx/grid.h>
+#include <wx/sstream.h>
 #include <wx/textbuf.h>
 #include <wx/txtstrm.h>
 #include <wx/wfstream.h>
 
+#include <algorithm>
+
 #include "config/Config.h"
 #include "core/FRError.h"
 #include "core/StringUtils.h"
@@ -49,7 +52,8 @@
 #include "metadata/table.h"
 
 DataGrid::DataGrid(wxWindow* parent, wxWindowID id)
-    : wxGrid(parent, id), timerM(this, TIMER_ID), calculateSumM(true)
+    : wxGrid(parent, id), timerM(this, TIMER_ID), calculateSumM(true),
+        idleHandlerConnectedM(false), aggregatedChangeCountM(0)
 {
     // this is necessary for wxWidgets 3.0, otherwise grid will be as wide
     // as the sum of column widths
@@ -164,7 +168,7 @@ void DataGrid::fetchData(bool readonly)
     // event handler is only needed if not all rows have already been
     // fetched
     if (table->canFetchMoreRows())
-        Connect(wxID_ANY, wxEVT_IDLE, wxIdleEventHandler(DataGrid::OnIdle));
+        connectIdleHandler();
 
 #ifdef __WXGTK__
     // needed to make scrollbars show on large datasets
@@ -212,6 +216,7 @@ void DataGrid::showPopupMenu(wxPoint cursorPos)
     m.Append(Cmds::DataGrid_EditBlob, _("Edit BLOB..."));
     m.Append(Cmds::DataGrid_ImportBlob, _("Import BLOB from file..."));
     m.Append(Cmds::DataGrid_ExportBlob, _("Save BLOB to file..."));
+    m.Append(Cmds::DataGrid_ExportBlobs, _("Save selected BLOBs to folder..."));
     m.AppendSeparator();
 
     m.Append(Cmds::DataGrid_SetFieldToNULL, _("Set field to NULL"));
@@ -614,6 +619,43 @@ void DataGrid::saveAsCSV(const wxString& fileName,
         notifyIfUnfetchedData();
 }
 
+unsigned DataGrid::importRowsFromClipboard(const wxString& table,
+    ProgressIndicator* pi)
+{
+    DataGridTable* dgt = getDataGridTable();
+    if (!dgt)
+        return 0;
+
+    wxString text;
+    if (!wxTheClipboard->Open())
+        throw FRError(_("Cannot open clipboard"));
+    if (wxTheClipboard->IsSupported(wxDF_TEXT))
+    {
+        wxTextDataObject data;
+        wxTheClipboard->GetData(data);
+        text = data.GetText();
+    }
+    wxTheClipboard->Close();
+    if (text.empty())
+        throw FRError(_("The clipboard contains no text."));
+
+    wxStringInputStream sis(text);
+    return dgt->importRows(table, sis, pi);
+}
+
+unsigned DataGrid::importRowsFromCSV(const wxString& table,
+    const wxString& fileName, ProgressIndicator* pi)
+{
+    DataGridTable* dgt = getDataGridTable();
+    if (!dgt)
+        return 0;
+
+    wxFileInputStream fis(fileName);
+    if (!fis.IsOk())
+        throw FRError(_("Cannot open file: ") + fileName);
+    return dgt->importRows(table, fis, pi);
+}
+
 void DataGrid::saveAsHTML()
 {
     wxString fname = ::wxFileSelector(_("Save data in selected cells as"),
@@ -868,63 +910,159 @@ void DataGrid::OnGridRangeSelected(wxGridRangeSelectEvent& event)
     event.Skip();
 }
 
+void DataGrid::getSelectedNumericRows(std::map<int, RowRanges>& selection)
+{
+    DataGridTable* table = getDataGridTable();
+    int rows = GetNumberRows();
+    if (!table || !rows)
+        return;
+
+    // fully selected rows are selected in every column
+    RowRanges selRows;
+    wxArrayInt fullRows(GetSelectedRows());
+    for (size_t i = 0; i < fullRows.size(); i++)
+        selRows.push_back(std::make_pair(fullRows[i], fullRows[i]));
+    for (int c = 0; c < GetNumberCols(); c++)
+    {
+        if (table->isNumericColumn(c))
+            selection[c] = selRows;
+    }
+
+    wxArrayInt cols(GetSelectedCols());
+    for (size_t i = 0; i < cols.size(); i++)
+    {
+        std::map<int, RowRanges>::iterator it = selection.find(cols[i]);
+        if (it != selection.end())
+            it->second.push_back(std::make_pair(0, rows - 1));
+    }
+
+    wxGridCellCoordsArray blocksTL(GetSelectionBlockTopLeft());
+    wxGridCellCoordsArray blocksBR(GetSelectionBlockBottomRight());
+    for (size_t i = 0; i < blocksTL.size(); i++)
+    {
+        const wxGridCellCoords& tl = blocksTL[i];
+        const wxGridCellCoords& br = blocksBR[i];
+        for (int c = tl.GetCol(); c <= br.GetCol(); c++)
+        {
+            std::map<int, RowRanges>::iterator it = selection.find(c);
+            if (it != selection.end())
+            {
+                it->second.push_back(std::make_pair(tl.GetRow(),
+                    br.GetRow()));
+            }
+        }
+    }
+
+    wxGridCellCoordsArray cells(GetSelectedCells());
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        const wxGridCellCoords& cell = cells[i];
+        std::map<int, RowRanges>::iterator it = selection.find(cell.GetCol());
+        if (it != selection.end())
+            it->second.push_back(std::make_pair(cell.GetRow(), cell.GetRow()));
+    }
+
+    for (std::map<int, RowRanges>::iterator it = selection.begin();
+        it != selection.end(); )
+    {
+        normalizeRowRanges(it->second);
+        if (it->second.empty())
+            selection.erase(it++);
+        else
+            ++it;
+    }
+}
+
 DEFINE_EVENT_TYPE(wxEVT_FRDG_SUM)
 void DataGrid::OnTimer(wxTimerEvent& WXUNUSED(event))
 {
-    // calculate sum for all selected fields and show in status bar
+    // aggregate all selected numeric fields and show in status bar
     DataGridTable* table = getDataGridTable();
     if (!table || !calculateSumM)
         return;
 
-    double sum = 0;
-    bool any = false;
+    std::map<int, RowRanges> selection;
+    getSelectedNumericRows(selection);
+
+    // if the selection has only grown and no values have been changed, only
+    // the newly selected cells need to be added
+    std::map<int, RowRanges> added;
+    bool grown = table->getChangeCount() == aggregatedChangeCountM;
+    for (std::map<int, RowRanges>::iterator it = aggregatedRowsM.begin();
+        grown && it != aggregatedRowsM.end(); ++it)
+    {
+        std::map<int, RowRanges>::iterator sel = selection.find(it->first);
+        grown = sel != selection.end()
+            && subtractRowRanges(sel->second, it->second, added[it->first]);
+    }
+    if (grown)
+    {
+        for (std::map<int, RowRanges>::iterator it = selection.begin();
+            it != selection.end(); ++it)
+        {
+            if (aggregatedRowsM.find(it->first) == aggregatedRowsM.end())
+                added[it->first] = it->second;
+        }
+    }
+    else
+    {
+        aggregateM.clear();
+        added = selection;
+    }
+    // in case the calculation is aborted
+    aggregatedRowsM.clear();
+
+    // columns are aggregated in chunks of rows, to ask in time whether
+    // a huge calculation should be aborted
+    const int chunkRows = 65536;
     bool alert = true;
-    wxStopWatch sw;;
-    for (int j = 0; j < GetNumberCols(); j++)
+    wxStopWatch sw;
+    for (std::map<int, RowRanges>::iterator it = added.begin();
+        it != added.end(); ++it)
     {
-        if (!table->isNumericColumn(j))
-            continue;
-        for (int i = 0; i < GetNumberRows(); i++)
+        for (size_t i = 0; i < it->second.size(); i++)
         {
-            if (IsInSelection(i, j))
+            const std::pair<int, int>& range = it->second[i];
+            for (int from = range.first; from <= range.second;
+                from += chunkRows)
             {
-                double d;
-                wxString val = table->getCellValue(i, j);
-                if (val.ToDouble(&d))
+                int to = std::min(range.second, from + chunkRows - 1);
+                table->aggregateColumn(it->first, from, to, aggregateM);
+                if (alert && sw.Time() > 4000)
                 {
-                    sum += d;
-                    any = true;
+                    AdvancedMessageDialogButtonsYesNoCancel amb(_("&Abort"),
+                        _("&Disable for this grid"), _("&Continue"));
+                    int res = showQuestionDialog(this,
+                        _("Calculating the sum takes too long"),
+                        _("FlameRobin automatically calculates the sum of selected numeric values. However, the current calculation seems to be taking too long. Would you like to abort it?"),
+                        amb, config(), "DIALOG_DisableGridSum",
+                        _("Do not ask this question again"));
+                    if (res == wxNO)
+                        calculateSumM = false;
+                    if (res == wxYES || res == wxNO)
+                    {
+                        aggregateM.clear();
+                        return;
+                    }
+                    alert = false;
                 }
             }
-            if (alert && sw.Time() > 4000)
-            {
-                AdvancedMessageDialogButtonsYesNoCancel amb(_("&Abort"),
-                    _("&Disable for this grid"), _("&Continue"));
-                int res = showQuestionDialog(this,
-                    _("Calculating the sum takes too long"),
-                    _("FlameRobin automatically calculates the sum of selected numeric values. However, the current calculation seems to be taking too long. Would you like to abort it?"),
-                    amb, config(), "DIALOG_DisableGridSum",
-                    _("Do not ask this question again"));
-                if (res == wxNO)
-                    calculateSumM = false;
-                if (res == wxYES || res == wxNO)
-                    return;
-                alert = false;
-            }
         }
     }
+    aggregatedRowsM.swap(selection);
+    aggregatedChangeCountM = table->getChangeCount();
 
-    if (any)
+    // used in frame to update status bar, an empty string clears it
+    wxCommandEvent evt(wxEVT_FRDG_SUM, GetId());
+    if (aggregateM.getCount())
     {
-        // used in frame to update status bar
-        wxCommandEvent evt(wxEVT_FRDG_SUM, GetId());
-        wxString ss = wxString::Format("Sum: %f", sum);
-        // strip trailing zeroes
-        ss.Truncate(1 + ss.find_last_not_of("0"));
-        ss.Truncate(1 + ss.find_last_not_of("."));
-        evt.SetString(ss);
-        wxPostEvent(this, evt);
+        evt.SetString(wxString::Format(
+            _("Sum: %s  Avg: %s  Min: %s  Max: %s  Count: %d (%d distinct)"),
+            aggregateM.getSum().c_str(), aggregateM.getAverage().c_str(),
+            aggregateM.getMin().c_str(), aggregateM.getMax().c_str(),
+            int(aggregateM.getCount()), int(aggregateM.getDistinctCount())));
     }
+    wxPostEvent(this, evt);
 }
 
 void DataGrid::OnEditorCreated(wxGridEditorCreatedEvent& event)
@@ -998,20 +1136,46 @@ void DataGrid::OnIdle(wxIdleEvent& event)
     DataGridTable* table = getDataGridTable();
     // disconnect event handler if nothing more to be done, will be
     // re-registered on next successfull execution of select statement
-    if (!table || !table->canFetchMoreRows())
+    // or when BLOB cells need to be read
+    if (!table || (!table->canFetchMoreRows()
+        && !table->hasBlobPreviewsQueued()))
     {
         Disconnect(wxID_ANY, wxEVT_IDLE);
+        idleHandlerConnectedM = false;
         return;
     }
     // fetch more rows until row cache is filled or timeslice is spent, and
     // request another wxEVT_IDLE event if row cache has not been filled
-    if (table->needsMoreRowsFetched())
+    if (table->canFetchMoreRows() && table->needsMoreRowsFetched())
     {
         table->fetch();
         if (table->needsMoreRowsFetched())
             event.RequestMore();
         AdjustScrollbars();
     }
+    // BLOB cells are painted with a placeholder, read them in short
+    // timeslices so scrolling doesn't depend on the size of the BLOBs
+    if (table->hasBlobPreviewsQueued())
+    {
+        if (table->loadBlobPreviews(50))
+            ForceRefresh();
+        if (table->hasBlobPreviewsQueued())
+            event.RequestMore();
+    }
+}
+
+void DataGrid::connectIdleHandler()
+{
+    if (!idleHandlerConnectedM)
+    {
+        Connect(wxID_ANY, wxEVT_IDLE, wxIdleEventHandler(DataGrid::OnIdle));
+        idleHandlerConnectedM = true;
+    }
+}
+
+void DataGrid::loadBlobPreviewsOnIdle()
+{
+    connectIdleHandler();
 }
 
 void DataGrid::OnKeyDown(wxKeyEvent& event)
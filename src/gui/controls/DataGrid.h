@@ -28,9 +28,13 @@
 #include <wx/grid.h>
 #include <wx/listimpl.cpp>
 
+#include <map>
 #include <vector>
 
+#include "engine/SelectionAggregate.h"
+
 class DataGridTable;
+class ProgressIndicator;
 
 BEGIN_DECLARE_EVENT_TYPES()
     // this event is sent when selection is changed and values are summed up
@@ -43,9 +47,19 @@ private:
     wxTimer timerM;
     enum { TIMER_ID = 3333 };
     bool calculateSumM;
+    bool idleHandlerConnectedM;
+
+    // the numeric values of the selection, with the rows of each column
+    // they have been added for, so that a growing selection only needs
+    // the values of the new cells added
+    SelectionAggregate aggregateM;
+    std::map<int, RowRanges> aggregatedRowsM;
+    unsigned aggregatedChangeCountM;
+    void getSelectedNumericRows(std::map<int, RowRanges>& selection);
 
     void copyToClipboard(const wxString cbText);
     void extendSelection(int direction);
+    void connectIdleHandler();
     void notifyIfUnfetchedData();
     void showPopupMenu(wxPoint cursorPos);
     void updateRowHeights();
@@ -55,6 +69,7 @@ public:
 
     DataGridTable* getDataGridTable();
     void fetchData(bool readonly);
+    void loadBlobPreviewsOnIdle();
 private:
     void OnContextMenu(wxContextMenuEvent& event);
     void OnGridCellRightClick(wxGridEvent& event);
@@ -77,6 +92,11 @@ public:
     void saveAsHTML();
     void saveAsCSV(const wxString& fileName,
         const wxChar& fieldDelimiter, const wxChar& textDelimiter);
+    // insert delimited text as new rows of table, return the row count
+    unsigned importRowsFromClipboard(const wxString& table,
+        ProgressIndicator* pi = 0);
+    unsigned importRowsFromCSV(const wxString& table,
+        const wxString& fileName, ProgressIndicator* pi = 0);
 
     void refreshAndInvalidateAttributes();
     void setHeaderFont();
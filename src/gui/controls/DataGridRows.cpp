@@ -31,11 +31,16 @@
 #endif
 
 #include <wx/datetime.h>
-#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/stopwatch.h>
 #include <wx/textbuf.h>
 
 #include <algorithm>
 #include <bitset>
+#include <cstdlib>
+#include <iomanip>
+#include <locale>
+#include <sstream>
 #include <string>
 
 #include "config/Config.h"
@@ -43,6 +48,8 @@
 #include "core/Observer.h"
 #include "core/ProgressIndicator.h"
 #include "core/StringUtils.h"
+#include "engine/BlobTransfer.h"
+#include "engine/SelectionAggregate.h"
 #include "gui/controls/DataGridRowBuffer.h"
 #include "gui/controls/DataGridRows.h"
 #include "metadata/column.h"
@@ -485,12 +492,31 @@ ResultsetColumnDef::~ResultsetColumnDef()
 {
 }
 
+wxString ResultsetColumnDef::getAsComparableString(DataGridRowBuffer* buffer)
+{
+    return getAsString(buffer);
+}
+
 // needed to avoid strange date&time formatting if such column is PK/UNQ
 wxString ResultsetColumnDef::getAsFirebirdString(DataGridRowBuffer* buffer)
 {
     return getAsString(buffer);
 }
 
+void ResultsetColumnDef::setValueFromView(DataGridRowBuffer* buffer,
+    unsigned col, const IBPP::ColumnView& /*view*/,
+    const IBPP::Statement& statement, wxMBConv* converter)
+{
+    setValue(buffer, col, statement, converter);
+}
+
+void ResultsetColumnDef::setParameter(DataGridRowBuffer* /*buffer*/,
+    IBPP::Statement& /*statement*/, unsigned /*param*/,
+    wxMBConv* /*converter*/)
+{
+    throw FRError(_("This column can not be used as a statement parameter."));
+}
+
 wxString ResultsetColumnDef::getName()
 {
     return nameM;
@@ -506,6 +532,12 @@ bool ResultsetColumnDef::isNumeric()
     return false;
 }
 
+bool ResultsetColumnDef::addToAggregate(DataGridRowBuffer* /*buffer*/,
+    SelectionAggregate& /*aggregate*/)
+{
+    return false;
+}
+
 bool ResultsetColumnDef::isReadOnly()
 {
     return readOnlyM;
@@ -565,8 +597,15 @@ public:
     virtual wxString getAsString(DataGridRowBuffer* buffer);
     virtual unsigned getBufferSize();
     virtual bool isNumeric();
+    virtual bool addToAggregate(DataGridRowBuffer* buffer,
+        SelectionAggregate& aggregate);
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter);
+    virtual void setValueFromView(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::ColumnView& view, const IBPP::Statement& statement,
+        wxMBConv* converter);
+    virtual void setParameter(DataGridRowBuffer* buffer,
+        IBPP::Statement& statement, unsigned param, wxMBConv* converter);
     virtual void setFromString(DataGridRowBuffer* buffer,
         const wxString& source);
 };
@@ -606,6 +645,17 @@ bool IntegerColumnDef::isNumeric()
     return true;
 }
 
+bool IntegerColumnDef::addToAggregate(DataGridRowBuffer* buffer,
+    SelectionAggregate& aggregate)
+{
+    wxASSERT(buffer);
+    int value;
+    if (!buffer->getValue(offsetM, value))
+        return false;
+    aggregate.add(int64_t(value));
+    return true;
+}
+
 void IntegerColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     const IBPP::Statement& statement, wxMBConv*)
 {
@@ -615,6 +665,22 @@ void IntegerColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     buffer->setValue(offsetM, value);
 }
 
+void IntegerColumnDef::setValueFromView(DataGridRowBuffer* buffer, unsigned,
+    const IBPP::ColumnView& view, const IBPP::Statement&, wxMBConv*)
+{
+    wxASSERT(buffer);
+    buffer->setValue(offsetM, int(view.AsInt64()));
+}
+
+void IntegerColumnDef::setParameter(DataGridRowBuffer* buffer,
+    IBPP::Statement& statement, unsigned param, wxMBConv*)
+{
+    wxASSERT(buffer);
+    int value;
+    buffer->getValue(offsetM, value);
+    statement->Set(param, int32_t(value));
+}
+
 // Int64ColumnDef class
 class Int64ColumnDef : public ResultsetColumnDef
 {
@@ -626,8 +692,15 @@ public:
     virtual wxString getAsString(DataGridRowBuffer* buffer);
     virtual unsigned getBufferSize();
     virtual bool isNumeric();
+    virtual bool addToAggregate(DataGridRowBuffer* buffer,
+        SelectionAggregate& aggregate);
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter);
+    virtual void setValueFromView(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::ColumnView& view, const IBPP::Statement& statement,
+        wxMBConv* converter);
+    virtual void setParameter(DataGridRowBuffer* buffer,
+        IBPP::Statement& statement, unsigned param, wxMBConv* converter);
     virtual void setFromString(DataGridRowBuffer* buffer,
         const wxString& source);
 };
@@ -676,6 +749,17 @@ bool Int64ColumnDef::isNumeric()
     return true;
 }
 
+bool Int64ColumnDef::addToAggregate(DataGridRowBuffer* buffer,
+    SelectionAggregate& aggregate)
+{
+    wxASSERT(buffer);
+    int64_t value;
+    if (!buffer->getValue(offsetM, value))
+        return false;
+    aggregate.add(value);
+    return true;
+}
+
 void Int64ColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     const IBPP::Statement& statement, wxMBConv*)
 {
@@ -685,6 +769,22 @@ void Int64ColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     buffer->setValue(offsetM, value);
 }
 
+void Int64ColumnDef::setValueFromView(DataGridRowBuffer* buffer, unsigned,
+    const IBPP::ColumnView& view, const IBPP::Statement&, wxMBConv*)
+{
+    wxASSERT(buffer);
+    buffer->setValue(offsetM, view.AsInt64());
+}
+
+void Int64ColumnDef::setParameter(DataGridRowBuffer* buffer,
+    IBPP::Statement& statement, unsigned param, wxMBConv*)
+{
+    wxASSERT(buffer);
+    int64_t value;
+    buffer->getValue(offsetM, value);
+    statement->Set(param, value);
+}
+
 // DBKeyColumnDef class
 class DBKeyColumnDef : public ResultsetColumnDef
 {
@@ -698,6 +798,8 @@ public:
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter);
+    virtual void setParameter(DataGridRowBuffer* buffer,
+        IBPP::Statement& statement, unsigned param, wxMBConv* converter);
     virtual void setFromString(DataGridRowBuffer* buffer,
         const wxString& source);
     void getDBKey(IBPP::DBKey& dbkey, DataGridRowBuffer* buffer);
@@ -750,6 +852,15 @@ void DBKeyColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     buffer->setValue(offsetM, value);
 }
 
+void DBKeyColumnDef::setParameter(DataGridRowBuffer* buffer,
+    IBPP::Statement& statement, unsigned param, wxMBConv*)
+{
+    wxASSERT(buffer);
+    IBPP::DBKey value;
+    getDBKey(value, buffer);
+    statement->Set(param, value);
+}
+
 void DBKeyColumnDef::getDBKey(IBPP::DBKey& dbkey, DataGridRowBuffer* buffer)
 {
     wxASSERT(buffer);
@@ -764,11 +875,17 @@ private:
 public:
     DateColumnDef(const wxString& name, unsigned offset, bool readOnly,
         bool nullable);
+    virtual wxString getAsComparableString(DataGridRowBuffer* buffer);
     virtual wxString getAsFirebirdString(DataGridRowBuffer* buffer);
     virtual wxString getAsString(DataGridRowBuffer* buffer);
     virtual unsigned getBufferSize();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter);
+    virtual void setValueFromView(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::ColumnView& view, const IBPP::Statement& statement,
+        wxMBConv* converter);
+    virtual void setParameter(DataGridRowBuffer* buffer,
+        IBPP::Statement& statement, unsigned param, wxMBConv* converter);
     virtual void setFromString(DataGridRowBuffer* buffer,
         const wxString& source);
 };
@@ -792,6 +909,19 @@ wxString DateColumnDef::getAsString(DataGridRowBuffer* buffer)
     return GridCellFormats::get().formatDate(year, month, day);
 }
 
+wxString DateColumnDef::getAsComparableString(DataGridRowBuffer* buffer)
+{
+    wxASSERT(buffer);
+    int value;
+    if (!buffer->getValue(offsetM, value))
+        return wxEmptyString;
+
+    IBPP::Date date(value);
+    int year, month, day;
+    date.GetDate(year, month, day);
+    return wxString::Format("%04d-%02d-%02d", year, month, day);
+}
+
 wxString DateColumnDef::getAsFirebirdString(DataGridRowBuffer* buffer)
 {
     wxASSERT(buffer);
@@ -848,6 +978,24 @@ void DateColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     buffer->setValue(offsetM, value.GetDate());
 }
 
+void DateColumnDef::setValueFromView(DataGridRowBuffer* buffer, unsigned,
+    const IBPP::ColumnView& view, const IBPP::Statement&, wxMBConv*)
+{
+    wxASSERT(buffer);
+    IBPP::Date value;
+    view.GetDate(value);
+    buffer->setValue(offsetM, value.GetDate());
+}
+
+void DateColumnDef::setParameter(DataGridRowBuffer* buffer,
+    IBPP::Statement& statement, unsigned param, wxMBConv*)
+{
+    wxASSERT(buffer);
+    int value;
+    buffer->getValue(offsetM, value);
+    statement->Set(param, IBPP::Date(value));
+}
+
 // TimeColumnDef class
 class TimeColumnDef : public ResultsetColumnDef
 {
@@ -856,11 +1004,17 @@ private:
 public:
     TimeColumnDef(const wxString& name, unsigned offset, bool readOnly,
         bool nullable);
+    virtual wxString getAsComparableString(DataGridRowBuffer* buffer);
     virtual wxString getAsFirebirdString(DataGridRowBuffer* buffer);
     virtual wxString getAsString(DataGridRowBuffer* buffer);
     virtual unsigned getBufferSize();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter);
+    virtual void setValueFromView(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::ColumnView& view, const IBPP::Statement& statement,
+        wxMBConv* converter);
+    virtual void setParameter(DataGridRowBuffer* buffer,
+        IBPP::Statement& statement, unsigned param, wxMBConv* converter);
     virtual void setFromString(DataGridRowBuffer* buffer,
         const wxString& source);
 };
@@ -885,6 +1039,20 @@ wxString TimeColumnDef::getAsString(DataGridRowBuffer* buffer)
         tenththousands / 10);
 }
 
+wxString TimeColumnDef::getAsComparableString(DataGridRowBuffer* buffer)
+{
+    wxASSERT(buffer);
+    int value;
+    if (!buffer->getValue(offsetM, value))
+        return wxEmptyString;
+
+    IBPP::Time time(value);
+    int hour, minute, second, tenththousands;
+    time.GetTime(hour, minute, second, tenththousands);
+    return wxString::Format("%02d:%02d:%02d.%04d", hour, minute, second,
+        tenththousands);
+}
+
 wxString TimeColumnDef::getAsFirebirdString(DataGridRowBuffer* buffer)
 {
     wxASSERT(buffer);
@@ -934,6 +1102,24 @@ void TimeColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     buffer->setValue(offsetM, value.GetTime());
 }
 
+void TimeColumnDef::setValueFromView(DataGridRowBuffer* buffer, unsigned,
+    const IBPP::ColumnView& view, const IBPP::Statement&, wxMBConv*)
+{
+    wxASSERT(buffer);
+    IBPP::Time value;
+    view.GetTime(value);
+    buffer->setValue(offsetM, value.GetTime());
+}
+
+void TimeColumnDef::setParameter(DataGridRowBuffer* buffer,
+    IBPP::Statement& statement, unsigned param, wxMBConv*)
+{
+    wxASSERT(buffer);
+    int value;
+    buffer->getValue(offsetM, value);
+    statement->Set(param, IBPP::Time(value));
+}
+
 // TimestampColumnDef class
 class TimestampColumnDef : public ResultsetColumnDef
 {
@@ -942,11 +1128,17 @@ private:
 public:
     TimestampColumnDef(const wxString& name, unsigned offset, bool readOnly,
         bool nullable);
+    virtual wxString getAsComparableString(DataGridRowBuffer* buffer);
     virtual wxString getAsFirebirdString(DataGridRowBuffer* buffer);
     virtual wxString getAsString(DataGridRowBuffer* buffer);
     virtual unsigned getBufferSize();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter);
+    virtual void setValueFromView(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::ColumnView& view, const IBPP::Statement& statement,
+        wxMBConv* converter);
+    virtual void setParameter(DataGridRowBuffer* buffer,
+        IBPP::Statement& statement, unsigned param, wxMBConv* converter);
     virtual void setFromString(DataGridRowBuffer* buffer,
         const wxString& source);
 };
@@ -977,6 +1169,25 @@ wxString TimestampColumnDef::getAsString(DataGridRowBuffer* buffer)
         hour, minute, second, tenththousands / 10);
 }
 
+wxString TimestampColumnDef::getAsComparableString(DataGridRowBuffer* buffer)
+{
+    wxASSERT(buffer);
+    int dateValue, timeValue;
+    if (!buffer->getValue(offsetM, dateValue)
+        || !buffer->getValue(offsetM + sizeof(int), timeValue))
+    {
+        return wxEmptyString;
+    }
+    IBPP::Date date(dateValue);
+    IBPP::Time time(timeValue);
+
+    int year, month, day, hour, minute, second, tenththousands;
+    date.GetDate(year, month, day);
+    time.GetTime(hour, minute, second, tenththousands);
+    return wxString::Format("%04d-%02d-%02d %02d:%02d:%02d.%04d", year,
+        month, day, hour, minute, second, tenththousands);
+}
+
 wxString TimestampColumnDef::getAsFirebirdString(DataGridRowBuffer* buffer)
 {
     wxASSERT(buffer);
@@ -1051,132 +1262,885 @@ void TimestampColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     buffer->setValue(offsetM + sizeof(int), value.GetTime());
 }
 
-// FloatColumnDef class
-class FloatColumnDef : public ResultsetColumnDef
+void TimestampColumnDef::setValueFromView(DataGridRowBuffer* buffer, unsigned,
+    const IBPP::ColumnView& view, const IBPP::Statement&, wxMBConv*)
+{
+    wxASSERT(buffer);
+    IBPP::Timestamp value;
+    view.GetTimestamp(value);
+    buffer->setValue(offsetM, value.GetDate());
+    buffer->setValue(offsetM + sizeof(int), value.GetTime());
+}
+
+void TimestampColumnDef::setParameter(DataGridRowBuffer* buffer,
+    IBPP::Statement& statement, unsigned param, wxMBConv*)
+{
+    wxASSERT(buffer);
+    int date, time;
+    buffer->getValue(offsetM, date);
+    buffer->getValue(offsetM + sizeof(int), time);
+    IBPP::Timestamp value(IBPP::Date(date));
+    value.SetTime(time);
+    statement->Set(param, value);
+}
+
+// TimeTzColumnDef class
+// Firebird v4 TIME WITH TIME ZONE, the local time followed by the offset
+// from UTC in minutes
+class TimeTzColumnDef : public ResultsetColumnDef
 {
 private:
     unsigned offsetM;
 public:
-    FloatColumnDef(const wxString& name, unsigned offset, bool readOnly,
+    TimeTzColumnDef(const wxString& name, unsigned offset, bool readOnly,
         bool nullable);
+    virtual wxString getAsComparableString(DataGridRowBuffer* buffer);
+    virtual wxString getAsFirebirdString(DataGridRowBuffer* buffer);
     virtual wxString getAsString(DataGridRowBuffer* buffer);
     virtual unsigned getBufferSize();
-    virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter);
+    virtual void setValueFromView(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::ColumnView& view, const IBPP::Statement& statement,
+        wxMBConv* converter);
+    virtual void setParameter(DataGridRowBuffer* buffer,
+        IBPP::Statement& statement, unsigned param, wxMBConv* converter);
     virtual void setFromString(DataGridRowBuffer* buffer,
         const wxString& source);
 };
 
-FloatColumnDef::FloatColumnDef(const wxString& name, unsigned offset,
-        bool readOnly, bool nullable)
+// formats the offset from UTC as +hh:mm
+static wxString formatTimezoneOffset(int offset)
+{
+    if (offset == IBPP::NoTimezone)
+        return wxEmptyString;
+    char sign = offset < 0 ? '-' : '+';
+    if (offset < 0)
+        offset = -offset;
+    return wxString::Format(" %c%02d:%02d", sign, offset / 60, offset % 60);
+}
+
+// removes a trailing +hh:mm or -hh:mm from text, returns false if there
+// is none
+static bool extractTimezoneOffset(wxString& text, int& offset)
+{
+    size_t pos = text.find_last_of("+-");
+    if (pos == wxString::npos || pos == 0)
+        return false;
+    // a minus sign not preceded by a blank separates the parts of a date
+    if (text[pos] == '-' && text[pos - 1] != ' ')
+        return false;
+
+    wxString offsetText(text.Mid(pos + 1));
+    wxString hours(offsetText.BeforeFirst(':'));
+    wxString minutes(offsetText.AfterFirst(':'));
+    long h, m = 0;
+    if (!hours.ToLong(&h) || h < 0 || h > 14
+        || (!minutes.empty() && (!minutes.ToLong(&m) || m < 0 || m > 59)))
+    {
+        throw FRError(_("Cannot parse time zone offset"));
+    }
+    offset = int(h * 60 + m);
+    if (text[pos] == '-')
+        offset = -offset;
+    text.Truncate(pos);
+    text.Trim(true);
+    return true;
+}
+
+TimeTzColumnDef::TimeTzColumnDef(const wxString& name, unsigned offset,
+    bool readOnly, bool nullable)
     : ResultsetColumnDef(name, readOnly, nullable), offsetM(offset)
 {
 }
 
-wxString FloatColumnDef::getAsString(DataGridRowBuffer* buffer)
+wxString TimeTzColumnDef::getAsString(DataGridRowBuffer* buffer)
 {
     wxASSERT(buffer);
-    float value;
-    if (!buffer->getValue(offsetM, value))
+    int value, tz;
+    if (!buffer->getValue(offsetM, value)
+        || !buffer->getValue(offsetM + sizeof(int), tz))
+    {
         return wxEmptyString;
+    }
 
-    return GridCellFormats::get().format<float>(value);
+    IBPP::Time time(value);
+    int hour, minute, second, tenththousands;
+    time.GetTime(hour, minute, second, tenththousands);
+    return GridCellFormats::get().formatTime(hour, minute, second,
+        tenththousands / 10) + formatTimezoneOffset(tz);
 }
 
-void FloatColumnDef::setFromString(DataGridRowBuffer* buffer,
-    const wxString& source)
+wxString TimeTzColumnDef::getAsComparableString(DataGridRowBuffer* buffer)
 {
     wxASSERT(buffer);
-    double d;
-    if (!source.ToDouble(&d))
-        throw FRError(_("Invalid float numeric value"));
-    buffer->setValue(offsetM, (float)d);
+    int value, tz;
+    if (!buffer->getValue(offsetM, value)
+        || !buffer->getValue(offsetM + sizeof(int), tz))
+    {
+        return wxEmptyString;
+    }
+
+    IBPP::Time time(value);
+    int hour, minute, second, tenththousands;
+    time.GetTime(hour, minute, second, tenththousands);
+    return wxString::Format("%02d:%02d:%02d.%04d", hour, minute, second,
+        tenththousands) + formatTimezoneOffset(tz);
 }
 
-unsigned FloatColumnDef::getBufferSize()
+wxString TimeTzColumnDef::getAsFirebirdString(DataGridRowBuffer* buffer)
 {
-    return sizeof(float);
+    wxASSERT(buffer);
+    int value, tz;
+    if (!buffer->getValue(offsetM, value)
+        || !buffer->getValue(offsetM + sizeof(int), tz))
+    {
+        return wxEmptyString;
+    }
+
+    IBPP::Time time(value);
+    int hour, minute, second, tenththousands;
+    time.GetTime(hour, minute, second, tenththousands);
+    return wxString::Format("%d:%d:%d.%d", hour, minute, second,
+        tenththousands / 10) + formatTimezoneOffset(tz);
 }
 
-bool FloatColumnDef::isNumeric()
+void TimeTzColumnDef::setFromString(DataGridRowBuffer* buffer,
+    const wxString& source)
 {
-    return true;
+    wxASSERT(buffer);
+    IBPP::Time itm;
+    itm.Now();
+
+    wxString temp(source);
+    temp.Trim(true).Trim(false);
+
+    // without an explicit offset the one of the old value is kept
+    int tz;
+    if (!extractTimezoneOffset(temp, tz)
+        && (!buffer->getValue(offsetM + sizeof(int), tz)
+            || tz == IBPP::NoTimezone))
+    {
+        tz = 0;
+    }
+
+    if (temp.CmpNoCase("TIME") != 0 && temp.CmpNoCase("NOW") != 0)
+    {
+        wxString::iterator it = temp.begin();
+        int hr = 0, mn = 0, sc = 0, ms = 0;
+        if (!GridCellFormats::get().parseTime(it, temp.end(), hr, mn, sc, ms))
+            throw FRError(_("Cannot parse time"));
+        itm.SetTime(hr, mn, sc, 10 * ms);
+    }
+    buffer->setValue(offsetM, itm.GetTime());
+    buffer->setValue(offsetM + sizeof(int), tz);
 }
 
-void FloatColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
+unsigned TimeTzColumnDef::getBufferSize()
+{
+    return 2 * sizeof(int);
+}
+
+void TimeTzColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     const IBPP::Statement& statement, wxMBConv*)
 {
     wxASSERT(buffer);
-    float value;
+    IBPP::Time value;
     statement->Get(col, value);
-    buffer->setValue(offsetM, value);
+    buffer->setValue(offsetM, value.GetTime());
+    buffer->setValue(offsetM + sizeof(int), value.Timezone());
 }
 
-// DoubleColumnDef class
-class DoubleColumnDef : public ResultsetColumnDef
+void TimeTzColumnDef::setValueFromView(DataGridRowBuffer* buffer, unsigned,
+    const IBPP::ColumnView& view, const IBPP::Statement&, wxMBConv*)
+{
+    wxASSERT(buffer);
+    IBPP::Time value;
+    view.GetTime(value);
+    buffer->setValue(offsetM, value.GetTime());
+    buffer->setValue(offsetM + sizeof(int), value.Timezone());
+}
+
+void TimeTzColumnDef::setParameter(DataGridRowBuffer* buffer,
+    IBPP::Statement& statement, unsigned param, wxMBConv*)
+{
+    wxASSERT(buffer);
+    int time, tz;
+    buffer->getValue(offsetM, time);
+    buffer->getValue(offsetM + sizeof(int), tz);
+    IBPP::Time value(time);
+    value.SetTimezone(tz);
+    statement->Set(param, value);
+}
+
+// TimestampTzColumnDef class
+// Firebird v4 TIMESTAMP WITH TIME ZONE, the local date and time followed
+// by the offset from UTC in minutes
+class TimestampTzColumnDef : public ResultsetColumnDef
 {
 private:
     unsigned offsetM;
-    short scaleM;
 public:
-    DoubleColumnDef(const wxString& name, unsigned offset, bool readOnly,
-        bool nullable, short scale);
+    TimestampTzColumnDef(const wxString& name, unsigned offset,
+        bool readOnly, bool nullable);
+    virtual wxString getAsComparableString(DataGridRowBuffer* buffer);
+    virtual wxString getAsFirebirdString(DataGridRowBuffer* buffer);
     virtual wxString getAsString(DataGridRowBuffer* buffer);
     virtual unsigned getBufferSize();
-    virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter);
+    virtual void setValueFromView(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::ColumnView& view, const IBPP::Statement& statement,
+        wxMBConv* converter);
+    virtual void setParameter(DataGridRowBuffer* buffer,
+        IBPP::Statement& statement, unsigned param, wxMBConv* converter);
     virtual void setFromString(DataGridRowBuffer* buffer,
         const wxString& source);
 };
 
-DoubleColumnDef::DoubleColumnDef(const wxString& name, unsigned offset,
-        bool readOnly, bool nullable, short scale)
-    : ResultsetColumnDef(name, readOnly, nullable), offsetM(offset),
-        scaleM(scale)
+TimestampTzColumnDef::TimestampTzColumnDef(const wxString& name,
+    unsigned offset, bool readOnly, bool nullable)
+    : ResultsetColumnDef(name, readOnly, nullable), offsetM(offset)
 {
 }
 
-wxString DoubleColumnDef::getAsString(DataGridRowBuffer* buffer)
+wxString TimestampTzColumnDef::getAsString(DataGridRowBuffer* buffer)
 {
     wxASSERT(buffer);
-    double value;
-    if (!buffer->getValue(offsetM, value))
+    int dateValue, timeValue, tz;
+    if (!buffer->getValue(offsetM, dateValue)
+        || !buffer->getValue(offsetM + sizeof(int), timeValue)
+        || !buffer->getValue(offsetM + 2 * sizeof(int), tz))
+    {
         return wxEmptyString;
+    }
+    IBPP::Date date(dateValue);
+    IBPP::Time time(timeValue);
 
-    if (scaleM)
-        return wxString::Format("%.*f", scaleM, value);
-    return GridCellFormats::get().format<double>(value);
+    int year, month, day, hour, minute, second, tenththousands;
+    date.GetDate(year, month, day);
+    time.GetTime(hour, minute, second, tenththousands);
+
+    return GridCellFormats::get().formatTimestamp(year, month, day,
+        hour, minute, second, tenththousands / 10)
+        + formatTimezoneOffset(tz);
 }
 
-void DoubleColumnDef::setFromString(DataGridRowBuffer* buffer,
-    const wxString& source)
+wxString TimestampTzColumnDef::getAsComparableString(
+    DataGridRowBuffer* buffer)
 {
     wxASSERT(buffer);
-    double d;
-    if (!source.ToDouble(&d))
-        throw FRError(_("Invalid double numeric value"));
-    buffer->setValue(offsetM, d);
+    int dateValue, timeValue, tz;
+    if (!buffer->getValue(offsetM, dateValue)
+        || !buffer->getValue(offsetM + sizeof(int), timeValue)
+        || !buffer->getValue(offsetM + 2 * sizeof(int), tz))
+    {
+        return wxEmptyString;
+    }
+    IBPP::Date date(dateValue);
+    IBPP::Time time(timeValue);
+
+    int year, month, day, hour, minute, second, tenththousands;
+    date.GetDate(year, month, day);
+    time.GetTime(hour, minute, second, tenththousands);
+    return wxString::Format("%04d-%02d-%02d %02d:%02d:%02d.%04d", year,
+        month, day, hour, minute, second, tenththousands)
+        + formatTimezoneOffset(tz);
 }
 
-unsigned DoubleColumnDef::getBufferSize()
+wxString TimestampTzColumnDef::getAsFirebirdString(DataGridRowBuffer* buffer)
+{
+    wxASSERT(buffer);
+    int dateValue, timeValue, tz;
+    if (!buffer->getValue(offsetM, dateValue)
+        || !buffer->getValue(offsetM + sizeof(int), timeValue)
+        || !buffer->getValue(offsetM + 2 * sizeof(int), tz))
+    {
+        return wxEmptyString;
+    }
+    IBPP::Date date(dateValue);
+    IBPP::Time time(timeValue);
+
+    int year, month, day, hour, minute, second, tenththousands;
+    date.GetDate(year, month, day);
+    time.GetTime(hour, minute, second, tenththousands);
+
+    return wxString::Format("%d-%d-%d %d:%d:%d.%d", year, month, day,
+        hour, minute, second, tenththousands / 10)
+        + formatTimezoneOffset(tz);
+}
+
+void TimestampTzColumnDef::setFromString(DataGridRowBuffer* buffer,
+        const wxString& source)
+{
+    wxASSERT(buffer);
+    IBPP::Timestamp its;
+    its.Today(); // defaults to no time
+
+    wxString temp(source);
+    temp.Trim(true).Trim(false);
+
+    // without an explicit offset the one of the old value is kept
+    int tz;
+    if (!extractTimezoneOffset(temp, tz)
+        && (!buffer->getValue(offsetM + 2 * sizeof(int), tz)
+            || tz == IBPP::NoTimezone))
+    {
+        tz = 0;
+    }
+
+    if (temp.CmpNoCase("TOMORROW") == 0)
+        its.Add(1);
+    else if (temp.CmpNoCase("YESTERDAY") == 0)
+        its.Add(-1);
+    else if (temp.CmpNoCase("NOW") == 0)
+        its.Now(); // with time
+    else if (temp.CmpNoCase("DATE") != 0
+        && temp.CmpNoCase("TODAY") != 0)
+    {
+        int y = its.Year();  // defaults
+        int m = its.Month();
+        int d = its.Day();
+        int hr = 0, mn = 0, sc = 0, ms = 0;
+        wxString::iterator it = temp.begin();
+        if (!GridCellFormats::get().parseTimestamp(it, temp.end(),
+            y, m, d, hr, mn, sc, ms))
+        {
+            throw FRError(_("Cannot parse timestamp"));
+        }
+        its.SetDate(y, m, d);
+        its.SetTime(hr, mn, sc, 10 * ms);
+    }
+
+    buffer->setValue(offsetM, its.GetDate());
+    buffer->setValue(offsetM + sizeof(int), its.GetTime());
+    buffer->setValue(offsetM + 2 * sizeof(int), tz);
+}
+
+unsigned TimestampTzColumnDef::getBufferSize()
+{
+    return 3 * sizeof(int);
+}
+
+void TimestampTzColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
+    const IBPP::Statement& statement, wxMBConv*)
+{
+    wxASSERT(buffer);
+    IBPP::Timestamp value;
+    statement->Get(col, value);
+    buffer->setValue(offsetM, value.GetDate());
+    buffer->setValue(offsetM + sizeof(int), value.GetTime());
+    buffer->setValue(offsetM + 2 * sizeof(int), value.Timezone());
+}
+
+void TimestampTzColumnDef::setValueFromView(DataGridRowBuffer* buffer,
+    unsigned, const IBPP::ColumnView& view, const IBPP::Statement&, wxMBConv*)
+{
+    wxASSERT(buffer);
+    IBPP::Timestamp value;
+    view.GetTimestamp(value);
+    buffer->setValue(offsetM, value.GetDate());
+    buffer->setValue(offsetM + sizeof(int), value.GetTime());
+    buffer->setValue(offsetM + 2 * sizeof(int), value.Timezone());
+}
+
+void TimestampTzColumnDef::setParameter(DataGridRowBuffer* buffer,
+    IBPP::Statement& statement, unsigned param, wxMBConv*)
+{
+    wxASSERT(buffer);
+    int date, time, tz;
+    buffer->getValue(offsetM, date);
+    buffer->getValue(offsetM + sizeof(int), time);
+    buffer->getValue(offsetM + 2 * sizeof(int), tz);
+    IBPP::Timestamp value(IBPP::Date(date));
+    value.SetTime(time);
+    value.SetTimezone(tz);
+    statement->Set(param, value);
+}
+
+// locale independent, with enough digits to tell any two values apart
+static wxString formatFullPrecision(double value, int digits)
+{
+    std::ostringstream ss;
+    ss.imbue(std::locale::classic());
+    ss << std::setprecision(digits) << value;
+    return wxString(ss.str());
+}
+
+// FloatColumnDef class
+class FloatColumnDef : public ResultsetColumnDef
+{
+private:
+    unsigned offsetM;
+public:
+    FloatColumnDef(const wxString& name, unsigned offset, bool readOnly,
+        bool nullable);
+    virtual wxString getAsComparableString(DataGridRowBuffer* buffer);
+    virtual wxString getAsString(DataGridRowBuffer* buffer);
+    virtual unsigned getBufferSize();
+    virtual bool isNumeric();
+    virtual bool addToAggregate(DataGridRowBuffer* buffer,
+        SelectionAggregate& aggregate);
+    virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::Statement& statement, wxMBConv* converter);
+    virtual void setValueFromView(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::ColumnView& view, const IBPP::Statement& statement,
+        wxMBConv* converter);
+    virtual void setParameter(DataGridRowBuffer* buffer,
+        IBPP::Statement& statement, unsigned param, wxMBConv* converter);
+    virtual void setFromString(DataGridRowBuffer* buffer,
+        const wxString& source);
+};
+
+FloatColumnDef::FloatColumnDef(const wxString& name, unsigned offset,
+        bool readOnly, bool nullable)
+    : ResultsetColumnDef(name, readOnly, nullable), offsetM(offset)
+{
+}
+
+wxString FloatColumnDef::getAsComparableString(DataGridRowBuffer* buffer)
+{
+    wxASSERT(buffer);
+    float value;
+    if (!buffer->getValue(offsetM, value))
+        return wxEmptyString;
+
+    return formatFullPrecision(value, 9);
+}
+
+wxString FloatColumnDef::getAsString(DataGridRowBuffer* buffer)
+{
+    wxASSERT(buffer);
+    float value;
+    if (!buffer->getValue(offsetM, value))
+        return wxEmptyString;
+
+    return GridCellFormats::get().format<float>(value);
+}
+
+void FloatColumnDef::setFromString(DataGridRowBuffer* buffer,
+    const wxString& source)
+{
+    wxASSERT(buffer);
+    double d;
+    if (!source.ToDouble(&d))
+        throw FRError(_("Invalid float numeric value"));
+    buffer->setValue(offsetM, (float)d);
+}
+
+unsigned FloatColumnDef::getBufferSize()
+{
+    return sizeof(float);
+}
+
+bool FloatColumnDef::isNumeric()
+{
+    return true;
+}
+
+bool FloatColumnDef::addToAggregate(DataGridRowBuffer* buffer,
+    SelectionAggregate& aggregate)
+{
+    wxASSERT(buffer);
+    float value;
+    if (!buffer->getValue(offsetM, value))
+        return false;
+    aggregate.add(double(value));
+    return true;
+}
+
+void FloatColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
+    const IBPP::Statement& statement, wxMBConv*)
+{
+    wxASSERT(buffer);
+    float value;
+    statement->Get(col, value);
+    buffer->setValue(offsetM, value);
+}
+
+void FloatColumnDef::setValueFromView(DataGridRowBuffer* buffer, unsigned,
+    const IBPP::ColumnView& view, const IBPP::Statement&, wxMBConv*)
+{
+    wxASSERT(buffer);
+    buffer->setValue(offsetM, view.AsFloat());
+}
+
+void FloatColumnDef::setParameter(DataGridRowBuffer* buffer,
+    IBPP::Statement& statement, unsigned param, wxMBConv*)
+{
+    wxASSERT(buffer);
+    float value;
+    buffer->getValue(offsetM, value);
+    statement->Set(param, value);
+}
+
+// DoubleColumnDef class
+class DoubleColumnDef : public ResultsetColumnDef
+{
+private:
+    unsigned offsetM;
+    short scaleM;
+public:
+    DoubleColumnDef(const wxString& name, unsigned offset, bool readOnly,
+        bool nullable, short scale);
+    virtual wxString getAsComparableString(DataGridRowBuffer* buffer);
+    virtual wxString getAsString(DataGridRowBuffer* buffer);
+    virtual unsigned getBufferSize();
+    virtual bool isNumeric();
+    virtual bool addToAggregate(DataGridRowBuffer* buffer,
+        SelectionAggregate& aggregate);
+    virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::Statement& statement, wxMBConv* converter);
+    virtual void setValueFromView(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::ColumnView& view, const IBPP::Statement& statement,
+        wxMBConv* converter);
+    virtual void setParameter(DataGridRowBuffer* buffer,
+        IBPP::Statement& statement, unsigned param, wxMBConv* converter);
+    virtual void setFromString(DataGridRowBuffer* buffer,
+        const wxString& source);
+};
+
+DoubleColumnDef::DoubleColumnDef(const wxString& name, unsigned offset,
+        bool readOnly, bool nullable, short scale)
+    : ResultsetColumnDef(name, readOnly, nullable), offsetM(offset),
+        scaleM(scale)
+{
+}
+
+wxString DoubleColumnDef::getAsComparableString(DataGridRowBuffer* buffer)
+{
+    wxASSERT(buffer);
+    double value;
+    if (!buffer->getValue(offsetM, value))
+        return wxEmptyString;
+
+    if (scaleM)
+        return wxString::FromCDouble(value, scaleM);
+    return formatFullPrecision(value, 17);
+}
+
+wxString DoubleColumnDef::getAsString(DataGridRowBuffer* buffer)
+{
+    wxASSERT(buffer);
+    double value;
+    if (!buffer->getValue(offsetM, value))
+        return wxEmptyString;
+
+    if (scaleM)
+        return wxString::Format("%.*f", scaleM, value);
+    return GridCellFormats::get().format<double>(value);
+}
+
+void DoubleColumnDef::setFromString(DataGridRowBuffer* buffer,
+    const wxString& source)
+{
+    wxASSERT(buffer);
+    double d;
+    if (!source.ToDouble(&d))
+        throw FRError(_("Invalid double numeric value"));
+    buffer->setValue(offsetM, d);
+}
+
+unsigned DoubleColumnDef::getBufferSize()
+{
+    return sizeof(double);
+}
+
+bool DoubleColumnDef::isNumeric()
+{
+    return true;
+}
+
+bool DoubleColumnDef::addToAggregate(DataGridRowBuffer* buffer,
+    SelectionAggregate& aggregate)
+{
+    wxASSERT(buffer);
+    double value;
+    if (!buffer->getValue(offsetM, value))
+        return false;
+    // NUMERIC and DECIMAL columns are read as double
+    if (scaleM)
+        aggregate.addScaled(value, scaleM);
+    else
+        aggregate.add(value);
+    return true;
+}
+
+void DoubleColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
+    const IBPP::Statement& statement, wxMBConv*)
+{
+    wxASSERT(buffer);
+    double value;
+    statement->Get(col, value);
+    buffer->setValue(offsetM, value);
+}
+
+void DoubleColumnDef::setValueFromView(DataGridRowBuffer* buffer, unsigned,
+    const IBPP::ColumnView& view, const IBPP::Statement&, wxMBConv*)
+{
+    wxASSERT(buffer);
+    buffer->setValue(offsetM, view.AsDouble());
+}
+
+void DoubleColumnDef::setParameter(DataGridRowBuffer* buffer,
+    IBPP::Statement& statement, unsigned param, wxMBConv*)
+{
+    wxASSERT(buffer);
+    double value;
+    buffer->getValue(offsetM, value);
+    statement->Set(param, value);
+}
+
+// Int128ColumnDef class
+// Firebird v4 INT128 and NUMERIC(x,y) with more than 18 digits, kept as
+// two 64 bit halves so that all digits are shown and edited exactly
+class Int128ColumnDef : public ResultsetColumnDef
+{
+private:
+    unsigned offsetM;
+    short scaleM;
+public:
+    Int128ColumnDef(const wxString& name, unsigned offset, bool readOnly,
+        bool nullable, short scale);
+    virtual wxString getAsString(DataGridRowBuffer* buffer);
+    virtual unsigned getBufferSize();
+    virtual bool isNumeric();
+    virtual bool addToAggregate(DataGridRowBuffer* buffer,
+        SelectionAggregate& aggregate);
+    virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::Statement& statement, wxMBConv* converter);
+    virtual void setValueFromView(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::ColumnView& view, const IBPP::Statement& statement,
+        wxMBConv* converter);
+    virtual void setParameter(DataGridRowBuffer* buffer,
+        IBPP::Statement& statement, unsigned param, wxMBConv* converter);
+    virtual void setFromString(DataGridRowBuffer* buffer,
+        const wxString& source);
+};
+
+Int128ColumnDef::Int128ColumnDef(const wxString& name, unsigned offset,
+        bool readOnly, bool nullable, short scale)
+    : ResultsetColumnDef(name, readOnly, nullable), offsetM(offset),
+        scaleM(scale)
+{
+}
+
+wxString Int128ColumnDef::getAsString(DataGridRowBuffer* buffer)
+{
+    wxASSERT(buffer);
+    int64_t low, high;
+    if (!buffer->getValue(offsetM, low)
+        || !buffer->getValue(offsetM + sizeof(int64_t), high))
+    {
+        return wxEmptyString;
+    }
+
+    IBPP::Int128 value;
+    value.SetValue((uint64_t)low, high);
+    char text[48];
+    int len = value.Format(text, scaleM);
+    return wxString::FromAscii(text, len);
+}
+
+void Int128ColumnDef::setFromString(DataGridRowBuffer* buffer,
+    const wxString& source)
+{
+    wxASSERT(buffer);
+    IBPP::Int128 value;
+    if (!value.FromString(wx2std(source), scaleM))
+        throw FRError(_("Invalid 128bit numeric value"));
+    buffer->setValue(offsetM, (int64_t)value.Low());
+    buffer->setValue(offsetM + sizeof(int64_t), value.High());
+}
+
+unsigned Int128ColumnDef::getBufferSize()
+{
+    return 2 * sizeof(int64_t);
+}
+
+bool Int128ColumnDef::isNumeric()
+{
+    return true;
+}
+
+bool Int128ColumnDef::addToAggregate(DataGridRowBuffer* buffer,
+    SelectionAggregate& aggregate)
+{
+    wxASSERT(buffer);
+    int64_t low, high;
+    if (!buffer->getValue(offsetM, low)
+        || !buffer->getValue(offsetM + sizeof(int64_t), high))
+    {
+        return false;
+    }
+    IBPP::Int128 value;
+    value.SetValue((uint64_t)low, high);
+    aggregate.add(value, scaleM);
+    return true;
+}
+
+void Int128ColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
+    const IBPP::Statement& statement, wxMBConv*)
+{
+    wxASSERT(buffer);
+    IBPP::Int128 value;
+    statement->Get(col, value);
+    buffer->setValue(offsetM, (int64_t)value.Low());
+    buffer->setValue(offsetM + sizeof(int64_t), value.High());
+}
+
+void Int128ColumnDef::setValueFromView(DataGridRowBuffer* buffer, unsigned,
+    const IBPP::ColumnView& view, const IBPP::Statement&, wxMBConv*)
+{
+    wxASSERT(buffer);
+    IBPP::Int128 value;
+    view.GetInt128(value);
+    buffer->setValue(offsetM, (int64_t)value.Low());
+    buffer->setValue(offsetM + sizeof(int64_t), value.High());
+}
+
+void Int128ColumnDef::setParameter(DataGridRowBuffer* buffer,
+    IBPP::Statement& statement, unsigned param, wxMBConv*)
+{
+    wxASSERT(buffer);
+    int64_t low, high;
+    buffer->getValue(offsetM, low);
+    buffer->getValue(offsetM + sizeof(int64_t), high);
+    IBPP::Int128 value;
+    value.SetValue(uint64_t(low), high);
+    statement->Set(param, value);
+}
+
+// DecFloatColumnDef class
+// Firebird v4 DECFLOAT(16) and DECFLOAT(34), kept in their encoded form
+class DecFloatColumnDef : public ResultsetColumnDef
+{
+private:
+    unsigned offsetM;
+    int digitsM;
+public:
+    DecFloatColumnDef(const wxString& name, unsigned offset, bool readOnly,
+        bool nullable, int digits);
+    virtual wxString getAsString(DataGridRowBuffer* buffer);
+    virtual unsigned getBufferSize();
+    virtual bool isNumeric();
+    virtual bool addToAggregate(DataGridRowBuffer* buffer,
+        SelectionAggregate& aggregate);
+    virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::Statement& statement, wxMBConv* converter);
+    virtual void setValueFromView(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::ColumnView& view, const IBPP::Statement& statement,
+        wxMBConv* converter);
+    virtual void setParameter(DataGridRowBuffer* buffer,
+        IBPP::Statement& statement, unsigned param, wxMBConv* converter);
+    virtual void setFromString(DataGridRowBuffer* buffer,
+        const wxString& source);
+};
+
+DecFloatColumnDef::DecFloatColumnDef(const wxString& name, unsigned offset,
+        bool readOnly, bool nullable, int digits)
+    : ResultsetColumnDef(name, readOnly, nullable), offsetM(offset),
+        digitsM(digits)
+{
+}
+
+wxString DecFloatColumnDef::getAsString(DataGridRowBuffer* buffer)
+{
+    wxASSERT(buffer);
+    int64_t low, high;
+    if (!buffer->getValue(offsetM, low)
+        || !buffer->getValue(offsetM + sizeof(int64_t), high))
+    {
+        return wxEmptyString;
+    }
+
+    IBPP::DecFloat value;
+    if (digitsM == 16)
+        value.SetDecimal64((uint64_t)low);
+    else
+        value.SetDecimal128((uint64_t)low, (uint64_t)high);
+    return wxString::FromAscii(value.AsString().c_str());
+}
+
+void DecFloatColumnDef::setFromString(DataGridRowBuffer* buffer,
+    const wxString& source)
+{
+    wxASSERT(buffer);
+    IBPP::DecFloat value(digitsM);
+    if (!value.FromString(wx2std(source)))
+    {
+        throw FRError(wxString::Format(
+            _("Invalid DECFLOAT(%d) numeric value"), digitsM));
+    }
+    buffer->setValue(offsetM, (int64_t)value.Low());
+    buffer->setValue(offsetM + sizeof(int64_t), (int64_t)value.High());
+}
+
+unsigned DecFloatColumnDef::getBufferSize()
+{
+    return 2 * sizeof(int64_t);
+}
+
+bool DecFloatColumnDef::isNumeric()
+{
+    return true;
+}
+
+bool DecFloatColumnDef::addToAggregate(DataGridRowBuffer* buffer,
+    SelectionAggregate& aggregate)
+{
+    wxASSERT(buffer);
+    int64_t low, high;
+    if (!buffer->getValue(offsetM, low)
+        || !buffer->getValue(offsetM + sizeof(int64_t), high))
+    {
+        return false;
+    }
+    IBPP::DecFloat value;
+    if (digitsM == 16)
+        value.SetDecimal64((uint64_t)low);
+    else
+        value.SetDecimal128((uint64_t)low, (uint64_t)high);
+    if (value.IsNaN() || value.IsInfinite())
+        return false;
+    // there is no arithmetic for DECFLOAT, so it's summed as double
+    aggregate.add(strtod(value.AsString().c_str(), 0));
+    return true;
+}
+
+void DecFloatColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
+    const IBPP::Statement& statement, wxMBConv*)
 {
-    return sizeof(double);
+    wxASSERT(buffer);
+    IBPP::DecFloat value;
+    statement->Get(col, value);
+    buffer->setValue(offsetM, (int64_t)value.Low());
+    buffer->setValue(offsetM + sizeof(int64_t), (int64_t)value.High());
 }
 
-bool DoubleColumnDef::isNumeric()
+void DecFloatColumnDef::setValueFromView(DataGridRowBuffer* buffer, unsigned,
+    const IBPP::ColumnView& view, const IBPP::Statement&, wxMBConv*)
 {
-    return true;
+    wxASSERT(buffer);
+    IBPP::DecFloat value;
+    view.GetDecFloat(value);
+    buffer->setValue(offsetM, (int64_t)value.Low());
+    buffer->setValue(offsetM + sizeof(int64_t), (int64_t)value.High());
 }
 
-void DoubleColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
-    const IBPP::Statement& statement, wxMBConv*)
+void DecFloatColumnDef::setParameter(DataGridRowBuffer* buffer,
+    IBPP::Statement& statement, unsigned param, wxMBConv*)
 {
     wxASSERT(buffer);
-    double value;
-    statement->Get(col, value);
-    buffer->setValue(offsetM, value);
+    int64_t low, high;
+    buffer->getValue(offsetM, low);
+    buffer->getValue(offsetM + sizeof(int64_t), high);
+    IBPP::DecFloat value;
+    if (digitsM == 16)
+        value.SetDecimal64(uint64_t(low));
+    else
+        value.SetDecimal128(uint64_t(low), uint64_t(high));
+    statement->Set(param, value);
 }
 
 class BlobColumnDef : public ResultsetColumnDef
@@ -1190,6 +2154,9 @@ public:
         unsigned stringIndex, unsigned blobIndex, bool textual);
     void reset(DataGridRowBuffer* buffer);
     virtual unsigned getIndex();
+    // the size and a hash of the whole BLOB, reads no settings so it can
+    // be used by worker threads
+    virtual wxString getAsComparableString(DataGridRowBuffer* buffer);
     virtual wxString getAsString(DataGridRowBuffer* buffer);
     virtual unsigned getBufferSize();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
@@ -1197,6 +2164,8 @@ public:
     virtual void setFromString(DataGridRowBuffer* buffer,
         const wxString& source);
     bool isTextual() { return textualM; };
+    // true when getAsString() has to read the BLOB
+    bool needsReading(DataGridRowBuffer* buffer);
 };
 
 BlobColumnDef::BlobColumnDef(const wxString& name, bool readOnly,
@@ -1217,6 +2186,47 @@ unsigned BlobColumnDef::getIndex()
     return indexM;
 }
 
+bool BlobColumnDef::needsReading(DataGridRowBuffer* buffer)
+{
+    wxASSERT(buffer);
+    if (buffer->isStringLoaded(stringIndexM))
+        return false;
+    if (!GridCellFormats::get().showBlobContent())
+        return false;
+    if (!textualM && !GridCellFormats::get().showBinaryBlobContent())
+        return false;
+    return buffer->getBlob(indexM) != 0;
+}
+
+wxString BlobColumnDef::getAsComparableString(DataGridRowBuffer* buffer)
+{
+    wxASSERT(buffer);
+    IBPP::Blob* b0 = buffer->getBlob(indexM);
+    if (!b0)
+        return wxEmptyString;
+    IBPP::Blob b = *b0;
+
+    // 64 bit FNV-1a over all bytes, read errors are thrown to the caller
+    uint64_t hash = 14695981039346656037ULL;
+    int64_t size = 0;
+    b->Open();
+    char data[32768];
+    int count;
+    while ((count = b->Read(data, sizeof(data))) > 0)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            hash ^= (unsigned char)data[i];
+            hash *= 1099511628211ULL;
+        }
+        size += count;
+    }
+    b->Close();
+    return wxString::Format("[BLOB %" wxLongLongFmtSpec "d bytes, "
+        "%016" wxLongLongFmtSpec "x]", wxLongLong_t(size),
+        wxULongLong_t(hash));
+}
+
 wxString BlobColumnDef::getAsString(DataGridRowBuffer* buffer)
 {
     wxASSERT(buffer);
@@ -1316,6 +2326,7 @@ class StringColumnDef : public ResultsetColumnDef
 protected:
     unsigned indexM;
     int charSizeM;
+    void setText(DataGridRowBuffer* buffer, const wxString& text);
 public:
     StringColumnDef(const wxString& name, unsigned stringIndex, bool readOnly,
         bool nullable, int charSize);
@@ -1325,6 +2336,11 @@ public:
     virtual unsigned getBufferSize();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter);
+    virtual void setValueFromView(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::ColumnView& view, const IBPP::Statement& statement,
+        wxMBConv* converter);
+    virtual void setParameter(DataGridRowBuffer* buffer,
+        IBPP::Statement& statement, unsigned param, wxMBConv* converter);
     virtual void setFromString(DataGridRowBuffer* buffer,
         const wxString& source);
 };
@@ -1390,13 +2406,55 @@ void StringColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
         buffer->setString(indexM, val);
     }
     else
+        setText(buffer, wxString(value.c_str(), *converter));
+}
+
+void StringColumnDef::setValueFromView(DataGridRowBuffer* buffer,
+    unsigned col, const IBPP::ColumnView& view,
+    const IBPP::Statement& statement, wxMBConv* converter)
+{
+    wxASSERT(buffer);
+    // BOOLEAN and OCTETS columns are handled by setValue()
+    if (view.type != IBPP::sdString || view.subtype == 1)
+        setValue(buffer, col, statement, converter);
+    else
+        setText(buffer, wxString(view.data, *converter, view.length));
+}
+
+void StringColumnDef::setText(DataGridRowBuffer* buffer,
+    const wxString& text)
+{
+    // CHAR columns are padded to their size in bytes, which can be more
+    // than the size in characters for multi-byte character sets
+    wxString val(text);
+    size_t trimLen = val.Strip().Length();
+    if (val.Length() > size_t(charSizeM))
+        val.Truncate(trimLen > size_t(charSizeM) ? trimLen : charSizeM);
+    buffer->setString(indexM, val);
+}
+
+void StringColumnDef::setParameter(DataGridRowBuffer* buffer,
+    IBPP::Statement& statement, unsigned param, wxMBConv* converter)
+{
+    wxASSERT(buffer);
+    wxString value(buffer->getString(indexM));
+    if (statement->ParameterType(param) == IBPP::sdBoolean) // Firebird v3
+        statement->Set(param, value == "true");
+    else if (statement->ParameterSubtype(param) == 1)   // charset OCTETS
     {
-        wxString val = wxString(value.c_str(), *converter);
-        size_t trimLen = val.Strip().Length();
-        if (val.Length() > size_t(charSizeM))
-            val.Truncate(trimLen > size_t(charSizeM) ? trimLen : charSizeM);
-        buffer->setString(indexM, val);
+        // shown as hex digits, see setValue()
+        std::string bytes;
+        unsigned long byte;
+        for (size_t p = 0; p + 1 < value.length(); p += 2)
+        {
+            if (!value.Mid(p, 2).ToULong(&byte, 16))
+                throw FRError(_("Invalid hexadecimal value"));
+            bytes += char(byte);
+        }
+        statement->Set(param, bytes.data(), int(bytes.size()));
     }
+    else
+        statement->Set(param, wx2std(value, converter));
 }
 
 class BooleanColumnDef : public StringColumnDef // Firebird v3
@@ -1421,9 +2479,40 @@ void BooleanColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     buffer->setString(StringColumnDef::indexM, val);
 }
 
+// creates a copy of the appropriate type
+static DataGridRowBuffer* copyRowBuffer(DataGridRowBuffer* buffer)
+{
+    if (InsertedGridRowBuffer* inserted =
+        dynamic_cast<InsertedGridRowBuffer*>(buffer))
+    {
+        return new InsertedGridRowBuffer(inserted);
+    }
+    return new DataGridRowBuffer(buffer);
+}
+
+// replaces the parameters in a statement with their values, for the log
+static wxString fillParameters(const wxString& sql,
+    const std::vector<wxString>& values)
+{
+    wxString result;
+    size_t index = 0;
+    bool quoted = false;
+    for (wxString::const_iterator it = sql.begin(); it != sql.end(); ++it)
+    {
+        if (*it == '"')
+            quoted = !quoted;
+        if (*it == '?' && !quoted && index < values.size())
+            result += values[index++];
+        else
+            result += *it;
+    }
+    return result;
+}
+
 // DataGridRows class
-DataGridRows::DataGridRows(Database* db)
-    : bufferSizeM(0), databaseM(db), readOnlyM(false)
+DataGridRows::DataGridRows(Database* db, bool readOnly)
+    : bufferSizeM(0), databaseM(db), readOnlyM(readOnly), deferEditsM(false),
+        changeCountM(0)
 {
 }
 
@@ -1445,6 +2534,16 @@ void DataGridRows::addRow(DataGridRowBuffer* buffer)
 }
 
 void DataGridRows::addRow(const IBPP::Statement& statement)
+{
+    addRow(readRow(statement));
+}
+
+void DataGridRows::addRow(const IBPP::ColumnViews& views)
+{
+    addRow(readRow(views));
+}
+
+DataGridRowBuffer* DataGridRows::readRow(const IBPP::Statement& statement)
 {
     DataGridRowBuffer* buffer = new DataGridRowBuffer(columnDefsM.size());
     // if anything fails, make sure we release the memory
@@ -1472,7 +2571,37 @@ void DataGridRows::addRow(const IBPP::Statement& statement)
         delete buffer;
         throw;
     }
-    addRow(buffer);
+    return buffer;
+}
+
+DataGridRowBuffer* DataGridRows::readRow(const IBPP::ColumnViews& views)
+{
+    wxASSERT(views.size() == columnDefsM.size());
+    DataGridRowBuffer* buffer = new DataGridRowBuffer(columnDefsM.size());
+    // if anything fails, make sure we release the memory
+    try
+    {
+        // see readRow(const IBPP::Statement&)
+        unsigned col = columnDefsM.size();
+        do
+        {
+            unsigned colIBPP = col--;
+            const IBPP::ColumnView& view = views[col];
+            buffer->setFieldNull(col, view.isNull);
+            if (!view.isNull)
+            {
+                columnDefsM[col]->setValueFromView(buffer, colIBPP, view,
+                    statementM, databaseM->getCharsetConverter());
+            }
+        }
+        while (col > 0);
+    }
+    catch(...)
+    {
+        delete buffer;
+        throw;
+    }
+    return buffer;
 }
 
     void freeBuffer(DataGridRowBuffer* buffer) { delete buffer; }
@@ -1481,6 +2610,10 @@ void DataGridRows::addRow(const IBPP::Statement& statement)
 
 void DataGridRows::clear()
 {
+    ++changeCountM;
+    discardPendingEdits(false);
+    blobPreviewQueueM.clear();
+    blobPreviewQueuedM.clear();
     if (buffersM.size())
     {
         for_each(buffersM.begin(), buffersM.end(), freeBuffer);
@@ -1542,6 +2675,7 @@ bool DataGridRows::canRemoveRow(size_t row)
 
 bool DataGridRows::removeRows(size_t from, size_t count, wxString& stm)
 {
+    ++changeCountM;
     if (statementTablesM.begin() == statementTablesM.end())
         return false;
 
@@ -1569,7 +2703,22 @@ bool DataGridRows::removeRows(size_t from, size_t count, wxString& stm)
         deleteFromM = statementTablesM.find(tab);
     }
 
-    for (size_t pos = 0; pos < count; ++pos)
+    for (size_t pos = 0; pos < count && deferEditsM; ++pos)
+    {
+        // changes of the row are dropped, the key values it had before
+        // them are used to delete it
+        std::map<unsigned, PendingEdit>::iterator it =
+            pendingEditsM.find(from + pos);
+        if (it == pendingEditsM.end())
+        {
+            PendingEdit edit;
+            edit.original = copyRowBuffer(buffersM[from + pos]);
+            it = pendingEditsM.insert(std::make_pair(from + pos, edit)).first;
+        }
+        it->second.columns.clear();
+        it->second.deleted = true;
+    }
+    for (size_t pos = 0; pos < count && !deferEditsM; ++pos)
     {
         if (pos > 0)
             stm += wxTextBuffer::GetEOL();
@@ -1598,6 +2747,235 @@ bool DataGridRows::removeRows(size_t from, size_t count, wxString& stm)
     return true;
 }
 
+void DataGridRows::setDeferEdits(bool defer)
+{
+    deferEditsM = defer;
+}
+
+bool DataGridRows::getDeferEdits() const
+{
+    return deferEditsM;
+}
+
+size_t DataGridRows::getPendingEditCount() const
+{
+    return pendingEditsM.size();
+}
+
+void DataGridRows::discardPendingEdits(bool restoreRows)
+{
+    ++changeCountM;
+    for (std::map<unsigned, PendingEdit>::iterator it =
+        pendingEditsM.begin(); it != pendingEditsM.end(); ++it)
+    {
+        if (restoreRows && it->first < buffersM.size())
+        {
+            delete buffersM[it->first];
+            buffersM[it->first] = it->second.original;
+        }
+        else
+            delete it->second.original;
+    }
+    pendingEditsM.clear();
+}
+
+DataGridRowBuffer* DataGridRows::getLocatorBuffer(unsigned row,
+    DataGridRowBuffer* current)
+{
+    std::map<unsigned, PendingEdit>::iterator it = pendingEditsM.find(row);
+    if (it != pendingEditsM.end())
+        return it->second.original;
+    return current;
+}
+
+void DataGridRows::discardEdits()
+{
+    discardPendingEdits(true);
+}
+
+void DataGridRows::getRecordLocator(UniqueConstraint* uq,
+    const wxString& table, RecordLocator& locator)
+{
+    locator.where.clear();
+    locator.columns.clear();
+    for (ColumnConstraint::const_iterator ci = uq->begin(); ci !=
+        uq->end(); ++ci)
+    {
+        for (int c2 = 1; c2 <= statementM->Columns(); ++c2)
+        {
+            wxString cn(std2wxIdentifier(statementM->ColumnName(c2),
+                databaseM->getCharsetConverter()));
+            wxString tn(std2wxIdentifier(statementM->ColumnTable(c2),
+                databaseM->getCharsetConverter()));
+            if (cn == (*ci) && tn == table) // found it, add to WHERE list
+            {
+                if (!locator.where.empty())
+                    locator.where += " AND ";
+                if (cn == "DB_KEY")
+                    locator.where += "RDB$DB_KEY = ?";
+                else
+                    locator.where += Identifier(cn).getQuoted() + " = ?";
+                locator.columns.push_back(c2 - 1);
+                break;
+            }
+        }
+        if ((*ci) == "DB_KEY")
+            break;
+    }
+    if (locator.columns.empty())
+    {
+        throw FRError(wxString::Format(_("No key columns found for table %s."),
+            table.c_str()));
+    }
+}
+
+void DataGridRows::setParameters(IBPP::Statement& st, unsigned& param,
+    const std::vector<unsigned>& columns, DataGridRowBuffer* buffer,
+    bool isKey, std::vector<wxString>& literals)
+{
+    for (std::vector<unsigned>::const_iterator it = columns.begin();
+        it != columns.end(); ++it, ++param)
+    {
+        if (isKey && buffer->isFieldNA(*it))
+            throw FRError(_("N/A value in key column."));
+        if (buffer->isFieldNull(*it))
+        {
+            st->SetNull(param);
+            literals.push_back("NULL");
+            continue;
+        }
+        columnDefsM[*it]->setParameter(buffer, st, param,
+            databaseM->getCharsetConverter());
+        if (dynamic_cast<DBKeyColumnDef*>(columnDefsM[*it]))
+            literals.push_back("?");
+        else
+        {
+            literals.push_back("'"
+                + columnDefsM[*it]->getAsFirebirdString(buffer) + "'");
+        }
+    }
+}
+
+wxString DataGridRows::applyEdits()
+{
+    if (pendingEditsM.empty())
+        return wxEmptyString;
+
+    // all changes or none, a failing one reverts the others
+    IBPP::Statement savepoint = IBPP::StatementFactory(
+        statementM->DatabasePtr(), statementM->TransactionPtr());
+    savepoint->ExecuteImmediate("SAVEPOINT FR_APPLY_EDITS");
+
+    wxString stm;
+    try
+    {
+        // the statements are prepared once and executed for every row
+        // with the same table and changed columns
+        std::map<wxString, IBPP::Statement> prepared;
+        std::map<wxString, RecordLocator> locators;
+        for (std::map<unsigned, PendingEdit>::iterator it =
+            pendingEditsM.begin(); it != pendingEditsM.end(); ++it)
+        {
+            PendingEdit& edit = it->second;
+            DataGridRowBuffer* buffer = buffersM[it->first];
+
+            // the changed columns of each table, or the table to delete from
+            std::map<wxString, std::vector<unsigned> > tableColumns;
+            if (edit.deleted)
+            {
+                if (deleteFromM == statementTablesM.end())
+                    continue;
+                tableColumns[(*deleteFromM).first];
+            }
+            for (std::set<unsigned>::const_iterator ci =
+                edit.columns.begin(); ci != edit.columns.end(); ++ci)
+            {
+                wxString tn(std2wxIdentifier(
+                    statementM->ColumnTable(*ci + 1),
+                    databaseM->getCharsetConverter()));
+                tableColumns[tn].push_back(*ci);
+            }
+
+            for (std::map<wxString, std::vector<unsigned> >::iterator tc =
+                tableColumns.begin(); tc != tableColumns.end(); ++tc)
+            {
+                const wxString& table = tc->first;
+                std::map<wxString, UniqueConstraint *>::iterator uq =
+                    statementTablesM.find(table);
+                if (uq == statementTablesM.end() || (*uq).second == 0)
+                    throw FRError(_("This column should not be editable"));
+                std::map<wxString, RecordLocator>::iterator loc =
+                    locators.find(table);
+                if (loc == locators.end())
+                {
+                    loc = locators.insert(
+                        std::make_pair(table, RecordLocator())).first;
+                    getRecordLocator((*uq).second, table, loc->second);
+                }
+
+                wxString sql;
+                if (edit.deleted)
+                    sql = "DELETE FROM " + Identifier(table).getQuoted();
+                else
+                {
+                    sql = "UPDATE " + Identifier(table,
+                        databaseM->getSqlDialect()).getQuoted() + " SET ";
+                    for (std::vector<unsigned>::const_iterator ci =
+                        tc->second.begin(); ci != tc->second.end(); ++ci)
+                    {
+                        if (ci != tc->second.begin())
+                            sql += ", ";
+                        wxString cn(std2wxIdentifier(
+                            statementM->ColumnName(*ci + 1),
+                            databaseM->getCharsetConverter()));
+                        sql += Identifier(cn,
+                            databaseM->getSqlDialect()).getQuoted() + " = ?";
+                    }
+                }
+                sql += " WHERE " + loc->second.where;
+
+                IBPP::Statement& st = prepared[sql];
+                if (st == 0)
+                {
+                    st = IBPP::StatementFactory(statementM->DatabasePtr(),
+                        statementM->TransactionPtr());
+                    st->Prepare(wx2std(sql, databaseM->getCharsetConverter()));
+                }
+                unsigned param = 1;
+                std::vector<wxString> literals;
+                if (!edit.deleted)
+                {
+                    setParameters(st, param, tc->second, buffer, false,
+                        literals);
+                }
+                setParameters(st, param, loc->second.columns, edit.original,
+                    true, literals);
+                st->Execute();
+
+                if (!stm.empty())
+                    stm += wxTextBuffer::GetEOL();
+                stm += fillParameters(sql, literals) + ";";
+            }
+        }
+        savepoint->ExecuteImmediate("RELEASE SAVEPOINT FR_APPLY_EDITS ONLY");
+    }
+    catch (...)
+    {
+        try
+        {
+            savepoint->ExecuteImmediate("ROLLBACK TO SAVEPOINT FR_APPLY_EDITS");
+        }
+        catch (IBPP::Exception&)
+        {
+            // the original error is the one to report
+        }
+        throw;
+    }
+
+    discardPendingEdits(false);
+    return stm;
+}
+
 unsigned DataGridRows::getRowCount()
 {
     return buffersM.size();
@@ -1764,7 +3142,7 @@ bool DataGridRows::initialize(const IBPP::Statement& statement)
         }
 
         IBPP::SDT type = statement->ColumnType(col);
-        if (statement->ColumnScale(col) > 0)
+        if (statement->ColumnScale(col) > 0 && type != IBPP::sdInt128)
             type = IBPP::sdDouble;
 
         ResultsetColumnDef* columnDef = 0;
@@ -1787,6 +3165,12 @@ bool DataGridRows::initialize(const IBPP::Statement& statement)
                 case IBPP::sdTimestamp:
                     columnDef = new TimestampColumnDef(colName, bufferSizeM, readOnly, nullable);
                     break;
+                case IBPP::sdTimeTz: // Firebird v4
+                    columnDef = new TimeTzColumnDef(colName, bufferSizeM, readOnly, nullable);
+                    break;
+                case IBPP::sdTimestampTz:
+                    columnDef = new TimestampTzColumnDef(colName, bufferSizeM, readOnly, nullable);
+                    break;
 
                 case IBPP::sdSmallint:
                 case IBPP::sdInteger:
@@ -1795,6 +3179,12 @@ bool DataGridRows::initialize(const IBPP::Statement& statement)
                 case IBPP::sdLargeint:
                     columnDef = new Int64ColumnDef(colName, bufferSizeM, readOnly, nullable);
                     break;
+                case IBPP::sdInt128: // Firebird v4
+                    columnDef = new Int128ColumnDef(colName, bufferSizeM, readOnly, nullable, statement->ColumnScale(col));
+                    break;
+                case IBPP::sdDecFloat:
+                    columnDef = new DecFloatColumnDef(colName, bufferSizeM, readOnly, nullable, statement->ColumnSize(col) == 8 ? 16 : 34);
+                    break;
 
                 case IBPP::sdFloat:
                     columnDef = new FloatColumnDef(colName, bufferSizeM, readOnly, nullable);
@@ -1846,6 +3236,32 @@ bool DataGridRows::isColumnNumeric(unsigned col)
     return columnDefsM[col]->isNumeric();
 }
 
+// returns false if the column isn't numeric, NULL values and deleted rows
+// are skipped
+bool DataGridRows::aggregateColumn(unsigned col, unsigned fromRow,
+    unsigned toRow, SelectionAggregate& aggregate)
+{
+    if (col >= columnDefsM.size() || !columnDefsM[col]->isNumeric())
+        return false;
+    ResultsetColumnDef* columnDef = columnDefsM[col];
+    for (unsigned row = fromRow; row <= toRow && row < buffersM.size(); ++row)
+    {
+        DataGridRowBuffer* buffer = buffersM[row];
+        if (buffer->isFieldNull(col) || buffer->isFieldNA(col)
+            || buffer->isDeleted())
+        {
+            continue;
+        }
+        columnDef->addToAggregate(buffer, aggregate);
+    }
+    return true;
+}
+
+unsigned DataGridRows::getChangeCount() const
+{
+    return changeCountM;
+}
+
 bool DataGridRows::isColumnReadonly(unsigned col)
 {
     if (col >= columnDefsM.size())
@@ -1864,6 +3280,13 @@ bool DataGridRows::getFieldInfo(unsigned row, unsigned col,
         || isColumnReadonly(col) || isFieldReadonly(row, col);
     info.fieldModified = !info.rowDeleted
         && buffersM[row]->isFieldModified(col);
+    if (!info.fieldModified && !info.rowDeleted && !pendingEditsM.empty())
+    {
+        std::map<unsigned, PendingEdit>::const_iterator it =
+            pendingEditsM.find(row);
+        info.fieldModified = it != pendingEditsM.end()
+            && it->second.columns.count(col) > 0;
+    }
     info.fieldNull = buffersM[row]->isFieldNull(col);
     info.fieldNA = buffersM[row]->isFieldNA(col);
     info.fieldNumeric = isColumnNumeric(col);
@@ -1918,6 +3341,53 @@ wxString DataGridRows::getFieldValue(unsigned row, unsigned col)
     return columnDefsM[col]->getAsString(buffersM[row]);
 }
 
+wxString DataGridRows::getFieldPreview(unsigned row, unsigned col)
+{
+    if (row >= buffersM.size() || col >= columnDefsM.size())
+        return wxEmptyString;
+    BlobColumnDef* bcd = dynamic_cast<BlobColumnDef*>(columnDefsM[col]);
+    if (!bcd || !bcd->needsReading(buffersM[row]))
+        return columnDefsM[col]->getAsString(buffersM[row]);
+
+    std::pair<unsigned, unsigned> cell(row, col);
+    if (blobPreviewQueuedM.insert(cell).second)
+    {
+        // cells painted last are visible, so they are read first, and
+        // cells that were scrolled away long ago are forgotten
+        blobPreviewQueueM.push_front(cell);
+        if (blobPreviewQueueM.size() > 1000)
+        {
+            blobPreviewQueuedM.erase(blobPreviewQueueM.back());
+            blobPreviewQueueM.pop_back();
+        }
+    }
+    return _("[loading]");
+}
+
+bool DataGridRows::hasBlobPreviewsQueued() const
+{
+    return !blobPreviewQueueM.empty();
+}
+
+bool DataGridRows::loadBlobPreviews(long maxMillis)
+{
+    bool loaded = false;
+    wxStopWatch sw;
+    while (!blobPreviewQueueM.empty() && (!loaded || sw.Time() < maxMillis))
+    {
+        std::pair<unsigned, unsigned> cell(blobPreviewQueueM.front());
+        blobPreviewQueueM.pop_front();
+        blobPreviewQueuedM.erase(cell);
+        // reads and caches at most the configured number of bytes
+        if (cell.first < buffersM.size() && cell.second < columnDefsM.size())
+        {
+            columnDefsM[cell.second]->getAsString(buffersM[cell.first]);
+            loaded = true;
+        }
+    }
+    return loaded;
+}
+
 bool DataGridRows::isFieldNull(unsigned row, unsigned col)
 {
     if (row >= buffersM.size())
@@ -2037,7 +3507,8 @@ DataGridRowsBlob DataGridRows::setBlobPrepare(unsigned row, unsigned col)
     DataGridRowsBlob b;
     b.row = row;
     b.col = col;
-    b.st = addWhere((*it).second, stm, tn, buffersM[row]);
+    b.st = addWhere((*it).second, stm, tn,
+        getLocatorBuffer(row, buffersM[row]));
     b.blob = IBPP::BlobFactory(b.st->DatabasePtr(), b.st->TransactionPtr());
     return b;
 }
@@ -2062,58 +3533,59 @@ void DataGridRows::setBlob(DataGridRowsBlob &b)
 void DataGridRows::exportBlobFile(const wxString& filename, unsigned row,
     unsigned col, ProgressIndicator *pi)
 {
-    wxFFile fl(filename, "wb+");
-    if (!fl.IsOpened())
-        throw FRError(_("Cannot open destination file."));
     IBPP::Blob *b0 = getBlob(row,col,true);
     IBPP::Blob b = *b0;
+    exportBlobToFile(b, filename, pi);
+}
 
-    b->Open();
-    int size;
-    b->Info(&size, 0, 0);
+// returns the number of files written, NULL cells and cells that aren't
+// BLOBs are skipped
+unsigned DataGridRows::exportBlobFiles(const wxString& directory,
+    const std::vector<std::pair<unsigned, unsigned> >& cells,
+    ProgressIndicator *pi)
+{
     if (pi)
-        pi->initProgress(_("Saving..."), size);
-    while (!pi || !pi->isCanceled())
+        pi->initProgress(_("Saving BLOBs..."), cells.size());
+    unsigned written = 0;
+    for (size_t i = 0; i < cells.size(); ++i)
     {
-        uint8_t buffer[32768];
-        int size = b->Read((void*)buffer, 32767);
-        if (size < 1)
+        if (pi && pi->isCanceled())
             break;
-        fl.Write(buffer, size);
+        unsigned row = cells[i].first;
+        unsigned col = cells[i].second;
+        bool textual = false;
+        if (isBlobColumn(col, &textual) && !isFieldNull(row, col))
+        {
+            // <column>_<row>.bin, with the row numbers shown in the grid
+            wxString name;
+            wxString column(getRowFieldName(col));
+            for (wxString::iterator it = column.begin(); it != column.end();
+                ++it)
+            {
+                wxChar c = *it;
+                name += (wxIsalnum(c) || c == '_' || c == '-') ? c : '_';
+            }
+            name << "_" << (row + 1) << (textual ? ".txt" : ".bin");
+            wxFileName fileName(directory, name);
+
+            IBPP::Blob b = *getBlob(row, col, true);
+            if (!exportBlobToFile(b, fileName.GetFullPath(), pi, 2))
+                break;
+            ++written;
+        }
         if (pi)
-            pi->stepProgress(size);
+            pi->stepProgress();
     }
-    fl.Close();
-    b->Close();
+    return written;
 }
 
 void DataGridRows::importBlobFile(const wxString& filename, unsigned row,
     unsigned col, ProgressIndicator *pi)
 {
-    wxFFile fl(filename, "rb");
-    if (!fl.IsOpened())
-        throw FRError(_("Cannot open BLOB file."));
-    if (pi)
-        pi->initProgress(_("Loading..."), fl.Length()); // wxFileOffset
-
     DataGridRowsBlob b = setBlobPrepare(row,col);
     b.blob->Create();
-    uint8_t buffer[32768];
-    while (!fl.Eof())
-    {
-        size_t len = fl.Read(buffer, 32767);    // slow when not 32k
-        if (len < 1 || (pi && pi->isCanceled()))
-            break;
-        b.blob->Write(buffer, len);
-        if (pi)
-            pi->stepProgress(len);
-    }
-    fl.Close();
-    b.blob->Close();
-    if (pi && pi->isCanceled())
-        return;
-
-    setBlob(b);
+    if (importBlobFromFile(b.blob, filename, pi))
+        setBlob(b);
 }
 
 // returns the executed SQL statement
@@ -2122,6 +3594,7 @@ wxString DataGridRows::setFieldValue(unsigned row, unsigned col,
 {
     if (columnDefsM[col]->isReadOnly())
         throw FRError(_("This column is not editable."));
+    ++changeCountM;
 
     // user wants to store null
     bool newIsNull = (
@@ -2133,14 +3606,7 @@ wxString DataGridRows::setFieldValue(unsigned row, unsigned col,
     // to ensure atomicity, we create a temporary buffer, try to store value
     // in it and also in database. if anything fails, we revert to the values
     // from temp buffer
-    DataGridRowBuffer *oldRecord;
-    // we create a copy of appropriate type
-    InsertedGridRowBuffer *test =
-        dynamic_cast<InsertedGridRowBuffer *>(buffersM[row]);
-    if (test)
-        oldRecord = new InsertedGridRowBuffer(test);
-    else
-        oldRecord = new DataGridRowBuffer(buffersM[row]);
+    DataGridRowBuffer *oldRecord = copyRowBuffer(buffersM[row]);
     try
     {
         buffersM[row]->setFieldNA(col, false);
@@ -2180,7 +3646,27 @@ wxString DataGridRows::setFieldValue(unsigned row, unsigned col,
         if (it == statementTablesM.end() || (*it).second == 0)
             throw FRError(_("This column should not be editable"));
 
-        IBPP::Statement st = addWhere((*it).second, stm, tn, oldRecord);
+        // BLOB values are still written right away
+        if (deferEditsM && !isBlobColumn(col))
+        {
+            std::map<unsigned, PendingEdit>::iterator pe =
+                pendingEditsM.find(row);
+            if (pe == pendingEditsM.end())
+            {
+                PendingEdit edit;
+                edit.original = oldRecord;
+                edit.deleted = false;
+                pe = pendingEditsM.insert(std::make_pair(row, edit)).first;
+            }
+            else
+                delete oldRecord;
+            pe->second.columns.insert(col);
+            return wxEmptyString;
+        }
+
+        // a pending change of the key columns isn't in the database yet
+        IBPP::Statement st = addWhere((*it).second, stm, tn,
+            getLocatorBuffer(row, oldRecord));
         st->Execute();
         delete oldRecord;
         return stm;
@@ -27,6 +27,7 @@
 #include <vector>
 #include <map>
 #include <list>
+#include <set>
 
 #include <ibpp.h>
 
@@ -35,6 +36,7 @@
 class Database;
 class DataGridRowBuffer;
 class ProgressIndicator;
+class SelectionAggregate;
 class wxMBConv;
 
 class ResultsetColumnDef
@@ -49,6 +51,8 @@ public:
         bool nullable = false);
     virtual ~ResultsetColumnDef();
 
+    // full precision and in a format that sorts like the column type
+    virtual wxString getAsComparableString(DataGridRowBuffer* buffer);
     virtual wxString getAsFirebirdString(DataGridRowBuffer* buffer);
     virtual wxString getAsString(DataGridRowBuffer* buffer) = 0;
     virtual void setFromString(DataGridRowBuffer* buffer,
@@ -57,10 +61,22 @@ public:
     wxString getName();
     virtual unsigned getIndex(); // for strings and blobs
     virtual bool isNumeric();
+    // adds the value of a numeric column, returns false if it hasn't any
+    virtual bool addToAggregate(DataGridRowBuffer* buffer,
+        SelectionAggregate& aggregate);
     bool isReadOnly();
     bool isNullable();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter) = 0;
+    // same as setValue(), but reads the field from the view of the fetched
+    // row, the default implementation uses setValue()
+    virtual void setValueFromView(DataGridRowBuffer* buffer, unsigned col,
+        const IBPP::ColumnView& view, const IBPP::Statement& statement,
+        wxMBConv* converter);
+    // the opposite of setValue(), sets the statement parameter to the
+    // field value
+    virtual void setParameter(DataGridRowBuffer* buffer,
+        IBPP::Statement& statement, unsigned param, wxMBConv* converter);
 };
 
 struct DataGridFieldInfo
@@ -95,15 +111,60 @@ private:
     std::list<UniqueConstraint> dbKeysM;
     unsigned bufferSizeM;
 
+    // changes that are kept until applyEdits(), by row
+    struct PendingEdit
+    {
+        // the row before it was first changed, with the key values
+        // that locate the record
+        DataGridRowBuffer* original;
+        std::set<unsigned> columns;
+        bool deleted;
+    };
+    bool deferEditsM;
+    std::map<unsigned, PendingEdit> pendingEditsM;
+    void discardPendingEdits(bool restoreRows);
+    // the buffer with the key values locating the record of the row in the
+    // database, which is the original row if it has pending changes
+    DataGridRowBuffer* getLocatorBuffer(unsigned row,
+        DataGridRowBuffer* current);
+
+    // the WHERE clause locating a record of the table, with a parameter
+    // for each of the key columns
+    struct RecordLocator
+    {
+        wxString where;
+        std::vector<unsigned> columns;
+    };
+    void getRecordLocator(UniqueConstraint* uq, const wxString& table,
+        RecordLocator& locator);
+    void setParameters(IBPP::Statement& st, unsigned& param,
+        const std::vector<unsigned>& columns, DataGridRowBuffer* buffer,
+        bool isKey, std::vector<wxString>& literals);
+
+    // BLOB cells of the grid show a preview which loadBlobPreviews()
+    // reads when the application is idle, most recently painted first
+    std::list<std::pair<unsigned, unsigned> > blobPreviewQueueM;
+    std::set<std::pair<unsigned, unsigned> > blobPreviewQueuedM;
+
+    // incremented whenever values are changed or rows removed
+    unsigned changeCountM;
+
     void getColumnInfo(Database* db, unsigned col, bool& readOnly,
         bool& nullable);
     IBPP::Statement addWhere(UniqueConstraint* uq, wxString& stm,
         const wxString& table, DataGridRowBuffer *buffer);
 public:
-    DataGridRows(Database* db);
+    // read-only rows don't look up the metadata of the result columns
+    DataGridRows(Database* db, bool readOnly = false);
     ~DataGridRows();
 
     void addRow(const IBPP::Statement& statement);
+    // reads the current row of the statement without storing it, the
+    // caller owns the returned buffer
+    DataGridRowBuffer* readRow(const IBPP::Statement& statement);
+    // same as above, for the row fetched with Statement::Fetch(ColumnViews&)
+    void addRow(const IBPP::ColumnViews& views);
+    DataGridRowBuffer* readRow(const IBPP::ColumnViews& views);
     void clear();
     unsigned getRowCount();
     unsigned getRowFieldCount();
@@ -114,21 +175,47 @@ public:
     bool isColumnNumeric(unsigned col);
     bool isColumnReadonly(unsigned col);
     bool isBlobColumn(unsigned col, bool* pIsTextual = 0);
+    // adds the values of rows fromRow to toRow of a numeric column
+    bool aggregateColumn(unsigned col, unsigned fromRow, unsigned toRow,
+        SelectionAggregate& aggregate);
+    unsigned getChangeCount() const;
     bool getFieldInfo(unsigned row, unsigned col, DataGridFieldInfo& info);
     bool isFieldReadonly(unsigned row, unsigned col);
     bool isFieldNull(unsigned row, unsigned col);
     bool isFieldNA(unsigned row, unsigned col);
 
     wxString getFieldValue(unsigned row, unsigned col);
+    // like getFieldValue(), but returns a placeholder for BLOB values that
+    // haven't been read yet and queues them for loadBlobPreviews()
+    wxString getFieldPreview(unsigned row, unsigned col);
+    bool hasBlobPreviewsQueued() const;
+    // reads queued BLOB previews until maxMillis have passed, returns
+    // whether any have been read
+    bool loadBlobPreviews(long maxMillis);
     wxString setFieldValue(unsigned row, unsigned col,
         const wxString& value, bool setNull = false);
     void importBlobFile(const wxString& filename, unsigned row, unsigned col,
         ProgressIndicator *pi);
     void exportBlobFile(const wxString& filename, unsigned row, unsigned col,
         ProgressIndicator *pi);
+    // writes the BLOBs of the (row, col) cells to one file each
+    unsigned exportBlobFiles(const wxString& directory,
+        const std::vector<std::pair<unsigned, unsigned> >& cells,
+        ProgressIndicator *pi);
     bool canRemoveRow(size_t row);
     bool removeRows(size_t from, size_t count, wxString& statement);
 
+    // when set, changed and deleted rows are only kept in memory until
+    // applyEdits() writes them all
+    void setDeferEdits(bool defer);
+    bool getDeferEdits() const;
+    size_t getPendingEditCount() const;
+    // executes the pending changes with one prepared statement per table
+    // and set of changed columns, either all of them or none, and returns
+    // the statements with their values for the log
+    wxString applyEdits();
+    void discardEdits();
+
     ResultsetColumnDef* getColumnDef(unsigned col);
     void addRow(DataGridRowBuffer* buffer);
 
@@ -31,13 +31,19 @@
 #endif
 
 #include <wx/grid.h>
+#include <wx/stream.h>
+#include <wx/txtstrm.h>
 
 #include <algorithm>
 #include <set>
 
 #include "config/Config.h"
+#include "config/DatabaseConfig.h"
 #include "core/FRError.h"
+#include "core/ProgressIndicator.h"
 #include "core/StringUtils.h"
+#include "gui/controls/DataGrid.h"
+#include "gui/controls/DataGridRowBuffer.h"
 #include "gui/controls/DataGridRows.h"
 #include "gui/controls/DataGridTable.h"
 #include "gui/AdvancedMessageDialog.h"
@@ -56,7 +62,9 @@ DataGridTable::DataGridTable(IBPP::Statement& s, Database* db)
     canInsertRowsIsSetM = false;
     canInsertRowsM = false;
     config().getValue("GridFetchAllRecords", fetchAllRowsM);
-    maxRowToFetchM = 100;
+    fetchBatchSizeM = 100;
+    logFetchStatsM = false;
+    maxRowToFetchM = fetchBatchSizeM;
     cellAttriM = new wxGridCellAttr();
 }
 
@@ -71,6 +79,35 @@ void DataGridTable::setNullFlag(bool isNull)
     nullFlagM = isNull;
 }
 
+void DataGridTable::readFetchSettings()
+{
+    fetchBatchSizeM = 100;
+    logFetchStatsM = false;
+    if (!databaseM)
+        return;
+
+    // on high-latency connections fetching bigger batches up front makes
+    // the grid fill (and scroll) with less waiting per round trip
+    DatabaseConfig dc(databaseM, config());
+    int batchSize = dc.get("GridFetchBatchSize", 100);
+    if (batchSize > 0)
+        fetchBatchSizeM = batchSize;
+    logFetchStatsM = dc.get("GridFetchLogStatistics", false);
+}
+
+bool DataGridTable::getWireRoundTrips(int64_t& roundTrips)
+{
+    try
+    {
+        return databaseM && databaseM->getIBPPDatabase()->WireStatistics(
+            &roundTrips, 0, 0, 0, 0);
+    }
+    catch (IBPP::Exception&)
+    {
+    }
+    return false;
+}
+
 // implementation methods
 bool DataGridTable::canFetchMoreRows()
 {
@@ -126,16 +163,18 @@ void DataGridTable::fetch()
     if (!canFetchMoreRows())
         return;
 
-    // fetch the first 100 rows no matter how long it takes
+    // fetch the first batch of rows no matter how long it takes
     unsigned oldRows = rowsM.getRowCount();
     bool initial = oldRows == 0;
+    int64_t roundTrips1 = 0;
+    bool hasWireStats = logFetchStatsM && getWireRoundTrips(roundTrips1);
     // fetch more rows until maxRowToFetchM reached or 100 ms elapsed
     wxLongLong startms = ::wxGetLocalTimeMillis();
     do
     {
         try
         {
-            if (!statementM->Fetch())
+            if (!statementM->Fetch(columnViewsM))
                 allRowsFetchedM = true;
         }
         catch (IBPP::Exception& e)
@@ -152,13 +191,29 @@ void DataGridTable::fetch()
         }
         if (allRowsFetchedM)
             break;
-        rowsM.addRow(statementM);
+        rowsM.addRow(columnViewsM);
 
         if (!initial && (::wxGetLocalTimeMillis() - startms > 100))
             break;
     }
     while ((fetchAllRowsM && !initial) || rowsM.getRowCount() < maxRowToFetchM);
 
+    // per batch statistics, used to tune the batch size per database
+    wxString fetchStats;
+    if (logFetchStatsM && rowsM.getRowCount() > oldRows)
+    {
+        wxLongLong elapsed = ::wxGetLocalTimeMillis() - startms;
+        fetchStats = wxString::Format(_("Fetched %u rows in %s ms"),
+            rowsM.getRowCount() - oldRows, elapsed.ToString().c_str());
+        int64_t roundTrips2 = 0;
+        if (hasWireStats && getWireRoundTrips(roundTrips2))
+        {
+            fetchStats += wxString::Format(_(", %s network round trips"),
+                wxLongLong(roundTrips2 - roundTrips1).ToString().c_str());
+        }
+        fetchStats += ".";
+    }
+
     if (rowsM.getRowCount() > oldRows && GetView())   // notify the grid
     {
         wxGridTableMessage msg(this, wxGRIDTABLE_NOTIFY_ROWS_APPENDED,
@@ -167,6 +222,7 @@ void DataGridTable::fetch()
         // used in frame to update status bar
         wxCommandEvent evt(wxEVT_FRDG_ROWCOUNT_CHANGED, GetView()->GetId());
         evt.SetExtraLong(rowsM.getRowCount());
+        evt.SetString(fetchStats);
         wxPostEvent(GetView(), evt);
     }
 }
@@ -425,9 +481,11 @@ wxString DataGridTable::GetValue(int row, int col)
     if (!isValidCellPos(row, col))
         return wxEmptyString;
 
-    // keep between 200 and 250 more rows fetched for better responsiveness
+    // keep between 200 and 250 more rows (or one fetch batch, if bigger)
+    // fetched for better responsiveness
     // (but make the count of fetched rows a multiple of 50)
-    unsigned maxRowToFetch = 50 * (row / 50 + 5);
+    unsigned ahead = std::max(fetchBatchSizeM, 250u);
+    unsigned maxRowToFetch = 50 * ((row + ahead) / 50);
     if (maxRowToFetchM < maxRowToFetch)
         maxRowToFetchM = maxRowToFetch;
 
@@ -435,8 +493,15 @@ wxString DataGridTable::GetValue(int row, int col)
         return "N/A";
     if (rowsM.isFieldNull(row, col))
         return "[null]";
+    // BLOB values are read later, the grid is told when there is work
+    bool previewsQueued = rowsM.hasBlobPreviewsQueued();
     // limit returned string to first line (speeds up output in grid)
-    wxString s(rowsM.getFieldValue(row, col));
+    wxString s(rowsM.getFieldPreview(row, col));
+    if (!previewsQueued && rowsM.hasBlobPreviewsQueued())
+    {
+        if (DataGrid* grid = dynamic_cast<DataGrid*>(GetView()))
+            grid->loadBlobPreviewsOnIdle();
+    }
     size_t eol = s.find_first_of("\r\n");
     if (eol != wxString::npos)
         s.erase(eol);
@@ -450,7 +515,8 @@ void DataGridTable::initialFetch(bool readonly)
     readOnlyM = readonly;
     canInsertRowsIsSetM = false;
     canInsertRowsM = false;
-    maxRowToFetchM = 100;
+    readFetchSettings();
+    maxRowToFetchM = fetchBatchSizeM;
 
     try
     {
@@ -500,6 +566,17 @@ bool DataGridTable::isNumericColumn(int col)
     return rowsM.isColumnNumeric(col);
 }
 
+bool DataGridTable::aggregateColumn(int col, int fromRow, int toRow,
+    SelectionAggregate& aggregate)
+{
+    return rowsM.aggregateColumn(col, fromRow, toRow, aggregate);
+}
+
+unsigned DataGridTable::getChangeCount()
+{
+    return rowsM.getChangeCount();
+}
+
 bool DataGridTable::isReadonlyColumn(int col)
 {
     return readOnlyM || rowsM.isColumnReadonly(col);
@@ -576,6 +653,282 @@ void DataGridTable::exportBlobFile(const wxString& filename, int row, int col,
     rowsM.exportBlobFile(filename, row, col, pi);
 }
 
+unsigned DataGridTable::exportBlobFiles(const wxString& directory,
+    const std::vector<std::pair<unsigned, unsigned> >& cells,
+    ProgressIndicator *pi)
+{
+    return rowsM.exportBlobFiles(directory, cells, pi);
+}
+
+// reads records of delimited text, fields may be enclosed in double quotes
+// and then contain delimiters, doubled quotes and line breaks
+class DelimitedTextReader
+{
+private:
+    wxInputStream& inputM;
+    wxTextInputStream textM;
+    wxChar delimiterM;
+    bool readLine(wxString& line);
+    void detectDelimiter(const wxString& line);
+public:
+    DelimitedTextReader(wxInputStream& input);
+    // unquoted empty fields and the "NULL" and "[null]" written by
+    // the CSV export and clipboard copy are returned as NULL
+    bool readRecord(std::vector<wxString>& values, std::vector<bool>& nulls);
+};
+
+DelimitedTextReader::DelimitedTextReader(wxInputStream& input)
+    : inputM(input), textM(input), delimiterM(0)
+{
+}
+
+bool DelimitedTextReader::readLine(wxString& line)
+{
+    if (inputM.Eof())
+        return false;
+    line = textM.ReadLine();
+    return !line.empty() || !inputM.Eof();
+}
+
+void DelimitedTextReader::detectDelimiter(const wxString& line)
+{
+    // use the candidate that occurs most often outside of quotes
+    static const wxChar candidates[] = { '\t', ';', ',' };
+    size_t counts[] = { 0, 0, 0 };
+    bool quoted = false;
+    for (wxString::const_iterator it = line.begin(); it != line.end(); ++it)
+    {
+        if (*it == '"')
+            quoted = !quoted;
+        for (size_t i = 0; !quoted && i < 3; ++i)
+        {
+            if (*it == candidates[i])
+                ++counts[i];
+        }
+    }
+    delimiterM = ',';
+    size_t maxCount = 0;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        if (counts[i] > maxCount)
+        {
+            delimiterM = candidates[i];
+            maxCount = counts[i];
+        }
+    }
+}
+
+bool DelimitedTextReader::readRecord(std::vector<wxString>& values,
+    std::vector<bool>& nulls)
+{
+    wxString line;
+    do
+    {
+        if (!readLine(line))
+            return false;
+    }
+    while (line.empty());   // skip blank lines
+    if (delimiterM == 0)
+        detectDelimiter(line);
+
+    values.clear();
+    nulls.clear();
+    wxString value;
+    bool quoted = false, wasQuoted = false;
+    while (true)
+    {
+        for (size_t i = 0; i < line.length(); ++i)
+        {
+            wxChar c = line[i];
+            if (quoted)
+            {
+                if (c != '"')
+                    value += c;
+                else if (i + 1 < line.length() && line[i + 1] == '"')
+                {
+                    value += c;
+                    ++i;
+                }
+                else
+                    quoted = false;
+            }
+            else if (c == '"' && value.empty() && !wasQuoted)
+                quoted = wasQuoted = true;
+            else if (c == delimiterM)
+            {
+                nulls.push_back((!wasQuoted && value.empty())
+                    || value == "NULL" || value == "[null]");
+                values.push_back(value);
+                value.clear();
+                wasQuoted = false;
+            }
+            else
+                value += c;
+        }
+        // line break inside a quoted value
+        if (!quoted || !readLine(line))
+            break;
+        value += '\n';
+    }
+    nulls.push_back((!wasQuoted && value.empty())
+        || value == "NULL" || value == "[null]");
+    values.push_back(value);
+    return true;
+}
+
+unsigned DataGridTable::importRows(const wxString& table,
+    wxInputStream& source, ProgressIndicator *pi)
+{
+    FieldSet fields;
+    getFields(table, fields);
+    if (fields.empty())
+        throw FRError(_("No columns of the table can be inserted."));
+
+    DelimitedTextReader reader(source);
+    std::vector<wxString> values;
+    std::vector<bool> nulls;
+    if (!reader.readRecord(values, nulls))
+        return 0;
+
+    // a first record that names columns of the table is a header which
+    // selects the columns, otherwise the values are taken in grid order
+    std::vector<int> columns;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        for (FieldSet::iterator it = fields.begin(); it != fields.end(); ++it)
+        {
+            if (values[i].CmpNoCase((*it).second.second->getName_()) == 0)
+            {
+                columns.push_back((*it).first);
+                break;
+            }
+        }
+    }
+    bool hasHeader = (columns.size() == values.size());
+    if (!hasHeader)
+    {
+        columns.clear();
+        for (FieldSet::iterator it = fields.begin(); it != fields.end()
+            && columns.size() < values.size(); ++it)
+        {
+            columns.push_back((*it).first);
+        }
+    }
+
+    wxString sql = "INSERT INTO "
+        + Identifier(table, databaseM->getSqlDialect()).getQuoted() + " (";
+    wxString params;
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        if (i > 0)
+        {
+            sql += ", ";
+            params += ", ";
+        }
+        sql += fields[columns[i]].second->getQuotedName();
+        params += "?";
+    }
+    sql += ") VALUES (" + params + ")";
+
+    // the rows are committed in batches by a transaction of their own, so
+    // a long import neither holds the grid transaction nor grows without
+    // bound, and a cancelled or failed import keeps the committed batches
+    int commitInterval = config().get("DataGridImportCommitInterval", 1000);
+    if (commitInterval < 1)
+        commitInterval = 1;
+    IBPP::Transaction tr = IBPP::TransactionFactory(
+        statementM->DatabasePtr(), IBPP::amWrite, IBPP::ilConcurrency,
+        IBPP::lrNoWait);
+    tr->Start();
+    IBPP::Statement st = IBPP::StatementFactory(statementM->DatabasePtr(),
+        tr);
+    wxMBConv* conv = databaseM->getCharsetConverter();
+    st->Prepare(wx2std(sql, conv));
+
+    wxFileOffset length = source.GetLength();
+    if (pi)
+    {
+        if (length != wxInvalidOffset && length > 0)
+            pi->initProgress(_("Importing rows..."), length);
+        else
+            pi->initProgressIndeterminate(_("Importing rows..."));
+    }
+
+    DataGridRowBuffer buffer(GetNumberCols());
+    unsigned recNo = 0, committed = 0;
+    bool haveRecord = !hasHeader || reader.readRecord(values, nulls);
+    while (haveRecord)
+    {
+        ++recNo;
+        try
+        {
+            if (values.size() > columns.size())
+            {
+                throw FRError(wxString::Format(
+                    _("%d values found, but only %d columns are imported."),
+                    int(values.size()), int(columns.size())));
+            }
+            for (size_t i = 0; i < columns.size(); ++i)
+            {
+                int param = i + 1;
+                if (i >= values.size() || nulls[i])
+                    st->SetNull(param);
+                else if (rowsM.isBlobColumn(columns[i]))
+                    st->Set(param, wx2std(values[i], conv));
+                else
+                {
+                    ResultsetColumnDef* def = fields[columns[i]].first;
+                    def->setFromString(&buffer, values[i]);
+                    buffer.setFieldNull(columns[i], false);
+                    def->setParameter(&buffer, st, param, conv);
+                }
+            }
+            st->Execute();
+        }
+        catch (std::exception& e)
+        {
+            tr->Rollback();
+            throw FRError(wxString::Format(
+                _("Import failed at row %d: %s\n%d rows have been committed."),
+                int(recNo), wxString(e.what()).c_str(), int(committed)));
+        }
+
+        if (recNo % unsigned(commitInterval) == 0)
+        {
+            tr->CommitRetain();
+            committed = recNo;
+        }
+        if (recNo % 100 == 0 && pi)
+        {
+            if (pi->isCanceled())
+                break;
+            if (length != wxInvalidOffset && length > 0)
+                pi->setProgressPosition(source.TellI());
+            pi->setProgressMessage(wxString::Format(
+                _("%d rows imported..."), int(recNo)));
+        }
+        haveRecord = reader.readRecord(values, nulls);
+    }
+
+    if (pi && pi->isCanceled())
+    {
+        tr->Rollback();
+        return committed;
+    }
+    tr->Commit();
+    return recNo;
+}
+
+bool DataGridTable::hasBlobPreviewsQueued()
+{
+    return rowsM.hasBlobPreviewsQueued();
+}
+
+bool DataGridTable::loadBlobPreviews(long maxMillis)
+{
+    return rowsM.loadBlobPreviews(maxMillis);
+}
+
 bool DataGridTable::isBlobColumn(int col, bool* pIsTextual)
 {
     return rowsM.isBlobColumn(col, pIsTextual);
@@ -597,10 +950,14 @@ void DataGridTable::SetValue(int row, int col, const wxString& value)
 
         if (wxGrid* grid = GetView())
         {
-            // used in frame to show executed statements
-            wxCommandEvent evt(wxEVT_FRDG_STATEMENT, grid->GetId());
-            evt.SetString(statement);
-            wxPostEvent(grid, evt);
+            // used in frame to show executed statements, there are none
+            // when the change is deferred
+            if (!statement.empty())
+            {
+                wxCommandEvent evt(wxEVT_FRDG_STATEMENT, grid->GetId());
+                evt.SetString(statement);
+                wxPostEvent(grid, evt);
+            }
 
             // used in frame to repaint cell (text color may have changed)
             wxCommandEvent evt2(wxEVT_FRDG_INVALIDATEATTR, grid->GetId());
@@ -655,9 +1012,12 @@ bool DataGridTable::DeleteRows(size_t pos, size_t numRows)
 
         // used in frame to show executed statements
         wxGrid* grid = GetView();
-        wxCommandEvent evt2(wxEVT_FRDG_STATEMENT, grid->GetId());
-        evt2.SetString(statement);
-        wxPostEvent(grid, evt2);
+        if (!statement.empty())
+        {
+            wxCommandEvent evt2(wxEVT_FRDG_STATEMENT, grid->GetId());
+            evt2.SetString(statement);
+            wxPostEvent(grid, evt2);
+        }
 
         if (numRows > 0)
             grid->ForceRefresh();
@@ -678,6 +1038,69 @@ bool DataGridTable::DeleteRows(size_t pos, size_t numRows)
     return false;
 }
 
+void DataGridTable::setDeferEdits(bool defer)
+{
+    rowsM.setDeferEdits(defer);
+}
+
+bool DataGridTable::hasPendingEdits()
+{
+    return rowsM.getPendingEditCount() > 0;
+}
+
+bool DataGridTable::applyEdits()
+{
+    if (!hasPendingEdits())
+        return true;
+    try
+    {
+        wxString statements = rowsM.applyEdits();
+        if (wxGrid* grid = GetView())
+        {
+            // used in frame to show executed statements
+            wxCommandEvent evt(wxEVT_FRDG_STATEMENT, grid->GetId());
+            evt.SetString(statements);
+            wxPostEvent(grid, evt);
+
+            wxCommandEvent evt2(wxEVT_FRDG_INVALIDATEATTR, grid->GetId());
+            wxPostEvent(grid, evt2);
+        }
+        return true;
+    }
+    catch (const FRError& err)
+    {
+        showErrorDialog(wxGetTopLevelParent(wxGetActiveWindow()),
+            _("Invalid data"), err.what(),
+            AdvancedMessageDialogButtonsOk());
+    }
+    catch (const IBPP::Exception& e)
+    {
+        showErrorDialog(wxGetTopLevelParent(wxGetActiveWindow()),
+            _("Database error"), e.what(),
+            AdvancedMessageDialogButtonsOk());
+    }
+    catch (...)
+    {
+        showErrorDialog(wxGetTopLevelParent(wxGetActiveWindow()),
+            _("System error"), _("Unhandled exception"),
+            AdvancedMessageDialogButtonsOk());
+    }
+    return false;
+}
+
+void DataGridTable::discardEdits()
+{
+    if (!hasPendingEdits())
+        return;
+    rowsM.discardEdits();
+    if (wxGrid* grid = GetView())
+    {
+        wxCommandEvent evt(wxEVT_FRDG_INVALIDATEATTR, grid->GetId());
+        wxPostEvent(grid, evt);
+        grid->ForceRefresh();
+    }
+}
+
 DEFINE_EVENT_TYPE(wxEVT_FRDG_ROWCOUNT_CHANGED)
 DEFINE_EVENT_TYPE(wxEVT_FRDG_STATEMENT)
 DEFINE_EVENT_TYPE(wxEVT_FRDG_INVALIDATEATTR)
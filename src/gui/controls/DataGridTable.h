@@ -37,6 +37,7 @@ class DataGridCell;
 class ResultsetColumnDef;
 class DataGridRowBuffer;
 class ProgressIndicator;
+class wxInputStream;
 
 BEGIN_DECLARE_EVENT_TYPES()
     // this event is sent after new rows have been fetched
@@ -54,6 +55,8 @@ private:
     bool allRowsFetchedM;
     bool fetchAllRowsM;
     unsigned maxRowToFetchM;
+    unsigned fetchBatchSizeM;
+    bool logFetchStatsM;
     bool readOnlyM;
     bool canInsertRowsIsSetM;
     bool canInsertRowsM;
@@ -65,9 +68,13 @@ private:
 
     Database *databaseM;
     IBPP::Statement& statementM;
+    // reused for every fetched row, so fetching allocates no column values
+    IBPP::ColumnViews columnViewsM;
     wxMBConv* charsetConverterM;
 
     int getStatementColCount();
+    void readFetchSettings();
+    bool getWireRoundTrips(int64_t& roundTrips);
     bool isValidCellPos(int row, int col);
 public:
     DataGridTable(IBPP::Statement& s, Database* db);
@@ -93,8 +100,17 @@ public:
     bool isNullableColumn(int col);
     bool isNullCell(int row, int col);
     bool isNumericColumn(int col);
+    // adds the numeric values of rows fromRow to toRow of the column
+    bool aggregateColumn(int col, int fromRow, int toRow,
+        SelectionAggregate& aggregate);
+    // changes whenever values are edited or rows are removed
+    unsigned getChangeCount();
     bool isReadonlyColumn(int col);
     bool isBlobColumn(int col, bool* pIsTextual = 0);
+    // GetValue() shows placeholders for BLOBs, which are read in the
+    // idle time of the grid
+    bool hasBlobPreviewsQueued();
+    bool loadBlobPreviews(long maxMillis);
     bool needsMoreRowsFetched();
     void setFetchAllRecords(bool fetchall);
     bool canInsertRows();
@@ -102,6 +118,13 @@ public:
 
     void setNullFlag(bool isNull);
 
+    // deferred changes are written by applyEdits(), which returns false
+    // and keeps them when that fails
+    void setDeferEdits(bool defer);
+    bool hasPendingEdits();
+    bool applyEdits();
+    void discardEdits();
+
     // methods of wxGridTableBase
     virtual void Clear();
     virtual wxGridCellAttr* GetAttr(int row, int col,
@@ -125,6 +148,15 @@ public:
         ProgressIndicator *pi = 0);
     void exportBlobFile(const wxString& filename, int row, int col,
         ProgressIndicator *pi = 0);
+    // saves the BLOBs of the given cells to one file each, returns the
+    // number of files written
+    unsigned exportBlobFiles(const wxString& directory,
+        const std::vector<std::pair<unsigned, unsigned> >& cells,
+        ProgressIndicator *pi = 0);
+    // inserts tab, comma or semicolon separated text as new rows of the
+    // table, committing in batches; returns the number of rows committed
+    unsigned importRows(const wxString& table, wxInputStream& source,
+        ProgressIndicator *pi = 0);
 };
 
 #endif
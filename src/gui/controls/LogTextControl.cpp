@@ -70,6 +70,20 @@ void LogTextControl::ClearAll()
     SetReadOnly(true);
 }
 
+void LogTextControl::discardOldLines(int maxLines)
+{
+    int excess = GetLineCount() - maxLines;
+    if (excess <= 0)
+        return;
+
+    SetReadOnly(false);
+    int removed = PositionFromLine(excess);
+    int pos = GetCurrentPos();
+    DeleteRange(0, removed);
+    GotoPos(pos > removed ? pos - removed : 0);
+    SetReadOnly(true);
+}
+
 void LogTextControl::logErrorMsg(const wxString& message)
 {
     addStyledText(message, logStyleError);
@@ -41,6 +41,8 @@ public:
     void logErrorMsg(const wxString& message);
     void logImportantMsg(const wxString& message);
     void logMsg(const wxString& message);
+    // removes the oldest lines so that at most maxLines are left
+    void discardOldLines(int maxLines);
 protected:
     void OnCommandClearAll(wxCommandEvent& event);
     void OnCommandUpdate(wxUpdateUIEvent& event);
@@ -0,0 +1,109 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+#include <vector>
+
+#include "gui/controls/PlanTreeControl.h"
+
+PlanTreeControl::PlanTreeControl(wxWindow* parent, wxWindowID id)
+    : wxTreeCtrl(parent, id, wxDefaultPosition, wxDefaultSize,
+        wxTR_DEFAULT_STYLE | wxTR_HIDE_ROOT | wxTR_SINGLE)
+{
+    AddRoot(wxEmptyString);
+}
+
+void PlanTreeControl::clearPlan()
+{
+    DeleteAllItems();
+    AddRoot(wxEmptyString);
+}
+
+int PlanTreeControl::setPlan(const PlanNodes& nodes,
+    const RowEstimates& estimates, double warningRows, wxMBConv* converter)
+{
+    Freeze();
+    clearPlan();
+
+    int warnings = 0;
+    // the last item added at each level, parents of the following nodes
+    std::vector<wxTreeItemId> parents;
+    parents.push_back(GetRootItem());
+    for (PlanNodes::const_iterator it = nodes.begin(); it != nodes.end();
+        ++it)
+    {
+        const PlanNode& node = *it;
+        // a malformed plan could skip levels, attach to the deepest parent
+        size_t level = std::min(size_t(node.level + 1), parents.size());
+        parents.resize(level);
+
+        wxString text(node.text.c_str(), *converter);
+        double rows = -1;
+        if (!node.relation.empty() && node.kind != PlanNode::nkProcedure)
+        {
+            RowEstimates::const_iterator est = estimates.find(node.relation);
+            if (est != estimates.end() && (*est).second > 0)
+            {
+                rows = (*est).second;
+                text += wxString::Format(_("  [~%.0f rows]"), rows);
+            }
+        }
+
+        wxTreeItemId item = AppendItem(parents.back(), text);
+        parents.push_back(item);
+
+        if (node.kind == PlanNode::nkNaturalScan)
+        {
+            SetItemTextColour(item, *wxRED);
+            if (rows >= warningRows)
+            {
+                SetItemBold(item);
+                ++warnings;
+            }
+        }
+        else if (node.kind == PlanNode::nkJoin
+            || node.kind == PlanNode::nkExpression)
+        {
+            SetItemBold(item);
+        }
+    }
+
+    // wxTreeCtrl::ExpandAll() doesn't work with a hidden root on all ports
+    wxTreeItemIdValue cookie;
+    for (wxTreeItemId item = GetFirstChild(GetRootItem(), cookie);
+        item.IsOk(); item = GetNextChild(GetRootItem(), cookie))
+    {
+        ExpandAllChildren(item);
+    }
+    Thaw();
+    return warnings;
+}
@@ -0,0 +1,50 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef PLANTREECONTROL_H
+#define PLANTREECONTROL_H
+
+#include <wx/treectrl.h>
+
+#include <map>
+#include <string>
+
+#include "engine/PlanTree.h"
+
+// Shows the plan of a statement as a collapsible tree. Tables are annotated
+// with their estimated size, natural scans of large tables are highlighted.
+class PlanTreeControl: public wxTreeCtrl
+{
+public:
+    // estimated number of rows by relation name, as used in the plan
+    typedef std::map<std::string, double> RowEstimates;
+
+    PlanTreeControl(wxWindow* parent, wxWindowID id = wxID_ANY);
+
+    void clearPlan();
+    // returns the number of highlighted natural scans
+    int setPlan(const PlanNodes& nodes, const RowEstimates& estimates,
+        double warningRows, wxMBConv* converter);
+};
+
+#endif // PLANTREECONTROL_H
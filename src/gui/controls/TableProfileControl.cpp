@@ -0,0 +1,157 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+
+#include "gui/controls/TableProfileControl.h"
+
+namespace
+{
+
+enum ProfileColumn { colTable, colSeqReads, colIdxReads, colInserts,
+    colUpdates, colDeletes, colBackouts, colPurges, colExpunges,
+    colCount };
+
+int getCount(const TableProfileControl::TableProfile& profile, int column)
+{
+    const IBPP::CountInfo& c = profile.counts;
+    switch (column)
+    {
+        case colSeqReads:   return c.seqReads;
+        case colIdxReads:   return c.idxReads;
+        case colInserts:    return c.inserts;
+        case colUpdates:    return c.updates;
+        case colDeletes:    return c.deletes;
+        case colBackouts:   return c.backouts;
+        case colPurges:     return c.purges;
+        case colExpunges:   return c.expunges;
+    }
+    return 0;
+}
+
+class ProfileLess
+{
+private:
+    int columnM;
+    bool ascendingM;
+public:
+    ProfileLess(int column, bool ascending)
+        : columnM(column), ascendingM(ascending) {}
+    bool operator()(const TableProfileControl::TableProfile& left,
+        const TableProfileControl::TableProfile& right) const
+    {
+        const TableProfileControl::TableProfile& a = ascendingM ? left : right;
+        const TableProfileControl::TableProfile& b = ascendingM ? right : left;
+        if (columnM == colTable)
+            return a.tableName.CmpNoCase(b.tableName) < 0;
+        int ca = getCount(a, columnM), cb = getCount(b, columnM);
+        if (ca != cb)
+            return ca < cb;
+        // keep a stable order for equal counts
+        return left.tableName.CmpNoCase(right.tableName) < 0;
+    }
+};
+
+} // namespace
+
+TableProfileControl::TableProfileControl(wxWindow* parent, wxWindowID id)
+    : wxListCtrl(parent, id, wxDefaultPosition, wxDefaultSize,
+        wxLC_REPORT | wxLC_SINGLE_SEL),
+    sortColumnM(colSeqReads), sortAscendingM(false)
+{
+    InsertColumn(colTable, _("Table"));
+    InsertColumn(colSeqReads, _("Natural reads"), wxLIST_FORMAT_RIGHT);
+    InsertColumn(colIdxReads, _("Indexed reads"), wxLIST_FORMAT_RIGHT);
+    InsertColumn(colInserts, _("Inserts"), wxLIST_FORMAT_RIGHT);
+    InsertColumn(colUpdates, _("Updates"), wxLIST_FORMAT_RIGHT);
+    InsertColumn(colDeletes, _("Deletes"), wxLIST_FORMAT_RIGHT);
+    InsertColumn(colBackouts, _("Backouts"), wxLIST_FORMAT_RIGHT);
+    InsertColumn(colPurges, _("Purges"), wxLIST_FORMAT_RIGHT);
+    InsertColumn(colExpunges, _("Expunges"), wxLIST_FORMAT_RIGHT);
+    SetColumnWidth(colTable, 200);
+}
+
+void TableProfileControl::clearProfiles()
+{
+    profilesM.clear();
+    DeleteAllItems();
+}
+
+void TableProfileControl::setProfiles(const TableProfiles& profiles)
+{
+    profilesM = profiles;
+    showProfiles();
+}
+
+void TableProfileControl::showProfiles()
+{
+    std::sort(profilesM.begin(), profilesM.end(),
+        ProfileLess(sortColumnM, sortAscendingM));
+
+    Freeze();
+    DeleteAllItems();
+    for (size_t i = 0; i < profilesM.size(); ++i)
+    {
+        long item = InsertItem(long(i), profilesM[i].tableName);
+        for (int col = colSeqReads; col < colCount; ++col)
+        {
+            int count = getCount(profilesM[i], col);
+            if (count != 0)
+                SetItem(item, col, wxString::Format("%d", count));
+        }
+        // tables read in natural order are usually what one looks for
+        if (profilesM[i].counts.seqReads > 0)
+            SetItemTextColour(item, *wxRED);
+    }
+    Thaw();
+}
+
+BEGIN_EVENT_TABLE(TableProfileControl, wxListCtrl)
+    EVT_LIST_COL_CLICK(wxID_ANY, TableProfileControl::OnColumnClick)
+END_EVENT_TABLE()
+
+void TableProfileControl::OnColumnClick(wxListEvent& event)
+{
+    int column = event.GetColumn();
+    if (column < 0 || column >= colCount)
+        return;
+    // clicking the sorted column again reverses the order, counts are
+    // sorted descending first
+    if (column == sortColumnM)
+        sortAscendingM = !sortAscendingM;
+    else
+    {
+        sortColumnM = column;
+        sortAscendingM = (column == colTable);
+    }
+    showProfiles();
+}
@@ -0,0 +1,60 @@
+/*
+  Copyright (c) 2004-2016 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef TABLEPROFILECONTROL_H
+#define TABLEPROFILECONTROL_H
+
+#include <wx/listctrl.h>
+
+#include <vector>
+
+#include <ibpp.h>
+
+// Shows the per-table record counters of a statement execution, sortable
+// by clicking on the column headers
+class TableProfileControl: public wxListCtrl
+{
+public:
+    struct TableProfile
+    {
+        wxString tableName;
+        IBPP::CountInfo counts;
+    };
+    typedef std::vector<TableProfile> TableProfiles;
+
+    TableProfileControl(wxWindow* parent, wxWindowID id = wxID_ANY);
+
+    void clearProfiles();
+    void setProfiles(const TableProfiles& profiles);
+private:
+    TableProfiles profilesM;
+    int sortColumnM;
+    bool sortAscendingM;
+
+    void showProfiles();
+
+    void OnColumnClick(wxListEvent& event);
+    DECLARE_EVENT_TABLE()
+};
+
+#endif // TABLEPROFILECONTROL_H
@@ -262,6 +262,7 @@ FBCLIENT* FBCLIENT::Call()
 		IB_ENTRYPOINT(get_segment);
 		IB_ENTRYPOINT(put_segment);
 		IB_ENTRYPOINT(blob_info);
+		IB_ENTRYPOINT(seek_blob);
 		IB_ENTRYPOINT(array_lookup_bounds);
 		IB_ENTRYPOINT(array_get_slice);
 		IB_ENTRYPOINT(array_put_slice);
@@ -64,6 +64,39 @@
 #define ASSERTION(x)    /* x */
 #endif
 
+//  Firebird v4 data types, not declared by the bundled (v2.5) ibase.h
+#ifndef SQL_INT128
+#define SQL_TIMESTAMP_TZ_EX                32748
+#define SQL_TIME_TZ_EX                     32750
+#define SQL_INT128                         32752
+#define SQL_TIMESTAMP_TZ                   32754
+#define SQL_TIME_TZ                        32756
+#define SQL_DEC16                          32760
+#define SQL_DEC34                          32762
+
+//  The *_EX variants add the offset of the time zone at that moment,
+//  output columns WITH TIME ZONE are coerced to them
+typedef struct
+{
+    ISC_TIME utc_time;
+    ISC_USHORT time_zone;
+    ISC_SHORT ext_offset;
+} ISC_TIME_TZ_EX;
+
+typedef struct
+{
+    ISC_TIMESTAMP utc_timestamp;
+    ISC_USHORT time_zone;
+    ISC_SHORT ext_offset;
+} ISC_TIMESTAMP_TZ_EX;
+#endif
+
+//  Firebird v5 service parameter, not declared by the bundled ibase.h
+#ifndef isc_spb_bkp_parallel_workers
+#define isc_spb_bkp_parallel_workers       21
+#define isc_spb_res_parallel_workers       isc_spb_bkp_parallel_workers
+#endif
+
 namespace ibpp_internals
 {
 
@@ -116,7 +149,7 @@ class EventsImpl;
 //  Native data types
 typedef enum {ivArray, ivBlob, ivDate, ivTime, ivTimestamp, ivString,
             ivInt16, ivInt32, ivInt64, ivFloat, ivDouble,
-            ivBool, ivDBKey, ivByte} IITYPE;
+            ivBool, ivDBKey, ivByte, ivInt128, ivDecFloat} IITYPE;
 
 //
 //  Those are the Interbase C API prototypes that we use
@@ -200,6 +233,12 @@ typedef ISC_STATUS  ISC_EXPORT proto_blob_info (ISC_STATUS *,
                       short,
                       char *);
 
+typedef ISC_STATUS  ISC_EXPORT proto_seek_blob (ISC_STATUS *,
+                      isc_blob_handle *,
+                      short,
+                      ISC_LONG,
+                      ISC_LONG *);
+
 typedef ISC_STATUS  ISC_EXPORT proto_array_lookup_bounds (ISC_STATUS *,
                         isc_db_handle *,
                         isc_tr_handle *,
@@ -419,6 +458,7 @@ struct FBCLIENT
     proto_get_segment*              m_get_segment;
     proto_put_segment*              m_put_segment;
     proto_blob_info*                m_blob_info;
+    proto_seek_blob*                m_seek_blob;
     proto_array_lookup_bounds*      m_array_lookup_bounds;
     proto_array_get_slice*          m_array_get_slice;
     proto_array_put_slice*          m_array_put_slice;
@@ -572,7 +612,9 @@ class RB
 
 public:
     void Reset();
+    bool HasToken(char token) { return FindToken(token) != 0; }
     int GetValue(char token);
+    int64_t GetValue64(char token);
     int GetCountValue(char token);
     void GetDetailedCounts(IBPP::DatabaseCounts& counts, char token);
     int GetValue(char token, char subtoken);
@@ -752,6 +794,7 @@ private:
     std::string mUserName;      // User Name
     std::string mUserPassword;  // User Password
     std::string mWaitMessage;   // Progress message returned by WaitMsg()
+    std::string mPendingOutput; // Output read ahead by StartTrace()
 
     isc_svc_handle* GetHandlePtr() { return &mHandle; }
     void SetServerName(const char*);
@@ -795,8 +838,21 @@ public:
         IBPP::BRF flags = IBPP::BRF(0));
     void StartRestore(const std::string& bkfile, const std::string& dbfile,
         int pagesize, IBPP::BRF flags = IBPP::BRF(0));
+    void StartBackupStream(const std::string& dbfile, IBPP::BRF flags,
+        int parallelWorkers);
+    void StartRestoreStream(const std::string& dbfile, int pagesize,
+        IBPP::BRF flags, int parallelWorkers);
+
+    void StartDbStats(const std::string& dbfile, IBPP::STF flags,
+        const std::vector<std::string>& tables);
+    int StartTrace(const std::string& configuration, const std::string& name);
+    void StopTrace(int sessionId);
+    void ListTraces(std::vector<IBPP::TraceSession>& sessions);
 
     const char* WaitMsg();
+    bool ReadOutput(std::string& output, int timeout);
+    bool WriteInput(const char* data, int size, int& requested,
+        std::string& output, int timeout);
     void Wait();
 
     IBPP::IService* AddRef();
@@ -865,6 +921,8 @@ public:
     void Counts(int* Insert, int* Update, int* Delete,
         int* ReadIdx, int* ReadSeq);
     void DetailedCounts(IBPP::DatabaseCounts& counts);
+    bool WireStatistics(int64_t* RoundTrips, int64_t* PacketsSent,
+        int64_t* PacketsReceived, int64_t* BytesSent, int64_t* BytesReceived);
     void Users(std::vector<std::string>& users);
     int Dialect() { return mDialect; }
 
@@ -967,6 +1025,9 @@ public:
     void AllocVariables();
     bool MissingValues();       // Returns wether one of the mMissing[] is true
     XSQLDA* Self() { return mDescrArea; }
+    bool Shared() const { return mRefCount > 1; }
+    bool SameLayout(const RowImpl&) const;  // Same columns, types and sizes
+    void GetViews(IBPP::ColumnViews&);
 
     RowImpl& operator=(const RowImpl& copied);
     RowImpl(const RowImpl& copied);
@@ -989,6 +1050,8 @@ public:
     void Set(int, const IBPP::Timestamp&);
     void Set(int, const IBPP::Date&);
     void Set(int, const IBPP::Time&);
+    void Set(int, const IBPP::Int128&);
+    void Set(int, const IBPP::DecFloat&);
     void Set(int, const IBPP::DBKey&);
     void Set(int, const IBPP::Blob&);
     void Set(int, const IBPP::Array&);
@@ -1006,6 +1069,8 @@ public:
     bool Get(int, IBPP::Timestamp&);
     bool Get(int, IBPP::Date&);
     bool Get(int, IBPP::Time&);
+    bool Get(int, IBPP::Int128&);
+    bool Get(int, IBPP::DecFloat&);
     bool Get(int, IBPP::DBKey&);
     bool Get(int, IBPP::Blob&);
     bool Get(int, IBPP::Array&);
@@ -1023,6 +1088,8 @@ public:
     bool Get(const std::string&, IBPP::Timestamp&);
     bool Get(const std::string&, IBPP::Date&);
     bool Get(const std::string&, IBPP::Time&);
+    bool Get(const std::string&, IBPP::Int128&);
+    bool Get(const std::string&, IBPP::DecFloat&);
     bool Get(const std::string&, IBPP::DBKey&);
     bool Get(const std::string&, IBPP::Blob&);
     bool Get(const std::string&, IBPP::Array&);
@@ -1094,6 +1161,7 @@ public:
     inline void CursorExecute(const std::string& cursor)    { CursorExecute(cursor, std::string()); }
     bool Fetch();
     bool Fetch(IBPP::Row&);
+    bool Fetch(IBPP::ColumnViews&);
     int AffectedRows();
     void Close();   // Free resources, attachments maintained
     std::string& Sql() { return mSql; }
@@ -1112,6 +1180,8 @@ public:
     void Set(int, const IBPP::Timestamp&);
     void Set(int, const IBPP::Date&);
     void Set(int, const IBPP::Time&);
+    void Set(int, const IBPP::Int128&);
+    void Set(int, const IBPP::DecFloat&);
     void Set(int, const IBPP::DBKey&);
     void Set(int, const IBPP::Blob&);
     void Set(int, const IBPP::Array&);
@@ -1135,6 +1205,8 @@ public:
     bool Get(int, IBPP::Timestamp&);
     bool Get(int, IBPP::Date&);
     bool Get(int, IBPP::Time&);
+    bool Get(int, IBPP::Int128&);
+    bool Get(int, IBPP::DecFloat&);
     bool Get(int, IBPP::DBKey&);
     bool Get(int, IBPP::Blob&);
     bool Get(int, IBPP::Array&);
@@ -1158,6 +1230,8 @@ public:
     bool Get(const std::string&, IBPP::Timestamp&);
     bool Get(const std::string&, IBPP::Date&);
     bool Get(const std::string&, IBPP::Time&);
+    bool Get(const std::string&, IBPP::Int128&);
+    bool Get(const std::string&, IBPP::DecFloat&);
     bool Get(const std::string&, IBPP::DBKey&);
     bool Get(const std::string&, IBPP::Blob&);
     bool Get(const std::string&, IBPP::Array&);
@@ -1180,6 +1254,7 @@ public:
     int Parameters();
 
     void Plan(std::string&);
+    void ExplainedPlan(std::string&);
 
     IBPP::Database DatabasePtr() const;
     IBPP::Transaction TransactionPtr() const;
@@ -1221,12 +1296,15 @@ public:
 
 public:
     void Create();
+    void CreateStream();
     void Open();
     void Close();
     void Cancel();
     int Read(void*, int size);
     void Write(const void*, int size);
     void Info(int* Size, int* Largest, int* Segments);
+    bool IsStream();
+    int Seek(int Offset);
 
     void Save(const std::string& data);
     void Load(std::string& data);
@@ -1346,7 +1424,9 @@ class EventsImpl : public IBPP::IEvents
     ISC_LONG mId;           // Firebird internal Id of these events
     bool mQueued;           // Has isc_que_events() been called?
     bool mTrapped;          // EventHandled() was called since last que_events()
+    IBPP::EventsTrapInterface* mTrapInterface;
 
+    bool Append(const std::string&, IBPP::EventInterface*);
     void FireActions();
     void Queue();
     void Cancel();
@@ -1365,10 +1445,12 @@ public:
 
 public:
     void Add(const std::string&, IBPP::EventInterface*);
+    size_t Add(const std::vector<std::string>&, IBPP::EventInterface*);
     void Drop(const std::string&);
     void List(std::vector<std::string>&);
     void Clear();               // Drop all events
     void Dispatch();            // Dispatch NON async events
+    void SetTrapInterface(IBPP::EventsTrapInterface*);
 
     IBPP::Database DatabasePtr() const;
 
@@ -1385,6 +1467,12 @@ void decodeTime(IBPP::Time& tm, const ISC_TIME& isc_tm);
 void encodeTimestamp(ISC_TIMESTAMP& isc_ts, const IBPP::Timestamp& ts);
 void decodeTimestamp(IBPP::Timestamp& ts, const ISC_TIMESTAMP& isc_ts);
 
+void encodeTimeTz(ISC_TIME_TZ_EX& isc_tm, const IBPP::Time& tm);
+void decodeTimeTz(IBPP::Time& tm, const ISC_TIME_TZ_EX& isc_tm);
+
+void encodeTimestampTz(ISC_TIMESTAMP_TZ_EX& isc_ts, const IBPP::Timestamp& ts);
+void decodeTimestampTz(IBPP::Timestamp& ts, const ISC_TIMESTAMP_TZ_EX& isc_ts);
+
 struct consts   // See _ibpp.cpp for initializations of these constants
 {
     static const double dscales[19];
@@ -92,6 +92,25 @@ int RB::GetValue(char token)
 	return value;
 }
 
+int64_t RB::GetValue64(char token)
+{
+	int len;
+	char* p = FindToken(token);
+
+	if (p == 0)
+		throw LogicExceptionImpl("RB::GetValue64", _("Token not found."));
+
+	// isc_vax_integer() only handles up to 4 bytes, so 8 bytes values
+	// are assembled from their two little-endian halves
+	len = (*gds.Call()->m_vax_integer)(p+1, 2);
+	if (len <= 4)
+		return len == 0 ? 0 : (*gds.Call()->m_vax_integer)(p+3, (short)len);
+
+	uint32_t low = (uint32_t)(*gds.Call()->m_vax_integer)(p+3, 4);
+	int32_t high = (int32_t)(*gds.Call()->m_vax_integer)(p+7, (short)(len - 4));
+	return ((int64_t)high << 32) | low;
+}
+
 int RB::GetCountValue(char token)
 {
 	// Specifically used on tokens like isc_info_insert_count and the like
@@ -144,12 +163,17 @@ void RB::GetDetailedCounts(IBPP::DatabaseCounts& counts, char token)
             counts.insert(std::pair<int, IBPP::CountInfo>(id, ci));
             it = counts.find(id);
         }
-        if (token == isc_info_insert_count)
-            (*it).second.inserts += value;
-        if (token == isc_info_update_count)
-            (*it).second.updates += value;
-        if (token == isc_info_delete_count)
-            (*it).second.deletes += value;
+        switch (token)
+        {
+            case isc_info_insert_count :    (*it).second.inserts += value; break;
+            case isc_info_update_count :    (*it).second.updates += value; break;
+            case isc_info_delete_count :    (*it).second.deletes += value; break;
+            case isc_info_read_seq_count :  (*it).second.seqReads += value; break;
+            case isc_info_read_idx_count :  (*it).second.idxReads += value; break;
+            case isc_info_backout_count :   (*it).second.backouts += value; break;
+            case isc_info_purge_count :     (*it).second.purges += value; break;
+            case isc_info_expunge_count :   (*it).second.expunges += value; break;
+        }
         p += 6;
         len -= 6;
 	}
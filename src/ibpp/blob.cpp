@@ -68,6 +68,26 @@ void BlobImpl::Create()
 	mWriteMode = true;
 }
 
+void BlobImpl::CreateStream()
+{
+	if (mHandle != 0)
+		throw LogicExceptionImpl("Blob::CreateStream", _("Blob already opened."));
+	if (mDatabase == 0)
+		throw LogicExceptionImpl("Blob::CreateStream", _("No Database is attached."));
+	if (mTransaction == 0)
+		throw LogicExceptionImpl("Blob::CreateStream", _("No Transaction is attached."));
+
+	char bpb[] = {isc_bpb_version1, isc_bpb_type, 1, isc_bpb_type_stream};
+	IBS status;
+	(*gds.Call()->m_create_blob2)(status.Self(), mDatabase->GetHandlePtr(),
+		mTransaction->GetHandlePtr(), &mHandle, &mId, sizeof(bpb), bpb);
+	if (status.Errors())
+		throw SQLExceptionImpl(status, "Blob::CreateStream",
+			_("isc_create_blob failed."));
+	mIdAssigned = true;
+	mWriteMode = true;
+}
+
 void BlobImpl::Close()
 {
 	if (mHandle == 0) return;	// Not opened anyway
@@ -150,6 +170,41 @@ void BlobImpl::Info(int* Size, int* Largest, int* Segments)
 	if (Segments != 0) *Segments = result.GetValue(isc_info_blob_num_segments);
 }
 
+bool BlobImpl::IsStream()
+{
+	char items[] = {isc_info_blob_type};
+
+	if (mHandle == 0)
+		throw LogicExceptionImpl("Blob::IsStream", _("The Blob is not opened"));
+
+	IBS status;
+	RB result(100);
+	(*gds.Call()->m_blob_info)(status.Self(), &mHandle, sizeof(items), items,
+		(short)result.Size(), result.Self());
+	if (status.Errors())
+		throw SQLExceptionImpl(status, "Blob::IsStream", _("isc_blob_info failed."));
+
+	return result.GetValue(isc_info_blob_type) == isc_bpb_type_stream;
+}
+
+int BlobImpl::Seek(int Offset)
+{
+	if (mHandle == 0)
+		throw LogicExceptionImpl("Blob::Seek", _("The Blob is not opened"));
+	if (mWriteMode)
+		throw LogicExceptionImpl("Blob::Seek", _("Can't seek in Blob opened for write"));
+	if (Offset < 0)
+		throw LogicExceptionImpl("Blob::Seek", _("Invalid offset"));
+
+	IBS status;
+	ISC_LONG position = 0;
+	(*gds.Call()->m_seek_blob)(status.Self(), &mHandle, 0 /* blb_seek_from_head */,
+		(ISC_LONG)Offset, &position);
+	if (status.Errors())
+		throw SQLExceptionImpl(status, "Blob::Seek", _("isc_seek_blob failed."));
+	return (int)position;
+}
+
 void BlobImpl::Save(const std::string& data)
 {
 	if (mHandle != 0)
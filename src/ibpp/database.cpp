@@ -343,9 +343,16 @@ void DatabaseImpl::DetailedCounts(IBPP::DatabaseCounts& counts)
     char items[] = {isc_info_insert_count,
                     isc_info_update_count,
                     isc_info_delete_count,
+                    isc_info_read_seq_count,
+                    isc_info_read_idx_count,
+                    isc_info_backout_count,
+                    isc_info_purge_count,
+                    isc_info_expunge_count,
                     isc_info_end};
     IBS status;
-    RB result(1024);
+    // 6 bytes per relation and counter, sized for databases with more than
+    // a few hundred tables (the buffer length is a signed 16 bits integer)
+    RB result(32000);
 
     status.Reset();
     (*gds.Call()->m_database_info)(status.Self(), &mHandle, sizeof(items), items,
@@ -356,6 +363,55 @@ void DatabaseImpl::DetailedCounts(IBPP::DatabaseCounts& counts)
     result.GetDetailedCounts(counts, isc_info_insert_count);
     result.GetDetailedCounts(counts, isc_info_update_count);
     result.GetDetailedCounts(counts, isc_info_delete_count);
+    result.GetDetailedCounts(counts, isc_info_read_seq_count);
+    result.GetDetailedCounts(counts, isc_info_read_idx_count);
+    result.GetDetailedCounts(counts, isc_info_backout_count);
+    result.GetDetailedCounts(counts, isc_info_purge_count);
+    result.GetDetailedCounts(counts, isc_info_expunge_count);
+}
+
+namespace
+{
+    // Firebird 5 wire statistics items (fb_info_wire_*), not declared by
+    // the bundled Firebird 2.5 ibase.h. They are answered by the client
+    // library itself, older clients and servers report them as unknown.
+    const char wireInfoOutPackets = (char)150;
+    const char wireInfoInPackets = (char)151;
+    const char wireInfoOutBytes = (char)152;
+    const char wireInfoInBytes = (char)153;
+    const char wireInfoRoundTrips = (char)158;
+}
+
+bool DatabaseImpl::WireStatistics(int64_t* RoundTrips, int64_t* PacketsSent,
+    int64_t* PacketsReceived, int64_t* BytesSent, int64_t* BytesReceived)
+{
+    if (mHandle == 0)
+        throw LogicExceptionImpl("Database::WireStatistics", _("Database is not connected."));
+
+    char items[] = {wireInfoRoundTrips,
+                    wireInfoOutPackets,
+                    wireInfoInPackets,
+                    wireInfoOutBytes,
+                    wireInfoInBytes,
+                    isc_info_end};
+    IBS status;
+    RB result(256);
+
+    status.Reset();
+    (*gds.Call()->m_database_info)(status.Self(), &mHandle, sizeof(items), items,
+        result.Size(), result.Self());
+    if (status.Errors())
+        throw SQLExceptionImpl(status, "Database::WireStatistics", _("isc_database_info failed"));
+
+    if (!result.HasToken(wireInfoRoundTrips))
+        return false;
+
+    if (RoundTrips != 0) *RoundTrips = result.GetValue64(wireInfoRoundTrips);
+    if (PacketsSent != 0) *PacketsSent = result.GetValue64(wireInfoOutPackets);
+    if (PacketsReceived != 0) *PacketsReceived = result.GetValue64(wireInfoInPackets);
+    if (BytesSent != 0) *BytesSent = result.GetValue64(wireInfoOutBytes);
+    if (BytesReceived != 0) *BytesReceived = result.GetValue64(wireInfoInBytes);
+    return true;
 }
 
 void DatabaseImpl::Users(std::vector<std::string>& users)
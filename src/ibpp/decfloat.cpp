@@ -0,0 +1,454 @@
+// DecFloat class implementation
+/*
+    (C) Copyright 2000-2006 T.I.P. Group S.A. and the IBPP Team (www.ibpp.org)
+
+    The contents of this file are subject to the IBPP License (the "License");
+    you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at http://www.ibpp.org or in the 'license.txt'
+    file which must have been distributed along with this file.
+
+    This software, distributed under the License, is distributed on an "AS IS"
+    basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See the
+    License for the specific language governing rights and limitations
+    under the License.
+*/
+
+#ifdef _MSC_VER
+#pragma warning(disable: 4786 4996)
+#ifndef _DEBUG
+#pragma warning(disable: 4702)
+#endif
+#endif
+
+#include "_ibpp.h"
+
+#ifdef HAS_HDRSTOP
+#pragma hdrstop
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace ibpp_internals;
+
+//	Private implementation
+
+namespace
+{
+	//	IEEE 754 decimal64 and decimal128 layout, from the most significant
+	//	bit: sign, 5 bits combination field (2 exponent bits and the most
+	//	significant digit), exponent continuation and the coefficient
+	//	continuation as declets of 10 bits holding 3 digits each (densely
+	//	packed decimal encoding).
+
+	struct Layout
+	{
+		int width;			// 64 or 128 bits
+		int digits;			// 16 or 34
+		int expBits;		// exponent continuation bits
+		int declets;		// (digits - 1) / 3
+		int bias;
+	};
+
+	const Layout decimal64 = {64, 16, 8, 5, 398};
+	const Layout decimal128 = {128, 34, 12, 11, 6176};
+
+	const Layout& layoutFor(int digits)
+	{
+		return digits == 16 ? decimal64 : decimal128;
+	}
+
+	unsigned getBits(uint64_t high, uint64_t low, int pos, int count)
+	{
+		uint64_t value;
+		if (pos >= 64)
+			value = high >> (pos - 64);
+		else if (pos + count <= 64)
+			value = low >> pos;
+		else
+			value = (low >> pos) | (high << (64 - pos));
+		return (unsigned)(value & ((1u << count) - 1));
+	}
+
+	void setBits(uint64_t& high, uint64_t& low, int pos, int count, unsigned bits)
+	{
+		uint64_t value = bits & ((1u << count) - 1);
+		if (pos >= 64)
+			high |= value << (pos - 64);
+		else if (pos + count <= 64)
+			low |= value << pos;
+		else
+		{
+			low |= value << pos;
+			high |= value >> (64 - pos);
+		}
+	}
+
+	// Decodes one declet into 3 digits (IEEE 754-2008, table 3.3)
+	void decodeDeclet(unsigned d, char* digits)
+	{
+		unsigned p = (d >> 9) & 1, q = (d >> 8) & 1, r = (d >> 7) & 1;
+		unsigned s = (d >> 6) & 1, t = (d >> 5) & 1, u = (d >> 4) & 1;
+		unsigned v = (d >> 3) & 1, w = (d >> 2) & 1, x = (d >> 1) & 1;
+		unsigned y = d & 1;
+		unsigned pqr = (p << 2) | (q << 1) | r;
+		unsigned stu = (s << 2) | (t << 1) | u;
+		unsigned d1, d2, d3;
+		if (v == 0)
+		{
+			d1 = pqr; d2 = stu; d3 = (w << 2) | (x << 1) | y;
+		}
+		else
+		{
+			switch ((w << 1) | x)
+			{
+				case 0:  d1 = pqr; d2 = stu; d3 = 8 + y; break;
+				case 1:  d1 = pqr; d2 = 8 + u; d3 = (s << 2) | (t << 1) | y; break;
+				case 2:  d1 = 8 + r; d2 = stu; d3 = (p << 2) | (q << 1) | y; break;
+				default:
+					switch ((s << 1) | t)
+					{
+						case 0:  d1 = 8 + r; d2 = 8 + u; d3 = (p << 2) | (q << 1) | y; break;
+						case 1:  d1 = 8 + r; d2 = (p << 2) | (q << 1) | u; d3 = 8 + y; break;
+						case 2:  d1 = pqr; d2 = 8 + u; d3 = 8 + y; break;
+						default: d1 = 8 + r; d2 = 8 + u; d3 = 8 + y; break;
+					}
+			}
+		}
+		digits[0] = (char)d1;
+		digits[1] = (char)d2;
+		digits[2] = (char)d3;
+	}
+
+	// Encodes 3 digits into one declet, the inverse of decodeDeclet()
+	unsigned encodeDeclet(const char* digits)
+	{
+		unsigned d1 = (unsigned)digits[0], d2 = (unsigned)digits[1];
+		unsigned d3 = (unsigned)digits[2];
+		unsigned a = d1 >> 3, e = d2 >> 3, i = d3 >> 3;
+		unsigned bcd = d1 & 7, fgh = d2 & 7, jkm = d3 & 7;
+		unsigned d = d1 & 1, h = d2 & 1, m = d3 & 1;
+		unsigned jk = jkm >> 1, fg = fgh >> 1;
+		switch ((a << 2) | (e << 1) | i)
+		{
+			case 0:  return (bcd << 7) | (fgh << 4) | jkm;
+			case 1:  return (bcd << 7) | (fgh << 4) | 8 | m;
+			case 2:  return (bcd << 7) | (jk << 5) | (h << 4) | 10 | m;
+			case 4:  return (jk << 8) | (d << 7) | (fgh << 4) | 12 | m;
+			case 6:  return (jk << 8) | (d << 7) | (h << 4) | 14 | m;
+			case 5:  return (fg << 8) | (d << 7) | (1 << 5) | (h << 4) | 14 | m;
+			case 3:  return (bcd << 7) | (2 << 5) | (h << 4) | 14 | m;
+			default: return (d << 7) | (3 << 5) | (h << 4) | 14 | m;
+		}
+	}
+
+	enum Kind {kFinite, kInfinite, kNaN, kSignalingNaN};
+
+	struct Decoded
+	{
+		Kind kind;
+		bool negative;
+		int exponent;
+		int count;			// number of coefficient digits, always fmt.digits
+		char digits[34];	// coefficient digits (values 0 to 9), MSD first
+	};
+
+	void decode(const Layout& fmt, uint64_t high, uint64_t low, Decoded& dec)
+	{
+		dec.negative = getBits(high, low, fmt.width - 1, 1) != 0;
+		unsigned g = getBits(high, low, fmt.width - 6, 5);
+		dec.count = fmt.digits;
+		dec.exponent = 0;
+		if ((g >> 1) == 0xF)
+		{
+			if ((g & 1) == 0)
+				dec.kind = kInfinite;
+			else if (getBits(high, low, fmt.width - 7, 1) == 0)
+				dec.kind = kNaN;
+			else
+				dec.kind = kSignalingNaN;
+			return;
+		}
+		dec.kind = kFinite;
+
+		unsigned expMsb, msd;
+		if ((g >> 3) != 3)
+		{
+			expMsb = g >> 3;
+			msd = g & 7;
+		}
+		else
+		{
+			expMsb = (g >> 1) & 3;
+			msd = 8 + (g & 1);
+		}
+		unsigned expCont = getBits(high, low, fmt.width - 6 - fmt.expBits,
+			fmt.expBits);
+		dec.exponent = (int)((expMsb << fmt.expBits) | expCont) - fmt.bias;
+
+		dec.digits[0] = (char)msd;
+		for (int i = 0; i < fmt.declets; i++)
+		{
+			unsigned declet = getBits(high, low,
+				(fmt.declets - 1 - i) * 10, 10);
+			decodeDeclet(declet, &dec.digits[1 + 3 * i]);
+		}
+	}
+
+	// Expects exactly fmt.digits digits and an exponent in range
+	void encode(const Layout& fmt, const Decoded& dec, uint64_t& high,
+		uint64_t& low)
+	{
+		high = 0;
+		low = 0;
+		if (dec.negative)
+			setBits(high, low, fmt.width - 1, 1, 1);
+		if (dec.kind != kFinite)
+		{
+			setBits(high, low, fmt.width - 6, 5,
+				dec.kind == kInfinite ? 0x1E : 0x1F);
+			if (dec.kind == kSignalingNaN)
+				setBits(high, low, fmt.width - 7, 1, 1);
+			return;
+		}
+
+		unsigned biased = (unsigned)(dec.exponent + fmt.bias);
+		unsigned expMsb = biased >> fmt.expBits;
+		unsigned msd = (unsigned)dec.digits[0];
+		unsigned g;
+		if (msd < 8)
+			g = (expMsb << 3) | msd;
+		else
+			g = 0x18 | (expMsb << 1) | (msd & 1);
+		setBits(high, low, fmt.width - 6, 5, g);
+		setBits(high, low, fmt.width - 6 - fmt.expBits, fmt.expBits,
+			biased & ((1u << fmt.expBits) - 1));
+		for (int i = 0; i < fmt.declets; i++)
+		{
+			setBits(high, low, (fmt.declets - 1 - i) * 10, 10,
+				encodeDeclet(&dec.digits[1 + 3 * i]));
+		}
+	}
+
+	bool equalsNoCase(const std::string& text, const char* name)
+	{
+		std::string::size_type i = 0;
+		for (; i < text.size() && name[i] != 0; i++)
+		{
+			if (tolower((unsigned char)text[i]) != name[i])
+				return false;
+		}
+		return i == text.size() && name[i] == 0;
+	}
+}
+
+//	Public implementation
+
+void IBPP::DecFloat::Clear(int digits)
+{
+	mDigits = digits == 16 ? 16 : 34;
+	const Layout& fmt = layoutFor(mDigits);
+	Decoded zero;
+	zero.kind = kFinite;
+	zero.negative = false;
+	zero.exponent = 0;
+	zero.count = fmt.digits;
+	memset(zero.digits, 0, sizeof(zero.digits));
+	encode(fmt, zero, mHigh, mLow);
+}
+
+bool IBPP::DecFloat::IsNegative() const
+{
+	const Layout& fmt = layoutFor(mDigits);
+	return getBits(mHigh, mLow, fmt.width - 1, 1) != 0;
+}
+
+bool IBPP::DecFloat::IsInfinite() const
+{
+	const Layout& fmt = layoutFor(mDigits);
+	return getBits(mHigh, mLow, fmt.width - 6, 5) == 0x1E;
+}
+
+bool IBPP::DecFloat::IsNaN() const
+{
+	const Layout& fmt = layoutFor(mDigits);
+	return getBits(mHigh, mLow, fmt.width - 6, 5) == 0x1F;
+}
+
+double IBPP::DecFloat::AsDouble() const
+{
+	Decoded dec;
+	decode(layoutFor(mDigits), mHigh, mLow, dec);
+	if (dec.kind == kInfinite)
+	{
+		return dec.negative ? -std::numeric_limits<double>::infinity()
+			: std::numeric_limits<double>::infinity();
+	}
+	if (dec.kind != kFinite)
+		return std::numeric_limits<double>::quiet_NaN();
+
+	double value = 0.0;
+	for (int i = 0; i < dec.count; i++)
+		value = value * 10.0 + dec.digits[i];
+	if (dec.exponent != 0)
+		value *= pow(10.0, dec.exponent);
+	return dec.negative ? -value : value;
+}
+
+std::string IBPP::DecFloat::AsString() const
+{
+	Decoded dec;
+	decode(layoutFor(mDigits), mHigh, mLow, dec);
+
+	std::string result;
+	if (dec.negative)
+		result += '-';
+	if (dec.kind == kInfinite)
+		return result + "Infinity";
+	if (dec.kind == kNaN)
+		return result + "NaN";
+	if (dec.kind == kSignalingNaN)
+		return result + "sNaN";
+
+	// Same rules as the to-scientific-string conversion of the server
+	int first = 0;
+	while (first < dec.count - 1 && dec.digits[first] == 0)
+		++first;
+	char coefficient[34];
+	int len = dec.count - first;
+	for (int i = 0; i < len; i++)
+		coefficient[i] = (char)('0' + dec.digits[first + i]);
+
+	int adjusted = dec.exponent + len - 1;
+	if (dec.exponent <= 0 && adjusted >= -6)
+	{
+		int intDigits = len + dec.exponent;
+		if (dec.exponent == 0)
+			result.append(coefficient, len);
+		else if (intDigits > 0)
+		{
+			result.append(coefficient, intDigits);
+			result += '.';
+			result.append(coefficient + intDigits, len - intDigits);
+		}
+		else
+		{
+			result += "0.";
+			result.append(-intDigits, '0');
+			result.append(coefficient, len);
+		}
+		return result;
+	}
+
+	result += coefficient[0];
+	if (len > 1)
+	{
+		result += '.';
+		result.append(coefficient + 1, len - 1);
+	}
+	char exponent[16];
+	sprintf(exponent, "E%+d", adjusted);
+	return result + exponent;
+}
+
+bool IBPP::DecFloat::FromString(const std::string& text)
+{
+	std::string::size_type pos = text.find_first_not_of(" \t");
+	std::string::size_type end = text.find_last_not_of(" \t");
+	if (pos == std::string::npos)
+		return false;
+	++end;
+
+	const Layout& fmt = layoutFor(mDigits);
+	Decoded dec;
+	dec.kind = kFinite;
+	dec.negative = false;
+	if (text[pos] == '-' || text[pos] == '+')
+		dec.negative = text[pos++] == '-';
+
+	std::string word(text, pos, end - pos);
+	if (equalsNoCase(word, "inf") || equalsNoCase(word, "infinity"))
+		dec.kind = kInfinite;
+	else if (equalsNoCase(word, "nan"))
+		dec.kind = kNaN;
+	else if (equalsNoCase(word, "snan"))
+		dec.kind = kSignalingNaN;
+	if (dec.kind != kFinite)
+	{
+		encode(fmt, dec, mHigh, mLow);
+		return true;
+	}
+
+	// Significant digits (without leading zeros) and the exponent
+	std::string digits;
+	int exponent = 0;
+	bool inFraction = false, anyDigit = false;
+	for (; pos < end; ++pos)
+	{
+		char c = text[pos];
+		if (c == '.' && !inFraction)
+			inFraction = true;
+		else if (c >= '0' && c <= '9')
+		{
+			anyDigit = true;
+			if (c != '0' || !digits.empty())
+				digits += (char)(c - '0');
+			if (inFraction)
+				--exponent;
+		}
+		else if ((c == 'e' || c == 'E') && anyDigit)
+		{
+			++pos;
+			if (pos < end && (text[pos] == '-' || text[pos] == '+'))
+				++pos;
+			if (pos >= end || text.find_first_not_of("0123456789", pos) < end)
+				return false;
+			if (end - pos > 6)		// way out of range anyway
+				return false;
+			int e = atoi(text.c_str() + pos);
+			exponent += text[pos - 1] == '-' ? -e : e;
+			break;
+		}
+		else
+			return false;
+	}
+	if (!anyDigit)
+		return false;
+
+	// Drop trailing zeros which don't fit, then try to bring the exponent
+	// into range without losing digits
+	int maxExponent = (3 << fmt.expBits) - 1 - fmt.bias;
+	int minExponent = -fmt.bias;
+	while ((int)digits.size() > fmt.digits && digits[digits.size() - 1] == 0)
+	{
+		digits.erase(digits.size() - 1);
+		++exponent;
+	}
+	if ((int)digits.size() > fmt.digits)
+		return false;
+	if (digits.empty())
+		exponent = std::max(minExponent, std::min(exponent, maxExponent));
+	while (exponent > maxExponent && (int)digits.size() < fmt.digits)
+	{
+		digits += (char)0;
+		--exponent;
+	}
+	while (exponent < minExponent && !digits.empty()
+		&& digits[digits.size() - 1] == 0)
+	{
+		digits.erase(digits.size() - 1);
+		++exponent;
+	}
+	if (exponent > maxExponent || exponent < minExponent)
+		return false;
+
+	dec.exponent = exponent;
+	dec.count = fmt.digits;
+	int padding = fmt.digits - (int)digits.size();
+	memset(dec.digits, 0, padding);
+	for (std::string::size_type i = 0; i < digits.size(); i++)
+		dec.digits[padding + i] = digits[i];
+	encode(fmt, dec, mHigh, mLow);
+	return true;
+}
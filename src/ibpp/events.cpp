@@ -61,47 +61,31 @@ const size_t EventsImpl::MAXEVENTNAMELEN = 127;
 
 void EventsImpl::Add(const std::string& eventname, IBPP::EventInterface* objref)
 {
-	if (eventname.size() == 0)
-		throw LogicExceptionImpl("Events::Add", _("Zero length event names not permitted"));
-	if (eventname.size() > MAXEVENTNAMELEN)
-		throw LogicExceptionImpl("Events::Add", _("Event name is too long"));
-	if ((mEventBuffer.size() + eventname.length() + 5) > 32766)	// max signed 16 bits integer minus one
+	std::vector<std::string> eventnames(1, eventname);
+	if (Add(eventnames, objref) == 0)
 		throw LogicExceptionImpl("Events::Add",
 			_("Can't add this event, the events list would overflow IB/FB limitation"));
+}
 
+size_t EventsImpl::Add(const std::vector<std::string>& eventnames,
+	IBPP::EventInterface* objref)
+{
+	// Cancelling and queueing once for the whole list instead of once per
+	// name matters when hundreds of events are monitored
 	Cancel();
-
-	// 1) Alloc or grow the buffers
-	size_t prev_buffer_size = mEventBuffer.size();
-	size_t needed = ((prev_buffer_size==0) ? 1 : 0) + eventname.length() + 5;
-	// Initial alloc will require one more byte, we need 4 more bytes for
-	// the count itself, and one byte for the string length prefix
-
-	mEventBuffer.resize(mEventBuffer.size() + needed);
-	mResultsBuffer.resize(mResultsBuffer.size() + needed);
-	if (prev_buffer_size == 0)
-		mEventBuffer[0] = mResultsBuffer[0] = 1; // First byte is a 'one'. Documentation ??
-
-	// 2) Update the buffers (append)
+	size_t added = 0;
+	try
 	{
-		Buffer::iterator it = mEventBuffer.begin() +
-				((prev_buffer_size==0) ? 1 : prev_buffer_size); // Byte after current content
-		*(it++) = static_cast<char>(eventname.length());
-		it = std::copy(eventname.begin(), eventname.end(), it);
-		// We initialize the counts to (uint32_t)(-1) to initialize properly, see FireActions()
-		*(it++) = -1; *(it++) = -1; *(it++) = -1; *it = -1;
+		while (added < eventnames.size() && Append(eventnames[added], objref))
+			++added;
 	}
-
-	// copying new event to the results buffer to keep event_buffer_ and results_buffer_ consistant,
-	// otherwise we might get a problem in `FireActions`
-	// Val Samko, val@digiways.com
-	std::copy(mEventBuffer.begin() + prev_buffer_size,
-		mEventBuffer.end(), mResultsBuffer.begin() + prev_buffer_size);
-
-	// 3) Alloc or grow the objref array and update the objref array (append)
-	mObjectReferences.push_back(objref);
-
-	Queue();
+	catch (...)
+	{
+		if (mEventBuffer.size() > 1) Queue();
+		throw;
+	}
+	if (mEventBuffer.size() > 1) Queue();
+	return added;
 }
 
 void EventsImpl::Drop(const std::string& eventname)
@@ -172,6 +156,11 @@ void EventsImpl::Dispatch()
 	Queue();
 }
 
+void EventsImpl::SetTrapInterface(IBPP::EventsTrapInterface* trapInterface)
+{
+	mTrapInterface = trapInterface;
+}
+
 IBPP::Database EventsImpl::DatabasePtr() const
 {
 	if (mDatabase == 0) throw LogicExceptionImpl("Events::DatabasePtr",
@@ -197,6 +186,49 @@ void EventsImpl::Release()
 
 //	(((((((( OBJECT INTERNAL METHODS ))))))))
 
+bool EventsImpl::Append(const std::string& eventname, IBPP::EventInterface* objref)
+{
+	// Appends to the buffers, the caller cancels and queues the events;
+	// returns false if the name doesn't fit anymore
+	if (eventname.size() == 0)
+		throw LogicExceptionImpl("Events::Add", _("Zero length event names not permitted"));
+	if (eventname.size() > MAXEVENTNAMELEN)
+		throw LogicExceptionImpl("Events::Add", _("Event name is too long"));
+	if ((mEventBuffer.size() + eventname.length() + 5) > 32766)	// max signed 16 bits integer minus one
+		return false;
+
+	// 1) Alloc or grow the buffers
+	size_t prev_buffer_size = mEventBuffer.size();
+	size_t needed = ((prev_buffer_size==0) ? 1 : 0) + eventname.length() + 5;
+	// Initial alloc will require one more byte, we need 4 more bytes for
+	// the count itself, and one byte for the string length prefix
+
+	mEventBuffer.resize(mEventBuffer.size() + needed);
+	mResultsBuffer.resize(mResultsBuffer.size() + needed);
+	if (prev_buffer_size == 0)
+		mEventBuffer[0] = mResultsBuffer[0] = 1; // First byte is a 'one'. Documentation ??
+
+	// 2) Update the buffers (append)
+	{
+		Buffer::iterator it = mEventBuffer.begin() +
+				((prev_buffer_size==0) ? 1 : prev_buffer_size); // Byte after current content
+		*(it++) = static_cast<char>(eventname.length());
+		it = std::copy(eventname.begin(), eventname.end(), it);
+		// We initialize the counts to (uint32_t)(-1) to initialize properly, see FireActions()
+		*(it++) = -1; *(it++) = -1; *(it++) = -1; *it = -1;
+	}
+
+	// copying new event to the results buffer to keep event_buffer_ and results_buffer_ consistant,
+	// otherwise we might get a problem in `FireActions`
+	// Val Samko, val@digiways.com
+	std::copy(mEventBuffer.begin() + prev_buffer_size,
+		mEventBuffer.end(), mResultsBuffer.begin() + prev_buffer_size);
+
+	// 3) Alloc or grow the objref array and update the objref array (append)
+	mObjectReferences.push_back(objref);
+	return true;
+}
+
 void EventsImpl::Queue()
 {
 	if (! mQueued)
@@ -318,6 +350,8 @@ void EventsImpl::EventHandler(const char* object, short size, const char* tmpbuf
 				rb[i] = tmpbuffer[i];
 			evi->mTrapped = true;
 			evi->mQueued = false;
+			if (evi->mTrapInterface != 0)
+				evi->mTrapInterface->ibppEventsTrapped(evi);
 		}
 		catch (...) { }
 	}
@@ -347,6 +381,7 @@ EventsImpl::EventsImpl(DatabaseImpl* database)
 	mDatabase = 0;
 	mId = 0;
 	mQueued = mTrapped = false;
+	mTrapInterface = 0;
 	AttachDatabaseImpl(database);
 }
 
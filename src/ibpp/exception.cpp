@@ -258,6 +258,13 @@ WrongTypeImpl::WrongTypeImpl(const std::string& context, int sqlType, IITYPE var
 	switch (sqlType & ~1)
 	{
 		case SQL_BOOLEAN :		info.append("BOOLEAN"); break; // Firebird v3
+		case SQL_INT128 :		info.append("INT128"); break; // Firebird v4
+		case SQL_DEC16 :		info.append("DECFLOAT(16)"); break;
+		case SQL_DEC34 :		info.append("DECFLOAT(34)"); break;
+		case SQL_TIME_TZ :
+		case SQL_TIME_TZ_EX :	info.append("TIME WITH TIME ZONE"); break;
+		case SQL_TIMESTAMP_TZ :
+		case SQL_TIMESTAMP_TZ_EX :	info.append("TIMESTAMP WITH TIME ZONE"); break;
 		case SQL_TEXT :			info.append("CHAR"); break;
 		case SQL_VARYING :		info.append("VARCHAR"); break;
 		case SQL_SHORT :		info.append("SMALLINT"); break;
@@ -288,6 +295,8 @@ WrongTypeImpl::WrongTypeImpl(const std::string& context, int sqlType, IITYPE var
 		case ivBool :		info.append("bool"); break;
 		case ivDBKey :		info.append("DBKey"); break;
 		case ivByte :		info.append("int8_t"); break;
+		case ivInt128 :		info.append("Int128"); break;
+		case ivDecFloat :	info.append("DecFloat"); break;
 	}
 	mWhat.append(info).append("\n");
 }
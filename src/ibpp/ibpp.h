@@ -78,6 +78,9 @@ namespace IBPP
     const int MinDate = -693594;    //  1 JAN 0001
     const int MaxDate = 2958464;    // 31 DEC 9999
 
+    //  Time zone of a Time or Timestamp which has none
+    const int NoTimezone = -32768;
+
     //  Transaction Access Modes
     enum TAM {amWrite, amRead};
 
@@ -98,7 +101,8 @@ namespace IBPP
 
     //  SQL Data Types
     enum SDT {sdArray, sdBlob, sdDate, sdTime, sdTimestamp, sdString,
-        sdSmallint, sdInteger, sdLargeint, sdFloat, sdDouble, sdBoolean};
+        sdSmallint, sdInteger, sdLargeint, sdFloat, sdDouble, sdBoolean,
+        sdInt128, sdDecFloat, sdTimeTz, sdTimestampTz};   // Firebird v4
 
     //  Array Data Types
     enum ADT {adDate, adTime, adTimestamp, adString,
@@ -120,6 +124,13 @@ namespace IBPP
         brPerTableCommit = 0x100000, brUseAllSpace = 0x200000
     };
 
+    // Service::StartDbStats Flags
+    enum STF
+    {
+        stDataPages = 0x1, stHeaderPages = 0x2, stIndexPages = 0x4,
+        stSystemRelations = 0x8, stRecordVersions = 0x10
+    };
+
     // Service::Repair Flags
     enum RPF
     {
@@ -234,9 +245,10 @@ namespace IBPP
     {
     protected:
         int mTime;  // The time, in ten-thousandths of seconds since midnight
+        int mTimezone;  // Offset from UTC in minutes, or NoTimezone
 
     public:
-        void Clear()    { mTime = 0; }
+        void Clear()    { mTime = 0; mTimezone = NoTimezone; }
         void Now();
         void SetTime(int hour, int minute, int second, int tenthousandths = 0);
         void SetTime(int tm);
@@ -247,8 +259,13 @@ namespace IBPP
         int Minutes() const;
         int Seconds() const;
         int SubSeconds() const;     // Actually tenthousandths of seconds
+        // The time zone is only used with the Firebird v4 TIME/TIMESTAMP
+        // WITH TIME ZONE types, mTime then holds the time in that zone
+        bool HasTimezone() const { return mTimezone != NoTimezone; }
+        int Timezone() const { return mTimezone; }
+        void SetTimezone(int offsetMinutes) { mTimezone = offsetMinutes; }
         Time()          { Clear(); }
-        Time(int tm)    { SetTime(tm); }
+        Time(int tm)    { mTimezone = NoTimezone; SetTime(tm); }
         Time(int hour, int minute, int second, int tenthousandths = 0);
         Time(const Time&);                          // Copy Constructor
         Time& operator=(const Timestamp&);          // Timestamp Assignment operator
@@ -281,22 +298,26 @@ namespace IBPP
             { Date::SetDate(y, mo, d); Time::SetTime(h, mi, s, t); }
 
         Timestamp(const Timestamp& rv)
-            : Date(rv.mDate), Time(rv.mTime) {} // Copy Constructor
+            : Date(rv.mDate), Time(rv) {}   // Copy Constructor
 
         Timestamp(const Date& rv)
-            { mDate = rv.GetDate(); mTime = 0; }
+            { mDate = rv.GetDate(); mTime = 0; mTimezone = NoTimezone; }
 
         Timestamp(const Time& rv)
-            { mDate = 0; mTime = rv.GetTime(); }
+            { mDate = 0; mTime = rv.GetTime(); mTimezone = rv.Timezone(); }
 
         Timestamp& operator=(const Timestamp& rv)   // Timestamp Assignment operator
-            { mDate = rv.mDate; mTime = rv.mTime; return *this; }
+            { mDate = rv.mDate; mTime = rv.mTime; mTimezone = rv.mTimezone;
+              return *this; }
 
         Timestamp& operator=(const Date& rv)        // Date Assignment operator
             { mDate = rv.GetDate(); return *this; }
 
         Timestamp& operator=(const Time& rv)        // Time Assignment operator
-            { mTime = rv.GetTime(); return *this; }
+            { mTime = rv.GetTime(); mTimezone = rv.Timezone(); return *this; }
+
+        // Moves the timestamp by the given number of minutes
+        void AddMinutes(int minutes);
 
         bool operator==(const Timestamp& rv)
             { return (mDate == rv.GetDate()) && (mTime == rv.GetTime()); }
@@ -332,6 +353,82 @@ namespace IBPP
         ~DBKey() { }
     };
 
+    /* Class Int128 stores a Firebird v4 INT128 value, which is also used
+     * for NUMERIC and DECIMAL with a precision above 18. The scale given to
+     * the conversions is the number of digits after the decimal point. */
+
+    class Int128
+    {
+    private:
+        uint64_t mLow;
+        int64_t mHigh;
+
+    public:
+        void Clear()    { mLow = 0; mHigh = 0; }
+        void SetValue(int64_t value);
+        void SetValue(uint64_t low, int64_t high) { mLow = low; mHigh = high; }
+        uint64_t Low() const    { return mLow; }
+        int64_t High() const    { return mHigh; }
+        bool IsNegative() const { return mHigh < 0; }
+        bool IsZero() const     { return mLow == 0 && mHigh == 0; }
+
+        bool GetInt64(int64_t& value) const;    // false if out of range
+        double AsDouble(int scale = 0) const;
+        std::string AsString(int scale = 0) const;
+        // Writes the decimal representation to buffer (at least 42 chars),
+        // returns the number of characters written, no terminating 0
+        int Format(char* buffer, int scale = 0) const;
+        // Parses [+-]digits[.digits], rounding extra decimals half away
+        // from zero; returns false on syntax errors and overflow
+        bool FromString(const std::string& text, int scale = 0);
+
+        Int128& operator+=(const Int128& rv);
+        Int128& operator-=(const Int128& rv);
+        bool operator==(const Int128& rv) const
+            { return mLow == rv.mLow && mHigh == rv.mHigh; }
+        bool operator<(const Int128& rv) const
+            { return mHigh < rv.mHigh || (mHigh == rv.mHigh && mLow < rv.mLow); }
+
+        Int128()                { Clear(); }
+        Int128(int64_t value)   { SetValue(value); }
+    };
+
+    /* Class DecFloat stores a Firebird v4 DECFLOAT(16) or DECFLOAT(34)
+     * value, in the IEEE 754 decimal64 or decimal128 format (with densely
+     * packed decimal coefficient) which the server uses. The conversions are
+     * exact, nothing is rounded. */
+
+    class DecFloat
+    {
+    private:
+        uint64_t mLow;
+        uint64_t mHigh;     // Unused for DECFLOAT(16)
+        int mDigits;        // 16 or 34
+
+    public:
+        void Clear(int digits = 34);
+        int Digits() const      { return mDigits; }
+        void SetDecimal64(uint64_t bits)
+            { mLow = bits; mHigh = 0; mDigits = 16; }
+        void SetDecimal128(uint64_t low, uint64_t high)
+            { mLow = low; mHigh = high; mDigits = 34; }
+        uint64_t Low() const    { return mLow; }
+        uint64_t High() const   { return mHigh; }
+
+        bool IsNegative() const;
+        bool IsInfinite() const;
+        bool IsNaN() const;
+        double AsDouble() const;
+        std::string AsString() const;
+        // Parses a number ([+-]digits[.digits][E[+-]digits]), Infinity or
+        // NaN; returns false on syntax errors and on values which can't be
+        // represented exactly with Digits() digits
+        bool FromString(const std::string& text);
+
+        DecFloat()              { Clear(); }
+        DecFloat(int digits)    { Clear(digits); }
+    };
+
     /* Class User wraps all the information about a user that the engine can manage. */
 
     class User
@@ -356,6 +453,54 @@ namespace IBPP
         ~User() { }
     };
 
+    /* Class TraceSession describes one trace session of the server, as
+     * returned by Service::ListTraces(). */
+
+    class TraceSession
+    {
+    public:
+        int id;
+        std::string name;
+        std::string user;
+        std::string date;
+        std::string flags;      // e.g. "active, trace"
+
+        TraceSession() : id(0)  { }
+    };
+
+    /* Class ColumnView gives direct access to the value of one column of the
+     * current row of a Statement, without copying it. The data pointer refers
+     * to the statement's own fetch buffer, it is only valid until the next
+     * Fetch(), Execute() or Close() of the statement. The accessors don't do
+     * any type checking, the caller has to respect the column type. */
+
+    class ColumnView
+    {
+    public:
+        SDT type;
+        int subtype;
+        int scale;          // Negative scale of NUMERIC(x,y) columns, or 0
+        bool isNull;
+        const char* data;   // Native value (text without VARCHAR length prefix)
+        int length;         // Number of bytes at data (actual length of VARCHAR)
+
+        int16_t AsInt16() const     { return *(const int16_t*)data; }
+        int32_t AsInt32() const     { return *(const int32_t*)data; }
+        int64_t AsInt64() const;    // Any integer type, unscaled
+        float AsFloat() const       { return *(const float*)data; }
+        double AsDouble() const;    // Any numeric type, scale applied
+        bool AsBool() const         { return *data != 0; }
+        void GetDate(Date&) const;
+        void GetTime(Time&) const;
+        void GetTimestamp(Timestamp&) const;
+        void GetInt128(Int128&) const;
+        void GetDecFloat(DecFloat&) const;
+
+        ColumnView() : type(sdString), subtype(0), scale(0), isNull(true),
+            data(0), length(0) { }
+    };
+    typedef std::vector<ColumnView> ColumnViews;
+
     //  Interface Wrapper
     template <class T>
     class Ptr
@@ -431,12 +576,18 @@ namespace IBPP
     {
     public:
         virtual void Create() = 0;
+        // creates a stream blob, which can be read with Seek() later
+        virtual void CreateStream() = 0;
         virtual void Open() = 0;
         virtual void Close() = 0;
         virtual void Cancel() = 0;
         virtual int Read(void*, int size) = 0;
         virtual void Write(const void*, int size) = 0;
         virtual void Info(int* Size, int* Largest, int* Segments) = 0;
+        // only stream blobs can be positioned, Seek() returns the new
+        // offset from the start of the blob
+        virtual bool IsStream() = 0;
+        virtual int Seek(int Offset) = 0;
 
         virtual void Save(const std::string& data) = 0;
         virtual void Load(std::string& data) = 0;
@@ -511,8 +662,40 @@ namespace IBPP
             const std::string& bkfile, BRF flags = BRF(0)) = 0;
         virtual void StartRestore(const std::string& bkfile, const std::string& dbfile,
             int pagesize = 0, BRF flags = BRF(0)) = 0;
+        // Backup and restore through the service connection instead of a
+        // file on the server: the backup is read with ReadOutput(), the
+        // restore is fed with WriteInput(). brVerbose is ignored for the
+        // backup since the output carries the data. parallelWorkers > 0
+        // needs Firebird 5.
+        virtual void StartBackupStream(const std::string& dbfile,
+            BRF flags = BRF(0), int parallelWorkers = 0) = 0;
+        virtual void StartRestoreStream(const std::string& dbfile,
+            int pagesize = 0, BRF flags = BRF(0), int parallelWorkers = 0) = 0;
+        // The gstat report, read with ReadOutput() or WaitMsg(). Unless
+        // tables is empty only the listed tables are analyzed (Firebird 2.1+)
+        virtual void StartDbStats(const std::string& dbfile, STF flags,
+            const std::vector<std::string>& tables = std::vector<std::string>()) = 0;
+
+        // Trace sessions (Firebird 2.5+). StartTrace() returns the session id,
+        // the output is then read with ReadOutput() until the session stops.
+        // The Service stays busy meanwhile, so StopTrace() and ListTraces()
+        // have to be called on another Service object.
+        virtual int StartTrace(const std::string& configuration,
+            const std::string& name = "") = 0;
+        virtual void StopTrace(int sessionId) = 0;
+        virtual void ListTraces(std::vector<TraceSession>& sessions) = 0;
 
         virtual const char* WaitMsg() = 0;  // With reporting (does not block)
+        // Returns the output available within timeout seconds, which may be
+        // empty, or false when the running task has finished
+        virtual bool ReadOutput(std::string& output, int timeout) = 0;
+        // Sends size bytes of data (at most the last requested amount) to a
+        // restore started by StartRestoreStream(). Returns in requested how
+        // many bytes the server wants next and the verbose output in output,
+        // or false when the restore has finished. data is 0 when there is
+        // nothing to send, size 0 with a valid data pointer ends the input
+        virtual bool WriteInput(const char* data, int size, int& requested,
+            std::string& output, int timeout) = 0;
         virtual void Wait() = 0;            // Without reporting (does block)
 
         virtual IService* AddRef() = 0;
@@ -526,14 +709,21 @@ namespace IBPP
      * object, you can create/drop/connect databases. */
 
     class EventInterface;   // Cross-reference between EventInterface and IDatabase
+    class EventsTrapInterface;
 
     class CountInfo
     {
     public:
-        CountInfo(): inserts(0), updates(0), deletes(0) {}
+        CountInfo(): inserts(0), updates(0), deletes(0), seqReads(0),
+            idxReads(0), backouts(0), purges(0), expunges(0) {}
         int inserts;
         int updates;
         int deletes;
+        int seqReads;       // Records read in natural order
+        int idxReads;       // Records read through an index
+        int backouts;       // Record versions backed out
+        int purges;         // Old record versions removed by garbage collection
+        int expunges;       // Deleted records removed by garbage collection
     };
     typedef std::map<int, CountInfo> DatabaseCounts; // int = relation ID
 
@@ -558,6 +748,12 @@ namespace IBPP
         virtual void Counts(int* Insert, int* Update, int* Delete,
             int* ReadIdx, int* ReadSeq) = 0;
         virtual void DetailedCounts(DatabaseCounts& counts) = 0;
+        // Network statistics of the attachment, as counted by the client
+        // library. Returns false when the client library or the server
+        // does not report them (only Firebird 5 and later clients do).
+        virtual bool WireStatistics(int64_t* RoundTrips, int64_t* PacketsSent,
+            int64_t* PacketsReceived, int64_t* BytesSent,
+            int64_t* BytesReceived) = 0;
         virtual void Users(std::vector<std::string>& users) = 0;
         virtual int Dialect() = 0;
 
@@ -624,6 +820,8 @@ namespace IBPP
         virtual void Set(int, const Timestamp&) = 0;
         virtual void Set(int, const Date&) = 0;
         virtual void Set(int, const Time&) = 0;
+        virtual void Set(int, const Int128&) = 0;
+        virtual void Set(int, const DecFloat&) = 0;
         virtual void Set(int, const DBKey&) = 0;
         virtual void Set(int, const Blob&) = 0;
         virtual void Set(int, const Array&) = 0;
@@ -640,6 +838,8 @@ namespace IBPP
         virtual bool Get(int, Timestamp&) = 0;
         virtual bool Get(int, Date&) = 0;
         virtual bool Get(int, Time&) = 0;
+        virtual bool Get(int, Int128&) = 0;
+        virtual bool Get(int, DecFloat&) = 0;
         virtual bool Get(int, DBKey&) = 0;
         virtual bool Get(int, Blob&) = 0;
         virtual bool Get(int, Array&) = 0;
@@ -656,6 +856,8 @@ namespace IBPP
         virtual bool Get(const std::string&, Timestamp&) = 0;
         virtual bool Get(const std::string&, Date&) = 0;
         virtual bool Get(const std::string&, Time&) = 0;
+        virtual bool Get(const std::string&, Int128&) = 0;
+        virtual bool Get(const std::string&, DecFloat&) = 0;
         virtual bool Get(const std::string&, DBKey&) = 0;
         virtual bool Get(const std::string&, Blob&) = 0;
         virtual bool Get(const std::string&, Array&) = 0;
@@ -701,6 +903,9 @@ namespace IBPP
         virtual void CursorExecute(const std::string& cursor, const std::string&) = 0;
         virtual bool Fetch() = 0;
         virtual bool Fetch(Row&) = 0;
+        // Fetches the next row and describes it in the (reused) views,
+        // without allocating memory for the row data
+        virtual bool Fetch(ColumnViews&) = 0;
         virtual int AffectedRows() = 0;
         virtual void Close() = 0;
         virtual std::string& Sql() = 0;
@@ -719,6 +924,8 @@ namespace IBPP
         virtual void Set(int, const Timestamp& value) = 0;
         virtual void Set(int, const Date& value) = 0;
         virtual void Set(int, const Time& value) = 0;
+        virtual void Set(int, const Int128& value) = 0;
+        virtual void Set(int, const DecFloat& value) = 0;
         virtual void Set(int, const DBKey& value) = 0;
         virtual void Set(int, const Blob& value) = 0;
         virtual void Set(int, const Array& value) = 0;
@@ -735,6 +942,8 @@ namespace IBPP
         virtual bool Get(int, Timestamp& value) = 0;
         virtual bool Get(int, Date& value) = 0;
         virtual bool Get(int, Time& value) = 0;
+        virtual bool Get(int, Int128& value) = 0;
+        virtual bool Get(int, DecFloat& value) = 0;
         virtual bool Get(int, DBKey& value) = 0;
         virtual bool Get(int, Blob& value) = 0;
         virtual bool Get(int, Array& value) = 0;
@@ -751,6 +960,8 @@ namespace IBPP
         virtual bool Get(const std::string&, Timestamp& value) = 0;
         virtual bool Get(const std::string&, Date& value) = 0;
         virtual bool Get(const std::string&, Time& value) = 0;
+        virtual bool Get(const std::string&, Int128& value) = 0;
+        virtual bool Get(const std::string&, DecFloat& value) = 0;
         virtual bool Get(const std::string&, DBKey& value) = 0;
         virtual bool Get(const std::string&, Blob& value) = 0;
         virtual bool Get(const std::string&, Array& value) = 0;
@@ -772,6 +983,9 @@ namespace IBPP
         virtual int Parameters() = 0;
 
         virtual void Plan(std::string&) = 0;
+        // Firebird 3 and later: the plan as an indented tree, one access
+        // method per line; empty when the server doesn't provide it
+        virtual void ExplainedPlan(std::string&) = 0;
 
         virtual Database DatabasePtr() const = 0;
         virtual Transaction TransactionPtr() const = 0;
@@ -802,10 +1016,16 @@ namespace IBPP
     {
     public:
         virtual void Add(const std::string&, EventInterface*) = 0;
+        // Adds as many of the names as fit into one events block, queueing
+        // them only once; returns the number of names added
+        virtual size_t Add(const std::vector<std::string>&, EventInterface*) = 0;
         virtual void Drop(const std::string&) = 0;
         virtual void List(std::vector<std::string>&) = 0;
         virtual void Clear() = 0;               // Drop all events
         virtual void Dispatch() = 0;            // Dispatch events (calls handlers)
+        // The interface is notified when events are trapped, so that
+        // Dispatch() doesn't have to be polled
+        virtual void SetTrapInterface(EventsTrapInterface*) = 0;
 
         virtual Database DatabasePtr() const = 0;
 
@@ -827,6 +1047,18 @@ namespace IBPP
         virtual ~EventInterface() { }
     };
 
+    /* Class EventsTrapInterface is notified when Firebird has trapped events
+     * which are waiting for Dispatch(). ibppEventsTrapped() is called on a
+     * thread of the Firebird client library, like an interrupt handler: it
+     * may only signal an application thread which then calls Dispatch(). */
+
+    class EventsTrapInterface
+    {
+    public:
+        virtual void ibppEventsTrapped(IEvents*) = 0;
+        virtual ~EventsTrapInterface() { }
+    };
+
     //  --- Factories ---
     //  These methods are the only way to get one of the above
     //  Interfaces.  They are at the heart of how you program using IBPP.  For
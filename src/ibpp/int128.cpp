@@ -0,0 +1,231 @@
+// Int128 class implementation
+/*
+    (C) Copyright 2000-2006 T.I.P. Group S.A. and the IBPP Team (www.ibpp.org)
+
+    The contents of this file are subject to the IBPP License (the "License");
+    you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at http://www.ibpp.org or in the 'license.txt'
+    file which must have been distributed along with this file.
+
+    This software, distributed under the License, is distributed on an "AS IS"
+    basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See the
+    License for the specific language governing rights and limitations
+    under the License.
+*/
+
+#ifdef _MSC_VER
+#pragma warning(disable: 4786 4996)
+#ifndef _DEBUG
+#pragma warning(disable: 4702)
+#endif
+#endif
+
+#include "_ibpp.h"
+
+#ifdef HAS_HDRSTOP
+#pragma hdrstop
+#endif
+
+#include <cmath>
+
+using namespace ibpp_internals;
+
+//	Private implementation
+
+namespace
+{
+	//	The arithmetic works on the unsigned magnitude, split into 32 bits
+	//	limbs so that all intermediate results fit into 64 bits. This is
+	//	portable to compilers without a native 128 bits integer type.
+
+	const uint64_t lowMask = 0xFFFFFFFFu;
+
+	void negate(uint64_t& high, uint64_t& low)
+	{
+		low = ~low + 1;
+		high = ~high + (low == 0 ? 1 : 0);
+	}
+
+	// Divides the magnitude by divisor (< 2^32), returns the remainder
+	uint32_t divMod(uint64_t& high, uint64_t& low, uint32_t divisor)
+	{
+		uint64_t limbs[4] = {high >> 32, high & lowMask, low >> 32, low & lowMask};
+		uint64_t rest = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			uint64_t cur = (rest << 32) | limbs[i];
+			limbs[i] = cur / divisor;
+			rest = cur % divisor;
+		}
+		high = (limbs[0] << 32) | limbs[1];
+		low = (limbs[2] << 32) | limbs[3];
+		return (uint32_t)rest;
+	}
+
+	// Computes magnitude * factor + addend (both < 2^32), returns false
+	// when the result doesn't fit into 128 bits
+	bool mulAdd(uint64_t& high, uint64_t& low, uint32_t factor, uint32_t addend)
+	{
+		uint64_t limbs[4] = {low & lowMask, low >> 32, high & lowMask, high >> 32};
+		uint64_t carry = addend;
+		for (int i = 0; i < 4; i++)
+		{
+			uint64_t cur = limbs[i] * factor + carry;
+			limbs[i] = cur & lowMask;
+			carry = cur >> 32;
+		}
+		high = (limbs[3] << 32) | limbs[2];
+		low = (limbs[1] << 32) | limbs[0];
+		return carry == 0;
+	}
+}
+
+//	Public implementation
+
+void IBPP::Int128::SetValue(int64_t value)
+{
+	mLow = (uint64_t)value;
+	mHigh = value < 0 ? -1 : 0;
+}
+
+bool IBPP::Int128::GetInt64(int64_t& value) const
+{
+	// Fits if the high part is the sign extension of the low part
+	if ((mHigh == 0 && (mLow >> 63) == 0) || (mHigh == -1 && (mLow >> 63) == 1))
+	{
+		value = (int64_t)mLow;
+		return true;
+	}
+	return false;
+}
+
+double IBPP::Int128::AsDouble(int scale) const
+{
+	uint64_t high = (uint64_t)mHigh, low = mLow;
+	if (mHigh < 0)
+		negate(high, low);
+	double value = (double)high * 18446744073709551616.0 + (double)low;
+	if (scale > 0)
+		value /= (scale < 19) ? consts::dscales[scale] : pow(10.0, scale);
+	return mHigh < 0 ? -value : value;
+}
+
+int IBPP::Int128::Format(char* buffer, int scale) const
+{
+	uint64_t high = (uint64_t)mHigh, low = mLow;
+	if (mHigh < 0)
+		negate(high, low);
+
+	// Collect the digits in reverse order, nine at a time
+	char digits[48];
+	int count = 0;
+	while (high != 0 || low != 0)
+	{
+		uint32_t chunk = divMod(high, low, 1000000000u);
+		bool last = high == 0 && low == 0;
+		for (int i = 0; i < 9 && (!last || chunk != 0); i++)
+		{
+			digits[count++] = (char)('0' + chunk % 10);
+			chunk /= 10;
+		}
+	}
+	if (scale < 0)
+		scale = 0;
+	while (count <= scale)
+		digits[count++] = '0';
+
+	char* p = buffer;
+	if (mHigh < 0)
+		*p++ = '-';
+	while (count > scale)
+		*p++ = digits[--count];
+	if (scale > 0)
+	{
+		*p++ = '.';
+		while (count > 0)
+			*p++ = digits[--count];
+	}
+	return (int)(p - buffer);
+}
+
+std::string IBPP::Int128::AsString(int scale) const
+{
+	char buffer[48 + 1];
+	int len = Format(buffer, scale < 48 - 2 ? scale : 48 - 2);
+	return std::string(buffer, len);
+}
+
+bool IBPP::Int128::FromString(const std::string& text, int scale)
+{
+	std::string::size_type pos = text.find_first_not_of(" \t");
+	std::string::size_type end = text.find_last_not_of(" \t");
+	if (pos == std::string::npos)
+		return false;
+	++end;
+
+	bool negative = false;
+	if (text[pos] == '-' || text[pos] == '+')
+		negative = text[pos++] == '-';
+
+	uint64_t high = 0, low = 0;
+	int digitCount = 0, decimals = 0;
+	bool inFraction = false, roundUp = false;
+	for (; pos < end; ++pos)
+	{
+		char c = text[pos];
+		if (c == '.' && !inFraction)
+		{
+			inFraction = true;
+			continue;
+		}
+		if (c < '0' || c > '9')
+			return false;
+		++digitCount;
+		if (inFraction && decimals >= scale)
+		{
+			// Extra decimals are rounded half away from zero
+			if (decimals++ == scale)
+				roundUp = c >= '5';
+			continue;
+		}
+		if (inFraction)
+			++decimals;
+		if (!mulAdd(high, low, 10, (uint32_t)(c - '0')))
+			return false;
+	}
+	if (digitCount == 0)
+		return false;
+	for (; decimals < scale; ++decimals)
+	{
+		if (!mulAdd(high, low, 10, 0))
+			return false;
+	}
+	if (roundUp && !mulAdd(high, low, 1, 1))
+		return false;
+
+	// The magnitude can be 2^127 for negative values only
+	if ((high >> 63) != 0 && !(negative && high == (uint64_t)1 << 63 && low == 0))
+		return false;
+	if (negative)
+		negate(high, low);
+	mHigh = (int64_t)high;
+	mLow = low;
+	return true;
+}
+
+IBPP::Int128& IBPP::Int128::operator+=(const IBPP::Int128& rv)
+{
+	uint64_t low = mLow + rv.mLow;
+	uint64_t carry = low < mLow ? 1 : 0;
+	mHigh = (int64_t)((uint64_t)mHigh + (uint64_t)rv.mHigh + carry);
+	mLow = low;
+	return *this;
+}
+
+IBPP::Int128& IBPP::Int128::operator-=(const IBPP::Int128& rv)
+{
+	uint64_t borrow = mLow < rv.mLow ? 1 : 0;
+	mLow -= rv.mLow;
+	mHigh = (int64_t)((uint64_t)mHigh - (uint64_t)rv.mHigh - borrow);
+	return *this;
+}
@@ -32,9 +32,179 @@
 
 #include <cmath>
 #include <ctime>
+#include <sstream>
 
 using namespace ibpp_internals;
 
+//	(((((((( 128 bits values ))))))))
+
+namespace
+{
+	//	INT128 and DECFLOAT(34) values are two 64 bits words in the native
+	//	byte order of the client, the least significant one first on little
+	//	endian machines.
+
+	inline bool littleEndian()
+	{
+		const uint16_t probe = 1;
+		return *(const char*)&probe == 1;
+	}
+
+	void loadWords(const char* data, uint64_t& low, uint64_t& high)
+	{
+		const int lowIdx = littleEndian() ? 0 : 1;
+		memcpy(&low, data + 8 * lowIdx, 8);
+		memcpy(&high, data + 8 * (1 - lowIdx), 8);
+	}
+
+	void storeWords(char* data, uint64_t low, uint64_t high)
+	{
+		const int lowIdx = littleEndian() ? 0 : 1;
+		memcpy(data + 8 * lowIdx, &low, 8);
+		memcpy(data + 8 * (1 - lowIdx), &high, 8);
+	}
+
+	void loadInt128(const char* data, IBPP::Int128& value)
+	{
+		uint64_t low, high;
+		loadWords(data, low, high);
+		value.SetValue(low, (int64_t)high);
+	}
+
+	void loadDecFloat(const char* data, int sqltype, IBPP::DecFloat& value)
+	{
+		if (sqltype == SQL_DEC16)
+		{
+			uint64_t bits;
+			memcpy(&bits, data, 8);
+			value.SetDecimal64(bits);
+		}
+		else
+		{
+			uint64_t low, high;
+			loadWords(data, low, high);
+			value.SetDecimal128(low, high);
+		}
+	}
+
+	// Copies value to a DECFLOAT column of the other precision by way of
+	// its string representation, which only succeeds when it is exact
+	void storeDecFloat(char* data, int sqltype, const IBPP::DecFloat& value)
+	{
+		int digits = sqltype == SQL_DEC16 ? 16 : 34;
+		IBPP::DecFloat converted(digits);
+		if (value.Digits() == digits)
+			converted = value;
+		else if (!converted.FromString(value.AsString()))
+			throw LogicExceptionImpl("RowImpl::SetValue",
+				_("Out of range numeric conversion !"));
+		if (digits == 16)
+		{
+			uint64_t bits = converted.Low();
+			memcpy(data, &bits, 8);
+		}
+		else
+			storeWords(data, converted.Low(), converted.High());
+	}
+}
+
+//	(((((((( ColumnView helpers ))))))))
+
+int64_t IBPP::ColumnView::AsInt64() const
+{
+	switch (type)
+	{
+		case sdSmallint :	return *(const int16_t*)data;
+		case sdInteger :	return *(const int32_t*)data;
+		case sdLargeint :	return *(const int64_t*)data;
+		default : throw LogicExceptionImpl("ColumnView::AsInt64",
+						_("Incompatible types."));
+	}
+}
+
+double IBPP::ColumnView::AsDouble() const
+{
+	double value;
+	switch (type)
+	{
+		case sdSmallint :	value = *(const int16_t*)data; break;
+		case sdInteger :	value = *(const int32_t*)data; break;
+		case sdLargeint :	value = (double)*(const int64_t*)data; break;
+		case sdInt128 :
+		{
+			IBPP::Int128 i128;
+			loadInt128(data, i128);
+			return i128.AsDouble(-scale);
+		}
+		case sdDecFloat :
+		{
+			IBPP::DecFloat df;
+			loadDecFloat(data, length == 8 ? SQL_DEC16 : SQL_DEC34, df);
+			return df.AsDouble();
+		}
+		case sdFloat :		return *(const float*)data;
+		case sdDouble :		value = *(const double*)data;
+							if (scale < 0)
+							{
+								// Round to scale y of NUMERIC(x,y)
+								double multiplier = consts::dscales[-scale];
+								return floor(value * multiplier + 0.5) / multiplier;
+							}
+							return value;
+		default : throw LogicExceptionImpl("ColumnView::AsDouble",
+						_("Incompatible types."));
+	}
+	if (scale < 0)
+		value /= consts::dscales[-scale];
+	return value;
+}
+
+void IBPP::ColumnView::GetDate(IBPP::Date& date) const
+{
+	if (type == sdTimestamp)
+		decodeDate(date, ((const ISC_TIMESTAMP*)data)->timestamp_date);
+	else
+		decodeDate(date, *(const ISC_DATE*)data);
+}
+
+void IBPP::ColumnView::GetTime(IBPP::Time& time) const
+{
+	if (type == sdTimestamp)
+		decodeTime(time, ((const ISC_TIMESTAMP*)data)->timestamp_time);
+	else if (type == sdTimeTz)
+		decodeTimeTz(time, *(const ISC_TIME_TZ_EX*)data);
+	else if (type == sdTimestampTz)
+	{
+		IBPP::Timestamp timestamp;
+		decodeTimestampTz(timestamp, *(const ISC_TIMESTAMP_TZ_EX*)data);
+		time = timestamp;
+	}
+	else
+		decodeTime(time, *(const ISC_TIME*)data);
+}
+
+void IBPP::ColumnView::GetTimestamp(IBPP::Timestamp& timestamp) const
+{
+	if (type == sdTimestampTz)
+		decodeTimestampTz(timestamp, *(const ISC_TIMESTAMP_TZ_EX*)data);
+	else
+		decodeTimestamp(timestamp, *(const ISC_TIMESTAMP*)data);
+}
+
+void IBPP::ColumnView::GetInt128(IBPP::Int128& value) const
+{
+	if (type != sdInt128)
+		throw LogicExceptionImpl("ColumnView::GetInt128", _("Incompatible types."));
+	loadInt128(data, value);
+}
+
+void IBPP::ColumnView::GetDecFloat(IBPP::DecFloat& value) const
+{
+	if (type != sdDecFloat)
+		throw LogicExceptionImpl("ColumnView::GetDecFloat", _("Incompatible types."));
+	loadDecFloat(data, length == 8 ? SQL_DEC16 : SQL_DEC34, value);
+}
+
 //	(((((((( OBJECT INTERFACE IMPLEMENTATION ))))))))
 
 void RowImpl::SetNull(int param)
@@ -180,6 +350,24 @@ void RowImpl::Set(int param, const IBPP::Time& value)
 	mUpdated[param-1] = true;
 }
 
+void RowImpl::Set(int param, const IBPP::Int128& value)
+{
+	if (mDescrArea == 0)
+		throw LogicExceptionImpl("Row::Set[Int128]", _("The row is not initialized."));
+
+	SetValue(param, ivInt128, &value);
+	mUpdated[param-1] = true;
+}
+
+void RowImpl::Set(int param, const IBPP::DecFloat& value)
+{
+	if (mDescrArea == 0)
+		throw LogicExceptionImpl("Row::Set[DecFloat]", _("The row is not initialized."));
+
+	SetValue(param, ivDecFloat, &value);
+	mUpdated[param-1] = true;
+}
+
 void RowImpl::Set(int param, const IBPP::Blob& blob)
 {
 	if (mDescrArea == 0)
@@ -304,8 +492,8 @@ bool RowImpl::Get(int column, int16_t& retvalue)
 	if (mDescrArea == 0)
 		throw LogicExceptionImpl("Row::Get", _("The row is not initialized."));
 
-	void* pvalue = GetValue(column, ivInt16);
-	if (pvalue != 0)
+	void* pvalue = GetValue(column, ivInt16, &retvalue);
+	if (pvalue != 0 && pvalue != &retvalue)
 		retvalue = *(int16_t*)pvalue;
 	return pvalue == 0 ? true : false;
 }
@@ -315,8 +503,8 @@ bool RowImpl::Get(int column, int32_t& retvalue)
 	if (mDescrArea == 0)
 		throw LogicExceptionImpl("Row::Get", _("The row is not initialized."));
 
-	void* pvalue = GetValue(column, ivInt32);
-	if (pvalue != 0)
+	void* pvalue = GetValue(column, ivInt32, &retvalue);
+	if (pvalue != 0 && pvalue != &retvalue)
 		retvalue = *(int32_t*)pvalue;
 	return pvalue == 0 ? true : false;
 }
@@ -326,8 +514,8 @@ bool RowImpl::Get(int column, int64_t& retvalue)
 	if (mDescrArea == 0)
 		throw LogicExceptionImpl("Row::Get", _("The row is not initialized."));
 
-	void* pvalue = GetValue(column, ivInt64);
-	if (pvalue != 0)
+	void* pvalue = GetValue(column, ivInt64, &retvalue);
+	if (pvalue != 0 && pvalue != &retvalue)
 		retvalue = *(int64_t*)pvalue;
 	return pvalue == 0 ? true : false;
 }
@@ -337,8 +525,8 @@ bool RowImpl::Get(int column, float& retvalue)
 	if (mDescrArea == 0)
 		throw LogicExceptionImpl("Row::Get", _("The row is not initialized."));
 
-	void* pvalue = GetValue(column, ivFloat);
-	if (pvalue != 0)
+	void* pvalue = GetValue(column, ivFloat, &retvalue);
+	if (pvalue != 0 && pvalue != &retvalue)
 		retvalue = *(float*)pvalue;
 	return pvalue == 0 ? true : false;
 }
@@ -348,8 +536,8 @@ bool RowImpl::Get(int column, double& retvalue)
 	if (mDescrArea == 0)
 		throw LogicExceptionImpl("Row::Get", _("The row is not initialized."));
 
-	void* pvalue = GetValue(column, ivDouble);
-	if (pvalue != 0)
+	void* pvalue = GetValue(column, ivDouble, &retvalue);
+	if (pvalue != 0 && pvalue != &retvalue)
 		retvalue = *(double*)pvalue;
 	return pvalue == 0 ? true : false;
 }
@@ -393,6 +581,24 @@ bool RowImpl::Get(int column, IBPP::Time& time)
 	return pvalue == 0 ? true : false;
 }
 
+bool RowImpl::Get(int column, IBPP::Int128& retvalue)
+{
+	if (mDescrArea == 0)
+		throw LogicExceptionImpl("Row::Get", _("The row is not initialized."));
+
+	void* pvalue = GetValue(column, ivInt128, (void*)&retvalue);
+	return pvalue == 0 ? true : false;
+}
+
+bool RowImpl::Get(int column, IBPP::DecFloat& retvalue)
+{
+	if (mDescrArea == 0)
+		throw LogicExceptionImpl("Row::Get", _("The row is not initialized."));
+
+	void* pvalue = GetValue(column, ivDecFloat, (void*)&retvalue);
+	return pvalue == 0 ? true : false;
+}
+
 bool RowImpl::Get(int column, IBPP::Blob& retblob)
 {
 	if (mDescrArea == 0)
@@ -536,6 +742,22 @@ bool RowImpl::Get(const std::string& name, IBPP::Time& retvalue)
 	return Get(ColumnNum(name), retvalue);
 }
 
+bool RowImpl::Get(const std::string& name, IBPP::Int128& retvalue)
+{
+	if (mDescrArea == 0)
+		throw LogicExceptionImpl("Row::Get", _("The row is not initialized."));
+
+	return Get(ColumnNum(name), retvalue);
+}
+
+bool RowImpl::Get(const std::string& name, IBPP::DecFloat& retvalue)
+{
+	if (mDescrArea == 0)
+		throw LogicExceptionImpl("Row::Get", _("The row is not initialized."));
+
+	return Get(ColumnNum(name), retvalue);
+}
+
 bool RowImpl::Get(const std::string&name, IBPP::Blob& retblob)
 {
 	if (mDescrArea == 0)
@@ -698,6 +920,13 @@ IBPP::SDT RowImpl::ColumnType(int varnum)
 		case SQL_BLOB :      value = IBPP::sdBlob;      break;
 		case SQL_ARRAY :     value = IBPP::sdArray;     break;
 		case SQL_BOOLEAN :   value = IBPP::sdBoolean;     break;
+		case SQL_INT128 :    value = IBPP::sdInt128;    break;
+		case SQL_DEC16 :
+		case SQL_DEC34 :     value = IBPP::sdDecFloat;  break;
+		case SQL_TIME_TZ :
+		case SQL_TIME_TZ_EX :      value = IBPP::sdTimeTz;      break;
+		case SQL_TIMESTAMP_TZ :
+		case SQL_TIMESTAMP_TZ_EX : value = IBPP::sdTimestampTz; break;
 		default : throw LogicExceptionImpl("Row::ColumnType",
 						_("Found an unknown sqltype !"));
 	}
@@ -794,6 +1023,17 @@ void RowImpl::Release()
 
 //	(((((((( OBJECT INTERNAL METHODS ))))))))
 
+namespace
+{
+	// Numeric conversions store their result directly in the caller's
+	// variable when one is given, and in the row scratch storage otherwise
+	template<class T>
+	inline T* ConversionTarget(void* retvalue, T& scratch)
+	{
+		return retvalue != 0 ? (T*)retvalue : &scratch;
+	}
+}
+
 void RowImpl::SetValue(int varnum, IITYPE ivType, const void* value, int userlen)
 {
 	if (varnum < 1 || varnum > mDescrArea->sqld)
@@ -1015,6 +1255,83 @@ void RowImpl::SetValue(int varnum, IITYPE ivType, const void* value, int userlen
 			encodeTime(*(ISC_TIME*)var->sqldata, *(IBPP::Time*)value);
 			break;
 
+		case SQL_INT128 :	// Firebird v4
+			{
+				IBPP::Int128 i128;
+				if (ivType == ivInt128)
+					i128 = *(IBPP::Int128*)value;
+				else
+				{
+					// This SQL_INT128 may be a NUMERIC(x,y), the conversion
+					// goes through the text representation to scale it
+					std::ostringstream text;
+					if (ivType == ivString)
+						text << *(std::string*)value;
+					else if (ivType == ivInt16)
+						text << *(int16_t*)value;
+					else if (ivType == ivInt32)
+						text << *(int32_t*)value;
+					else if (ivType == ivInt64)
+						text << *(int64_t*)value;
+					else if (ivType == ivDouble)
+					{
+						text.setf(std::ios::fixed);
+						text.precision(-var->sqlscale);
+						text << *(double*)value;
+					}
+					else throw WrongTypeImpl("RowImpl::SetValue", var->sqltype, ivType,
+												_("Incompatible types."));
+					if (!i128.FromString(text.str(), -var->sqlscale))
+						throw LogicExceptionImpl("RowImpl::SetValue",
+							_("Out of range numeric conversion !"));
+				}
+				storeWords(var->sqldata, i128.Low(), (uint64_t)i128.High());
+			}
+			break;
+
+		case SQL_DEC16 :
+		case SQL_DEC34 :
+			{
+				IBPP::DecFloat df((var->sqltype & ~1) == SQL_DEC16 ? 16 : 34);
+				if (ivType == ivDecFloat)
+					df = *(IBPP::DecFloat*)value;
+				else if (ivType == ivString)
+				{
+					if (!df.FromString(*(std::string*)value))
+						throw LogicExceptionImpl("RowImpl::SetValue",
+							_("Out of range numeric conversion !"));
+				}
+				else if (ivType == ivDouble)
+				{
+					// A double has at most 17 significant digits
+					std::ostringstream text;
+					text.precision(df.Digits() < 17 ? df.Digits() : 17);
+					text << *(double*)value;
+					if (!df.FromString(text.str()))
+						throw LogicExceptionImpl("RowImpl::SetValue",
+							_("Out of range numeric conversion !"));
+				}
+				else throw WrongTypeImpl("RowImpl::SetValue", var->sqltype, ivType,
+											_("Incompatible types."));
+				storeDecFloat(var->sqldata, var->sqltype & ~1, df);
+			}
+			break;
+
+		case SQL_TIME_TZ_EX :
+			if (ivType != ivTime)
+				throw WrongTypeImpl("RowImpl::SetValue", var->sqltype, ivType,
+											_("Incompatible types."));
+			encodeTimeTz(*(ISC_TIME_TZ_EX*)var->sqldata, *(IBPP::Time*)value);
+			break;
+
+		case SQL_TIMESTAMP_TZ_EX :
+			if (ivType != ivTimestamp)
+				throw WrongTypeImpl("RowImpl::SetValue", var->sqltype, ivType,
+											_("Incompatible types."));
+			encodeTimestampTz(*(ISC_TIMESTAMP_TZ_EX*)var->sqldata,
+				*(IBPP::Timestamp*)value);
+			break;
+
 		case SQL_BLOB :
 			if (ivType == ivBlob)
 			{
@@ -1086,8 +1403,7 @@ void* RowImpl::GetValue(int varnum, IITYPE ivType, void* retvalue)
 				// In case of ivString, 'void* retvalue' points to a std::string where we
 				// will directly store the data.
 				std::string* str = (std::string*)retvalue;
-				str->erase();
-				str->append(var->sqldata, var->sqllen);
+				str->assign(var->sqldata, var->sqllen);
 				value = retvalue;	// value != 0 means 'not null'
 			}
 			else if (ivType == ivByte)
@@ -1124,8 +1440,7 @@ void* RowImpl::GetValue(int varnum, IITYPE ivType, void* retvalue)
 				// In case of ivString, 'void* retvalue' points to a std::string where we
 				// will directly store the data.
 				std::string* str = (std::string*)retvalue;
-				str->erase();
-				str->append(var->sqldata+2, (int32_t)*(int16_t*)var->sqldata);
+				str->assign(var->sqldata+2, (int32_t)*(int16_t*)var->sqldata);
 				value = retvalue;
 			}
 			else if (ivType == ivByte)
@@ -1164,28 +1479,27 @@ void* RowImpl::GetValue(int varnum, IITYPE ivType, void* retvalue)
 			}
 			else if (ivType == ivInt32)
 			{
-				mInt32s[varnum-1] = *(int16_t*)var->sqldata;
-				value = &mInt32s[varnum-1];
+				value = ConversionTarget(retvalue, mInt32s[varnum-1]);
+				*(int32_t*)value = *(int16_t*)var->sqldata;
 			}
 			else if (ivType == ivInt64)
 			{
-				mInt64s[varnum-1] = *(int16_t*)var->sqldata;
-				value = &mInt64s[varnum-1];
+				value = ConversionTarget(retvalue, mInt64s[varnum-1]);
+				*(int64_t*)value = *(int16_t*)var->sqldata;
 			}
 			else if (ivType == ivFloat)
 			{
 				// This SQL_SHORT is a NUMERIC(x,y), scale it !
 				double divisor = consts::dscales[-var->sqlscale];
-				mFloats[varnum-1] = (float)(*(int16_t*)var->sqldata / divisor);
-
-				value = &mFloats[varnum-1];
+				value = ConversionTarget(retvalue, mFloats[varnum-1]);
+				*(float*)value = (float)(*(int16_t*)var->sqldata / divisor);
 			}
 			else if (ivType == ivDouble)
 			{
 				// This SQL_SHORT is a NUMERIC(x,y), scale it !
 				double divisor = consts::dscales[-var->sqlscale];
-				mNumerics[varnum-1] = *(int16_t*)var->sqldata / divisor;
-				value = &mNumerics[varnum-1];
+				value = ConversionTarget(retvalue, mNumerics[varnum-1]);
+				*(double*)value = *(int16_t*)var->sqldata / divisor;
 			}
 			else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
 										_("Incompatible types."));
@@ -1208,27 +1522,27 @@ void* RowImpl::GetValue(int varnum, IITYPE ivType, void* retvalue)
 				if (tmp < consts::min16 || tmp > consts::max16)
 					throw LogicExceptionImpl("RowImpl::GetValue",
 						_("Out of range numeric conversion !"));
-				mInt16s[varnum-1] = (int16_t)tmp;
-				value = &mInt16s[varnum-1];
+				value = ConversionTarget(retvalue, mInt16s[varnum-1]);
+				*(int16_t*)value = (int16_t)tmp;
 			}
 			else if (ivType == ivInt64)
 			{
-				mInt64s[varnum-1] = *(int32_t*)var->sqldata;
-				value = &mInt64s[varnum-1];
+				value = ConversionTarget(retvalue, mInt64s[varnum-1]);
+				*(int64_t*)value = *(int32_t*)var->sqldata;
 			}
 			else if (ivType == ivFloat)
 			{
 				// This SQL_LONG is a NUMERIC(x,y), scale it !
 				double divisor = consts::dscales[-var->sqlscale];
-				mFloats[varnum-1] = (float)(*(int32_t*)var->sqldata / divisor);
-				value = &mFloats[varnum-1];
+				value = ConversionTarget(retvalue, mFloats[varnum-1]);
+				*(float*)value = (float)(*(int32_t*)var->sqldata / divisor);
 			}
 			else if (ivType == ivDouble)
 			{
 				// This SQL_LONG is a NUMERIC(x,y), scale it !
 				double divisor = consts::dscales[-var->sqlscale];
-				mNumerics[varnum-1] = *(int32_t*)var->sqldata / divisor;
-				value = &mNumerics[varnum-1];
+				value = ConversionTarget(retvalue, mNumerics[varnum-1]);
+				*(double*)value = *(int32_t*)var->sqldata / divisor;
 			}
 			else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
 										_("Incompatible types."));
@@ -1251,8 +1565,8 @@ void* RowImpl::GetValue(int varnum, IITYPE ivType, void* retvalue)
 				if (tmp < consts::min16 || tmp > consts::max16)
 					throw LogicExceptionImpl("RowImpl::GetValue",
 						_("Out of range numeric conversion !"));
-				mInt16s[varnum-1] = (int16_t)tmp;
-				value = &mInt16s[varnum-1];
+				value = ConversionTarget(retvalue, mInt16s[varnum-1]);
+				*(int16_t*)value = (int16_t)tmp;
 			}
 			else if (ivType == ivInt32)
 			{
@@ -1260,22 +1574,22 @@ void* RowImpl::GetValue(int varnum, IITYPE ivType, void* retvalue)
 				if (tmp < consts::min32 || tmp > consts::max32)
 					throw LogicExceptionImpl("RowImpl::GetValue",
 						_("Out of range numeric conversion !"));
-				mInt32s[varnum-1] = (int32_t)tmp;
-				value = &mInt32s[varnum-1];
+				value = ConversionTarget(retvalue, mInt32s[varnum-1]);
+				*(int32_t*)value = (int32_t)tmp;
 			}
 			else if (ivType == ivFloat)
 			{
 				// This SQL_INT64 is a NUMERIC(x,y), scale it !
 				double divisor = consts::dscales[-var->sqlscale];
-				mFloats[varnum-1] = (float)(*(int64_t*)var->sqldata / divisor);
-				value = &mFloats[varnum-1];
+				value = ConversionTarget(retvalue, mFloats[varnum-1]);
+				*(float*)value = (float)(*(int64_t*)var->sqldata / divisor);
 			}
 			else if (ivType == ivDouble)
 			{
 				// This SQL_INT64 is a NUMERIC(x,y), scale it !
 				double divisor = consts::dscales[-var->sqlscale];
-				mNumerics[varnum-1] = *(int64_t*)var->sqldata / divisor;
-				value = &mNumerics[varnum-1];
+				value = ConversionTarget(retvalue, mNumerics[varnum-1]);
+				*(double*)value = *(int64_t*)var->sqldata / divisor;
 			}
 			else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
 										_("Incompatible types."));
@@ -1296,9 +1610,9 @@ void* RowImpl::GetValue(int varnum, IITYPE ivType, void* retvalue)
 			{
 				// Round to scale y of NUMERIC(x,y)
 				double multiplier = consts::dscales[-var->sqlscale];
-				mNumerics[varnum-1] =
+				value = ConversionTarget(retvalue, mNumerics[varnum-1]);
+				*(double*)value =
 					floor(*(double*)var->sqldata * multiplier + 0.5) / multiplier;
-				value = &mNumerics[varnum-1];
 			}
 			else value = var->sqldata;
 			break;
@@ -1327,6 +1641,109 @@ void* RowImpl::GetValue(int varnum, IITYPE ivType, void* retvalue)
 			value = retvalue;
 			break;
 
+		case SQL_INT128 :	// Firebird v4
+			{
+				IBPP::Int128 i128;
+				loadInt128(var->sqldata, i128);
+				if (ivType == ivInt128)
+				{
+					*(IBPP::Int128*)retvalue = i128;
+					value = retvalue;
+				}
+				else if (ivType == ivString)
+				{
+					// This SQL_INT128 may be a NUMERIC(x,y), scale it !
+					*(std::string*)retvalue = i128.AsString(-var->sqlscale);
+					value = retvalue;
+				}
+				else if (ivType == ivDouble)
+				{
+					value = ConversionTarget(retvalue, mNumerics[varnum-1]);
+					*(double*)value = i128.AsDouble(-var->sqlscale);
+				}
+				else if ((ivType == ivInt16 || ivType == ivInt32 || ivType == ivInt64)
+					&& var->sqlscale == 0)
+				{
+					int64_t tmp;
+					if (!i128.GetInt64(tmp)
+						|| (ivType == ivInt16 && (tmp < consts::min16 || tmp > consts::max16))
+						|| (ivType == ivInt32 && (tmp < consts::min32 || tmp > consts::max32)))
+						throw LogicExceptionImpl("RowImpl::GetValue",
+							_("Out of range numeric conversion !"));
+					if (ivType == ivInt16)
+					{
+						value = ConversionTarget(retvalue, mInt16s[varnum-1]);
+						*(int16_t*)value = (int16_t)tmp;
+					}
+					else if (ivType == ivInt32)
+					{
+						value = ConversionTarget(retvalue, mInt32s[varnum-1]);
+						*(int32_t*)value = (int32_t)tmp;
+					}
+					else
+					{
+						value = ConversionTarget(retvalue, mInt64s[varnum-1]);
+						*(int64_t*)value = tmp;
+					}
+				}
+				else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+											_("Incompatible types."));
+			}
+			break;
+
+		case SQL_DEC16 :
+		case SQL_DEC34 :
+			{
+				IBPP::DecFloat df;
+				loadDecFloat(var->sqldata, var->sqltype & ~1, df);
+				if (ivType == ivDecFloat)
+				{
+					*(IBPP::DecFloat*)retvalue = df;
+					value = retvalue;
+				}
+				else if (ivType == ivString)
+				{
+					*(std::string*)retvalue = df.AsString();
+					value = retvalue;
+				}
+				else if (ivType == ivDouble)
+				{
+					value = ConversionTarget(retvalue, mNumerics[varnum-1]);
+					*(double*)value = df.AsDouble();
+				}
+				else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+											_("Incompatible types."));
+			}
+			break;
+
+		case SQL_TIME_TZ_EX :
+			if (ivType != ivTime)
+				throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+										_("Incompatible types."));
+			decodeTimeTz(*(IBPP::Time*)retvalue, *(ISC_TIME_TZ_EX*)var->sqldata);
+			value = retvalue;
+			break;
+
+		case SQL_TIMESTAMP_TZ_EX :
+			if (ivType == ivTimestamp)
+			{
+				decodeTimestampTz(*(IBPP::Timestamp*)retvalue,
+					*(ISC_TIMESTAMP_TZ_EX*)var->sqldata);
+			}
+			else if (ivType == ivDate || ivType == ivTime)
+			{
+				IBPP::Timestamp timestamp;
+				decodeTimestampTz(timestamp, *(ISC_TIMESTAMP_TZ_EX*)var->sqldata);
+				if (ivType == ivDate)
+					*(IBPP::Date*)retvalue = timestamp;
+				else
+					*(IBPP::Time*)retvalue = timestamp;
+			}
+			else throw WrongTypeImpl("RowImpl::GetValue", var->sqltype, ivType,
+										_("Incompatible types."));
+			value = retvalue;
+			break;
+
 		case SQL_BLOB :
 			if (ivType == ivBlob)
 			{
@@ -1381,6 +1798,13 @@ void RowImpl::Free()
 					case SQL_TYPE_TIME :delete (ISC_TIME*) var->sqldata; break;
 					case SQL_TYPE_DATE :delete (ISC_DATE*) var->sqldata; break;
 					case SQL_BOOLEAN : // Firebird v3
+					case SQL_INT128 :  // Firebird v4
+					case SQL_DEC16 :
+					case SQL_DEC34 :
+					case SQL_TIME_TZ :
+					case SQL_TIME_TZ_EX :
+					case SQL_TIMESTAMP_TZ :
+					case SQL_TIMESTAMP_TZ_EX :
 					case SQL_TEXT :
 					case SQL_VARYING :	delete [] var->sqldata; break;
 					case SQL_SHORT :	delete (int16_t*) var->sqldata; break;
@@ -1467,6 +1891,28 @@ void RowImpl::AllocVariables()
 								break;
 		    case SQL_BOOLEAN :  var->sqldata = new char[1]; // Firebird v3
 								break;
+			// Firebird v4, WITH TIME ZONE values are fetched with the offset
+			// of their time zone, which IBPP can use without the time zone
+			// database (the server accepts the coercion)
+			case SQL_TIME_TZ :	var->sqltype = (short)(SQL_TIME_TZ_EX | (var->sqltype & 1));
+								var->sqllen = sizeof(ISC_TIME_TZ_EX);
+								var->sqldata = new char[var->sqllen];
+								memset(var->sqldata, 0, var->sqllen);
+								break;
+			case SQL_TIMESTAMP_TZ :
+								var->sqltype = (short)(SQL_TIMESTAMP_TZ_EX | (var->sqltype & 1));
+								var->sqllen = sizeof(ISC_TIMESTAMP_TZ_EX);
+								var->sqldata = new char[var->sqllen];
+								memset(var->sqldata, 0, var->sqllen);
+								break;
+			case SQL_INT128 :
+			case SQL_DEC16 :
+			case SQL_DEC34 :
+			case SQL_TIME_TZ_EX :
+			case SQL_TIMESTAMP_TZ_EX :
+								var->sqldata = new char[var->sqllen];
+								memset(var->sqldata, 0, var->sqllen);
+								break;
 			case SQL_TEXT :		var->sqldata = new char[var->sqllen+1];
 								memset(var->sqldata, ' ', var->sqllen);
 								var->sqldata[var->sqllen] = '\0';
@@ -1495,6 +1941,72 @@ bool RowImpl::MissingValues()
 	return false;
 }
 
+bool RowImpl::SameLayout(const RowImpl& other) const
+{
+	if (mDescrArea == 0 || other.mDescrArea == 0)
+		return false;
+	if (mDatabase != other.mDatabase || mTransaction != other.mTransaction
+		|| mDialect != other.mDialect)
+		return false;
+	if (mDescrArea->sqld != other.mDescrArea->sqld)
+		return false;
+	for (int i = 0; i < mDescrArea->sqld; i++)
+	{
+		const XSQLVAR* var = &(mDescrArea->sqlvar[i]);
+		const XSQLVAR* org = &(other.mDescrArea->sqlvar[i]);
+		if (var->sqltype != org->sqltype || var->sqllen != org->sqllen)
+			return false;
+	}
+	return true;
+}
+
+void RowImpl::GetViews(IBPP::ColumnViews& views)
+{
+	if (mDescrArea == 0)
+		throw LogicExceptionImpl("Row::GetViews", _("The row is not initialized."));
+
+	// Only (re)allocates when the number of columns changes
+	if (views.size() != (size_t)mDescrArea->sqld)
+		views.resize(mDescrArea->sqld);
+
+	for (int i = 0; i < mDescrArea->sqld; i++)
+	{
+		XSQLVAR* var = &(mDescrArea->sqlvar[i]);
+		IBPP::ColumnView& view = views[i];
+		view.scale = var->sqlscale;
+		view.subtype = var->sqlsubtype;
+		view.isNull = (var->sqltype & 1) && *(var->sqlind) != 0;
+		view.data = var->sqldata;
+		view.length = var->sqllen;
+		switch (var->sqltype & ~1)
+		{
+			case SQL_TEXT :      view.type = IBPP::sdString;    break;
+			case SQL_VARYING :   view.type = IBPP::sdString;
+								 view.data = var->sqldata + 2;
+								 view.length = (int)*(int16_t*)var->sqldata;
+								 break;
+			case SQL_SHORT :     view.type = IBPP::sdSmallint;  break;
+			case SQL_LONG :      view.type = IBPP::sdInteger;   break;
+			case SQL_INT64 :     view.type = IBPP::sdLargeint;  break;
+			case SQL_FLOAT :     view.type = IBPP::sdFloat;     break;
+			case SQL_DOUBLE :    view.type = IBPP::sdDouble;    break;
+			case SQL_TIMESTAMP : view.type = IBPP::sdTimestamp; break;
+			case SQL_TYPE_DATE : view.type = IBPP::sdDate;      break;
+			case SQL_TYPE_TIME : view.type = IBPP::sdTime;      break;
+			case SQL_BLOB :      view.type = IBPP::sdBlob;      break;
+			case SQL_ARRAY :     view.type = IBPP::sdArray;     break;
+			case SQL_BOOLEAN :   view.type = IBPP::sdBoolean;   break;
+			case SQL_INT128 :    view.type = IBPP::sdInt128;    break;
+			case SQL_DEC16 :
+			case SQL_DEC34 :     view.type = IBPP::sdDecFloat;  break;
+			case SQL_TIME_TZ_EX :      view.type = IBPP::sdTimeTz;      break;
+			case SQL_TIMESTAMP_TZ_EX : view.type = IBPP::sdTimestampTz; break;
+			default : throw LogicExceptionImpl("Row::GetViews",
+							_("Found an unknown sqltype !"));
+		}
+	}
+}
+
 RowImpl& RowImpl::operator=(const RowImpl& copied)
 {
 	Free();
@@ -1528,6 +2040,16 @@ RowImpl& RowImpl::operator=(const RowImpl& copied)
 								break;
 			case SQL_BOOLEAN :  var->sqldata = new char[1]; // Firebird v3
 								break;
+			case SQL_INT128 :	// Firebird v4
+			case SQL_DEC16 :
+			case SQL_DEC34 :
+			case SQL_TIME_TZ :
+			case SQL_TIME_TZ_EX :
+			case SQL_TIMESTAMP_TZ :
+			case SQL_TIMESTAMP_TZ_EX :
+								var->sqldata = new char[var->sqllen];
+								memcpy(var->sqldata, org->sqldata, var->sqllen);
+								break;
 			case SQL_TEXT :		var->sqldata = new char[var->sqllen+1];
 								memcpy(var->sqldata, org->sqldata, var->sqllen+1);
 								break;
@@ -550,6 +550,37 @@ void ServiceImpl::Repair(const std::string& dbfile, IBPP::RPF flags)
 	Wait();
 }
 
+namespace
+{
+
+unsigned int BackupOptions(IBPP::BRF flags)
+{
+	unsigned int mask = 0;
+	if (flags & IBPP::brIgnoreChecksums)	mask |= isc_spb_bkp_ignore_checksums;
+	if (flags & IBPP::brIgnoreLimbo)		mask |= isc_spb_bkp_ignore_limbo;
+	if (flags & IBPP::brMetadataOnly)		mask |= isc_spb_bkp_metadata_only;
+	if (flags & IBPP::brNoGarbageCollect)	mask |= isc_spb_bkp_no_garbage_collect;
+	if (flags & IBPP::brNonTransportable)	mask |= isc_spb_bkp_non_transportable;
+	if (flags & IBPP::brConvertExtTables)	mask |= isc_spb_bkp_convert;
+	return mask;
+}
+
+unsigned int RestoreOptions(IBPP::BRF flags)
+{
+	unsigned int mask;
+	if (flags & IBPP::brReplace) mask = isc_spb_res_replace;
+		else mask = isc_spb_res_create;	// Safe default mode
+
+	if (flags & IBPP::brDeactivateIdx)	mask |= isc_spb_res_deactivate_idx;
+	if (flags & IBPP::brNoShadow)		mask |= isc_spb_res_no_shadow;
+	if (flags & IBPP::brNoValidity)		mask |= isc_spb_res_no_validity;
+	if (flags & IBPP::brPerTableCommit)	mask |= isc_spb_res_one_at_a_time;
+	if (flags & IBPP::brUseAllSpace)	mask |= isc_spb_res_use_all_space;
+	return mask;
+}
+
+}
+
 void ServiceImpl::StartBackup(const std::string& dbfile,
 	const std::string& bkfile, IBPP::BRF flags)
 {
@@ -568,13 +599,7 @@ void ServiceImpl::StartBackup(const std::string& dbfile,
 	spb.InsertString(isc_spb_bkp_file, 2, bkfile.c_str());
 	if (flags & IBPP::brVerbose) spb.Insert(isc_spb_verbose);
 
-	unsigned int mask = 0;
-	if (flags & IBPP::brIgnoreChecksums)	mask |= isc_spb_bkp_ignore_checksums;
-	if (flags & IBPP::brIgnoreLimbo)		mask |= isc_spb_bkp_ignore_limbo;
-	if (flags & IBPP::brMetadataOnly)		mask |= isc_spb_bkp_metadata_only;
-	if (flags & IBPP::brNoGarbageCollect)	mask |= isc_spb_bkp_no_garbage_collect;
-	if (flags & IBPP::brNonTransportable)	mask |= isc_spb_bkp_non_transportable;
-	if (flags & IBPP::brConvertExtTables)	mask |= isc_spb_bkp_convert;
+	unsigned int mask = BackupOptions(flags);
 	if (mask != 0) spb.InsertQuad(isc_spb_options, mask);
 
 	(*gds.Call()->m_service_start)(status.Self(), &mHandle, 0, spb.Size(), spb.Self());
@@ -601,15 +626,7 @@ void ServiceImpl::StartRestore(const std::string& bkfile, const std::string& dbf
 	if (flags & IBPP::brVerbose) spb.Insert(isc_spb_verbose);
 	if (pagesize !=	0) spb.InsertQuad(isc_spb_res_page_size, pagesize);
 
-	unsigned int mask;
-	if (flags & IBPP::brReplace) mask = isc_spb_res_replace;
-		else mask = isc_spb_res_create;	// Safe default mode
-
-	if (flags & IBPP::brDeactivateIdx)	mask |= isc_spb_res_deactivate_idx;
-	if (flags & IBPP::brNoShadow)		mask |= isc_spb_res_no_shadow;
-	if (flags & IBPP::brNoValidity)		mask |= isc_spb_res_no_validity;
-	if (flags & IBPP::brPerTableCommit)	mask |= isc_spb_res_one_at_a_time;
-	if (flags & IBPP::brUseAllSpace)	mask |= isc_spb_res_use_all_space;
+	unsigned int mask = RestoreOptions(flags);
 	if (mask != 0) spb.InsertQuad(isc_spb_options, mask);
 
 	(*gds.Call()->m_service_start)(status.Self(), &mHandle, 0, spb.Size(), spb.Self());
@@ -617,6 +634,194 @@ void ServiceImpl::StartRestore(const std::string& bkfile, const std::string& dbf
 		throw SQLExceptionImpl(status, "Service::Restore", _("isc_service_start failed"));
 }
 
+void ServiceImpl::StartBackupStream(const std::string& dbfile,
+	IBPP::BRF flags, int parallelWorkers)
+{
+	if (mHandle	== 0)
+		throw LogicExceptionImpl("Service::BackupStream", _("Service is not connected."));
+	if (dbfile.empty())
+		throw LogicExceptionImpl("Service::BackupStream", _("Main database file must be specified."));
+
+	IBS status;
+	SPB spb;
+
+	// The backup is written to the standard output of the service, so
+	// isc_spb_verbose can't be used, its lines would end up in the data
+	spb.Insert(isc_action_svc_backup);
+	spb.InsertString(isc_spb_dbname, 2, dbfile.c_str());
+	spb.InsertString(isc_spb_bkp_file, 2, "stdout");
+	if (parallelWorkers > 0)
+		spb.InsertQuad(isc_spb_bkp_parallel_workers, parallelWorkers);
+
+	unsigned int mask = BackupOptions(flags);
+	if (mask != 0) spb.InsertQuad(isc_spb_options, mask);
+
+	(*gds.Call()->m_service_start)(status.Self(), &mHandle, 0, spb.Size(), spb.Self());
+	if (status.Errors())
+		throw SQLExceptionImpl(status, "Service::BackupStream", _("isc_service_start failed"));
+	mPendingOutput.clear();
+}
+
+void ServiceImpl::StartRestoreStream(const std::string& dbfile,
+	int	pagesize, IBPP::BRF flags, int parallelWorkers)
+{
+	if (mHandle	== 0)
+		throw LogicExceptionImpl("Service::RestoreStream", _("Service is not connected."));
+	if (dbfile.empty())
+		throw LogicExceptionImpl("Service::RestoreStream", _("Main database file must be specified."));
+
+	IBS status;
+	SPB spb;
+
+	spb.Insert(isc_action_svc_restore);
+	spb.InsertString(isc_spb_bkp_file, 2, "stdin");
+	spb.InsertString(isc_spb_dbname, 2, dbfile.c_str());
+	if (flags & IBPP::brVerbose) spb.Insert(isc_spb_verbose);
+	if (pagesize !=	0) spb.InsertQuad(isc_spb_res_page_size, pagesize);
+	if (parallelWorkers > 0)
+		spb.InsertQuad(isc_spb_res_parallel_workers, parallelWorkers);
+
+	unsigned int mask = RestoreOptions(flags);
+	if (mask != 0) spb.InsertQuad(isc_spb_options, mask);
+
+	(*gds.Call()->m_service_start)(status.Self(), &mHandle, 0, spb.Size(), spb.Self());
+	if (status.Errors())
+		throw SQLExceptionImpl(status, "Service::RestoreStream", _("isc_service_start failed"));
+}
+
+void ServiceImpl::StartDbStats(const std::string& dbfile, IBPP::STF flags,
+	const std::vector<std::string>& tables)
+{
+	if (mHandle	== 0)
+		throw LogicExceptionImpl("Service::StartDbStats", _("Service is not connected."));
+	if (dbfile.empty())
+		throw LogicExceptionImpl("Service::StartDbStats", _("Main database file must be specified."));
+
+	IBS status;
+	SPB spb;
+
+	spb.Insert(isc_action_svc_db_stats);
+	spb.InsertString(isc_spb_dbname, 2, dbfile.c_str());
+
+	unsigned int mask = 0;
+	if (flags & IBPP::stDataPages)			mask |= isc_spb_sts_data_pages;
+	if (flags & IBPP::stHeaderPages)		mask |= isc_spb_sts_hdr_pages;
+	if (flags & IBPP::stIndexPages)			mask |= isc_spb_sts_idx_pages;
+	if (flags & IBPP::stSystemRelations)	mask |= isc_spb_sts_sys_relations;
+	if (flags & IBPP::stRecordVersions)		mask |= isc_spb_sts_record_versions;
+	if (mask != 0) spb.InsertQuad(isc_spb_options, mask);
+
+	for (std::vector<std::string>::const_iterator it = tables.begin();
+		it != tables.end(); ++it)
+	{
+		spb.InsertString(isc_spb_sts_table, 2, it->c_str());
+	}
+
+	(*gds.Call()->m_service_start)(status.Self(), &mHandle, 0, spb.Size(), spb.Self());
+	if (status.Errors())
+		throw SQLExceptionImpl(status, "Service::StartDbStats", _("isc_service_start failed"));
+	mPendingOutput.clear();
+}
+
+int ServiceImpl::StartTrace(const std::string& configuration,
+	const std::string& name)
+{
+	if (mHandle	== 0)
+		throw LogicExceptionImpl("Service::StartTrace", _("Service is not connected."));
+	if (configuration.empty())
+		throw LogicExceptionImpl("Service::StartTrace", _("Trace configuration must be specified."));
+
+	IBS status;
+	SPB spb;
+
+	spb.Insert(isc_action_svc_trace_start);
+	if (!name.empty()) spb.InsertString(isc_spb_trc_name, 2, name.c_str());
+	spb.InsertString(isc_spb_trc_cfg, 2, configuration.c_str());
+
+	(*gds.Call()->m_service_start)(status.Self(), &mHandle, 0, spb.Size(), spb.Self());
+	if (status.Errors())
+		throw SQLExceptionImpl(status, "Service::StartTrace", _("isc_service_start failed"));
+
+	// The server reports "Trace session ID <n> started" right away
+	mPendingOutput.clear();
+	const char* line = WaitMsg();
+	if (line == 0)
+		throw LogicExceptionImpl("Service::StartTrace", _("Trace session did not start."));
+
+	const char* prefix = "Trace session ID ";
+	std::string text(line);
+	if (text.compare(0, strlen(prefix), prefix) == 0)
+	{
+		int id = atoi(text.c_str() + strlen(prefix));
+		if (id > 0) return id;
+	}
+	// Not the expected message, don't lose it
+	mPendingOutput = text + "\n";
+	return 0;
+}
+
+void ServiceImpl::StopTrace(int sessionId)
+{
+	if (mHandle	== 0)
+		throw LogicExceptionImpl("Service::StopTrace", _("Service is not connected."));
+
+	IBS status;
+	SPB spb;
+
+	spb.Insert(isc_action_svc_trace_stop);
+	spb.InsertQuad(isc_spb_trc_id, sessionId);
+
+	(*gds.Call()->m_service_start)(status.Self(), &mHandle, 0, spb.Size(), spb.Self());
+	if (status.Errors())
+		throw SQLExceptionImpl(status, "Service::StopTrace", _("isc_service_start failed"));
+
+	Wait();
+}
+
+void ServiceImpl::ListTraces(std::vector<IBPP::TraceSession>& sessions)
+{
+	if (mHandle	== 0)
+		throw LogicExceptionImpl("Service::ListTraces", _("Service is not connected."));
+
+	IBS status;
+	SPB spb;
+
+	spb.Insert(isc_action_svc_trace_list);
+
+	(*gds.Call()->m_service_start)(status.Self(), &mHandle, 0, spb.Size(), spb.Self());
+	if (status.Errors())
+		throw SQLExceptionImpl(status, "Service::ListTraces", _("isc_service_start failed"));
+
+	// Every session is reported as a block of "key: value" lines,
+	// starting with "Session ID: <n>"
+	sessions.clear();
+	const char* line;
+	while ((line = WaitMsg()) != 0)
+	{
+		std::string text(line);
+		std::string::size_type colon = text.find(':');
+		if (colon == std::string::npos) continue;
+
+		std::string key = text.substr(0, colon);
+		std::string value = text.substr(colon + 1);
+		key.erase(0, key.find_first_not_of(" \t"));
+		value.erase(0, value.find_first_not_of(" \t"));
+		value.erase(value.find_last_not_of(" \t\r\n") + 1);
+
+		if (key == "Session ID")
+		{
+			sessions.push_back(IBPP::TraceSession());
+			sessions.back().id = atoi(value.c_str());
+		}
+		else if (sessions.empty())
+			continue;
+		else if (key == "name") sessions.back().name = value;
+		else if (key == "user") sessions.back().user = value;
+		else if (key == "date") sessions.back().date = value;
+		else if (key == "flags") sessions.back().flags = value;
+	}
+}
+
 const char* ServiceImpl::WaitMsg()
 {
 	IBS status;
@@ -639,6 +844,131 @@ const char* ServiceImpl::WaitMsg()
 	return mWaitMessage.c_str();
 }
 
+bool ServiceImpl::ReadOutput(std::string& output, int timeout)
+{
+	if (mHandle	== 0)
+		throw LogicExceptionImpl("Service::ReadOutput", _("Service is not connected."));
+
+	output.clear();
+	if (!mPendingOutput.empty())
+	{
+		output.swap(mPendingOutput);
+		return true;
+	}
+
+	IBS status;
+	RB result(32000);
+
+	// isc_info_svc_timeout takes a length prefixed 4 bytes value
+	char send[7];
+	send[0] = isc_info_svc_timeout;
+	send[1] = 4;
+	send[2] = 0;
+	for (int i = 0; i < 4; i++)
+		send[3 + i] = char((timeout >> (8 * i)) & 0xFF);
+	char request[] = {isc_info_svc_to_eof};
+
+	// _service_query returns as much output as fits into the buffer, or
+	// whatever there is when the timeout has elapsed
+	(*gds.Call()->m_service_query)(status.Self(), &mHandle, 0,
+		sizeof(send), send, sizeof(request), request, result.Size(), result.Self());
+	if (status.Errors())
+		throw SQLExceptionImpl(status, "Service::ReadOutput", _("isc_service_query failed"));
+
+	char* p = result.Self();
+	if (*p != isc_info_svc_to_eof)
+		throw SQLExceptionImpl(status, "Service::ReadOutput", _("isc_service_query returned unexpected answer"));
+
+	int len = (*gds.Call()->m_vax_integer)(p+1, 2);
+	output.assign(p+3, len);
+
+	// Without output, the task has finished unless the server flags that
+	// the timeout elapsed or that more data is to come
+	bool running = len > 0;
+	char* pEnd = result.Self() + result.Size();
+	for (p += 3 + len; p < pEnd && *p != isc_info_end; p++)
+	{
+		if (*p == isc_info_svc_timeout || *p == isc_info_data_not_ready
+			|| *p == isc_info_truncated)
+		{
+			running = true;
+		}
+	}
+	return running;
+}
+
+bool ServiceImpl::WriteInput(const char* data, int size, int& requested,
+	std::string& output, int timeout)
+{
+	if (mHandle	== 0)
+		throw LogicExceptionImpl("Service::WriteInput", _("Service is not connected."));
+	if (size < 0 || size > 32000 || (size > 0 && data == 0))
+		throw LogicExceptionImpl("Service::WriteInput", _("Invalid data size."));
+
+	requested = 0;
+	output.clear();
+
+	IBS status;
+	RB result(32000);
+
+	// The data goes into a length prefixed isc_info_svc_line item of the
+	// send buffer, followed by the timeout of the query. An empty item
+	// tells the server that the input has ended
+	std::vector<char> send;
+	send.reserve(size + 10);
+	if (data != 0)
+	{
+		send.push_back(isc_info_svc_line);
+		send.push_back(char(size & 0xFF));
+		send.push_back(char((size >> 8) & 0xFF));
+		send.insert(send.end(), data, data + size);
+	}
+	send.push_back(isc_info_svc_timeout);
+	send.push_back(4);
+	send.push_back(0);
+	for (int i = 0; i < 4; i++)
+		send.push_back(char((timeout >> (8 * i)) & 0xFF));
+	char request[] = {isc_info_svc_stdin, isc_info_svc_line};
+
+	(*gds.Call()->m_service_query)(status.Self(), &mHandle, 0,
+		(short)send.size(), &send[0], sizeof(request), request,
+		result.Size(), result.Self());
+	if (status.Errors())
+		throw SQLExceptionImpl(status, "Service::WriteInput", _("isc_service_query failed"));
+
+	// isc_info_svc_stdin is followed by a plain 4 bytes value, without the
+	// usual length prefix
+	bool pending = false;
+	char* p = result.Self();
+	char* pEnd = result.Self() + result.Size();
+	while (p < pEnd && *p != isc_info_end)
+	{
+		switch (*p)
+		{
+			case isc_info_svc_stdin:
+				requested = (*gds.Call()->m_vax_integer)(p+1, 4);
+				p += 5;
+				break;
+			case isc_info_svc_line:
+			{
+				int len = (*gds.Call()->m_vax_integer)(p+1, 2);
+				output.append(p+3, len);
+				p += 3 + len;
+				break;
+			}
+			case isc_info_svc_timeout:
+			case isc_info_data_not_ready:
+			case isc_info_truncated:
+				pending = true;
+				p++;
+				break;
+			default:
+				throw SQLExceptionImpl(status, "Service::WriteInput", _("isc_service_query returned unexpected answer"));
+		}
+	}
+	return requested > 0 || !output.empty() || pending;
+}
+
 void ServiceImpl::Wait()
 {
 	IBS status;
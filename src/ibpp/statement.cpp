@@ -249,6 +249,36 @@ void StatementImpl::Plan(std::string& plan)
 	if (plan[0] == '\n') plan.erase(0, 1);
 }
 
+void StatementImpl::ExplainedPlan(std::string& plan)
+{
+	if (mHandle == 0)
+		throw LogicExceptionImpl("Statement::ExplainedPlan", _("No statement has been prepared."));
+	if (mDatabase == 0)
+		throw LogicExceptionImpl("Statement::ExplainedPlan", _("A Database must be attached."));
+	if (mDatabase->GetHandle() == 0)
+		throw LogicExceptionImpl("Statement::ExplainedPlan", _("Database must be connected."));
+
+	// The explained plan of a large join is several times as long as the
+	// legacy one, so use the largest buffer the API accepts.
+	IBS status;
+	RB result(32000);
+	char itemsReq[] = {isc_info_sql_explain_plan};
+
+	(*gds.Call()->m_dsql_sql_info)(status.Self(), &mHandle, 1, itemsReq,
+								   result.Size(), result.Self());
+	if (status.Errors()) throw SQLExceptionImpl(status,
+								"Statement::ExplainedPlan", _("isc_dsql_sql_info failed."));
+
+	// Servers before Firebird 3 answer with isc_info_error, a plan which
+	// doesn't fit in the buffer is answered with isc_info_truncated.
+	// The caller falls back to the legacy plan in both cases.
+	plan.erase();
+	if (!result.HasToken(isc_info_sql_explain_plan))
+		return;
+	result.GetString(isc_info_sql_explain_plan, plan);
+	if (!plan.empty() && plan[0] == '\n') plan.erase(0, 1);
+}
+
 void StatementImpl::Execute(const std::string& sql)
 {
 	if (! sql.empty()) Prepare(sql);
@@ -440,8 +470,14 @@ bool StatementImpl::Fetch(IBPP::Row& row)
 		throw LogicExceptionImpl("Statement::Fetch(row)",
 			_("No statement has been executed or no result set available."));
 
-	RowImpl* rowimpl = new RowImpl(*mOutRow);
-	row = rowimpl;
+	// Reuse the caller's row when nobody else holds a reference to it and it
+	// was fetched from this statement before, saves a full row allocation
+	RowImpl* rowimpl = dynamic_cast<RowImpl*>(row.intf());
+	if (rowimpl == 0 || rowimpl->Shared() || ! rowimpl->SameLayout(*mOutRow))
+	{
+		rowimpl = new RowImpl(*mOutRow);
+		row = rowimpl;
+	}
 
 	IBS status;
 	ISC_STATUS code = (*gds.Call()->m_dsql_fetch)(status.Self(), &mHandle, 1,
@@ -467,6 +503,14 @@ bool StatementImpl::Fetch(IBPP::Row& row)
 	return true;
 }
 
+bool StatementImpl::Fetch(IBPP::ColumnViews& views)
+{
+	if (! Fetch())
+		return false;
+	mOutRow->GetViews(views);
+	return true;
+}
+
 void StatementImpl::Close()
 {
 	// Free all statement resources.
@@ -620,6 +664,26 @@ void StatementImpl::Set(int param, const IBPP::Time& value)
 	mInRow->Set(param, value);
 }
 
+void StatementImpl::Set(int param, const IBPP::Int128& value)
+{
+	if (mHandle == 0)
+		throw LogicExceptionImpl("Statement::Set[Int128]", _("No statement has been prepared."));
+	if (mInRow == 0)
+		throw LogicExceptionImpl("Statement::Set[Int128]", _("The statement does not take parameters."));
+
+	mInRow->Set(param, value);
+}
+
+void StatementImpl::Set(int param, const IBPP::DecFloat& value)
+{
+	if (mHandle == 0)
+		throw LogicExceptionImpl("Statement::Set[DecFloat]", _("No statement has been prepared."));
+	if (mInRow == 0)
+		throw LogicExceptionImpl("Statement::Set[DecFloat]", _("The statement does not take parameters."));
+
+	mInRow->Set(param, value);
+}
+
 void StatementImpl::Set(int param, const IBPP::Blob& blob)
 {
 	if (mHandle == 0)
@@ -826,6 +890,22 @@ bool StatementImpl::Get(int column, IBPP::Time& time)
 	return mOutRow->Get(column, time);
 }
 
+bool StatementImpl::Get(int column, IBPP::Int128& value)
+{
+	if (mOutRow == 0)
+		throw LogicExceptionImpl("Statement::Get", _("The row is not initialized."));
+
+	return mOutRow->Get(column, value);
+}
+
+bool StatementImpl::Get(int column, IBPP::DecFloat& value)
+{
+	if (mOutRow == 0)
+		throw LogicExceptionImpl("Statement::Get", _("The row is not initialized."));
+
+	return mOutRow->Get(column, value);
+}
+
 bool StatementImpl::Get(int column, IBPP::Blob& blob)
 {
 	if (mOutRow == 0)
@@ -1024,6 +1104,22 @@ bool StatementImpl::Get(const std::string& name, IBPP::Time& retvalue)
 	return mOutRow->Get(name, retvalue);
 }
 
+bool StatementImpl::Get(const std::string& name, IBPP::Int128& retvalue)
+{
+	if (mOutRow == 0)
+		throw LogicExceptionImpl("Statement::Get", _("The row is not initialized."));
+
+	return mOutRow->Get(name, retvalue);
+}
+
+bool StatementImpl::Get(const std::string& name, IBPP::DecFloat& retvalue)
+{
+	if (mOutRow == 0)
+		throw LogicExceptionImpl("Statement::Get", _("The row is not initialized."));
+
+	return mOutRow->Get(name, retvalue);
+}
+
 bool StatementImpl::Get(const std::string&name, IBPP::Blob& retblob)
 {
 	if (mOutRow == 0)
@@ -95,26 +95,46 @@ int IBPP::Time::SubSeconds() const	// Actually tenthousandths of seconds
 
 IBPP::Time::Time(int hour, int minute, int second, int tenthousandths)
 {
+	mTimezone = IBPP::NoTimezone;
 	SetTime(hour, minute, second, tenthousandths);
 }
 
 IBPP::Time::Time(const IBPP::Time& copied)
 {
 	mTime = copied.mTime;
+	mTimezone = copied.mTimezone;
 }
 
 IBPP::Time& IBPP::Time::operator=(const IBPP::Timestamp& assigned)
 {
 	mTime = assigned.GetTime();
+	mTimezone = assigned.Timezone();
 	return *this;
 }
 
 IBPP::Time& IBPP::Time::operator=(const IBPP::Time& assigned)
 {
 	mTime = assigned.mTime;
+	mTimezone = assigned.mTimezone;
 	return *this;
 }
 
+void IBPP::Timestamp::AddMinutes(int minutes)
+{
+	const int oneDay = 864000000;	// in ten-thousandths of seconds
+	int64_t ticks = (int64_t)mTime + (int64_t)minutes * 600000;
+	int days = (int)(ticks / oneDay);
+	ticks -= (int64_t)days * oneDay;
+	if (ticks < 0)
+	{
+		ticks += oneDay;
+		--days;
+	}
+	mTime = (int)ticks;
+	if (days != 0)
+		Add(days);
+}
+
 //	Time calculations. Internal format is the number of seconds elapsed since
 //	midnight. Splits such a time in its hours, minutes, seconds components.
 
@@ -175,6 +195,7 @@ void encodeTime(ISC_TIME& isc_tm, const IBPP::Time& tm)
 void decodeTime(IBPP::Time& tm, const ISC_TIME& isc_tm)
 {
 	tm.SetTime((int)isc_tm);
+	tm.SetTimezone(IBPP::NoTimezone);
 }
 
 void encodeTimestamp(ISC_TIMESTAMP& isc_ts, const IBPP::Timestamp& ts)
@@ -189,5 +210,55 @@ void decodeTimestamp(IBPP::Timestamp& ts, const ISC_TIMESTAMP& isc_ts)
 	decodeTime(ts, isc_ts.timestamp_time);
 }
 
+//	Firebird v4 stores the UTC time plus a time zone id. IBPP only deals with
+//	offsets from UTC, it exchanges the local time with the offset valid at
+//	that moment (the ext_offset of the *_TZ_EX types). Offset time zones
+//	have the ids 0 to 2878, 1439 being UTC; region ids (like those of
+//	'Europe/Berlin') can't be mapped without the time zone database.
+
+namespace
+{
+	const int tzOffsetZero = 1439;
+	const int oneDay = 864000000;	// in ten-thousandths of seconds
+	const int oneMinute = 600000;
+}
+
+void encodeTimeTz(ISC_TIME_TZ_EX& isc_tm, const IBPP::Time& tm)
+{
+	int offset = tm.HasTimezone() ? tm.Timezone() : 0;
+	int utc = (tm.GetTime() - offset * oneMinute) % oneDay;
+	if (utc < 0)
+		utc += oneDay;
+	isc_tm.utc_time = (ISC_TIME)utc;
+	isc_tm.time_zone = (ISC_USHORT)(tzOffsetZero + offset);
+	isc_tm.ext_offset = (ISC_SHORT)offset;
+}
+
+void decodeTimeTz(IBPP::Time& tm, const ISC_TIME_TZ_EX& isc_tm)
+{
+	int local = ((int)isc_tm.utc_time + isc_tm.ext_offset * oneMinute) % oneDay;
+	if (local < 0)
+		local += oneDay;
+	tm.SetTime(local);
+	tm.SetTimezone(isc_tm.ext_offset);
+}
+
+void encodeTimestampTz(ISC_TIMESTAMP_TZ_EX& isc_ts, const IBPP::Timestamp& ts)
+{
+	int offset = ts.HasTimezone() ? ts.Timezone() : 0;
+	IBPP::Timestamp utc(ts);
+	utc.AddMinutes(-offset);
+	encodeTimestamp(isc_ts.utc_timestamp, utc);
+	isc_ts.time_zone = (ISC_USHORT)(tzOffsetZero + offset);
+	isc_ts.ext_offset = (ISC_SHORT)offset;
+}
+
+void decodeTimestampTz(IBPP::Timestamp& ts, const ISC_TIMESTAMP_TZ_EX& isc_ts)
+{
+	decodeTimestamp(ts, isc_ts.utc_timestamp);
+	ts.AddMinutes(isc_ts.ext_offset);
+	ts.SetTimezone(isc_ts.ext_offset);
+}
+
 }
 
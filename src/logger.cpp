@@ -32,6 +32,11 @@
 #include <wx/datetime.h>
 #include <wx/file.h>
 #include <wx/filename.h>
+#include <wx/thread.h>
+
+#include <deque>
+#include <map>
+#include <vector>
 
 #include "config/DatabaseConfig.h"
 #include "core/StringUtils.h"
@@ -41,22 +46,239 @@
 #include "sql/SqlStatement.h"
 #include "metadata/database.h"
 
+// the most statements written to the log table in one transaction
+static const size_t maxLogBatchSize = 1000;
+
+// a statement waiting to be written to the log table
+struct LogDatabaseEntry
+{
+    Database* database;
+    // the custom SELECT for the next id, or empty to use the generator
+    wxString idSelect;
+    bool isDDL;
+    wxString objectType;
+    wxString objectName;
+    wxString sql;
+};
+
+// a statement waiting to be written to a log file
+struct LogFileEntry
+{
+    wxString fileName;
+    // fileName contains a number format, every entry gets its own file
+    bool multiFile;
+    int firstIndex;
+    wxString text;
+};
+
+// LogFileWriterThread class
+// Appends the queued statements to the log files. Consecutive entries for
+// the same file are written as one block, and the next number of every
+// multiple file name is remembered, so the directory isn't searched for a
+// free name from the start for every statement.
+class LogFileWriterThread: public wxThread
+{
+private:
+    wxMutex mutexM;
+    wxCondition conditionM;
+    std::deque<LogFileEntry> entriesM;
+    bool stopM;
+    wxString errorM;
+
+    // only used by the thread
+    std::map<wxString, int> nextIndexM;
+
+    void setError(const wxString& error);
+    bool openNextFile(const LogFileEntry& entry, wxFile& file);
+    void write(const std::vector<LogFileEntry>& entries);
+public:
+    LogFileWriterThread();
+
+    void add(const LogFileEntry& entry);
+    // the thread exits when all queued entries are written
+    void stop();
+    // returns and clears the first error since the last call
+    wxString takeError();
+
+    virtual ExitCode Entry();
+};
+
+LogFileWriterThread::LogFileWriterThread()
+    : wxThread(wxTHREAD_JOINABLE), conditionM(mutexM), stopM(false)
+{
+}
+
+void LogFileWriterThread::add(const LogFileEntry& entry)
+{
+    wxMutexLocker lock(mutexM);
+    // no string data may be shared with the GUI thread
+    LogFileEntry copy;
+    copy.fileName = entry.fileName.Clone();
+    copy.multiFile = entry.multiFile;
+    copy.firstIndex = entry.firstIndex;
+    copy.text = entry.text.Clone();
+    entriesM.push_back(copy);
+    conditionM.Signal();
+}
+
+void LogFileWriterThread::stop()
+{
+    wxMutexLocker lock(mutexM);
+    stopM = true;
+    conditionM.Signal();
+}
+
+void LogFileWriterThread::setError(const wxString& error)
+{
+    wxMutexLocker lock(mutexM);
+    if (errorM.empty())
+        errorM = error.Clone();
+}
+
+wxString LogFileWriterThread::takeError()
+{
+    wxMutexLocker lock(mutexM);
+    wxString error(errorM.Clone());
+    errorM.clear();
+    return error;
+}
+
+bool LogFileWriterThread::openNextFile(const LogFileEntry& entry,
+    wxFile& file)
+{
+    int start = entry.firstIndex;
+    std::map<wxString, int>::iterator it = nextIndexM.find(entry.fileName);
+    if (it != nextIndexM.end() && it->second > start)
+        start = it->second;
+
+    wxString test;
+    for (int i = start; i < 100000; ++i)
+    {
+        test.Printf(entry.fileName, i);
+        wxFileName fn(test);
+        if (!wxDirExists(fn.GetPath()))  // directory doesn't exist
+        {
+            setError(wxString::Format(_("Directory %s does not exist"),
+                fn.GetPath().c_str()));
+            return false;
+        }
+        if (!wxFileExists(test) && file.Open(test, wxFile::write))
+        {
+            nextIndexM[entry.fileName] = i + 1;
+            return true;
+        }
+    }
+    setError(_("Cannot open log file."));
+    return false;
+}
+
+void LogFileWriterThread::write(const std::vector<LogFileEntry>& entries)
+{
+    size_t i = 0;
+    while (i < entries.size())
+    {
+        wxFile f;
+        if (entries[i].multiFile)
+        {
+            if (openNextFile(entries[i], f))
+                f.Write(entries[i].text);
+            ++i;
+            continue;
+        }
+
+        wxString block;
+        size_t j = i;
+        while (j < entries.size() && !entries[j].multiFile
+            && entries[j].fileName == entries[i].fileName)
+        {
+            block += entries[j++].text;
+        }
+        if (f.Open(entries[i].fileName, wxFile::write_append))
+            f.Write(block);
+        else
+            setError(_("Cannot open log file for writing."));
+        i = j;
+    }
+}
+
+wxThread::ExitCode LogFileWriterThread::Entry()
+{
+    while (true)
+    {
+        std::vector<LogFileEntry> entries;
+        {
+            wxMutexLocker lock(mutexM);
+            while (entriesM.empty() && !stopM)
+                conditionM.Wait();
+            if (entriesM.empty())
+                return 0;
+            entries.assign(entriesM.begin(), entriesM.end());
+            entriesM.clear();
+        }
+        write(entries);
+    }
+}
+
+static std::vector<LogDatabaseEntry> databaseEntries;
+static LogFileWriterThread* fileWriter = 0;
+
+static bool reportFileWriterError()
+{
+    if (!fileWriter)
+        return true;
+    wxString error(fileWriter->takeError());
+    if (error.empty())
+        return true;
+    showWarningDialog(0, _("Logging to file failed"), error,
+        AdvancedMessageDialogButtonsOk());
+    return false;
+}
+
 bool Logger::log2database(Config *cfg, const SqlStatement& stm, Database* db)
 {
-    wxMBConv* conv = db->getCharsetConverter();
+    LogDatabaseEntry entry;
+    entry.database = db;
+    if (cfg->get("LoggingUsesCustomSelect", false))
+    {
+        entry.idSelect = cfg->get("LoggingCustomSelect",
+            wxString("SELECT 1+MAX(ID) FROM FLAMEROBIN$LOG"));
+    }
+    entry.isDDL = stm.isDDL();
+    if (entry.isDDL)
+    {
+        entry.objectType = getNameOfType(stm.getObjectType());
+        entry.objectName = stm.getName();
+    }
+    entry.sql = stm.getStatement();
+    databaseEntries.push_back(entry);
+    return true;
+}
 
+// writes the entries [from, to), which all belong to the same database and
+// use the same id SELECT, in one transaction
+bool Logger::writeDatabaseEntries(const std::vector<LogDatabaseEntry>& entries,
+    size_t from, size_t to)
+{
+    Database* db = entries[from].database;
+    if (!prepareDatabase(db))
+        return false;
+
+    wxMBConv* conv = db->getCharsetConverter();
     IBPP::Transaction tr = IBPP::TransactionFactory(db->getIBPPDatabase());
     try
     {
         tr->Start();
         IBPP::Statement st = IBPP::StatementFactory(db->getIBPPDatabase(), tr);
 
-        // find next id
-        wxString sql = "SELECT gen_id(FLAMEROBIN$LOG_GEN, 1) FROM rdb$database";
-        if (cfg->get("LoggingUsesCustomSelect", false))
+        // find the first id, the generator is incremented once for the
+        // whole batch
+        int count = int(to - from);
+        wxString sql = entries[from].idSelect;
+        if (sql.empty())
         {
-            sql = cfg->get("LoggingCustomSelect",
-                wxString("SELECT 1+MAX(ID) FROM FLAMEROBIN$LOG"));
+            sql = wxString::Format(
+                "SELECT gen_id(FLAMEROBIN$LOG_GEN, %d) - %d FROM rdb$database",
+                count, count - 1);
         }
         st->Prepare(wx2std(sql, conv));
         st->Execute();
@@ -66,21 +288,25 @@ bool Logger::log2database(Config *cfg, const SqlStatement& stm, Database* db)
 
         st->Prepare("INSERT INTO FLAMEROBIN$LOG (id, object_type, \
             object_name, sql_statement) values (?,?,?,?)");
-        st->Set(1, cnt);
-        if (stm.isDDL())
+        for (size_t i = from; i < to; ++i)
         {
-            st->Set(2, wx2std(getNameOfType(stm.getObjectType()), conv));
-            st->Set(3, wx2std(stm.getName(), conv));
-        }
-        else
-        {
-            st->SetNull(2);
-            st->SetNull(3);
+            const LogDatabaseEntry& entry = entries[i];
+            st->Set(1, cnt++);
+            if (entry.isDDL)
+            {
+                st->Set(2, wx2std(entry.objectType, conv));
+                st->Set(3, wx2std(entry.objectName, conv));
+            }
+            else
+            {
+                st->SetNull(2);
+                st->SetNull(3);
+            }
+            IBPP::Blob bl = IBPP::BlobFactory(st->DatabasePtr(), tr);
+            bl->Save(wx2std(entry.sql, conv));
+            st->Set(4, bl);
+            st->Execute();
         }
-        IBPP::Blob bl = IBPP::BlobFactory(st->DatabasePtr(), tr);
-        bl->Save(wx2std(stm.getStatement(), conv));
-        st->Set(4, bl);
-        st->Execute();
         tr->Commit();
         return true;
     }
@@ -116,8 +342,11 @@ bool Logger::log2file(Config *cfg, const SqlStatement& st,
             sql += st.getTerminator();
     }
 
-    wxFile f;
-    if (logToFileType == multiFile)
+    LogFileEntry entry;
+    entry.fileName = filename;
+    entry.multiFile = (logToFileType == multiFile);
+    entry.firstIndex = 1;
+    if (entry.multiFile)
     {   // filename should contain stuff like: %d, %02d, %05d, etc.
         if (filename.find_last_of("%") == wxString::npos) // % not found
         {
@@ -126,69 +355,53 @@ bool Logger::log2file(Config *cfg, const SqlStatement& st,
                 AdvancedMessageDialogButtonsOk());
             return false;
         }
-        wxString test;
-        int start = 1;
-        cfg->getValue("IncrementalLogFileStart", start);
-        for (int i=start; i < 100000; ++i) // dummy test for 100000
-        {
-            test.Printf(filename, i);
-            wxFileName fn(test);
-
-            if (!wxDirExists(fn.GetPath()))  // directory doesn't exist
-            {
-                showWarningDialog(0, _("Logging to file failed"),
-                    wxString::Format(_("Directory %s does not exist"), fn.GetPath().c_str()),
-                    AdvancedMessageDialogButtonsOk());
-                return false;
-            }
-
-            if (!wxFileExists(test))
-            {
-                if (f.Open(test, wxFile::write))
-                    break;
-            }
-        }
-        if (!f.IsOpened())
-        {
-            showWarningDialog(0, _("Logging to file failed"),
-                _("Cannot open log file."), AdvancedMessageDialogButtonsOk());
-            return false;
-        }
-    }
-    else if (!f.Open(filename, wxFile::write_append )) // cannot open
-    {
-        showWarningDialog(0, _("Logging to file failed"),
-            _("Cannot open log file for writing."),
-            AdvancedMessageDialogButtonsOk());
-        return false;
+        cfg->getValue("IncrementalLogFileStart", entry.firstIndex);
     }
 
     bool loggingAddHeader = true;
     cfg->getValue("LoggingAddHeader", loggingAddHeader);
     if (loggingAddHeader)
     {
-        wxString header = wxString::Format(
+        entry.text = wxString::Format(
             _("\n/* Logged by FlameRobin %d.%d.%d at %s\n   User: %s    Database: %s */\n"),
             FR_VERSION_MAJOR, FR_VERSION_MINOR, FR_VERSION_RLS,
             wxDateTime::Now().Format().c_str(),
             db->getUsername().c_str(),
             db->getPath().c_str()
         );
-        f.Write(header);
     }
     else
-        f.Write("\n");
+        entry.text = "\n";
     if (logSetTerm && st.getTerminator() != ";")
-        f.Write("SET TERM " + st.getTerminator() + " ;\n");
-    f.Write(sql);
+        entry.text += "SET TERM " + st.getTerminator() + " ;\n";
+    entry.text += sql;
     if (logSetTerm && st.getTerminator() != ";")
-        f.Write("\nSET TERM ; " + st.getTerminator() + "\n");
-    f.Close();
+        entry.text += "\nSET TERM ; " + st.getTerminator() + "\n";
+
+    if (!fileWriter)
+    {
+        fileWriter = new LogFileWriterThread();
+        if (fileWriter->Create() != wxTHREAD_NO_ERROR
+            || fileWriter->Run() != wxTHREAD_NO_ERROR)
+        {
+            delete fileWriter;
+            fileWriter = 0;
+            showWarningDialog(0, _("Logging to file failed"),
+                _("Cannot start the log writer thread."),
+                AdvancedMessageDialogButtonsOk());
+            return false;
+        }
+    }
+    fileWriter->add(entry);
     return true;
 }
 
 bool Logger::logStatement(const SqlStatement& st, Database* db)
 {
+    // errors of the file writer show up with the next statement
+    if (!reportFileWriterError())
+        return false;
+
     DatabaseConfig dc(db, config());
     bool result = logStatementByConfig(&dc, st, db);
     if (!dc.get("ExcludeFromGlobalLogging", false))
@@ -273,11 +486,40 @@ bool Logger::logStatementByConfig(Config* cfg, const SqlStatement& st,
     bool logToDb = false;
     cfg->getValue("LogToDatabase", logToDb);
     if (logToDb)
+        return log2database(cfg, st, db);            // <- queue it
+    return true;
+}
+
+bool Logger::flush()
+{
+    std::vector<LogDatabaseEntry> entries;
+    entries.swap(databaseEntries);
+    size_t from = 0;
+    while (from < entries.size())
     {
-        if (!prepareDatabase(db))
+        size_t to = from + 1;
+        while (to < entries.size() && to - from < maxLogBatchSize
+            && entries[to].database == entries[from].database
+            && entries[to].idSelect == entries[from].idSelect)
+        {
+            ++to;
+        }
+        if (!writeDatabaseEntries(entries, from, to))
             return false;
-        return log2database(cfg, st, db);            // <- log it
+        from = to;
     }
-    return true;
+    return reportFileWriterError();
 }
 
+void Logger::shutdown()
+{
+    // databases can't be used any more, their entries are written by flush()
+    databaseEntries.clear();
+    if (fileWriter)
+    {
+        fileWriter->stop();
+        fileWriter->Wait();
+        delete fileWriter;
+        fileWriter = 0;
+    }
+}
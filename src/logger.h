@@ -26,21 +26,33 @@
 
 // Functions used to log successfully executed statements
 // in database or textual files
+#include <vector>
+
 #include <ibpp.h>
 class SqlStatement;
 
 class Database;
 class Config;
+struct LogDatabaseEntry;
 
+// The statements are queued: flush() writes those for the log tables in
+// batched transactions, a background thread appends those for the files.
 class Logger            // maybe we'll extend this later
 {
 private:
     static bool prepareDatabase(Database *db);
     static bool log2database(Config *, const SqlStatement& st, Database *db);
+    static bool writeDatabaseEntries(
+        const std::vector<LogDatabaseEntry>& entries, size_t from, size_t to);
     static bool log2file(Config *, const SqlStatement& st, Database *db, const wxString& filename);
     static bool logStatementByConfig(Config *cfg, const SqlStatement& st, Database *db);
 public:
     static bool logStatement(const SqlStatement& st, Database *db);
+    // writes the queued statements to the log tables, has to be called
+    // while their databases are still connected
+    static bool flush();
+    // waits until the log files are written, called on exit
+    static void shutdown();
 };
 
 #endif
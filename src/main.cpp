@@ -29,6 +29,7 @@
 #endif
 
 #include <wx/cmdline.h>
+#include <wx/stopwatch.h>
 #include <wx/sysopt.h>
 #include <wx/utils.h>
 
@@ -40,6 +41,7 @@
 #include "core/FRError.h"
 #include "core/StringUtils.h"
 #include "gui/MainFrame.h"
+#include "logger.h"
 #include "main.h"
 
 IMPLEMENT_APP(Application)
@@ -76,6 +78,7 @@ bool Application::OnInit()
     ::wxHandleFatalExceptions();
 #endif
 
+    wxStopWatch sw;
     std::set_terminate(parachute);
     checkEnvironment();
     parseCommandLine();
@@ -99,14 +102,23 @@ bool Application::OnInit()
 
     wxSystemOptions::SetOption("mac.listctrl.always_use_generic", true);
 
+    wxLogVerbose(_("Libraries initialized in %ld ms"), sw.Time());
     MainFrame* main_frame = new MainFrame(0, -1, "");
     SetTopWindow(main_frame);
     main_frame->Show();
+    wxLogVerbose(_("Main window shown after %ld ms"), sw.Time());
 
     openDatabasesFromParams(main_frame);
     return true;
 }
 
+int Application::OnExit()
+{
+    // the statements queued for the log files must not get lost
+    Logger::shutdown();
+    return wxApp::OnExit();
+}
+
 void Application::HandleEvent(wxEvtHandler* handler, wxEventFunction func,
     wxEvent& event) const
 {
@@ -140,6 +152,8 @@ void Application::parseCommandLine()
     parser.AddOption("h", "home", _("Set FlameRobin's home path"));
     parser.AddOption("uh", "user-home",
         _("Set FlameRobin's user home path"));
+    parser.AddSwitch("v", "verbose",
+        _("Report the startup timings and other details"));
     // open databases given as command line parameters
     parser.AddParam(_("File name of database to open"), wxCMD_LINE_VAL_STRING,
         wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE);
@@ -153,6 +167,9 @@ void Application::parseCommandLine()
         if (parser.Found("user-home", &paramValue))
             config().setUserHomePath(translatePathMacros(paramValue));
 
+        if (parser.Found("verbose"))
+            wxLog::SetVerbose(true);
+
         for (size_t i = 0; i < parser.GetParamCount(); i++)
             cmdlineParamsM.Add(parser.GetParam(i));
     }
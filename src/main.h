@@ -43,6 +43,7 @@ protected:
     virtual const wxString getConfigurableObjectId() const;
 public:
     bool OnInit();
+    virtual int OnExit();
     virtual bool OnExceptionInMainLoop();
     void OnFatalException();
     virtual void HandleEvent(wxEvtHandler* handler, wxEventFunction func,
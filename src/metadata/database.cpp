@@ -44,6 +44,7 @@
 #include "core/FRError.h"
 #include "core/ProgressIndicator.h"
 #include "core/StringUtils.h"
+#include "engine/ConnectionPool.h"
 #include "engine/MetadataLoader.h"
 #include "MasterPassword.h"
 #include "metadata/column.h"
@@ -311,13 +312,15 @@ bool DatabaseAuthenticationMode::getUseEncryptedPassword() const
 
 // Database class
 Database::Database()
-    : MetadataItem(ntDatabase), metadataLoaderM(0), connectedM(false),
-        connectionCredentialsM(0), charsetConverterM(0), dialectM(3), idM(0)
+    : MetadataItem(ntDatabase), metadataLoaderM(0), connectionPoolM(0),
+        connectedM(false), connectionCredentialsM(0), charsetConverterM(0),
+        dialectM(3), idM(0)
 {
 }
 
 Database::~Database()
 {
+    delete connectionPoolM;
     resetCredentials();
 }
 
@@ -1121,6 +1124,14 @@ void Database::connect(const wxString& password, ProgressIndicator* indicator)
                 setChildrenLoaded(false);
                 loadCollections(indicator);
                 setChildrenLoaded(true);
+
+                // spare attachments are only connected in advance when
+                // ConnectionPoolPrewarm is set
+                DatabaseConfig dc(this, config());
+                getConnectionPool().open(databaseM,
+                    std::max(0, dc.get("ConnectionPoolSize", 4)),
+                    std::max(0, dc.get("ConnectionPoolPrewarm", 0)),
+                    dc.get("ConnectionKeepAliveInterval", 120));
                 if (indicator)
                     indicator->initProgress(_("Complete"), 1, 1);
             }
@@ -1247,6 +1258,8 @@ void Database::setDisconnected()
 {
     delete metadataLoaderM;
     metadataLoaderM = 0;
+    if (connectionPoolM)
+        connectionPoolM->close();
     resetCredentials();     // "forget" temporary username/password
     connectedM = false;
     resetPendingLoadData();
@@ -1281,6 +1294,13 @@ MetadataLoader* Database::getMetadataLoader()
     return metadataLoaderM;
 }
 
+ConnectionPool& Database::getConnectionPool()
+{
+    if (connectionPoolM == 0)
+        connectionPoolM = new ConnectionPool();
+    return *connectionPoolM;
+}
+
 bool Database::getChildren(std::vector<MetadataItem*>& temp)
 {
     if (!connectedM)
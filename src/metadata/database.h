@@ -33,6 +33,7 @@
 #include "metadata/MetadataClasses.h"
 #include "metadata/metadataitem.h"
 
+class ConnectionPool;
 class MetadataLoader;
 class ProgressIndicator;
 class SqlStatement;
@@ -148,6 +149,7 @@ private:
     ServerWeakPtr serverM;
     IBPP::Database databaseM;
     MetadataLoader* metadataLoaderM;
+    ConnectionPool* connectionPoolM;
 
     bool connectedM;
     wxString databaseCharsetM;
@@ -233,6 +235,9 @@ public:
     void drop();
 
     MetadataLoader* getMetadataLoader();
+    // spare attachments for background tasks and additional windows,
+    // the pool is open while the database is connected
+    ConnectionPool& getConnectionPool();
 
     wxArrayString loadIdentifiers(const wxString& loadStatement,
         ProgressIndicator* progressIndicator = 0);